@@ -438,6 +438,7 @@ int SharedCrtResourceManager::establishConnection(const PlainConfig &config)
                     "successfully connected to the core. ",
                     ErrorDebugString(errorCode));
             }
+            notifyConnectionState(false);
         }
     };
 
@@ -447,6 +448,7 @@ int SharedCrtResourceManager::establishConnection(const PlainConfig &config)
     auto OnConnectionResumed = [this](const Mqtt::MqttConnection &, int returnCode, bool) {
         {
             LOGM_INFO(TAG, "MQTT connection resumed with return code: %d", returnCode);
+            notifyConnectionState(true);
         }
     };
 
@@ -536,9 +538,28 @@ Aws::Crt::Io::ClientBootstrap *SharedCrtResourceManager::getClientBootstrap()
     return clientBootstrap.get();
 }
 
+void SharedCrtResourceManager::addConnectionStateListener(ConnectionStateListener listener)
+{
+    lock_guard<mutex> lock(connectionStateListenersLock);
+    connectionStateListeners.push_back(move(listener));
+}
+
+void SharedCrtResourceManager::notifyConnectionState(bool connected)
+{
+    lock_guard<mutex> lock(connectionStateListenersLock);
+    for (const auto &listener : connectionStateListeners)
+    {
+        listener(connected);
+    }
+}
+
 void SharedCrtResourceManager::disconnect()
 {
     LOG_DEBUG(TAG, "Attempting to disconnect MQTT connection");
+    {
+        lock_guard<mutex> lock(connectionStateListenersLock);
+        connectionStateListeners.clear();
+    }
     if (connection == NULL)
     {
         return;
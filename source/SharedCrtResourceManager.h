@@ -11,7 +11,10 @@
 #include <atomic>
 #include <aws/crt/Api.h>
 #include <aws/iot/MqttClient.h>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 namespace Aws
 {
@@ -27,6 +30,12 @@ namespace Aws
              */
             class SharedCrtResourceManager
             {
+              public:
+                /**
+                 * \brief Callback invoked when the MQTT connection is interrupted (false) or resumed (true)
+                 */
+                using ConnectionStateListener = std::function<void(bool connected)>;
+
               private:
                 const char *TAG = "SharedCrtResourceManager.cpp";
                 const char *BINARY_NAME = "IoTDeviceClient";
@@ -44,6 +53,8 @@ namespace Aws
                 aws_allocator *allocator{nullptr};
                 aws_mem_trace_level memTraceLevel{AWS_MEMTRACE_NONE};
                 std::shared_ptr<Util::FeatureRegistry> features;
+                std::mutex connectionStateListenersLock;
+                std::vector<ConnectionStateListener> connectionStateListeners;
 
                 bool setupLogging(const PlainConfig &config) const;
 
@@ -51,6 +62,8 @@ namespace Aws
 
                 void loadMemTraceLevelFromEnvironment();
 
+                void notifyConnectionState(bool connected);
+
               protected:
                 /**
                  * inheritable for testing
@@ -98,6 +111,13 @@ namespace Aws
 
                 virtual Aws::Crt::Io::ClientBootstrap *getClientBootstrap();
 
+                /**
+                 * \brief Register a listener for MQTT connection interruptions and resumptions
+                 *
+                 * Listeners are invoked from the MQTT client event loop, and are removed on disconnect().
+                 */
+                void addConnectionStateListener(ConnectionStateListener listener);
+
                 void disconnect();
 
                 void dumpMemTrace();
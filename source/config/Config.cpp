@@ -27,10 +27,17 @@
 #include <algorithm>
 #include <aws/crt/JsonObject.h>
 #include <aws/io/socket.h>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <regex>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <sys/stat.h>
@@ -491,6 +498,15 @@ void PlainConfig::SerializeToObject(Crt::JsonObject &object) const
 
 constexpr char PlainConfig::LogConfig::LOG_TYPE_FILE[];
 constexpr char PlainConfig::LogConfig::LOG_TYPE_STDOUT[];
+constexpr char PlainConfig::LogConfig::LOG_TYPE_BINARY[];
+
+constexpr char PlainConfig::LogConfig::LOG_FLUSH_BATCH[];
+constexpr char PlainConfig::LogConfig::LOG_FLUSH_INTERVAL[];
+constexpr char PlainConfig::LogConfig::LOG_FLUSH_ERROR[];
+
+constexpr char PlainConfig::LogConfig::LOG_OVERFLOW_DROP_OLDEST[];
+constexpr char PlainConfig::LogConfig::LOG_OVERFLOW_DROP_NEWEST[];
+constexpr char PlainConfig::LogConfig::LOG_OVERFLOW_BLOCK[];
 
 constexpr char PlainConfig::LogConfig::CLI_LOG_LEVEL[];
 constexpr char PlainConfig::LogConfig::CLI_LOG_TYPE[];
@@ -499,6 +515,11 @@ constexpr char PlainConfig::LogConfig::CLI_LOG_FILE[];
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_LEVEL[];
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_TYPE[];
 constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_FILE[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_FLUSH_POLICY[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_FLUSH_INTERVAL_MS[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_QUEUE_CAPACITY[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_OVERFLOW_POLICY[];
+constexpr char PlainConfig::LogConfig::JSON_KEY_LOG_OVERFLOW_BLOCK_MS[];
 
 constexpr char PlainConfig::LogConfig::CLI_ENABLE_SDK_LOGGING[];
 constexpr char PlainConfig::LogConfig::CLI_SDK_LOG_LEVEL[];
@@ -585,13 +606,74 @@ string PlainConfig::LogConfig::ParseDeviceClientLogType(const string &value) con
     {
         return LOG_TYPE_STDOUT;
     }
+    else if (LOG_TYPE_BINARY == temp)
+    {
+        return LOG_TYPE_BINARY;
+    }
     else
     {
         throw std::invalid_argument(FormatMessage(
-            "Provided log type %s is not a known log type. Acceptable values are: [%s, %s]",
+            "Provided log type %s is not a known log type. Acceptable values are: [%s, %s, %s]",
             Sanitize(value).c_str(),
             LOG_TYPE_FILE,
-            LOG_TYPE_STDOUT));
+            LOG_TYPE_STDOUT,
+            LOG_TYPE_BINARY));
+    }
+}
+
+string PlainConfig::LogConfig::ParseDeviceClientLogFlushPolicy(const string &value) const
+{
+    string temp = value;
+    // Convert to lowercase for comparisons
+    std::transform(temp.begin(), temp.end(), temp.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (LOG_FLUSH_BATCH == temp)
+    {
+        return LOG_FLUSH_BATCH;
+    }
+    else if (LOG_FLUSH_INTERVAL == temp)
+    {
+        return LOG_FLUSH_INTERVAL;
+    }
+    else if (LOG_FLUSH_ERROR == temp)
+    {
+        return LOG_FLUSH_ERROR;
+    }
+    else
+    {
+        throw std::invalid_argument(FormatMessage(
+            "Provided log flush policy %s is not a known flush policy. Acceptable values are: [%s, %s, %s]",
+            Sanitize(value).c_str(),
+            LOG_FLUSH_BATCH,
+            LOG_FLUSH_INTERVAL,
+            LOG_FLUSH_ERROR));
+    }
+}
+
+string PlainConfig::LogConfig::ParseDeviceClientLogOverflowPolicy(const string &value) const
+{
+    string temp = value;
+    // Convert to lowercase for comparisons
+    std::transform(temp.begin(), temp.end(), temp.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (LOG_OVERFLOW_DROP_OLDEST == temp)
+    {
+        return LOG_OVERFLOW_DROP_OLDEST;
+    }
+    else if (LOG_OVERFLOW_DROP_NEWEST == temp)
+    {
+        return LOG_OVERFLOW_DROP_NEWEST;
+    }
+    else if (LOG_OVERFLOW_BLOCK == temp)
+    {
+        return LOG_OVERFLOW_BLOCK;
+    }
+    else
+    {
+        throw std::invalid_argument(FormatMessage(
+            "Provided log overflow policy %s is not a known overflow policy. Acceptable values are: [%s, %s, %s]",
+            Sanitize(value).c_str(),
+            LOG_OVERFLOW_DROP_OLDEST,
+            LOG_OVERFLOW_DROP_NEWEST,
+            LOG_OVERFLOW_BLOCK));
     }
 }
 
@@ -664,7 +746,7 @@ bool PlainConfig::LogConfig::LoadFromJson(const Crt::JsonView &json)
     }
 
     jsonKey = JSON_KEY_LOG_FILE;
-    if ((deviceClientLogtype == LOG_TYPE_FILE) && json.ValueExists(jsonKey))
+    if ((deviceClientLogtype == LOG_TYPE_FILE || deviceClientLogtype == LOG_TYPE_BINARY) && json.ValueExists(jsonKey))
     {
         if (!json.GetString(jsonKey).empty())
         {
@@ -676,6 +758,66 @@ bool PlainConfig::LogConfig::LoadFromJson(const Crt::JsonView &json)
         }
     }
 
+    jsonKey = JSON_KEY_LOG_FLUSH_POLICY;
+    if (json.ValueExists(jsonKey))
+    {
+        if (!json.GetString(jsonKey).empty())
+        {
+            try
+            {
+                deviceClientLogFlushPolicy = ParseDeviceClientLogFlushPolicy(json.GetString(jsonKey).c_str());
+            }
+            catch (const std::invalid_argument &e)
+            {
+                LOGM_ERROR(Config::TAG, "Unable to parse incoming log flush policy passed via JSON: %s", e.what());
+                return false;
+            }
+        }
+        else
+        {
+            LOGM_WARN(Config::TAG, "Key {%s} was provided in the JSON configuration file with an empty value", jsonKey);
+        }
+    }
+
+    jsonKey = JSON_KEY_LOG_FLUSH_INTERVAL_MS;
+    if (json.ValueExists(jsonKey))
+    {
+        deviceClientLogFlushIntervalMs = json.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_LOG_QUEUE_CAPACITY;
+    if (json.ValueExists(jsonKey))
+    {
+        deviceClientLogQueueCapacity = json.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_KEY_LOG_OVERFLOW_POLICY;
+    if (json.ValueExists(jsonKey))
+    {
+        if (!json.GetString(jsonKey).empty())
+        {
+            try
+            {
+                deviceClientLogOverflowPolicy = ParseDeviceClientLogOverflowPolicy(json.GetString(jsonKey).c_str());
+            }
+            catch (const std::invalid_argument &e)
+            {
+                LOGM_ERROR(Config::TAG, "Unable to parse incoming log overflow policy passed via JSON: %s", e.what());
+                return false;
+            }
+        }
+        else
+        {
+            LOGM_WARN(Config::TAG, "Key {%s} was provided in the JSON configuration file with an empty value", jsonKey);
+        }
+    }
+
+    jsonKey = JSON_KEY_LOG_OVERFLOW_BLOCK_MS;
+    if (json.ValueExists(jsonKey))
+    {
+        deviceClientLogOverflowBlockMs = json.GetInt64(jsonKey);
+    }
+
     jsonKey = JSON_KEY_ENABLE_SDK_LOGGING;
     if (json.ValueExists(jsonKey))
     {
@@ -781,6 +923,36 @@ bool PlainConfig::LogConfig::LoadFromCliArgs(const CliArgs &cliArgs)
 
 bool PlainConfig::LogConfig::Validate() const
 {
+    if (deviceClientLogFlushIntervalMs <= 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be positive",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_KEY_LOG_FLUSH_INTERVAL_MS,
+            deviceClientLogFlushIntervalMs);
+        return false;
+    }
+    if (deviceClientLogQueueCapacity <= 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be positive",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_KEY_LOG_QUEUE_CAPACITY,
+            deviceClientLogQueueCapacity);
+        return false;
+    }
+    if (deviceClientLogOverflowBlockMs < 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be non-negative",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_KEY_LOG_OVERFLOW_BLOCK_MS,
+            deviceClientLogOverflowBlockMs);
+        return false;
+    }
     return true;
 }
 
@@ -789,6 +961,11 @@ void PlainConfig::LogConfig::SerializeToObject(Crt::JsonObject &object) const
     object.WithString(JSON_KEY_LOG_LEVEL, StringifyDeviceClientLogLevel(deviceClientlogLevel).c_str());
     object.WithString(JSON_KEY_LOG_TYPE, deviceClientLogtype.c_str());
     object.WithString(JSON_KEY_LOG_FILE, deviceClientLogFile.c_str());
+    object.WithString(JSON_KEY_LOG_FLUSH_POLICY, deviceClientLogFlushPolicy.c_str());
+    object.WithInt64(JSON_KEY_LOG_FLUSH_INTERVAL_MS, deviceClientLogFlushIntervalMs);
+    object.WithInt64(JSON_KEY_LOG_QUEUE_CAPACITY, deviceClientLogQueueCapacity);
+    object.WithString(JSON_KEY_LOG_OVERFLOW_POLICY, deviceClientLogOverflowPolicy.c_str());
+    object.WithInt64(JSON_KEY_LOG_OVERFLOW_BLOCK_MS, deviceClientLogOverflowBlockMs);
     object.WithBool(JSON_KEY_ENABLE_SDK_LOGGING, sdkLoggingEnabled);
     object.WithString(JSON_KEY_SDK_LOG_LEVEL, StringifySDKLogLevel(sdkLogLevel).c_str());
     object.WithString(JSON_KEY_SDK_LOG_FILE, sdkLogFile.c_str());
@@ -2087,17 +2264,90 @@ constexpr char PlainConfig::SensorPublish::JSON_ENABLED[];
 constexpr char PlainConfig::SensorPublish::JSON_NAME[];
 constexpr char PlainConfig::SensorPublish::JSON_ADDR[];
 constexpr char PlainConfig::SensorPublish::JSON_ADDR_POLL_SEC[];
+constexpr char PlainConfig::SensorPublish::JSON_ADDR_TYPE[];
+constexpr char PlainConfig::SensorPublish::JSON_MAX_MESSAGE_BYTES[];
 constexpr char PlainConfig::SensorPublish::JSON_BUFFER_TIME_MS[];
 constexpr char PlainConfig::SensorPublish::JSON_BUFFER_SIZE[];
 constexpr char PlainConfig::SensorPublish::JSON_BUFFER_CAPACITY[];
+constexpr char PlainConfig::SensorPublish::JSON_MAX_INFLIGHT[];
+constexpr char PlainConfig::SensorPublish::JSON_READ_BUDGET_BYTES[];
 constexpr char PlainConfig::SensorPublish::JSON_EOM_DELIMITER[];
 constexpr char PlainConfig::SensorPublish::JSON_MQTT_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_MQTT_DEAD_LETTER_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_MQTT_HEARTBEAT_TOPIC[];
 constexpr char PlainConfig::SensorPublish::JSON_HEARTBEAT_TIME_SEC[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_DIR[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_MAX_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_SPOOL_DRAIN_RATE[];
+constexpr char PlainConfig::SensorPublish::JSON_COMPRESSION[];
+constexpr char PlainConfig::SensorPublish::JSON_COMPRESSION_MIN_BYTES[];
+constexpr char PlainConfig::SensorPublish::ADDR_TYPE_STREAM[];
+constexpr char PlainConfig::SensorPublish::ADDR_TYPE_DGRAM[];
+constexpr char PlainConfig::SensorPublish::ADDR_TYPE_SEQPACKET[];
+constexpr char PlainConfig::SensorPublish::ADDR_TYPE_UDP[];
+constexpr char PlainConfig::SensorPublish::ADDR_TYPE_CAN[];
+constexpr char PlainConfig::SensorPublish::COMPRESSION_NONE[];
+constexpr char PlainConfig::SensorPublish::COMPRESSION_DEFLATE[];
+constexpr char PlainConfig::SensorPublish::COMPRESSION_ZSTD[];
+constexpr char PlainConfig::SensorPublish::JSON_BATCH_FORMAT[];
+constexpr char PlainConfig::SensorPublish::JSON_BATCH_TIMESTAMPS[];
+constexpr char PlainConfig::SensorPublish::JSON_EVENT_LOOP[];
+constexpr char PlainConfig::SensorPublish::JSON_AGGREGATE[];
+constexpr char PlainConfig::SensorPublish::JSON_SUMMARY_FORMAT[];
+constexpr char PlainConfig::SensorPublish::JSON_SUMMARY_FIELDS[];
+constexpr char PlainConfig::SensorPublish::JSON_SUMMARY_WINDOW_MS[];
+constexpr char PlainConfig::SensorPublish::JSON_DROP_DUPLICATES[];
+constexpr char PlainConfig::SensorPublish::JSON_DEADBAND_FORMAT[];
+constexpr char PlainConfig::SensorPublish::JSON_DEADBAND_FIELDS[];
+constexpr char PlainConfig::SensorPublish::JSON_DEADBAND[];
+constexpr char PlainConfig::SensorPublish::JSON_MAX_MESSAGE_RATE[];
+constexpr char PlainConfig::SensorPublish::JSON_MQTT_COMMAND_TOPIC[];
+constexpr char PlainConfig::SensorPublish::JSON_COMMAND_BUFFER_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_COMMAND_DROP_POLICY[];
+constexpr char PlainConfig::SensorPublish::JSON_CAN_FILTERS[];
+constexpr char PlainConfig::SensorPublish::JSON_EVENT_LOOP_THREADS[];
+constexpr char PlainConfig::SensorPublish::JSON_EVENT_LOOP_CPUS[];
+constexpr char PlainConfig::SensorPublish::JSON_MAX_SENSORS[];
+constexpr char PlainConfig::SensorPublish::JSON_SENSORS_DIR[];
+constexpr char PlainConfig::SensorPublish::JSON_MEMORY_BUDGET_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_AGGREGATE_TOPIC[];
+constexpr char PlainConfig::SensorPublish::JSON_AGGREGATE_MAX_BYTES[];
+constexpr char PlainConfig::SensorPublish::JSON_AGGREGATE_TIME_MS[];
+constexpr char PlainConfig::SensorPublish::JSON_AGGREGATE_MAX_INFLIGHT[];
+constexpr char PlainConfig::SensorPublish::JSON_STATS_FILE[];
+constexpr char PlainConfig::SensorPublish::JSON_STATS_TOPIC[];
+constexpr char PlainConfig::SensorPublish::JSON_STATS_INTERVAL_SEC[];
+constexpr char PlainConfig::SensorPublish::JSON_HEARTBEAT_TOPIC[];
+constexpr char PlainConfig::SensorPublish::JSON_HEARTBEAT_INTERVAL_SEC[];
+constexpr char PlainConfig::SensorPublish::SENSOR_FILE_SUFFIX[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_RAW[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_JSON_ARRAY[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_CBOR[];
+constexpr char PlainConfig::SensorPublish::BATCH_FORMAT_LENGTH_PREFIXED[];
+constexpr char PlainConfig::SensorPublish::FIELD_FORMAT_JSON[];
+constexpr char PlainConfig::SensorPublish::FIELD_FORMAT_CSV[];
+constexpr char PlainConfig::SensorPublish::DROP_POLICY_NEWEST[];
+constexpr char PlainConfig::SensorPublish::DROP_POLICY_OLDEST[];
 
 constexpr int64_t PlainConfig::SensorPublish::BUF_CAPACITY_BYTES;
 constexpr int64_t PlainConfig::SensorPublish::BUF_CAPACITY_BYTES_MIN;
+constexpr int64_t PlainConfig::SensorPublish::MAX_INFLIGHT;
+constexpr int64_t PlainConfig::SensorPublish::READ_BUDGET_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::MAX_MESSAGE_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::SPOOL_MAX_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::SPOOL_MAX_BYTES_MIN;
+constexpr int64_t PlainConfig::SensorPublish::SPOOL_DRAIN_RATE;
+constexpr int64_t PlainConfig::SensorPublish::COMPRESSION_MIN_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::EVENT_LOOP_THREADS_MAX;
+constexpr int64_t PlainConfig::SensorPublish::AGGREGATE_TIME_MS;
+constexpr int64_t PlainConfig::SensorPublish::SUMMARY_WINDOW_MS;
+constexpr size_t PlainConfig::SensorPublish::FIELDS_MAX;
+constexpr int64_t PlainConfig::SensorPublish::COMMAND_BUFFER_BYTES;
+constexpr int64_t PlainConfig::SensorPublish::CAN_MESSAGE_BYTES_MAX;
+constexpr size_t PlainConfig::SensorPublish::CAN_FILTERS_MAX;
+constexpr int64_t PlainConfig::SensorPublish::STATS_INTERVAL_SEC;
+constexpr int64_t PlainConfig::SensorPublish::HEARTBEAT_INTERVAL_SEC;
+constexpr int64_t PlainConfig::SensorPublish::MAX_SENSORS_LIMIT;
 
 bool PlainConfig::SensorPublish::LoadFromJson(const Crt::JsonView &json)
 {
@@ -2107,177 +2357,710 @@ bool PlainConfig::SensorPublish::LoadFromJson(const Crt::JsonView &json)
         int entryId = 1;
         for (const auto &entry : json.GetArray(sensorsKey))
         {
-            SensorPublish::SensorSettings sensorSettings;
+            settings.push_back(LoadSensorSettings(entry, to_string(entryId)));
+            ++entryId;
+        }
+    }
 
-            const char *jsonKey = JSON_ENABLED;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.enabled = entry.GetBool(jsonKey);
-            }
+    const char *jsonKey = JSON_SENSORS_DIR;
+    if (json.ValueExists(jsonKey))
+    {
+        sensorsDir = json.GetString(jsonKey).c_str();
+        LoadSensorsDir();
+    }
 
-            // If at least one sensor is enabled, then enable the feature.
-            if (sensorSettings.enabled)
-            {
-                enabled = true;
-            }
+    // If at least one sensor is enabled, then enable the feature.
+    for (const auto &setting : settings)
+    {
+        if (setting.enabled)
+        {
+            enabled = true;
+        }
+    }
 
-            jsonKey = JSON_NAME;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.name = entry.GetString(jsonKey).c_str();
-            }
-            else
-            {
-                sensorSettings.name = to_string(entryId);
-            }
+    jsonKey = JSON_EVENT_LOOP_THREADS;
+    if (json.ValueExists(jsonKey))
+    {
+        eventLoopThreads = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_ADDR;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.addr = entry.GetString(jsonKey).c_str();
-            }
+    jsonKey = JSON_EVENT_LOOP_CPUS;
+    if (json.ValueExists(jsonKey) && json.GetJsonObject(jsonKey).IsListType())
+    {
+        for (const auto &cpu : json.GetArray(jsonKey))
+        {
+            eventLoopCpus.push_back(cpu.AsInt64());
+        }
+    }
 
-            jsonKey = JSON_ADDR_POLL_SEC;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.addrPollSec = entry.GetInt64(jsonKey);
-            }
+    jsonKey = JSON_MAX_SENSORS;
+    if (json.ValueExists(jsonKey))
+    {
+        maxSensors = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_BUFFER_TIME_MS;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.bufferTimeMs = entry.GetInt64(jsonKey);
-            }
+    jsonKey = JSON_MEMORY_BUDGET_BYTES;
+    if (json.ValueExists(jsonKey))
+    {
+        memoryBudgetBytes = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_BUFFER_SIZE;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.bufferSize = entry.GetInt64(jsonKey);
-            }
+    jsonKey = JSON_AGGREGATE_TOPIC;
+    if (json.ValueExists(jsonKey))
+    {
+        aggregateTopic = json.GetString(jsonKey).c_str();
+    }
 
-            jsonKey = JSON_BUFFER_CAPACITY;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.bufferCapacity = entry.GetInt64(jsonKey);
-            }
+    jsonKey = JSON_AGGREGATE_MAX_BYTES;
+    if (json.ValueExists(jsonKey))
+    {
+        aggregateMaxBytes = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_EOM_DELIMITER;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.eomDelimiter = entry.GetString(jsonKey).c_str();
-            }
+    jsonKey = JSON_AGGREGATE_TIME_MS;
+    if (json.ValueExists(jsonKey))
+    {
+        aggregateTimeMs = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_MQTT_TOPIC;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.mqttTopic = entry.GetString(jsonKey).c_str();
-            }
+    jsonKey = JSON_AGGREGATE_MAX_INFLIGHT;
+    if (json.ValueExists(jsonKey))
+    {
+        aggregateMaxInflight = json.GetInt64(jsonKey);
+    }
 
-            jsonKey = JSON_MQTT_DEAD_LETTER_TOPIC;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.mqttDeadLetterTopic = entry.GetString(jsonKey).c_str();
-            }
+    jsonKey = JSON_STATS_FILE;
+    if (json.ValueExists(jsonKey))
+    {
+        statsFile = json.GetString(jsonKey).c_str();
+    }
 
-            jsonKey = JSON_MQTT_HEARTBEAT_TOPIC;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.mqttHeartbeatTopic = entry.GetString(jsonKey).c_str();
-            }
+    jsonKey = JSON_STATS_TOPIC;
+    if (json.ValueExists(jsonKey))
+    {
+        statsTopic = json.GetString(jsonKey).c_str();
+    }
 
-            jsonKey = JSON_HEARTBEAT_TIME_SEC;
-            if (entry.ValueExists(jsonKey))
-            {
-                sensorSettings.heartbeatTimeSec = entry.GetInt64(jsonKey);
-            }
+    jsonKey = JSON_STATS_INTERVAL_SEC;
+    if (json.ValueExists(jsonKey))
+    {
+        statsIntervalSec = json.GetInt64(jsonKey);
+    }
 
-            settings.push_back(sensorSettings);
-            ++entryId;
-        }
+    jsonKey = JSON_HEARTBEAT_TOPIC;
+    if (json.ValueExists(jsonKey))
+    {
+        heartbeatTopic = json.GetString(jsonKey).c_str();
     }
 
-    return true;
-}
+    jsonKey = JSON_HEARTBEAT_INTERVAL_SEC;
+    if (json.ValueExists(jsonKey))
+    {
+        heartbeatIntervalSec = json.GetInt64(jsonKey);
+    }
 
-bool PlainConfig::SensorPublish::LoadFromCliArgs(const CliArgs &cliArgs)
-{
     return true;
 }
 
-bool PlainConfig::SensorPublish::LoadFromEnvironment()
+PlainConfig::SensorPublish::SensorSettings PlainConfig::SensorPublish::LoadSensorSettings(
+    const Crt::JsonView &entry,
+    const string &defaultName)
 {
-    return true;
-}
+    SensorSettings sensorSettings;
 
-bool PlainConfig::SensorPublish::Validate() const
-{
-    if (settings.empty())
+    const char *jsonKey = JSON_ENABLED;
+    if (entry.ValueExists(jsonKey))
     {
-        return true; // Nothing to validate.
+        sensorSettings.enabled = entry.GetBool(jsonKey);
     }
 
-    // Check the number of sensor entries in the configuration does not exceed maximum.
-    if (settings.size() > MAX_SENSOR_SIZE)
+    jsonKey = JSON_NAME;
+    if (entry.ValueExists(jsonKey))
     {
-        LOGM_ERROR(
-            Config::TAG,
-            "*** %s: Number of sensor entries in config (%ld) exceeds maximum (%ld)",
-            DeviceClient::DC_FATAL_ERROR,
-            settings.size(),
-            MAX_SENSOR_SIZE);
-        // Disable every sensor entry and disable the feature.
-        for (auto &setting : settings)
-        {
-            setting.enabled = false;
-        }
-        return false;
+        sensorSettings.name = entry.GetString(jsonKey).c_str();
+    }
+    else
+    {
+        sensorSettings.name = defaultName;
     }
 
-    bool atLeastOneValidSensor{false};
-
-    // Validate the settings associated with each sensor.
-    // If at least one setting associated with the sensor is invalid, then we disable the sensor.
-    for (auto &setting : settings)
+    jsonKey = JSON_ADDR;
+    if (entry.ValueExists(jsonKey))
     {
-        if (!setting.enabled)
-        {
-            continue; // Skip validation
-        }
+        sensorSettings.addr = entry.GetString(jsonKey).c_str();
+    }
 
-        // Validate the pathname socket path exists and satisfies permissions.
-        if (FileUtils::FileExists(setting.addr.value()))
-        {
-            // If the path points to an existing file,
-            // then check the path satisfies permissions.
-            if (!FileUtils::ValidateFilePermissions(setting.addr.value(), Permissions::SENSOR_PUBLISH_ADDR_FILE))
-            {
-                setting.enabled = false;
-            }
-        }
-        else
-        {
-            // If the path does not point to an existing file,
-            // then check the parent directory exists and has required permissions.
-            auto addrParentDir = FileUtils::ExtractParentDirectory(setting.addr.value());
-            if (!FileUtils::ValidateFilePermissions(addrParentDir, Permissions::SENSOR_PUBLISH_ADDR_DIR))
-            {
-                setting.enabled = false;
-            }
-        }
+    jsonKey = JSON_ADDR_POLL_SEC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.addrPollSec = entry.GetInt64(jsonKey);
+    }
 
-        // Validate the pathname socket does not exceed max address size.
-        // Include extra character for terminating null byte.
-        if (setting.addr.value().length() + 1 > AWS_ADDRESS_MAX_LEN)
-        {
-            setting.enabled = false;
-            LOGM_ERROR(
-                Config::TAG,
-                "*** %s: Config %s length (%ld) exceeds maximum (%ld)",
-                DeviceClient::DC_FATAL_ERROR,
-                JSON_ADDR,
-                setting.addr.value().length() + 1,
-                AWS_ADDRESS_MAX_LEN);
-        }
+    jsonKey = JSON_ADDR_TYPE;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.addrType = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_MAX_MESSAGE_BYTES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.maxMessageBytes = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_BUFFER_TIME_MS;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.bufferTimeMs = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_BUFFER_SIZE;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.bufferSize = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_BUFFER_CAPACITY;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.bufferCapacity = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_MAX_INFLIGHT;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.maxInflight = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_READ_BUDGET_BYTES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.readBudgetBytes = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_EOM_DELIMITER;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.eomDelimiter = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_MQTT_TOPIC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.mqttTopic = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_MQTT_DEAD_LETTER_TOPIC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.mqttDeadLetterTopic = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_MQTT_HEARTBEAT_TOPIC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.mqttHeartbeatTopic = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_HEARTBEAT_TIME_SEC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.heartbeatTimeSec = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_SPOOL_DIR;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.spoolDir = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_SPOOL_MAX_BYTES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.spoolMaxBytes = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_SPOOL_DRAIN_RATE;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.spoolDrainRate = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_COMPRESSION;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.compression = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_COMPRESSION_MIN_BYTES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.compressionMinBytes = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_BATCH_FORMAT;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.batchFormat = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_BATCH_TIMESTAMPS;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.batchTimestamps = entry.GetBool(jsonKey);
+    }
+
+    jsonKey = JSON_EVENT_LOOP;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.eventLoop = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_AGGREGATE;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.aggregate = entry.GetBool(jsonKey);
+    }
+
+    jsonKey = JSON_SUMMARY_FORMAT;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.summaryFormat = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_SUMMARY_FIELDS;
+    if (entry.ValueExists(jsonKey) && entry.GetJsonObject(jsonKey).IsListType())
+    {
+        for (const auto &field : entry.GetArray(jsonKey))
+        {
+            sensorSettings.summaryFields.push_back(field.AsString().c_str());
+        }
+    }
+
+    jsonKey = JSON_SUMMARY_WINDOW_MS;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.summaryWindowMs = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_DROP_DUPLICATES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.dropDuplicates = entry.GetBool(jsonKey);
+    }
+
+    jsonKey = JSON_DEADBAND_FORMAT;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.deadbandFormat = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_DEADBAND_FIELDS;
+    if (entry.ValueExists(jsonKey) && entry.GetJsonObject(jsonKey).IsListType())
+    {
+        for (const auto &field : entry.GetArray(jsonKey))
+        {
+            sensorSettings.deadbandFields.push_back(field.AsString().c_str());
+        }
+    }
+
+    jsonKey = JSON_DEADBAND;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.deadband = entry.GetDouble(jsonKey);
+    }
+
+    jsonKey = JSON_MAX_MESSAGE_RATE;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.maxMessageRate = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_MQTT_COMMAND_TOPIC;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.mqttCommandTopic = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_COMMAND_BUFFER_BYTES;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.commandBufferBytes = entry.GetInt64(jsonKey);
+    }
+
+    jsonKey = JSON_COMMAND_DROP_POLICY;
+    if (entry.ValueExists(jsonKey))
+    {
+        sensorSettings.commandDropPolicy = entry.GetString(jsonKey).c_str();
+    }
+
+    jsonKey = JSON_CAN_FILTERS;
+    if (entry.ValueExists(jsonKey) && entry.GetJsonObject(jsonKey).IsListType())
+    {
+        for (const auto &filter : entry.GetArray(jsonKey))
+        {
+            sensorSettings.canFilters.push_back(filter.AsString().c_str());
+        }
+    }
+
+    return sensorSettings;
+}
+
+void PlainConfig::SensorPublish::LoadSensorsDir()
+{
+    string dirPath = FileUtils::ExtractExpandedPath(sensorsDir.value());
+    if (!FileUtils::DirectoryExists(dirPath))
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s directory %s does not exist",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_SENSORS_DIR,
+            Sanitize(dirPath).c_str());
+        return;
+    }
+    if (!FileUtils::ValidateFilePermissions(dirPath, Permissions::SENSOR_PUBLISH_SENSORS_DIR))
+    {
+        return;
+    }
+
+    DIR *dir = opendir(dirPath.c_str());
+    if (dir == nullptr)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "Unable to open %s directory %s: %s",
+            JSON_SENSORS_DIR,
+            Sanitize(dirPath).c_str(),
+            strerror(errno));
+        return;
+    }
+    vector<string> fileNames;
+    const size_t suffixLen = strlen(SENSOR_FILE_SUFFIX);
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+        string fileName = entry->d_name;
+        if (fileName.size() > suffixLen &&
+            fileName.compare(fileName.size() - suffixLen, suffixLen, SENSOR_FILE_SUFFIX) == 0)
+        {
+            fileNames.push_back(fileName);
+        }
+    }
+    closedir(dir);
+    sort(fileNames.begin(), fileNames.end());
+
+    for (const auto &fileName : fileNames)
+    {
+        string filePath = dirPath + Config::PATH_DIRECTORY_SEPARATOR + fileName;
+        if (!FileUtils::ValidateFilePermissions(filePath, Permissions::SENSOR_PUBLISH_SENSOR_FILE))
+        {
+            continue;
+        }
+        size_t fileSize = FileUtils::GetFileSize(filePath);
+        if (fileSize > Config::MAX_CONFIG_SIZE)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "Refusing to open sensor file %s, file size %zu bytes is greater than allowable limit of %zu bytes",
+                Sanitize(filePath).c_str(),
+                fileSize,
+                Config::MAX_CONFIG_SIZE);
+            continue;
+        }
+
+        ifstream sensorFile(filePath.c_str());
+        if (!sensorFile.is_open())
+        {
+            LOGM_ERROR(Config::TAG, "Unable to open file: '%s'", Sanitize(filePath).c_str());
+            continue;
+        }
+        string contents((istreambuf_iterator<char>(sensorFile)), istreambuf_iterator<char>());
+        auto jsonObj = Aws::Crt::JsonObject(contents.c_str());
+        if (!jsonObj.WasParseSuccessful())
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "Couldn't parse JSON sensor file %s. GetErrorMessage returns: %s",
+                Sanitize(filePath).c_str(),
+                jsonObj.GetErrorMessage().c_str());
+            continue;
+        }
+
+        // Sensors without a name are named after their file.
+        auto sensorSettings =
+            LoadSensorSettings(Aws::Crt::JsonView(jsonObj), fileName.substr(0, fileName.size() - suffixLen));
+        sensorSettings.definitionFile = filePath;
+        settings.push_back(sensorSettings);
+    }
+}
+
+bool PlainConfig::SensorPublish::LoadFromCliArgs(const CliArgs &cliArgs)
+{
+    return true;
+}
+
+bool PlainConfig::SensorPublish::LoadFromEnvironment()
+{
+    return true;
+}
+
+bool PlainConfig::SensorPublish::Validate() const
+{
+    if (settings.empty())
+    {
+        return true; // Nothing to validate.
+    }
+
+    // Check the maximum number of sensor entries is in range.
+    if (maxSensors.value() < 1 || maxSensors.value() > MAX_SENSORS_LIMIT)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be between 1 and %ld",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_MAX_SENSORS,
+            maxSensors.value(),
+            MAX_SENSORS_LIMIT);
+        // Disable every sensor entry and disable the feature.
+        for (auto &setting : settings)
+        {
+            setting.enabled = false;
+        }
+        return false;
+    }
+
+    // Check the number of sensor entries in the configuration does not exceed maximum.
+    if (settings.size() > static_cast<size_t>(maxSensors.value()))
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Number of sensor entries in config (%ld) exceeds maximum (%ld)",
+            DeviceClient::DC_FATAL_ERROR,
+            settings.size(),
+            maxSensors.value());
+        // Disable every sensor entry and disable the feature.
+        for (auto &setting : settings)
+        {
+            setting.enabled = false;
+        }
+        return false;
+    }
+
+    // Validate the event loop and memory settings, which apply to every sensor.
+    bool validSharedSettings = true;
+    if (eventLoopThreads.value() < 0 || eventLoopThreads.value() > EVENT_LOOP_THREADS_MAX)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be between 0 and %ld",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_EVENT_LOOP_THREADS,
+            eventLoopThreads.value(),
+            EVENT_LOOP_THREADS_MAX);
+        validSharedSettings = false;
+    }
+    for (auto cpu : eventLoopCpus)
+    {
+        if (cpu < 0)
+        {
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_EVENT_LOOP_CPUS,
+                cpu);
+            validSharedSettings = false;
+        }
+    }
+    if (memoryBudgetBytes.value() < 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be non-negative",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_MEMORY_BUDGET_BYTES,
+            memoryBudgetBytes.value());
+        validSharedSettings = false;
+    }
+    if (aggregateMaxBytes.value() < BUF_CAPACITY_BYTES_MIN || aggregateMaxBytes.value() > BUF_CAPACITY_BYTES)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be between %ld and %ld",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_AGGREGATE_MAX_BYTES,
+            aggregateMaxBytes.value(),
+            BUF_CAPACITY_BYTES_MIN,
+            BUF_CAPACITY_BYTES);
+        validSharedSettings = false;
+    }
+    if (aggregateTimeMs.value() <= 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be positive",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_AGGREGATE_TIME_MS,
+            aggregateTimeMs.value());
+        validSharedSettings = false;
+    }
+    if (aggregateMaxInflight.value() < 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be non-negative",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_AGGREGATE_MAX_INFLIGHT,
+            aggregateMaxInflight.value());
+        validSharedSettings = false;
+    }
+    if (statsFile.has_value() && !statsFile->empty() &&
+        !FileUtils::DirectoryExists(
+            FileUtils::ExtractParentDirectory(FileUtils::ExtractExpandedPath(statsFile.value()))))
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %s must be in an existing directory",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_STATS_FILE,
+            Sanitize(statsFile.value()).c_str());
+        validSharedSettings = false;
+    }
+    if (statsTopic.has_value() && !statsTopic->empty() && !MqttUtils::ValidateAwsIotMqttTopicName(statsTopic.value()))
+    {
+        validSharedSettings = false;
+    }
+    if (statsIntervalSec.value() <= 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be positive",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_STATS_INTERVAL_SEC,
+            statsIntervalSec.value());
+        validSharedSettings = false;
+    }
+    if (heartbeatTopic.has_value() && !heartbeatTopic->empty() &&
+        !MqttUtils::ValidateAwsIotMqttTopicName(heartbeatTopic.value()))
+    {
+        validSharedSettings = false;
+    }
+    if (heartbeatIntervalSec.value() <= 0)
+    {
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %ld must be positive",
+            DeviceClient::DC_FATAL_ERROR,
+            JSON_HEARTBEAT_INTERVAL_SEC,
+            heartbeatIntervalSec.value());
+        validSharedSettings = false;
+    }
+    if (!validSharedSettings)
+    {
+        // Disable every sensor entry and disable the feature.
+        for (auto &setting : settings)
+        {
+            setting.enabled = false;
+        }
+        return false;
+    }
+
+    bool atLeastOneValidSensor{false};
+
+    // Spool directories of the sensors validated so far, since each sensor needs its own.
+    set<string> spoolDirs;
+
+    // Validate the settings associated with each sensor.
+    // If at least one setting associated with the sensor is invalid, then we disable the sensor.
+    for (auto &setting : settings)
+    {
+        if (!setting.enabled)
+        {
+            continue; // Skip validation
+        }
+
+        // Validate the address type, stream sockets are the default.
+        bool streamAddr = !setting.addrType.has_value() || setting.addrType.value() == ADDR_TYPE_STREAM;
+        bool udpAddr = setting.addrType.has_value() && setting.addrType.value() == ADDR_TYPE_UDP;
+        bool canAddr = setting.addrType.has_value() && setting.addrType.value() == ADDR_TYPE_CAN;
+        if (!streamAddr && !udpAddr && !canAddr && setting.addrType.value() != ADDR_TYPE_DGRAM &&
+            setting.addrType.value() != ADDR_TYPE_SEQPACKET)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not a supported address type",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_ADDR_TYPE,
+                Sanitize(setting.addrType.value()).c_str());
+        }
+
+        if (udpAddr)
+        {
+            // Validate the UDP address is a loopback address and port.
+            static const std::regex loopbackAddr(R"(127(\.[0-9]{1,3}){3}:([0-9]{1,5}))");
+            std::smatch match;
+            if (!std::regex_match(setting.addr.value(), match, loopbackAddr) || std::stol(match[2].str()) < 1 ||
+                std::stol(match[2].str()) > 65535)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s must be a loopback address and port of the form 127.0.0.1:port",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_ADDR,
+                    Sanitize(setting.addr.value()).c_str());
+            }
+        }
+        else if (canAddr)
+        {
+            // Validate the CAN address is a network interface name, such as can0 or vcan0.
+            static const std::regex interfaceName(R"([A-Za-z0-9_.-]{1,15})");
+            if (!std::regex_match(setting.addr.value(), interfaceName))
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s must be a network interface name of at most 15 characters",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_ADDR,
+                    Sanitize(setting.addr.value()).c_str());
+            }
+        }
+        else if (FileUtils::FileExists(setting.addr.value()))
+        {
+            // Validate the pathname socket path exists and satisfies permissions.
+            // If the path points to an existing file,
+            // then check the path satisfies permissions.
+            if (!FileUtils::ValidateFilePermissions(setting.addr.value(), Permissions::SENSOR_PUBLISH_ADDR_FILE))
+            {
+                setting.enabled = false;
+            }
+        }
+        else
+        {
+            // If the path does not point to an existing file,
+            // then check the parent directory exists and has required permissions.
+            auto addrParentDir = FileUtils::ExtractParentDirectory(setting.addr.value());
+            if (!FileUtils::ValidateFilePermissions(addrParentDir, Permissions::SENSOR_PUBLISH_ADDR_DIR))
+            {
+                setting.enabled = false;
+            }
+        }
+
+        // Validate the pathname socket does not exceed max address size.
+        // Include extra character for terminating null byte.
+        if (setting.addr.value().length() + 1 > AWS_ADDRESS_MAX_LEN)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s length (%ld) exceeds maximum (%ld)",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_ADDR,
+                setting.addr.value().length() + 1,
+                AWS_ADDRESS_MAX_LEN);
+        }
 
         // Validate that mqtt topic name is non-empty.
         if (!setting.mqttTopic.has_value() || setting.mqttTopic.value().empty())
@@ -2285,109 +3068,441 @@ bool PlainConfig::SensorPublish::Validate() const
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value must be non-empty",
+                "*** %s: Config %s value must be non-empty",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_MQTT_TOPIC);
+        }
+
+        // Validate that mqtt topic names conform to AWS Iot spec.
+        if (!MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttTopic.value()))
+        {
+            setting.enabled = false;
+        }
+        if (setting.mqttDeadLetterTopic.has_value() && !setting.mqttDeadLetterTopic.value().empty() &&
+            !MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttDeadLetterTopic.value()))
+        {
+            setting.enabled = false;
+        }
+        if (setting.mqttHeartbeatTopic.has_value() && !setting.mqttHeartbeatTopic.value().empty() &&
+            !MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttHeartbeatTopic.value()))
+        {
+            setting.enabled = false;
+        }
+
+        // Validate that delimiter is non-empty and valid.
+        // Message based sockets preserve message boundaries, so no delimiter is required.
+        if (!streamAddr)
+        {
+            if (setting.maxMessageBytes.value() < 1 || setting.maxMessageBytes.value() > setting.bufferCapacity.value())
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld must be between 1 and %s value %ld",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_MAX_MESSAGE_BYTES,
+                    setting.maxMessageBytes.value(),
+                    JSON_BUFFER_CAPACITY,
+                    setting.bufferCapacity.value());
+            }
+            else if (canAddr && setting.maxMessageBytes.value() < CAN_MESSAGE_BYTES_MAX)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld must be at least %ld for %s value %s",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_MAX_MESSAGE_BYTES,
+                    setting.maxMessageBytes.value(),
+                    CAN_MESSAGE_BYTES_MAX,
+                    JSON_ADDR_TYPE,
+                    ADDR_TYPE_CAN);
+            }
+        }
+        else if (!setting.eomDelimiter.has_value() || setting.eomDelimiter.value().empty())
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value must be non-empty",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_EOM_DELIMITER);
+        }
+        else
+        {
+            // Validate the regular expression by checking for exceptions when compiling the pattern.
+            try
+            {
+                std::regex re(setting.eomDelimiter.value());
+            }
+            catch (const std::regex_error &e)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value is not a valid regular expression: %s",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_EOM_DELIMITER,
+                    e.what());
+            }
+        }
+
+        // Validate that numeric values are non-negative.
+        if (setting.addrPollSec.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_ADDR_POLL_SEC,
+                setting.addrPollSec.value());
+        }
+        if (setting.bufferTimeMs.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BUFFER_TIME_MS,
+                setting.bufferTimeMs.value());
+        }
+        if (setting.bufferSize.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BUFFER_SIZE,
+                setting.bufferSize.value());
+        }
+        if (setting.maxInflight.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_MAX_INFLIGHT,
+                setting.maxInflight.value());
+        }
+        if (setting.readBudgetBytes.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_READ_BUDGET_BYTES,
+                setting.readBudgetBytes.value());
+        }
+        if (setting.heartbeatTimeSec.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_HEARTBEAT_TIME_SEC,
+                setting.heartbeatTimeSec.value());
+        }
+
+        // Validate the buffer capcity.
+        if (setting.bufferCapacity.value() < BUF_CAPACITY_BYTES_MIN)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld is less than minimum %ld",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BUFFER_CAPACITY,
+                setting.bufferCapacity.value(),
+                BUF_CAPACITY_BYTES_MIN);
+        }
+        if (memoryBudgetBytes.value() > 0 && setting.bufferCapacity.value() > memoryBudgetBytes.value())
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld exceeds %s value %ld",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BUFFER_CAPACITY,
+                setting.bufferCapacity.value(),
+                JSON_MEMORY_BUDGET_BYTES,
+                memoryBudgetBytes.value());
+        }
+
+        // Validate the spool settings, only used when a spool directory is configured.
+        if (setting.spoolDir.has_value() && !setting.spoolDir.value().empty())
+        {
+            string spoolDir = FileUtils::ExtractExpandedPath(setting.spoolDir.value());
+            while (spoolDir.size() > 1 && spoolDir.back() == '/')
+            {
+                spoolDir.pop_back();
+            }
+            if (!spoolDirs.insert(spoolDir).second)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s is already used by another sensor",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_SPOOL_DIR,
+                    Sanitize(setting.spoolDir.value()).c_str());
+            }
+            if (FileUtils::DirectoryExists(setting.spoolDir.value()) &&
+                !FileUtils::ValidateFilePermissions(setting.spoolDir.value(), Permissions::SENSOR_PUBLISH_SPOOL_DIR))
+            {
+                setting.enabled = false;
+            }
+            if (setting.spoolMaxBytes.value() < SPOOL_MAX_BYTES_MIN)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld is less than minimum %ld",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_SPOOL_MAX_BYTES,
+                    setting.spoolMaxBytes.value(),
+                    SPOOL_MAX_BYTES_MIN);
+            }
+            if (setting.spoolDrainRate.value() <= 0)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %ld must be positive",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_SPOOL_DRAIN_RATE,
+                    setting.spoolDrainRate.value());
+            }
+        }
+
+        // Validate the compression algorithm.
+        if (setting.compression.has_value() && setting.compression.value() != COMPRESSION_NONE &&
+            setting.compression.value() != COMPRESSION_DEFLATE)
+        {
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+            if (setting.compression.value() != COMPRESSION_ZSTD)
+#endif
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s is not a supported compression algorithm",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_COMPRESSION,
+                    Sanitize(setting.compression.value()).c_str());
+            }
+        }
+        if (setting.compressionMinBytes.value() < 0)
+        {
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be non-negative",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_MQTT_TOPIC);
+                JSON_COMPRESSION_MIN_BYTES,
+                setting.compressionMinBytes.value());
         }
 
-        // Validate that mqtt topic names conform to AWS Iot spec.
-        if (!MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttTopic.value()))
+        // Validate the batch format.
+        if (setting.batchFormat.has_value() && setting.batchFormat.value() != BATCH_FORMAT_RAW &&
+            setting.batchFormat.value() != BATCH_FORMAT_JSON_ARRAY &&
+            setting.batchFormat.value() != BATCH_FORMAT_CBOR &&
+            setting.batchFormat.value() != BATCH_FORMAT_LENGTH_PREFIXED)
         {
             setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not a supported batch format",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_BATCH_FORMAT,
+                Sanitize(setting.batchFormat.value()).c_str());
         }
-        if (setting.mqttDeadLetterTopic.has_value() && !setting.mqttDeadLetterTopic.value().empty() &&
-            !MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttDeadLetterTopic.value()))
+
+        // Validate the event loop the sensor is pinned to.
+        if (setting.eventLoop.has_value() &&
+            (setting.eventLoop.value() < 0 || setting.eventLoop.value() >= eventLoopThreads.value()))
         {
             setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %ld must be less than %s value %ld",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_EVENT_LOOP,
+                setting.eventLoop.value(),
+                JSON_EVENT_LOOP_THREADS,
+                eventLoopThreads.value());
         }
-        if (setting.mqttHeartbeatTopic.has_value() && !setting.mqttHeartbeatTopic.value().empty() &&
-            !MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttHeartbeatTopic.value()))
+
+        // Validate that aggregated batches have a topic to be published to.
+        if (setting.aggregate.value() && (!aggregateTopic.has_value() || aggregateTopic->empty()))
         {
             setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s requires %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_AGGREGATE,
+                JSON_AGGREGATE_TOPIC);
         }
 
-        // Validate that delimiter is non-empty and valid.
-        if (!setting.eomDelimiter.has_value() || setting.eomDelimiter.value().empty())
+        // Aggregate messages are neither compressed nor sent to a dead letter topic, and a failed aggregate
+        // publish is dropped, so refuse settings which promise otherwise.
+        if (setting.aggregate.value() && setting.compression.has_value() &&
+            setting.compression.value() != COMPRESSION_NONE)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value must be non-empty",
+                "*** %s: Config %s is not supported with %s value %s",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_EOM_DELIMITER);
+                JSON_AGGREGATE,
+                JSON_COMPRESSION,
+                Sanitize(setting.compression.value()).c_str());
         }
-        else
+        if (setting.aggregate.value() && setting.mqttDeadLetterTopic.has_value() &&
+            !setting.mqttDeadLetterTopic->empty())
         {
-            // Validate the regular expression by checking for exceptions when compiling the pattern.
-            try
+            setting.enabled = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s is not supported with %s",
+                DeviceClient::DC_FATAL_ERROR,
+                JSON_AGGREGATE,
+                JSON_MQTT_DEAD_LETTER_TOPIC);
+        }
+
+        // Validate the summary settings, only used when fields to summarize are configured.
+        if (!setting.summaryFields.empty())
+        {
+            if (!ValidateFields(JSON_SUMMARY_FORMAT, setting.summaryFormat, JSON_SUMMARY_FIELDS, setting.summaryFields))
             {
-                std::regex re(setting.eomDelimiter.value());
+                setting.enabled = false;
             }
-            catch (const std::regex_error &e)
+            if (setting.summaryWindowMs.value() <= 0)
             {
                 setting.enabled = false;
                 LOGM_ERROR(
                     Config::TAG,
-                    "*** %s: Config %s value is not a valid regular expression: %s",
+                    "*** %s: Config %s value %ld must be positive",
                     DeviceClient::DC_FATAL_ERROR,
-                    JSON_EOM_DELIMITER,
-                    e.what());
+                    JSON_SUMMARY_WINDOW_MS,
+                    setting.summaryWindowMs.value());
             }
         }
 
-        // Validate that numeric values are non-negative.
-        if (setting.addrPollSec.value() < 0)
+        // Validate the filter settings.
+        if (!setting.deadbandFields.empty())
+        {
+            if (!ValidateFields(
+                    JSON_DEADBAND_FORMAT, setting.deadbandFormat, JSON_DEADBAND_FIELDS, setting.deadbandFields))
+            {
+                setting.enabled = false;
+            }
+            if (!(setting.deadband.value() >= 0) || !isfinite(setting.deadband.value()))
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %g must be greater than or equal to 0",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_DEADBAND,
+                    setting.deadband.value());
+            }
+        }
+        if (setting.maxMessageRate.value() < 0)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value %ld must be non-negative",
+                "*** %s: Config %s value %ld must be greater than or equal to 0",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_ADDR_POLL_SEC,
-                setting.addrPollSec.value());
+                JSON_MAX_MESSAGE_RATE,
+                setting.maxMessageRate.value());
         }
-        if (setting.bufferTimeMs.value() < 0)
+
+        // Validate the command path. Commands are written to the connected peer, so sockets bound to their
+        // address, which have no single peer, cannot receive commands.
+        if (setting.mqttCommandTopic.has_value() && !setting.mqttCommandTopic.value().empty())
+        {
+            if (!MqttUtils::ValidateAwsIotMqttTopicName(setting.mqttCommandTopic.value()))
+            {
+                setting.enabled = false;
+            }
+            if (!streamAddr && setting.addrType.value() != ADDR_TYPE_SEQPACKET)
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s is not supported with %s value %s",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_MQTT_COMMAND_TOPIC,
+                    JSON_ADDR_TYPE,
+                    Sanitize(setting.addrType.value()).c_str());
+            }
+        }
+        if (setting.commandBufferBytes.value() < 1)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value %ld must be non-negative",
+                "*** %s: Config %s value %ld must be greater than 0",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_BUFFER_TIME_MS,
-                setting.bufferTimeMs.value());
+                JSON_COMMAND_BUFFER_BYTES,
+                setting.commandBufferBytes.value());
         }
-        if (setting.bufferSize.value() < 0)
+        if (setting.commandDropPolicy.has_value() && setting.commandDropPolicy.value() != DROP_POLICY_NEWEST &&
+            setting.commandDropPolicy.value() != DROP_POLICY_OLDEST)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value %ld must be non-negative",
+                "*** %s: Config %s value %s is not a supported drop policy",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_BUFFER_SIZE,
-                setting.bufferSize.value());
+                JSON_COMMAND_DROP_POLICY,
+                Sanitize(setting.commandDropPolicy.value()).c_str());
         }
-        if (setting.heartbeatTimeSec.value() < 0)
+
+        // Validate the CAN filters, hexadecimal identifiers and masks as accepted by candump.
+        if (!setting.canFilters.empty() && !canAddr)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value %ld must be non-negative",
+                "*** %s: Config %s is only supported with %s value %s",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_HEARTBEAT_TIME_SEC,
-                setting.heartbeatTimeSec.value());
+                JSON_CAN_FILTERS,
+                JSON_ADDR_TYPE,
+                ADDR_TYPE_CAN);
         }
-
-        // Validate the buffer capcity.
-        if (setting.bufferCapacity.value() < BUF_CAPACITY_BYTES_MIN)
+        if (setting.canFilters.size() > CAN_FILTERS_MAX)
         {
             setting.enabled = false;
             LOGM_ERROR(
                 Config::TAG,
-                "*** %s: Config %s value %ld is less than minimum %ld",
+                "*** %s: Config %s has %zu entries, more than maximum %zu",
                 DeviceClient::DC_FATAL_ERROR,
-                JSON_BUFFER_CAPACITY,
-                setting.bufferCapacity.value(),
-                BUF_CAPACITY_BYTES_MIN);
+                JSON_CAN_FILTERS,
+                setting.canFilters.size(),
+                CAN_FILTERS_MAX);
+        }
+        static const std::regex canFilter(R"([0-9A-Fa-f]{1,8}[:~][0-9A-Fa-f]{1,8})");
+        for (const auto &filter : setting.canFilters)
+        {
+            if (!std::regex_match(filter, canFilter))
+            {
+                setting.enabled = false;
+                LOGM_ERROR(
+                    Config::TAG,
+                    "*** %s: Config %s value %s must be of the form id:mask or id~mask in hexadecimal",
+                    DeviceClient::DC_FATAL_ERROR,
+                    JSON_CAN_FILTERS,
+                    Sanitize(filter).c_str());
+            }
         }
 
         // If at least one sensor is valid, then enable the feature.
@@ -2400,11 +3515,68 @@ bool PlainConfig::SensorPublish::Validate() const
     return atLeastOneValidSensor;
 }
 
+bool PlainConfig::SensorPublish::ValidateFields(
+    const char *formatKey,
+    const Aws::Crt::Optional<string> &format,
+    const char *fieldsKey,
+    const vector<string> &fields)
+{
+    bool valid = true;
+    const string formatName = format.has_value() ? format.value() : string();
+    if (formatName != FIELD_FORMAT_JSON && formatName != FIELD_FORMAT_CSV)
+    {
+        valid = false;
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s value %s must be %s or %s",
+            DeviceClient::DC_FATAL_ERROR,
+            formatKey,
+            Sanitize(formatName).c_str(),
+            FIELD_FORMAT_JSON,
+            FIELD_FORMAT_CSV);
+    }
+    if (fields.size() > FIELDS_MAX)
+    {
+        valid = false;
+        LOGM_ERROR(
+            Config::TAG,
+            "*** %s: Config %s has %zu entries, more than maximum %zu",
+            DeviceClient::DC_FATAL_ERROR,
+            fieldsKey,
+            fields.size(),
+            FIELDS_MAX);
+    }
+    for (const auto &field : fields)
+    {
+        // CSV columns are numbered from 0.
+        bool isColumn = !field.empty() && field.size() <= 4 && all_of(field.begin(), field.end(), [](char c) {
+                            return isdigit(static_cast<unsigned char>(c)) != 0;
+                        });
+        if (field.empty() || (formatName == FIELD_FORMAT_CSV && !isColumn))
+        {
+            valid = false;
+            LOGM_ERROR(
+                Config::TAG,
+                "*** %s: Config %s value %s is not a %s",
+                DeviceClient::DC_FATAL_ERROR,
+                fieldsKey,
+                Sanitize(field).c_str(),
+                formatName == FIELD_FORMAT_CSV ? "CSV column number" : "JSON key");
+        }
+    }
+    return valid;
+}
+
 void PlainConfig::SensorPublish::SerializeToObject(Crt::JsonObject &object) const
 {
     Aws::Crt::Vector<Aws::Crt::JsonObject> sensors;
     for (const auto &entry : settings)
     {
+        if (!entry.definitionFile.empty())
+        {
+            continue; // Defined in sensors_dir.
+        }
+
         Aws::Crt::JsonObject sensor;
 
         if (entry.name.has_value() && entry.name->c_str())
@@ -2424,6 +3596,16 @@ void PlainConfig::SensorPublish::SerializeToObject(Crt::JsonObject &object) cons
             sensor.WithInt64(JSON_ADDR_POLL_SEC, entry.addrPollSec.value());
         }
 
+        if (entry.addrType.has_value() && entry.addrType->c_str())
+        {
+            sensor.WithString(JSON_ADDR_TYPE, entry.addrType->c_str());
+        }
+
+        if (entry.maxMessageBytes.has_value())
+        {
+            sensor.WithInt64(JSON_MAX_MESSAGE_BYTES, entry.maxMessageBytes.value());
+        }
+
         if (entry.bufferTimeMs.has_value())
         {
             sensor.WithInt64(JSON_BUFFER_TIME_MS, entry.bufferTimeMs.value());
@@ -2439,6 +3621,16 @@ void PlainConfig::SensorPublish::SerializeToObject(Crt::JsonObject &object) cons
             sensor.WithInt64(JSON_BUFFER_CAPACITY, entry.bufferCapacity.value());
         }
 
+        if (entry.maxInflight.has_value())
+        {
+            sensor.WithInt64(JSON_MAX_INFLIGHT, entry.maxInflight.value());
+        }
+
+        if (entry.readBudgetBytes.has_value())
+        {
+            sensor.WithInt64(JSON_READ_BUDGET_BYTES, entry.readBudgetBytes.value());
+        }
+
         if (entry.eomDelimiter.has_value() && entry.eomDelimiter->c_str())
         {
             sensor.WithString(JSON_EOM_DELIMITER, entry.eomDelimiter->c_str());
@@ -2464,10 +3656,205 @@ void PlainConfig::SensorPublish::SerializeToObject(Crt::JsonObject &object) cons
             sensor.WithInt64(JSON_HEARTBEAT_TIME_SEC, entry.heartbeatTimeSec.value());
         }
 
+        if (entry.spoolDir.has_value() && entry.spoolDir->c_str())
+        {
+            sensor.WithString(JSON_SPOOL_DIR, entry.spoolDir->c_str());
+        }
+
+        if (entry.spoolMaxBytes.has_value())
+        {
+            sensor.WithInt64(JSON_SPOOL_MAX_BYTES, entry.spoolMaxBytes.value());
+        }
+
+        if (entry.spoolDrainRate.has_value())
+        {
+            sensor.WithInt64(JSON_SPOOL_DRAIN_RATE, entry.spoolDrainRate.value());
+        }
+
+        if (entry.compression.has_value() && entry.compression->c_str())
+        {
+            sensor.WithString(JSON_COMPRESSION, entry.compression->c_str());
+        }
+
+        if (entry.compressionMinBytes.has_value())
+        {
+            sensor.WithInt64(JSON_COMPRESSION_MIN_BYTES, entry.compressionMinBytes.value());
+        }
+
+        if (entry.batchFormat.has_value() && entry.batchFormat->c_str())
+        {
+            sensor.WithString(JSON_BATCH_FORMAT, entry.batchFormat->c_str());
+        }
+
+        if (entry.batchTimestamps.has_value())
+        {
+            sensor.WithBool(JSON_BATCH_TIMESTAMPS, entry.batchTimestamps.value());
+        }
+
+        if (entry.eventLoop.has_value())
+        {
+            sensor.WithInt64(JSON_EVENT_LOOP, entry.eventLoop.value());
+        }
+
+        if (entry.aggregate.has_value())
+        {
+            sensor.WithBool(JSON_AGGREGATE, entry.aggregate.value());
+        }
+
+        if (entry.summaryFormat.has_value() && entry.summaryFormat->c_str())
+        {
+            sensor.WithString(JSON_SUMMARY_FORMAT, entry.summaryFormat->c_str());
+        }
+
+        if (!entry.summaryFields.empty())
+        {
+            Aws::Crt::Vector<Aws::Crt::JsonObject> fields;
+            for (const auto &field : entry.summaryFields)
+            {
+                fields.push_back(Aws::Crt::JsonObject().AsString(field.c_str()));
+            }
+            sensor.WithArray(JSON_SUMMARY_FIELDS, fields);
+        }
+
+        if (entry.summaryWindowMs.has_value())
+        {
+            sensor.WithInt64(JSON_SUMMARY_WINDOW_MS, entry.summaryWindowMs.value());
+        }
+
+        if (entry.dropDuplicates.has_value())
+        {
+            sensor.WithBool(JSON_DROP_DUPLICATES, entry.dropDuplicates.value());
+        }
+
+        if (entry.deadbandFormat.has_value() && entry.deadbandFormat->c_str())
+        {
+            sensor.WithString(JSON_DEADBAND_FORMAT, entry.deadbandFormat->c_str());
+        }
+
+        if (!entry.deadbandFields.empty())
+        {
+            Aws::Crt::Vector<Aws::Crt::JsonObject> fields;
+            for (const auto &field : entry.deadbandFields)
+            {
+                fields.push_back(Aws::Crt::JsonObject().AsString(field.c_str()));
+            }
+            sensor.WithArray(JSON_DEADBAND_FIELDS, fields);
+        }
+
+        if (entry.deadband.has_value())
+        {
+            sensor.WithDouble(JSON_DEADBAND, entry.deadband.value());
+        }
+
+        if (entry.maxMessageRate.has_value())
+        {
+            sensor.WithInt64(JSON_MAX_MESSAGE_RATE, entry.maxMessageRate.value());
+        }
+
+        if (entry.mqttCommandTopic.has_value() && entry.mqttCommandTopic->c_str())
+        {
+            sensor.WithString(JSON_MQTT_COMMAND_TOPIC, entry.mqttCommandTopic->c_str());
+        }
+
+        if (entry.commandBufferBytes.has_value())
+        {
+            sensor.WithInt64(JSON_COMMAND_BUFFER_BYTES, entry.commandBufferBytes.value());
+        }
+
+        if (entry.commandDropPolicy.has_value() && entry.commandDropPolicy->c_str())
+        {
+            sensor.WithString(JSON_COMMAND_DROP_POLICY, entry.commandDropPolicy->c_str());
+        }
+
+        if (!entry.canFilters.empty())
+        {
+            Aws::Crt::Vector<Aws::Crt::JsonObject> filters;
+            for (const auto &filter : entry.canFilters)
+            {
+                filters.push_back(Aws::Crt::JsonObject().AsString(filter.c_str()));
+            }
+            sensor.WithArray(JSON_CAN_FILTERS, filters);
+        }
+
         sensors.push_back(sensor);
     }
 
     object.WithArray(JSON_SENSORS, sensors);
+
+    if (eventLoopThreads.has_value())
+    {
+        object.WithInt64(JSON_EVENT_LOOP_THREADS, eventLoopThreads.value());
+    }
+
+    if (!eventLoopCpus.empty())
+    {
+        Aws::Crt::Vector<Aws::Crt::JsonObject> cpus;
+        for (auto cpu : eventLoopCpus)
+        {
+            cpus.push_back(Aws::Crt::JsonObject().AsInt64(cpu));
+        }
+        object.WithArray(JSON_EVENT_LOOP_CPUS, cpus);
+    }
+
+    if (maxSensors.has_value())
+    {
+        object.WithInt64(JSON_MAX_SENSORS, maxSensors.value());
+    }
+
+    if (sensorsDir.has_value() && sensorsDir->c_str())
+    {
+        object.WithString(JSON_SENSORS_DIR, sensorsDir->c_str());
+    }
+
+    if (memoryBudgetBytes.has_value())
+    {
+        object.WithInt64(JSON_MEMORY_BUDGET_BYTES, memoryBudgetBytes.value());
+    }
+
+    if (aggregateTopic.has_value() && aggregateTopic->c_str())
+    {
+        object.WithString(JSON_AGGREGATE_TOPIC, aggregateTopic->c_str());
+    }
+
+    if (aggregateMaxBytes.has_value())
+    {
+        object.WithInt64(JSON_AGGREGATE_MAX_BYTES, aggregateMaxBytes.value());
+    }
+
+    if (aggregateTimeMs.has_value())
+    {
+        object.WithInt64(JSON_AGGREGATE_TIME_MS, aggregateTimeMs.value());
+    }
+
+    if (aggregateMaxInflight.has_value())
+    {
+        object.WithInt64(JSON_AGGREGATE_MAX_INFLIGHT, aggregateMaxInflight.value());
+    }
+
+    if (statsFile.has_value() && statsFile->c_str())
+    {
+        object.WithString(JSON_STATS_FILE, statsFile->c_str());
+    }
+
+    if (statsTopic.has_value() && statsTopic->c_str())
+    {
+        object.WithString(JSON_STATS_TOPIC, statsTopic->c_str());
+    }
+
+    if (statsIntervalSec.has_value())
+    {
+        object.WithInt64(JSON_STATS_INTERVAL_SEC, statsIntervalSec.value());
+    }
+
+    if (heartbeatTopic.has_value() && heartbeatTopic->c_str())
+    {
+        object.WithString(JSON_HEARTBEAT_TOPIC, heartbeatTopic->c_str());
+    }
+
+    if (heartbeatIntervalSec.has_value())
+    {
+        object.WithInt64(JSON_HEARTBEAT_INTERVAL_SEC, heartbeatIntervalSec.value());
+    }
 }
 
 constexpr char Config::TAG[];
@@ -2891,7 +4278,7 @@ void Config::PrintHelpMessage()
         "program\n"
         "%s <JSON-File-Location>:\t\t\t\t\tTake settings defined in the specified JSON file and start the binary\n"
         "%s <[DEBUG, INFO, WARN, ERROR]>:\t\t\t\tSpecify the log level for the AWS IoT Device Client\n"
-        "%s <[STDOUT, FILE]>:\t\t\t\t\t\tSpecify the logger implementation to use.\n"
+        "%s <[STDOUT, FILE, BINARY]>:\t\t\t\tSpecify the logger implementation to use.\n"
         "%s <File-Location>:\t\t\t\t\t\tWrite logs to specified log file when using the file logger.\n"
         "%s \t\t\t\t\t\t\tEnable SDK Logging.\n"
         "%s <[Trace, Debug, Info, Warn, Error, Fatal]>:\t\tSpecify the log level for the SDK\n"
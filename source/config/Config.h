@@ -47,6 +47,8 @@ namespace Aws
                 static constexpr int PUBSUB_DIR = 745;
                 static constexpr int PKCS11_LIB_DIR = 700;
                 static constexpr int SENSOR_PUBLISH_ADDR_DIR = 700;
+                static constexpr int SENSOR_PUBLISH_SPOOL_DIR = 700;
+                static constexpr int SENSOR_PUBLISH_SENSORS_DIR = 700;
 
                 /** Files **/
                 static constexpr int PRIVATE_KEY = 600;
@@ -60,6 +62,7 @@ namespace Aws
                 static constexpr int PUB_SUB_FILES = 600;
                 static constexpr int SAMPLE_SHADOW_FILES = 600;
                 static constexpr int SENSOR_PUBLISH_ADDR_FILE = 660;
+                static constexpr int SENSOR_PUBLISH_SENSOR_FILE = 600;
                 static constexpr int PKCS11_LIB_FILE = 640;
                 static constexpr int HTTP_PROXY_CONFIG_FILE = 600;
             };
@@ -119,12 +122,23 @@ namespace Aws
                     int ParseDeviceClientLogLevel(const std::string &value) const;
                     Aws::Crt::LogLevel ParseSDKLogLevel(const std::string &value) const;
                     std::string ParseDeviceClientLogType(const std::string &value) const;
+                    std::string ParseDeviceClientLogFlushPolicy(const std::string &value) const;
+                    std::string ParseDeviceClientLogOverflowPolicy(const std::string &value) const;
                     std::string StringifyDeviceClientLogLevel(int level) const;
                     std::string StringifySDKLogLevel(Aws::Crt::LogLevel level) const;
                     /** Serialize logging configurations To Json Object **/
                     void SerializeToObject(Crt::JsonObject &object) const;
                     static constexpr char LOG_TYPE_FILE[] = "file";
                     static constexpr char LOG_TYPE_STDOUT[] = "stdout";
+                    static constexpr char LOG_TYPE_BINARY[] = "binary";
+
+                    static constexpr char LOG_FLUSH_BATCH[] = "batch";
+                    static constexpr char LOG_FLUSH_INTERVAL[] = "interval";
+                    static constexpr char LOG_FLUSH_ERROR[] = "error";
+
+                    static constexpr char LOG_OVERFLOW_DROP_OLDEST[] = "drop-oldest";
+                    static constexpr char LOG_OVERFLOW_DROP_NEWEST[] = "drop-newest";
+                    static constexpr char LOG_OVERFLOW_BLOCK[] = "block";
 
                     static constexpr char CLI_LOG_LEVEL[] = "--log-level";
                     static constexpr char CLI_LOG_TYPE[] = "--log-type";
@@ -133,6 +147,11 @@ namespace Aws
                     static constexpr char JSON_KEY_LOG_LEVEL[] = "level";
                     static constexpr char JSON_KEY_LOG_TYPE[] = "type";
                     static constexpr char JSON_KEY_LOG_FILE[] = "file";
+                    static constexpr char JSON_KEY_LOG_FLUSH_POLICY[] = "flush-policy";
+                    static constexpr char JSON_KEY_LOG_FLUSH_INTERVAL_MS[] = "flush-interval-ms";
+                    static constexpr char JSON_KEY_LOG_QUEUE_CAPACITY[] = "queue-capacity";
+                    static constexpr char JSON_KEY_LOG_OVERFLOW_POLICY[] = "overflow-policy";
+                    static constexpr char JSON_KEY_LOG_OVERFLOW_BLOCK_MS[] = "overflow-block-ms";
 
                     static constexpr char CLI_ENABLE_SDK_LOGGING[] = "--enable-sdk-logging";
                     static constexpr char CLI_SDK_LOG_LEVEL[] = "--sdk-log-level";
@@ -145,6 +164,16 @@ namespace Aws
                     int deviceClientlogLevel{3};
                     std::string deviceClientLogtype{LOG_TYPE_STDOUT};
                     std::string deviceClientLogFile{"/var/log/aws-iot-device-client/aws-iot-device-client.log"};
+                    // Log output is written once per batch of queued messages, and flushed after every batch, every
+                    // deviceClientLogFlushIntervalMs, or after batches holding an ERROR message.
+                    std::string deviceClientLogFlushPolicy{LOG_FLUSH_BATCH};
+                    int64_t deviceClientLogFlushIntervalMs{1000};
+                    // Messages waiting to be written are held in a ring of deviceClientLogQueueCapacity messages. When
+                    // it is full, the oldest or the newest message is dropped, or the logging thread waits up to
+                    // deviceClientLogOverflowBlockMs for room before dropping the newest.
+                    int64_t deviceClientLogQueueCapacity{4096};
+                    std::string deviceClientLogOverflowPolicy{LOG_OVERFLOW_DROP_OLDEST};
+                    int64_t deviceClientLogOverflowBlockMs{100};
 
                     bool sdkLoggingEnabled{false};
                     Aws::Crt::LogLevel sdkLogLevel{Aws::Crt::LogLevel::Trace};
@@ -416,25 +445,91 @@ namespace Aws
                     void SerializeToObject(Crt::JsonObject &object) const;
 
                     static constexpr char JSON_SENSORS[] = "sensors";
+                    static constexpr char JSON_EVENT_LOOP_THREADS[] = "event_loop_threads";
+                    static constexpr char JSON_EVENT_LOOP_CPUS[] = "event_loop_cpus";
+                    static constexpr char JSON_MAX_SENSORS[] = "max_sensors";
+                    static constexpr char JSON_SENSORS_DIR[] = "sensors_dir";
+                    static constexpr char JSON_MEMORY_BUDGET_BYTES[] = "memory_budget_bytes";
+                    static constexpr char JSON_AGGREGATE_TOPIC[] = "aggregate_topic";
+                    static constexpr char JSON_AGGREGATE_MAX_BYTES[] = "aggregate_max_bytes";
+                    static constexpr char JSON_AGGREGATE_TIME_MS[] = "aggregate_time_ms";
+                    static constexpr char JSON_AGGREGATE_MAX_INFLIGHT[] = "aggregate_max_inflight";
+                    static constexpr char JSON_STATS_FILE[] = "stats_file";
+                    static constexpr char JSON_STATS_TOPIC[] = "stats_topic";
+                    static constexpr char JSON_STATS_INTERVAL_SEC[] = "stats_interval_sec";
+                    static constexpr char JSON_HEARTBEAT_TOPIC[] = "heartbeat_topic";
+                    static constexpr char JSON_HEARTBEAT_INTERVAL_SEC[] = "heartbeat_interval_sec";
                     static constexpr char JSON_ENABLED[] = "enabled";
                     static constexpr char JSON_NAME[] = "name";
                     static constexpr char JSON_ADDR[] = "addr";
                     static constexpr char JSON_ADDR_POLL_SEC[] = "addr_poll_sec";
+                    static constexpr char JSON_ADDR_TYPE[] = "addr_type";
+                    static constexpr char JSON_MAX_MESSAGE_BYTES[] = "max_message_bytes";
                     static constexpr char JSON_BUFFER_TIME_MS[] = "buffer_time_ms";
                     static constexpr char JSON_BUFFER_SIZE[] = "buffer_size";
                     static constexpr char JSON_BUFFER_CAPACITY[] = "buffer_capacity";
+                    static constexpr char JSON_MAX_INFLIGHT[] = "max_inflight";
+                    static constexpr char JSON_READ_BUDGET_BYTES[] = "read_budget_bytes";
                     static constexpr char JSON_EOM_DELIMITER[] = "eom_delimiter";
                     static constexpr char JSON_MQTT_TOPIC[] = "mqtt_topic";
                     static constexpr char JSON_MQTT_DEAD_LETTER_TOPIC[] = "mqtt_dead_letter_topic";
                     static constexpr char JSON_MQTT_HEARTBEAT_TOPIC[] = "mqtt_heartbeat_topic";
                     static constexpr char JSON_HEARTBEAT_TIME_SEC[] = "heartbeat_time_sec";
-
-                    // MAX_SENSOR_SIZE is the maximum number of sensor entries in a valid configuration.
+                    static constexpr char JSON_SPOOL_DIR[] = "spool_dir";
+                    static constexpr char JSON_SPOOL_MAX_BYTES[] = "spool_max_bytes";
+                    static constexpr char JSON_SPOOL_DRAIN_RATE[] = "spool_drain_rate";
+                    static constexpr char JSON_COMPRESSION[] = "compression";
+                    static constexpr char JSON_COMPRESSION_MIN_BYTES[] = "compression_min_bytes";
+                    static constexpr char JSON_BATCH_FORMAT[] = "batch_format";
+                    static constexpr char JSON_BATCH_TIMESTAMPS[] = "batch_timestamps";
+                    static constexpr char JSON_EVENT_LOOP[] = "event_loop";
+                    static constexpr char JSON_AGGREGATE[] = "aggregate";
+                    static constexpr char JSON_SUMMARY_FORMAT[] = "summary_format";
+                    static constexpr char JSON_SUMMARY_FIELDS[] = "summary_fields";
+                    static constexpr char JSON_SUMMARY_WINDOW_MS[] = "summary_window_ms";
+                    static constexpr char JSON_DROP_DUPLICATES[] = "drop_duplicates";
+                    static constexpr char JSON_DEADBAND_FORMAT[] = "deadband_format";
+                    static constexpr char JSON_DEADBAND_FIELDS[] = "deadband_fields";
+                    static constexpr char JSON_DEADBAND[] = "deadband";
+                    static constexpr char JSON_MAX_MESSAGE_RATE[] = "max_message_rate";
+                    static constexpr char JSON_MQTT_COMMAND_TOPIC[] = "mqtt_command_topic";
+                    static constexpr char JSON_COMMAND_BUFFER_BYTES[] = "command_buffer_bytes";
+                    static constexpr char JSON_COMMAND_DROP_POLICY[] = "command_drop_policy";
+                    static constexpr char JSON_CAN_FILTERS[] = "can_filters";
+
+                    static constexpr char ADDR_TYPE_STREAM[] = "stream";
+                    static constexpr char ADDR_TYPE_DGRAM[] = "dgram";
+                    static constexpr char ADDR_TYPE_SEQPACKET[] = "seqpacket";
+                    static constexpr char ADDR_TYPE_UDP[] = "udp";
+                    static constexpr char ADDR_TYPE_CAN[] = "can";
+
+                    static constexpr char COMPRESSION_NONE[] = "none";
+                    static constexpr char COMPRESSION_DEFLATE[] = "deflate";
+                    static constexpr char COMPRESSION_ZSTD[] = "zstd";
+
+                    static constexpr char BATCH_FORMAT_RAW[] = "raw";
+                    static constexpr char BATCH_FORMAT_JSON_ARRAY[] = "json_array";
+                    static constexpr char BATCH_FORMAT_CBOR[] = "cbor";
+                    static constexpr char BATCH_FORMAT_LENGTH_PREFIXED[] = "length_prefixed";
+
+                    static constexpr char FIELD_FORMAT_JSON[] = "json";
+                    static constexpr char FIELD_FORMAT_CSV[] = "csv";
+
+                    static constexpr char DROP_POLICY_NEWEST[] = "newest";
+                    static constexpr char DROP_POLICY_OLDEST[] = "oldest";
+
+                    // MAX_SENSOR_SIZE is the default maximum number of sensor entries in a valid configuration.
                     //
-                    // Increasing this limit will likely also require a user to increase the 5k limit on
-                    // the total size of the configuration.
+                    // The limit is raised with max_sensors. Beyond a handful of sensors, entries should be defined
+                    // in sensors_dir, since the configuration file itself is limited to 5k.
                     static constexpr std::size_t MAX_SENSOR_SIZE = 10;
 
+                    // MAX_SENSORS_LIMIT is the largest accepted value of max_sensors.
+                    static constexpr std::int64_t MAX_SENSORS_LIMIT = 1000;
+
+                    // SENSOR_FILE_SUFFIX is the suffix of the sensor definition files read from sensors_dir.
+                    static constexpr char SENSOR_FILE_SUFFIX[] = ".json";
+
                     // BUF_CAPACITY_BYTES is the default number of bytes buffered for a single sensor.
                     // When this limit is reached, we will publish all buffered complete messages.
                     //
@@ -447,28 +542,199 @@ namespace Aws
                     // multiples of buffer_size messages.
                     static constexpr std::int64_t BUF_CAPACITY_BYTES_MIN = 1024;
 
+                    // MAX_INFLIGHT is the default number of batches published to the sensor topic and not yet
+                    // acknowledged by the broker. When this limit is reached, the sensor stops reading until
+                    // acknowledgements arrive, so a slow broker pushes back on the sensor through its socket.
+                    static constexpr std::int64_t MAX_INFLIGHT = 32;
+
+                    // READ_BUDGET_BYTES is the default number of bytes read from a sensor before it yields the
+                    // event loop to other sensors, heartbeats and MQTT I/O sharing it.
+                    static constexpr std::int64_t READ_BUDGET_BYTES = 64 * 1024;
+
+                    // MAX_MESSAGE_BYTES is the default size of the largest message read from a message based socket.
+                    // Larger messages are dropped.
+                    static constexpr std::int64_t MAX_MESSAGE_BYTES = 4096;
+
+                    // SPOOL_MAX_BYTES is the default maximum size of the on-disk spool of a single sensor.
+                    // When this limit is reached, the oldest spooled batches are evicted.
+                    static constexpr std::int64_t SPOOL_MAX_BYTES = 64 * 1024 * 1024;
+
+                    // SPOOL_MAX_BYTES_MIN is the minimum spool size.
+                    static constexpr std::int64_t SPOOL_MAX_BYTES_MIN = 1024 * 1024;
+
+                    // SPOOL_DRAIN_RATE is the default number of spooled batches published per second after the
+                    // connection resumes. Live data is published in addition to spooled batches, so the rate should
+                    // leave headroom below the AWS IoT limit on publish requests per second per connection.
+                    static constexpr std::int64_t SPOOL_DRAIN_RATE = 10;
+
+                    // COMPRESSION_MIN_BYTES is the default size below which batches are published uncompressed.
+                    // Small batches compress poorly and already fit in a single 5KB unit of metered messaging.
+                    static constexpr std::int64_t COMPRESSION_MIN_BYTES = 512;
+
+                    // EVENT_LOOP_THREADS_MAX is the maximum number of event loop threads dedicated to sensors.
+                    static constexpr std::int64_t EVENT_LOOP_THREADS_MAX = 64;
+
+                    // AGGREGATE_TIME_MS is the default time a batch waits in the aggregate message for batches of
+                    // other sensors before the aggregate message is published.
+                    static constexpr std::int64_t AGGREGATE_TIME_MS = 1000;
+
+                    // SUMMARY_WINDOW_MS is the default length of the tumbling window summarized by a sensor
+                    // configured with summary_fields.
+                    static constexpr std::int64_t SUMMARY_WINDOW_MS = 1000;
+
+                    // FIELDS_MAX is the maximum number of summary_fields or deadband_fields of a sensor.
+                    static constexpr std::size_t FIELDS_MAX = 32;
+
+                    // COMMAND_BUFFER_BYTES is the default total size of the commands received on mqtt_command_topic
+                    // and not yet written to the sensor socket.
+                    static constexpr std::int64_t COMMAND_BUFFER_BYTES = 16 * 1024;
+
+                    // CAN_MESSAGE_BYTES_MAX is the size of the largest message read from a CAN socket, a frame with
+                    // an extended identifier and 8 data bytes in candump compact format.
+                    static constexpr std::int64_t CAN_MESSAGE_BYTES_MAX = 25;
+
+                    // STATS_INTERVAL_SEC is the default interval at which sensor statistics are written to
+                    // stats_file and published to stats_topic.
+                    static constexpr std::int64_t STATS_INTERVAL_SEC = 60;
+
+                    // HEARTBEAT_INTERVAL_SEC is the default interval at which the heartbeat of every sensor is
+                    // published to heartbeat_topic, the same as the default heartbeat_time_sec of a sensor.
+                    static constexpr std::int64_t HEARTBEAT_INTERVAL_SEC = 300;
+
+                    // CAN_FILTERS_MAX is the maximum number of can_filters of a sensor.
+                    static constexpr std::size_t CAN_FILTERS_MAX = 64;
+
                     bool enabled{false};
 
+                    // Number of event loop threads dedicated to sensors. When 0, sensors share the event loop
+                    // of the MQTT connection.
+                    Aws::Crt::Optional<int64_t> eventLoopThreads{0};
+
+                    // CPUs to pin the sensor event loop threads to, thread i is pinned to entry i modulo size.
+                    std::vector<int64_t> eventLoopCpus;
+
+                    // Maximum number of sensor entries, including entries defined in sensorsDir.
+                    Aws::Crt::Optional<int64_t> maxSensors{static_cast<int64_t>(MAX_SENSOR_SIZE)};
+
+                    // Directory of sensor definition files, each holding one sensor entry. Entries are appended to
+                    // the sensors array in file name order.
+                    Aws::Crt::Optional<std::string> sensorsDir;
+
+                    // Maximum number of bytes of read buffers held by all sensors at once. When 0, there is no limit
+                    // and each sensor may hold up to its buffer_capacity.
+                    Aws::Crt::Optional<int64_t> memoryBudgetBytes{0};
+
+                    // Topic on which batches of sensors configured with aggregate are published, merged into
+                    // aggregate messages of at most aggregateMaxBytes, within aggregateTimeMs of the oldest batch.
+                    // Once aggregateMaxInflight aggregate messages await acknowledgement, batches are published by
+                    // their sensor instead.
+                    Aws::Crt::Optional<std::string> aggregateTopic;
+                    Aws::Crt::Optional<int64_t> aggregateMaxBytes{BUF_CAPACITY_BYTES};
+                    Aws::Crt::Optional<int64_t> aggregateTimeMs{AGGREGATE_TIME_MS};
+                    Aws::Crt::Optional<int64_t> aggregateMaxInflight{MAX_INFLIGHT};
+
+                    // Sensor statistics, such as publish latency percentiles, are written to statsFile and
+                    // published to statsTopic every statsIntervalSec. Neither is done when not configured.
+                    Aws::Crt::Optional<std::string> statsFile;
+                    Aws::Crt::Optional<std::string> statsTopic;
+                    Aws::Crt::Optional<int64_t> statsIntervalSec{STATS_INTERVAL_SEC};
+
+                    // One heartbeat message listing every connected sensor and its counters is published to
+                    // heartbeatTopic every heartbeatIntervalSec, in addition to the heartbeats of each sensor.
+                    Aws::Crt::Optional<std::string> heartbeatTopic;
+                    Aws::Crt::Optional<int64_t> heartbeatIntervalSec{HEARTBEAT_INTERVAL_SEC};
+
                     struct SensorSettings
                     {
                         bool enabled{true};
                         Aws::Crt::Optional<std::string> name;
                         Aws::Crt::Optional<std::string> addr;
                         Aws::Crt::Optional<int64_t> addrPollSec{10};
+                        Aws::Crt::Optional<std::string> addrType;
+                        Aws::Crt::Optional<int64_t> maxMessageBytes{MAX_MESSAGE_BYTES};
                         Aws::Crt::Optional<int64_t> bufferTimeMs{0};
                         Aws::Crt::Optional<int64_t> bufferSize{0};
                         Aws::Crt::Optional<int64_t> bufferCapacity{BUF_CAPACITY_BYTES};
+                        Aws::Crt::Optional<int64_t> maxInflight{MAX_INFLIGHT};
+                        Aws::Crt::Optional<int64_t> readBudgetBytes{READ_BUDGET_BYTES};
                         Aws::Crt::Optional<std::string> eomDelimiter;
                         Aws::Crt::Optional<std::string> mqttTopic;
                         Aws::Crt::Optional<std::string> mqttDeadLetterTopic;
                         Aws::Crt::Optional<std::string> mqttHeartbeatTopic;
                         Aws::Crt::Optional<int64_t> heartbeatTimeSec{300};
+                        Aws::Crt::Optional<std::string> spoolDir;
+                        Aws::Crt::Optional<int64_t> spoolMaxBytes{SPOOL_MAX_BYTES};
+                        Aws::Crt::Optional<int64_t> spoolDrainRate{SPOOL_DRAIN_RATE};
+                        Aws::Crt::Optional<std::string> compression;
+                        Aws::Crt::Optional<int64_t> compressionMinBytes{COMPRESSION_MIN_BYTES};
+                        Aws::Crt::Optional<std::string> batchFormat;
+                        Aws::Crt::Optional<bool> batchTimestamps{false};
+                        Aws::Crt::Optional<int64_t> eventLoop;
+                        Aws::Crt::Optional<bool> aggregate{false};
+
+                        // When summaryFields is not empty, messages are not published. A summary of the fields
+                        // over each window of summaryWindowMs is published instead.
+                        Aws::Crt::Optional<std::string> summaryFormat;
+                        std::vector<std::string> summaryFields;
+                        Aws::Crt::Optional<int64_t> summaryWindowMs{SUMMARY_WINDOW_MS};
+
+                        // Messages are filtered before they are batched: repeats of the last kept message are
+                        // dropped with dropDuplicates, messages whose deadbandFields all changed by at most deadband
+                        // since the last kept message are dropped, and at most maxMessageRate messages are kept
+                        // per second. A maxMessageRate of 0 does not limit the rate.
+                        Aws::Crt::Optional<bool> dropDuplicates{false};
+                        Aws::Crt::Optional<std::string> deadbandFormat;
+                        std::vector<std::string> deadbandFields;
+                        Aws::Crt::Optional<double> deadband{0};
+                        Aws::Crt::Optional<int64_t> maxMessageRate{0};
+
+                        // Messages received on mqttCommandTopic are written to the sensor socket. Up to
+                        // commandBufferBytes of commands wait for the socket, beyond which the newest or oldest
+                        // commands are dropped according to commandDropPolicy.
+                        Aws::Crt::Optional<std::string> mqttCommandTopic;
+                        Aws::Crt::Optional<int64_t> commandBufferBytes{COMMAND_BUFFER_BYTES};
+                        Aws::Crt::Optional<std::string> commandDropPolicy;
+
+                        // CAN identifier filters applied by the kernel to sensors of addrType can, each of the form
+                        // id:mask, or id~mask for frames not matching. No filter receives all frames.
+                        std::vector<std::string> canFilters;
+
+                        // Sensor definition file the entry was loaded from, empty for entries of the sensors array.
+                        // Entries loaded from sensorsDir are not serialized.
+                        std::string definitionFile;
                     };
                     // If any setting associated with a sensor is found invalid during validation,
                     // then we will disable only that sensor. In order to do this we must modify
                     // the sensor enabled flag. Since Validate() is const member function, the
                     // settings array must be declared mutable to allow this flag to be changed.
                     mutable std::vector<SensorSettings> settings;
+
+                    /**
+                     * \brief Load the settings of one sensor entry
+                     *
+                     * @param defaultName name of the sensor when the entry has no name
+                     */
+                    static SensorSettings LoadSensorSettings(
+                        const Crt::JsonView &entry,
+                        const std::string &defaultName);
+
+                    /**
+                     * \brief Append the sensor entries defined in sensorsDir, in file name order
+                     *
+                     * Files which are too large, have the wrong permissions, or cannot be parsed are skipped.
+                     */
+                    void LoadSensorsDir();
+
+                    /**
+                     * \brief Validate the format and fields read from the messages of a sensor
+                     *
+                     * @return false when the format is not json or csv, or a field is not a key of that format
+                     */
+                    static bool ValidateFields(
+                        const char *formatKey,
+                        const Aws::Crt::Optional<std::string> &format,
+                        const char *fieldsKey,
+                        const std::vector<std::string> &fields);
                 };
                 SensorPublish sensorPublish;
             };
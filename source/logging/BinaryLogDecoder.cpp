@@ -0,0 +1,201 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BinaryLogDecoder.h"
+#include "BinaryLogFormat.h"
+#include "LogMessage.h"
+#include "LogUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+namespace
+{
+    using Dictionary = unordered_map<uint64_t, const char *>;
+
+    /**
+     * \brief Reads the entries of the dictionary, which ends at the first empty or incomplete entry
+     */
+    Dictionary readDictionary(const char *dictionary, size_t size)
+    {
+        Dictionary strings;
+        size_t position = 0;
+        while (position + sizeof(BinaryLogFormat::DictionaryEntry) <= size)
+        {
+            BinaryLogFormat::DictionaryEntry entry;
+            memcpy(&entry, dictionary + position, sizeof(entry));
+            const char *text = dictionary + position + sizeof(entry);
+            size_t entrySize = sizeof(entry) + BinaryLogFormat::align(static_cast<size_t>(entry.length) + 1);
+            if (entry.address == 0 || entrySize > size - position || text[entry.length] != '\0')
+            {
+                break;
+            }
+            strings[entry.address] = text;
+            position += entrySize;
+        }
+        return strings;
+    }
+
+    string formatRecord(
+        const Dictionary &strings,
+        const BinaryLogFormat::RecordHeader &header,
+        const char *arguments,
+        size_t size)
+    {
+        string message;
+        if (header.type == static_cast<uint8_t>(BinaryLogFormat::RecordType::Text))
+        {
+            if (!BinaryLogFormat::formatArguments("%s", arguments, size, message))
+            {
+                message = "<damaged message>";
+            }
+            return message;
+        }
+
+        auto format = strings.find(header.format);
+        if (format == strings.end())
+        {
+            char unknown[64];
+            snprintf(
+                unknown,
+                sizeof(unknown),
+                "<unknown format string at 0x%llx>",
+                static_cast<unsigned long long>(header.format));
+            return unknown;
+        }
+        if (!BinaryLogFormat::formatArguments(format->second, arguments, size, message))
+        {
+            message = string("<arguments do not match format string \"") + format->second + "\">";
+        }
+        return message;
+    }
+} // namespace
+
+bool BinaryLogDecoder::decode(const std::string &path, std::ostream &output, std::string &error)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    vector<char> contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    if (file.bad())
+    {
+        error = "cannot read " + path;
+        return false;
+    }
+
+    BinaryLogFormat::FileHeader header;
+    if (contents.size() < sizeof(header))
+    {
+        error = path + " is not a binary log file";
+        return false;
+    }
+    memcpy(&header, contents.data(), sizeof(header));
+    if (memcmp(header.magic, BinaryLogFormat::MAGIC, sizeof(header.magic)) != 0)
+    {
+        error = path + " is not a binary log file";
+        return false;
+    }
+    if (header.byteOrderMark != BinaryLogFormat::BYTE_ORDER_MARK)
+    {
+        error = path + " was written by a device with a different byte order";
+        return false;
+    }
+    if (header.version != BinaryLogFormat::VERSION)
+    {
+        error = path + " was written by an unsupported version of the Device Client";
+        return false;
+    }
+
+    uint64_t fileSize = contents.size();
+    if (header.dictionaryOffset > fileSize || header.dictionarySize > fileSize - header.dictionaryOffset ||
+        header.dataOffset > fileSize || header.blockSize < sizeof(BinaryLogFormat::BlockHeader) ||
+        header.blockSize % BinaryLogFormat::ALIGNMENT != 0 ||
+        header.blockCount > (fileSize - header.dataOffset) / header.blockSize)
+    {
+        error = path + " is truncated or damaged";
+        return false;
+    }
+
+    const char *base = contents.data();
+    Dictionary strings = readDictionary(base + header.dictionaryOffset, static_cast<size_t>(header.dictionarySize));
+
+    // The data area is a ring, so order the blocks by sequence to write the oldest messages first.
+    vector<pair<uint64_t, const char *>> blocks;
+    for (uint64_t i = 0; i < header.blockCount; i++)
+    {
+        const char *block = base + header.dataOffset + i * header.blockSize;
+        BinaryLogFormat::BlockHeader blockHeader;
+        memcpy(&blockHeader, block, sizeof(blockHeader));
+        if (blockHeader.sequence != 0)
+        {
+            blocks.emplace_back(blockHeader.sequence, block);
+        }
+    }
+    sort(blocks.begin(), blocks.end());
+
+    size_t blockSize = static_cast<size_t>(header.blockSize);
+    string line;
+    for (const auto &block : blocks)
+    {
+        size_t position = sizeof(BinaryLogFormat::BlockHeader);
+        while (position + BinaryLogFormat::PADDING_SIZE <= blockSize)
+        {
+            BinaryLogFormat::RecordHeader record;
+            memcpy(&record, block.second + position, BinaryLogFormat::PADDING_SIZE);
+            // A record left over from the previous lap of the ring has the sequence of an older block.
+            if (record.size == 0 || record.size % BinaryLogFormat::ALIGNMENT != 0 ||
+                record.size > blockSize - position || record.sequence != static_cast<uint32_t>(block.first))
+            {
+                break;
+            }
+            if (record.type == static_cast<uint8_t>(BinaryLogFormat::RecordType::Padding))
+            {
+                position += record.size;
+                continue;
+            }
+            if (record.size < sizeof(record) || record.level > static_cast<uint8_t>(LogLevel::DEBUG))
+            {
+                break;
+            }
+            memcpy(&record, block.second + position, sizeof(record));
+
+            const char *body = block.second + position + sizeof(record);
+            size_t bodySize = record.size - sizeof(record);
+            const char *tag;
+            size_t tagSize = BinaryLogFormat::decodeText(body, bodySize, tag);
+            if (tagSize == 0)
+            {
+                break;
+            }
+            chrono::time_point<chrono::system_clock> time(
+                chrono::duration_cast<chrono::system_clock::duration>(chrono::nanoseconds(record.timestamp)));
+            LogMessage message(
+                static_cast<LogLevel>(record.level),
+                tag,
+                time,
+                formatRecord(strings, record, body + tagSize, bodySize - tagSize));
+
+            line.clear();
+            LogUtil::appendLogLine(line, message);
+            output << line;
+            position += record.size;
+        }
+    }
+    output.flush();
+    return true;
+}
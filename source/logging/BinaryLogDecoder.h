@@ -0,0 +1,43 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BINARYLOGDECODER_H
+#define DEVICE_CLIENT_BINARYLOGDECODER_H
+
+#include <ostream>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Decodes files written by BinaryLogger back into the text the FileLogger would have written
+                 */
+                class BinaryLogDecoder
+                {
+                  public:
+                    /**
+                     * \brief Decodes the binary log file at path, writing one line per message to output, oldest
+                     * first
+                     *
+                     * Decoding stops at the first damaged record of each block, so a file copied while the Device
+                     * Client is running, or left behind by a crash, decodes up to the last complete message.
+                     *
+                     * @param path the binary log file
+                     * @param output the stream to write the messages to
+                     * @param error set to the reason when decoding fails
+                     * @return false if path could not be read or is not a binary log file
+                     */
+                    static bool decode(const std::string &path, std::ostream &output, std::string &error);
+                };
+            } // namespace Logging
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BINARYLOGDECODER_H
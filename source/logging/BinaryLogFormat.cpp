@@ -0,0 +1,519 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BinaryLogFormat.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+constexpr char BinaryLogFormat::MAGIC[];
+constexpr uint32_t BinaryLogFormat::VERSION;
+constexpr uint32_t BinaryLogFormat::BYTE_ORDER_MARK;
+constexpr size_t BinaryLogFormat::ALIGNMENT;
+constexpr size_t BinaryLogFormat::MAX_RECORD_SIZE;
+constexpr size_t BinaryLogFormat::PADDING_SIZE;
+constexpr size_t BinaryLogFormat::MAX_TAG_SIZE;
+
+namespace
+{
+    enum class Length
+    {
+        None,
+        Char,
+        Short,
+        Long,
+        LongLong,
+        IntMax,
+        Size,
+        PtrDiff,
+        LongDouble
+    };
+
+    /**
+     * \brief One conversion specification of a format string, such as "%-8.*lu"
+     */
+    struct Conversion
+    {
+        const char *flags = nullptr;
+        size_t flagsLength = 0;
+        bool widthFromArgument = false;
+        const char *width = nullptr;
+        size_t widthLength = 0;
+        bool hasPrecision = false;
+        bool precisionFromArgument = false;
+        int precision = 0;
+        Length length = Length::None;
+        char specifier = '\0';
+    };
+
+    bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    /**
+     * \brief Parses the conversion specification following a '%'
+     *
+     * @param spec the first character after the '%'
+     * @param conversion the parsed conversion specification
+     * @return the first character after the conversion specification, or nullptr if it is not supported
+     */
+    const char *parseConversion(const char *spec, Conversion &conversion)
+    {
+        const char *p = spec;
+        conversion.flags = p;
+        while (*p != '\0' && strchr("-+ #0'", *p) != nullptr)
+        {
+            p++;
+        }
+        conversion.flagsLength = static_cast<size_t>(p - conversion.flags);
+
+        if (*p == '*')
+        {
+            conversion.widthFromArgument = true;
+            p++;
+        }
+        else
+        {
+            conversion.width = p;
+            while (isDigit(*p))
+            {
+                p++;
+            }
+            conversion.widthLength = static_cast<size_t>(p - conversion.width);
+        }
+        if (*p == '$')
+        {
+            return nullptr; // Positional arguments
+        }
+
+        if (*p == '.')
+        {
+            p++;
+            conversion.hasPrecision = true;
+            if (*p == '*')
+            {
+                conversion.precisionFromArgument = true;
+                p++;
+            }
+            while (isDigit(*p))
+            {
+                conversion.precision = conversion.precision * 10 + (*p - '0');
+                p++;
+            }
+        }
+
+        switch (*p)
+        {
+            case 'h':
+                p++;
+                conversion.length = *p == 'h' ? Length::Char : Length::Short;
+                p += *p == 'h' ? 1 : 0;
+                break;
+            case 'l':
+                p++;
+                conversion.length = *p == 'l' ? Length::LongLong : Length::Long;
+                p += *p == 'l' ? 1 : 0;
+                break;
+            case 'q':
+                conversion.length = Length::LongLong;
+                p++;
+                break;
+            case 'j':
+                conversion.length = Length::IntMax;
+                p++;
+                break;
+            case 'z':
+                conversion.length = Length::Size;
+                p++;
+                break;
+            case 't':
+                conversion.length = Length::PtrDiff;
+                p++;
+                break;
+            case 'L':
+                conversion.length = Length::LongDouble;
+                p++;
+                break;
+            default:
+                break;
+        }
+
+        conversion.specifier = *p;
+        return *p == '\0' ? nullptr : p + 1;
+    }
+
+    bool isSigned(char specifier) { return specifier == 'd' || specifier == 'i'; }
+
+    bool isUnsigned(char specifier)
+    {
+        return specifier == 'u' || specifier == 'o' || specifier == 'x' || specifier == 'X';
+    }
+
+    bool isFloatingPoint(char specifier) { return specifier != '\0' && strchr("fFeEgGaA", specifier) != nullptr; }
+
+    /**
+     * \brief Writes encoded arguments into a fixed-size buffer, without allocating
+     */
+    struct ArgumentWriter
+    {
+        char *buffer;
+        size_t capacity;
+        size_t size;
+        bool fits;
+
+        void putValue(const void *value)
+        {
+            if (size + BinaryLogFormat::ALIGNMENT > capacity)
+            {
+                fits = false;
+                return;
+            }
+            memcpy(buffer + size, value, BinaryLogFormat::ALIGNMENT);
+            size += BinaryLogFormat::ALIGNMENT;
+        }
+
+        void putSigned(int64_t value) { putValue(&value); }
+        void putUnsigned(uint64_t value) { putValue(&value); }
+        void putDouble(double value) { putValue(&value); }
+
+        void putString(const char *text, size_t length)
+        {
+            uint32_t header[2] = {static_cast<uint32_t>(length), 0};
+            size_t padded = BinaryLogFormat::align(length + 1);
+            if (size + sizeof(header) + padded > capacity)
+            {
+                fits = false;
+                return;
+            }
+            memcpy(buffer + size, header, sizeof(header));
+            size += sizeof(header);
+            memcpy(buffer + size, text, length);
+            memset(buffer + size + length, 0, padded - length);
+            size += padded;
+        }
+    };
+
+    int64_t readSigned(va_list &args, Length length)
+    {
+        switch (length)
+        {
+            case Length::Char:
+                return static_cast<signed char>(va_arg(args, int));
+            case Length::Short:
+                return static_cast<short>(va_arg(args, int));
+            case Length::Long:
+                return va_arg(args, long);
+            case Length::LongLong:
+            case Length::LongDouble:
+                return va_arg(args, long long);
+            case Length::IntMax:
+                return va_arg(args, intmax_t);
+            case Length::Size:
+                return static_cast<int64_t>(static_cast<ptrdiff_t>(va_arg(args, size_t)));
+            case Length::PtrDiff:
+                return va_arg(args, ptrdiff_t);
+            case Length::None:
+                break;
+        }
+        return va_arg(args, int);
+    }
+
+    uint64_t readUnsigned(va_list &args, Length length)
+    {
+        switch (length)
+        {
+            case Length::Char:
+                return static_cast<unsigned char>(va_arg(args, unsigned int));
+            case Length::Short:
+                return static_cast<unsigned short>(va_arg(args, unsigned int));
+            case Length::Long:
+                return va_arg(args, unsigned long);
+            case Length::LongLong:
+            case Length::LongDouble:
+                return va_arg(args, unsigned long long);
+            case Length::IntMax:
+                return va_arg(args, uintmax_t);
+            case Length::Size:
+                return va_arg(args, size_t);
+            case Length::PtrDiff:
+                return static_cast<uint64_t>(va_arg(args, ptrdiff_t));
+            case Length::None:
+                break;
+        }
+        return va_arg(args, unsigned int);
+    }
+
+    bool encode(const char *format, va_list &args, ArgumentWriter &writer)
+    {
+        const char *p = format;
+        while (*p != '\0')
+        {
+            if (*p++ != '%')
+            {
+                continue;
+            }
+            if (*p == '%')
+            {
+                p++;
+                continue;
+            }
+
+            Conversion conversion;
+            p = parseConversion(p, conversion);
+            if (p == nullptr)
+            {
+                return false;
+            }
+
+            if (conversion.widthFromArgument)
+            {
+                writer.putSigned(va_arg(args, int));
+            }
+            int precision = conversion.hasPrecision ? conversion.precision : -1;
+            if (conversion.precisionFromArgument)
+            {
+                precision = va_arg(args, int);
+                writer.putSigned(precision);
+            }
+
+            char specifier = conversion.specifier;
+            if (isSigned(specifier))
+            {
+                writer.putSigned(readSigned(args, conversion.length));
+            }
+            else if (isUnsigned(specifier))
+            {
+                writer.putUnsigned(readUnsigned(args, conversion.length));
+            }
+            else if (isFloatingPoint(specifier))
+            {
+                writer.putDouble(
+                    conversion.length == Length::LongDouble ? static_cast<double>(va_arg(args, long double))
+                                                            : va_arg(args, double));
+            }
+            else if (specifier == 'c' && conversion.length == Length::None)
+            {
+                writer.putSigned(va_arg(args, int));
+            }
+            else if (specifier == 'p')
+            {
+                writer.putUnsigned(reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+            }
+            else if (specifier == 's' && conversion.length == Length::None)
+            {
+                const char *text = va_arg(args, const char *);
+                if (text == nullptr)
+                {
+                    text = "(null)";
+                }
+                // A precision limits how much of the string is read, so it may not be NULL terminated.
+                size_t length = precision >= 0 ? strnlen(text, static_cast<size_t>(precision)) : strlen(text);
+                writer.putString(text, length);
+            }
+            else
+            {
+                return false; // %n, %m, wide characters and strings
+            }
+
+            if (!writer.fits)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \brief Reads arguments written by ArgumentWriter
+     */
+    struct ArgumentReader
+    {
+        const char *arguments;
+        size_t size;
+        size_t position;
+
+        bool getValue(void *value)
+        {
+            if (position + BinaryLogFormat::ALIGNMENT > size)
+            {
+                return false;
+            }
+            memcpy(value, arguments + position, BinaryLogFormat::ALIGNMENT);
+            position += BinaryLogFormat::ALIGNMENT;
+            return true;
+        }
+
+        bool getString(const char *&text)
+        {
+            uint32_t header[2];
+            if (position + sizeof(header) > size)
+            {
+                return false;
+            }
+            memcpy(header, arguments + position, sizeof(header));
+            size_t padded = BinaryLogFormat::align(static_cast<size_t>(header[0]) + 1);
+            if (position + sizeof(header) + padded > size || arguments[position + sizeof(header) + header[0]] != '\0')
+            {
+                return false;
+            }
+            text = arguments + position + sizeof(header);
+            position += sizeof(header) + padded;
+            return true;
+        }
+    };
+
+    template <typename T> void appendFormatted(string &message, const string &spec, T value)
+    {
+        char buffer[128];
+        int length = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+        if (length < 0)
+        {
+            return;
+        }
+        if (static_cast<size_t>(length) < sizeof(buffer))
+        {
+            message.append(buffer, static_cast<size_t>(length));
+            return;
+        }
+        string formatted(static_cast<size_t>(length), '\0');
+        snprintf(&formatted[0], formatted.size() + 1, spec.c_str(), value);
+        message += formatted;
+    }
+} // namespace
+
+int BinaryLogFormat::encodeArguments(const char *format, va_list args, char *buffer, size_t bufferSize)
+{
+    ArgumentWriter writer{buffer, bufferSize, 0, true};
+    va_list encodeArgs;
+    va_copy(encodeArgs, args);
+    bool encoded = encode(format, encodeArgs, writer);
+    va_end(encodeArgs);
+    return encoded ? static_cast<int>(writer.size) : -1;
+}
+
+size_t BinaryLogFormat::encodeText(const char *text, char *buffer, size_t bufferSize)
+{
+    ArgumentWriter writer{buffer, bufferSize, 0, true};
+    size_t length = strlen(text);
+    size_t maxLength = bufferSize - sizeof(uint32_t) * 2 - 1;
+    writer.putString(text, length < maxLength ? length : maxLength);
+    return writer.size;
+}
+
+size_t BinaryLogFormat::decodeText(const char *arguments, size_t size, const char *&text)
+{
+    ArgumentReader reader{arguments, size, 0};
+    return reader.getString(text) ? reader.position : 0;
+}
+
+bool BinaryLogFormat::formatArguments(const char *format, const char *arguments, size_t size, string &message)
+{
+    ArgumentReader reader{arguments, size, 0};
+    const char *p = format;
+    while (*p != '\0')
+    {
+        if (*p != '%')
+        {
+            message += *p++;
+            continue;
+        }
+        p++;
+        if (*p == '%')
+        {
+            message += *p++;
+            continue;
+        }
+
+        Conversion conversion;
+        p = parseConversion(p, conversion);
+        if (p == nullptr)
+        {
+            return false;
+        }
+
+        // Rebuild the conversion specification with the width and precision taken from the arguments, and the
+        // length of the encoded argument.
+        string spec = "%";
+        spec.append(conversion.flags, conversion.flagsLength);
+        int64_t value = 0;
+        if (conversion.widthFromArgument)
+        {
+            if (!reader.getValue(&value))
+            {
+                return false;
+            }
+            spec += to_string(value);
+        }
+        else
+        {
+            spec.append(conversion.width, conversion.widthLength);
+        }
+        if (conversion.precisionFromArgument)
+        {
+            if (!reader.getValue(&value))
+            {
+                return false;
+            }
+            if (value >= 0)
+            {
+                spec += "." + to_string(value);
+            }
+        }
+        else if (conversion.hasPrecision)
+        {
+            spec += "." + to_string(conversion.precision);
+        }
+
+        char specifier = conversion.specifier;
+        if (specifier == 's')
+        {
+            const char *text;
+            if (!reader.getString(text))
+            {
+                return false;
+            }
+            appendFormatted(message, spec + 's', text);
+            continue;
+        }
+
+        if (!reader.getValue(&value))
+        {
+            return false;
+        }
+        if (isSigned(specifier))
+        {
+            appendFormatted(message, spec + "lld", static_cast<long long>(value));
+        }
+        else if (isUnsigned(specifier))
+        {
+            appendFormatted(message, spec + "ll" + specifier, static_cast<unsigned long long>(value));
+        }
+        else if (isFloatingPoint(specifier))
+        {
+            double number;
+            memcpy(&number, &value, sizeof(number));
+            appendFormatted(message, spec + specifier, number);
+        }
+        else if (specifier == 'c')
+        {
+            appendFormatted(message, spec + 'c', static_cast<int>(value));
+        }
+        else if (specifier == 'p')
+        {
+            // The pointer belongs to the device, so format it the way glibc does rather than as a local pointer.
+            string pointer = "(nil)";
+            if (value != 0)
+            {
+                pointer.clear();
+                appendFormatted(pointer, "0x%llx", static_cast<unsigned long long>(value));
+            }
+            appendFormatted(message, spec + 's', pointer.c_str());
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return reader.position == size;
+}
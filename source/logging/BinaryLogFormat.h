@@ -0,0 +1,184 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BINARYLOGFORMAT_H
+#define DEVICE_CLIENT_BINARYLOGFORMAT_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief The layout of the files written by BinaryLogger and read by BinaryLogDecoder
+                 *
+                 * A binary log file starts with a FileHeader, followed by the dictionary and the data area:
+                 * - The dictionary holds the text of every format string with arguments, keyed by its address in
+                 * the process that wrote the file. Each string is written once, the first time it is logged.
+                 * - The data area is a ring of blockCount blocks of blockSize bytes. Each block starts with a
+                 * BlockHeader holding the sequence number of the block, followed by records. Each record starts with
+                 * a RecordHeader and the tag of the message, stored as a string argument, and a record size of 0
+                 * ends the block.
+                 *
+                 * An Arguments record holds the raw arguments of a printf style format string, rather than the
+                 * formatted message, so that the message is only formatted when the file is decoded. Every integer,
+                 * floating point and pointer argument is stored in 8 bytes, and every string argument as a 4 byte
+                 * length, 4 bytes of padding and the characters of the string, padded to ALIGNMENT bytes. The
+                 * fields are stored in the byte order of the device, so files are decoded on a machine with the same
+                 * byte order.
+                 */
+                class BinaryLogFormat
+                {
+                  public:
+                    static constexpr char MAGIC[8] = {'D', 'C', 'B', 'I', 'N', 'L', 'O', 'G'};
+                    static constexpr uint32_t VERSION = 1;
+                    /**
+                     * \brief Written as a uint32_t to detect files written with another byte order
+                     */
+                    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+                    /**
+                     * \brief Every structure and record is aligned to, and a multiple of, ALIGNMENT bytes
+                     */
+                    static constexpr size_t ALIGNMENT = 8;
+                    /**
+                     * \brief The largest record, longer messages are truncated
+                     */
+                    static constexpr size_t MAX_RECORD_SIZE = 4096;
+
+                    struct FileHeader
+                    {
+                        char magic[8];
+                        uint32_t version;
+                        uint32_t byteOrderMark;
+                        uint64_t dictionaryOffset;
+                        uint64_t dictionarySize;
+                        uint64_t dataOffset;
+                        uint64_t blockSize;
+                        uint64_t blockCount;
+                    };
+
+                    /**
+                     * \brief Followed by length characters and a terminating NULL, padded to ALIGNMENT bytes. An
+                     * entry with an address of 0 ends the dictionary.
+                     */
+                    struct DictionaryEntry
+                    {
+                        uint64_t address;
+                        uint32_t length;
+                        uint32_t reserved;
+                    };
+
+                    struct BlockHeader
+                    {
+                        /**
+                         * \brief Number of blocks written before this one, plus one. 0 for a block never written.
+                         */
+                        uint64_t sequence;
+                    };
+
+                    enum class RecordType : uint8_t
+                    {
+                        /** The encoded arguments of the format string */
+                        Arguments = 1,
+                        /** A formatted message, stored as a string argument */
+                        Text = 2,
+                        /** Unused space, only the first PADDING_SIZE bytes of the header are written */
+                        Padding = 3
+                    };
+
+                    struct RecordHeader
+                    {
+                        /**
+                         * \brief Size of the record including its header, 0 ends the block
+                         */
+                        uint16_t size;
+                        uint8_t type;
+                        uint8_t level;
+                        /**
+                         * \brief Low 32 bits of the sequence of the block holding the record, which tells records of
+                         * the current lap of the ring from leftovers of the previous lap
+                         */
+                        uint32_t sequence;
+                        /**
+                         * \brief Nanoseconds since the epoch
+                         */
+                        int64_t timestamp;
+                        /**
+                         * \brief Address of the format string, 0 for Text records
+                         */
+                        uint64_t format;
+                    };
+
+                    /**
+                     * \brief The bytes of a RecordHeader written for Padding records
+                     */
+                    static constexpr size_t PADDING_SIZE = 8;
+
+                    /**
+                     * \brief The most bytes taken by the tag of a record, longer tags are truncated
+                     */
+                    static constexpr size_t MAX_TAG_SIZE = 64;
+
+                    /**
+                     * \brief Rounds size up to a multiple of ALIGNMENT
+                     */
+                    static size_t align(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+                    /**
+                     * \brief Encodes the arguments of format into buffer, without formatting them
+                     *
+                     * @param format the printf style format string
+                     * @param args the arguments of format
+                     * @param buffer the buffer to encode the arguments into
+                     * @param bufferSize the size of buffer
+                     * @return the number of bytes written, or -1 if format uses a conversion that cannot be encoded
+                     * (%n, wide characters or positional arguments) or the arguments do not fit in buffer
+                     */
+                    static int encodeArguments(const char *format, va_list args, char *buffer, size_t bufferSize);
+
+                    /**
+                     * \brief Encodes text as a string argument into buffer, truncating it to fit
+                     *
+                     * @return the number of bytes written
+                     */
+                    static size_t encodeText(const char *text, char *buffer, size_t bufferSize);
+
+                    /**
+                     * \brief Decodes a string argument written by encodeText() at the start of arguments
+                     *
+                     * @param arguments the encoded arguments
+                     * @param size the size of arguments
+                     * @param text set to the string, which points into arguments
+                     * @return the number of bytes read, or 0 if arguments does not start with a string argument
+                     */
+                    static size_t decodeText(const char *arguments, size_t size, const char *&text);
+
+                    /**
+                     * \brief Formats format against arguments written by encodeArguments()
+                     *
+                     * @param format the printf style format string
+                     * @param arguments the encoded arguments
+                     * @param size the size of arguments
+                     * @param message the string to append the formatted message to
+                     * @return false if the arguments do not match the format string
+                     */
+                    static bool formatArguments(
+                        const char *format,
+                        const char *arguments,
+                        size_t size,
+                        std::string &message);
+                };
+            } // namespace Logging
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BINARYLOGFORMAT_H
@@ -0,0 +1,348 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BinaryLogger.h"
+#include "../util/FileUtils.h"
+#include "FileLogger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+
+constexpr char BinaryLogger::DEFAULT_LOG_FILE[];
+constexpr size_t BinaryLogger::DICTIONARY_SIZE;
+constexpr size_t BinaryLogger::BLOCK_SIZE;
+constexpr size_t BinaryLogger::BLOCK_COUNT;
+constexpr size_t BinaryLogger::KNOWN_STRINGS_CAPACITY;
+
+BinaryLogger::~BinaryLogger()
+{
+    char *base = mapping.load(memory_order_acquire);
+    if (base != nullptr)
+    {
+        munmap(base, mappingSize);
+    }
+}
+
+bool BinaryLogger::start(const PlainConfig &config)
+{
+    setLogLevel(config.logConfig.deviceClientlogLevel);
+    if (mapping.load(memory_order_acquire) != nullptr)
+    {
+        return true; // Other threads may be writing to the mapped file, a running logger only takes the log level.
+    }
+    if (!config.logConfig.deviceClientLogFile.empty() &&
+        config.logConfig.deviceClientLogFile != FileLogger::DEFAULT_LOG_FILE)
+    {
+        logFile = config.logConfig.deviceClientLogFile;
+    }
+
+    if (!mapLogFile())
+    {
+        return false;
+    }
+    writeQueuedLogs();
+    return true;
+}
+
+bool BinaryLogger::mapLogFile()
+{
+    string logFileDir = FileUtils::ExtractParentDirectory(logFile);
+    if (!FileUtils::DirectoryExists(logFileDir))
+    {
+        FileUtils::Mkdirs(logFileDir);
+        if (!FileUtils::DirectoryExists(logFileDir))
+        {
+            cout << LOGGER_TAG << ": Failed to create log directories necessary for binary logging" << endl;
+            return false;
+        }
+    }
+
+    // The dictionary of an older file holds the string addresses of another process, so each start writes a new file.
+    if (FileUtils::FileExists(logFile))
+    {
+        rename(logFile.c_str(), (logFile + ".1").c_str());
+    }
+
+    int fd = open(logFile.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to open %s for binary logging", logFile.c_str()) << endl;
+        return false;
+    }
+
+    size_t headerSize = BinaryLogFormat::align(sizeof(BinaryLogFormat::FileHeader));
+    mappingSize = headerSize + DICTIONARY_SIZE + BLOCK_SIZE * BLOCK_COUNT;
+    // Allocate the whole file up front, so that writing to the mapping cannot fail later on a full disk.
+    void *address = MAP_FAILED;
+    if (posix_fallocate(fd, 0, static_cast<off_t>(mappingSize)) == 0)
+    {
+        address = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        cout << LOGGER_TAG << FormatMessage(": Failed to map %s for binary logging", logFile.c_str()) << endl;
+        return false;
+    }
+
+    char *base = static_cast<char *>(address);
+    BinaryLogFormat::FileHeader header;
+    memcpy(header.magic, BinaryLogFormat::MAGIC, sizeof(header.magic));
+    header.version = BinaryLogFormat::VERSION;
+    header.byteOrderMark = BinaryLogFormat::BYTE_ORDER_MARK;
+    header.dictionaryOffset = headerSize;
+    header.dictionarySize = DICTIONARY_SIZE;
+    header.dataOffset = headerSize + DICTIONARY_SIZE;
+    header.blockSize = BLOCK_SIZE;
+    header.blockCount = BLOCK_COUNT;
+    memcpy(base, &header, sizeof(header));
+
+    dictionary = base + header.dictionaryOffset;
+    data = base + header.dataOffset;
+    knownStrings = unique_ptr<atomic<uint64_t>[]>(new atomic<uint64_t>[KNOWN_STRINGS_CAPACITY]());
+    mapping.store(base, memory_order_release);
+    return true;
+}
+
+bool BinaryLogger::addToDictionary(const char *text)
+{
+    if (dictionaryFull.load(memory_order_relaxed))
+    {
+        return false;
+    }
+
+    uint64_t address = reinterpret_cast<uintptr_t>(text);
+    size_t mask = KNOWN_STRINGS_CAPACITY - 1;
+    size_t index = static_cast<size_t>((address * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    for (size_t probe = 0; probe < KNOWN_STRINGS_CAPACITY; probe++)
+    {
+        atomic<uint64_t> &slot = knownStrings[(index + probe) & mask];
+        uint64_t known = slot.load(memory_order_acquire);
+        if (known == 0 && slot.compare_exchange_strong(known, address, memory_order_acq_rel))
+        {
+            // This thread added the address to the set, so it writes the dictionary entry.
+            size_t length = strlen(text);
+            size_t size = sizeof(BinaryLogFormat::DictionaryEntry) + BinaryLogFormat::align(length + 1);
+            uint64_t position = dictionaryPosition.fetch_add(size, memory_order_relaxed);
+            // Leave room for the empty entry that ends the dictionary.
+            if (position + size + sizeof(BinaryLogFormat::DictionaryEntry) > DICTIONARY_SIZE)
+            {
+                dictionaryFull = true;
+                return false;
+            }
+            char *entry = dictionary + position;
+            memcpy(entry + sizeof(BinaryLogFormat::DictionaryEntry), text, length + 1);
+            BinaryLogFormat::DictionaryEntry header{address, static_cast<uint32_t>(length), 0};
+            memcpy(entry, &header, sizeof(header));
+            return true;
+        }
+        if (known == address)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+char *BinaryLogger::reserve(size_t size, uint64_t &sequence)
+{
+    constexpr size_t usable = BLOCK_SIZE - sizeof(BinaryLogFormat::BlockHeader);
+    for (;;)
+    {
+        uint64_t position = dataPosition.fetch_add(size, memory_order_relaxed);
+        uint64_t block = position / usable;
+        size_t offset = static_cast<size_t>(position % usable);
+        char *blockStart = data + (block % BLOCK_COUNT) * BLOCK_SIZE;
+
+        BinaryLogFormat::BlockHeader blockHeader{block + 1};
+        if (offset == 0)
+        {
+            memcpy(blockStart, &blockHeader, sizeof(blockHeader));
+        }
+        if (offset + size <= usable)
+        {
+            sequence = blockHeader.sequence;
+            return blockStart + sizeof(blockHeader) + offset;
+        }
+
+        // The record would cross the end of the block. End the block here, start the next block, and pad the part of
+        // the next block covered by this reservation before trying again.
+        uint16_t end = 0;
+        memcpy(blockStart + sizeof(blockHeader) + offset, &end, sizeof(end));
+
+        char *nextBlockStart = data + ((block + 1) % BLOCK_COUNT) * BLOCK_SIZE;
+        blockHeader.sequence = block + 2;
+        memcpy(nextBlockStart, &blockHeader, sizeof(blockHeader));
+
+        BinaryLogFormat::RecordHeader padding;
+        padding.size = static_cast<uint16_t>(offset + size - usable);
+        padding.type = static_cast<uint8_t>(BinaryLogFormat::RecordType::Padding);
+        padding.level = 0;
+        padding.sequence = static_cast<uint32_t>(blockHeader.sequence);
+        memcpy(nextBlockStart + sizeof(blockHeader), &padding, BinaryLogFormat::PADDING_SIZE);
+    }
+}
+
+namespace
+{
+    /**
+     * \brief Writes tag after the RecordHeader at the start of record
+     *
+     * @return the size of the record so far
+     */
+    size_t encodeTag(const char *tag, char *record)
+    {
+        size_t headerSize = sizeof(BinaryLogFormat::RecordHeader);
+        return headerSize + BinaryLogFormat::encodeText(tag, record + headerSize, BinaryLogFormat::MAX_TAG_SIZE);
+    }
+} // namespace
+
+void BinaryLogger::writeRecord(
+    char *record,
+    size_t size,
+    BinaryLogFormat::RecordType type,
+    LogLevel level,
+    const char *format,
+    std::chrono::time_point<std::chrono::system_clock> t)
+{
+    uint64_t sequence;
+    char *destination = reserve(size, sequence);
+
+    BinaryLogFormat::RecordHeader header;
+    header.size = static_cast<uint16_t>(size);
+    header.type = static_cast<uint8_t>(type);
+    header.level = static_cast<uint8_t>(level);
+    header.sequence = static_cast<uint32_t>(sequence);
+    header.timestamp = chrono::duration_cast<chrono::nanoseconds>(t.time_since_epoch()).count();
+    header.format = reinterpret_cast<uintptr_t>(format);
+    memcpy(record, &header, sizeof(header));
+    memcpy(destination, record, size);
+}
+
+void BinaryLogger::writeText(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> t,
+    const char *message)
+{
+    alignas(BinaryLogFormat::ALIGNMENT) char record[BinaryLogFormat::MAX_RECORD_SIZE];
+    size_t size = encodeTag(tag, record);
+    size += BinaryLogFormat::encodeText(message, record + size, sizeof(record) - size);
+    writeRecord(record, size, BinaryLogFormat::RecordType::Text, level, nullptr, t);
+}
+
+void BinaryLogger::vlog(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> t,
+    const char *message,
+    va_list args)
+{
+    if (mapping.load(memory_order_acquire) == nullptr)
+    {
+        // Not started yet, queue the formatted message.
+        Logger::vlog(level, tag, t, message, args);
+        return;
+    }
+
+    // Threads still holding a Logger replaced by this one add to its LogQueue, which logQueue follows.
+    if (logQueue->hasNextLog())
+    {
+        writeQueuedLogs();
+    }
+
+    // A message without conversions is often built at runtime, and a later message built in the same buffer would
+    // share its address, so only format strings with conversions go into the dictionary. Tags are copied into every
+    // record for the same reason.
+    if (strchr(message, '%') == nullptr)
+    {
+        writeText(level, tag, t, message);
+        return;
+    }
+
+    alignas(BinaryLogFormat::ALIGNMENT) char record[BinaryLogFormat::MAX_RECORD_SIZE];
+    size_t headerSize = encodeTag(tag, record);
+    int size = addToDictionary(message)
+                   ? BinaryLogFormat::encodeArguments(message, args, record + headerSize, sizeof(record) - headerSize)
+                   : -1;
+    if (size >= 0)
+    {
+        writeRecord(
+            record,
+            headerSize + static_cast<size_t>(size),
+            BinaryLogFormat::RecordType::Arguments,
+            level,
+            message,
+            t);
+        return;
+    }
+
+    // The format string uses a conversion that cannot be encoded, the arguments are too long, or the dictionary is
+    // full, so fall back to formatting the message here.
+    char text[BinaryLogFormat::MAX_RECORD_SIZE];
+    vsnprintf(text, sizeof(text), message, args);
+    writeText(level, tag, t, text);
+}
+
+void BinaryLogger::queueLog(unique_ptr<LogMessage> message)
+{
+    if (mapping.load(memory_order_acquire) == nullptr)
+    {
+        logQueue->addLog(std::move(message));
+        return;
+    }
+    writeText(message->getLevel(), message->getTag(), message->getTime(), message->getMessage());
+}
+
+void BinaryLogger::writeQueuedLogs()
+{
+    while (logQueue->hasNextLog())
+    {
+        unique_ptr<LogMessage> message = logQueue->getNextLog();
+        if (message != nullptr)
+        {
+            writeText(message->getLevel(), message->getTag(), message->getTime(), message->getMessage());
+        }
+    }
+}
+
+void BinaryLogger::stop()
+{
+    // Messages are written to the mapped file as they are logged, so there is no thread to stop.
+}
+
+unique_ptr<LogQueue> BinaryLogger::takeLogQueue()
+{
+    unique_ptr<LogQueue> tmp = std::move(logQueue);
+    logQueue = unique_ptr<LogQueue>(new LogQueue);
+    return tmp;
+}
+
+void BinaryLogger::setLogQueue(std::unique_ptr<LogQueue> incomingQueue)
+{
+    this->logQueue = std::move(incomingQueue);
+}
+
+void BinaryLogger::shutdown()
+{
+    flush();
+}
+
+void BinaryLogger::flush()
+{
+    char *base = mapping.load(memory_order_acquire);
+    if (base == nullptr)
+    {
+        return;
+    }
+    writeQueuedLogs();
+    msync(base, mappingSize, MS_SYNC);
+}
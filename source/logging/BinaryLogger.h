@@ -0,0 +1,173 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BINARYLOGGER_H
+#define DEVICE_CLIENT_BINARYLOGGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "BinaryLogFormat.h"
+#include "LogLevel.h"
+#include "LogQueue.h"
+#include "Logger.h"
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief Logging implementation that records log messages unformatted into a memory-mapped file
+                 *
+                 * Rather than formatting each message, the thread logging it copies the address of the format
+                 * string, a timestamp, the tag and the raw arguments into the file, in the layout described by
+                 * BinaryLogFormat. Space is reserved with a single atomic add, so there is no lock, no logging thread
+                 * and no vsnprintf on the way. Since the file is mapped, messages reach the page cache as soon as
+                 * they are logged and survive a crash of the Device Client. The data area is a ring, so the file
+                 * keeps the most recent messages.
+                 *
+                 * The file is decoded to text by the aws-iot-device-client-logdecode tool. Messages without
+                 * conversions, messages logged before start(), and messages whose format string cannot be encoded are
+                 * stored as text.
+                 */
+                class BinaryLogger final : public Logger
+                {
+                  private:
+                    /**
+                     * \brief Runtime configuration for which log file to log to.
+                     */
+                    std::string logFile = DEFAULT_LOG_FILE;
+
+                    /**
+                     * \brief Holds messages logged before the file is mapped
+                     */
+                    std::unique_ptr<LogQueue> logQueue = std::unique_ptr<LogQueue>(new LogQueue);
+
+                    /**
+                     * \brief The mapped file, nullptr until start() succeeds. The file stays mapped until the logger
+                     * is destroyed, since other threads may log to it at any time.
+                     */
+                    std::atomic<char *> mapping{nullptr};
+                    size_t mappingSize = 0;
+                    char *dictionary = nullptr;
+                    char *data = nullptr;
+
+                    /**
+                     * \brief Bytes of the dictionary and of the data ring reserved so far
+                     */
+                    std::atomic<uint64_t> dictionaryPosition{0};
+                    std::atomic<uint64_t> dataPosition{0};
+                    std::atomic<bool> dictionaryFull{false};
+
+                    /**
+                     * \brief Open addressing hash set of the addresses of the strings written to the dictionary
+                     */
+                    std::unique_ptr<std::atomic<uint64_t>[]> knownStrings;
+
+                    /**
+                     * \brief Makes sure text is in the dictionary
+                     *
+                     * @param text a format string with conversions, which must outlive the process
+                     * @return true if text is in the dictionary, false if the dictionary is full
+                     */
+                    bool addToDictionary(const char *text);
+
+                    /**
+                     * \brief Reserves size bytes for a record in the data ring
+                     *
+                     * @param size the size of the record, a multiple of BinaryLogFormat::ALIGNMENT
+                     * @param sequence set to the sequence of the block holding the record
+                     * @return where to write the record
+                     */
+                    char *reserve(size_t size, uint64_t &sequence);
+
+                    /**
+                     * \brief Fills in the header of record and copies it into the data ring
+                     */
+                    void writeRecord(
+                        char *record,
+                        size_t size,
+                        BinaryLogFormat::RecordType type,
+                        LogLevel level,
+                        const char *format,
+                        std::chrono::time_point<std::chrono::system_clock> t);
+
+                    /**
+                     * \brief Writes an already formatted message as a Text record
+                     */
+                    void writeText(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> t,
+                        const char *message);
+
+                    /**
+                     * \brief Creates and maps logFile, keeping the previous file as logFile.1
+                     *
+                     * @return true if the file was mapped
+                     */
+                    bool mapLogFile();
+
+                    /**
+                     * \brief Writes the messages waiting in logQueue to the file
+                     */
+                    void writeQueuedLogs();
+
+                  protected:
+                    virtual void queueLog(std::unique_ptr<LogMessage> message) override;
+
+                  public:
+                    /**
+                     * \brief The full path to the default binary log file for the Device Client
+                     *
+                     * Used when no log file, or the default log file of the FileLogger, is configured.
+                     */
+                    static constexpr char DEFAULT_LOG_FILE[] =
+                        "/var/log/aws-iot-device-client/aws-iot-device-client.blog";
+
+                    /**
+                     * \brief Size of the dictionary, and size and number of blocks of the data ring
+                     */
+                    static constexpr size_t DICTIONARY_SIZE = 1024 * 1024;
+                    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+                    static constexpr size_t BLOCK_COUNT = 128;
+                    /**
+                     * \brief Capacity of the set of strings written to the dictionary, a power of two
+                     */
+                    static constexpr size_t KNOWN_STRINGS_CAPACITY = 16384;
+
+                    ~BinaryLogger() override;
+
+                    virtual void vlog(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> t,
+                        const char *message,
+                        va_list args) override;
+
+                    virtual bool start(const PlainConfig &config) override;
+
+                    virtual void stop() override;
+
+                    virtual void shutdown() override;
+
+                    virtual std::unique_ptr<LogQueue> takeLogQueue() override;
+
+                    virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
+
+                    virtual LogQueue *getLogQueue() override { return logQueue.get(); }
+
+                    virtual void flush() override;
+                };
+            } // namespace Logging
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BINARYLOGGER_H
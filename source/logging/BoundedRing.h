@@ -0,0 +1,179 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BOUNDEDRING_H
+#define DEVICE_CLIENT_BOUNDEDRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief A fixed-capacity lock-free ring, the bounded MPMC queue of Dmitry Vyukov
+                 *
+                 * Any number of threads may push and pop at once. Each slot carries a sequence that tells producers
+                 * and consumers whose turn the slot is, so a push or a pop only contends on a single compare and
+                 * swap of its position.
+                 *
+                 * @tparam T the type of the values, which must be default constructible and movable
+                 */
+                template <typename T> class BoundedRing
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param requestedCapacity the number of values the ring holds, rounded up to a power of two
+                     */
+                    explicit BoundedRing(size_t requestedCapacity)
+                        : capacity(roundCapacity(requestedCapacity)), mask(capacity - 1)
+                    {
+                        slots = std::unique_ptr<Slot[]>(new Slot[capacity]);
+                        for (size_t i = 0; i < capacity; i++)
+                        {
+                            slots[i].sequence.store(i, std::memory_order_relaxed);
+                        }
+                    }
+
+                    BoundedRing(const BoundedRing &) = delete;
+                    BoundedRing &operator=(const BoundedRing &) = delete;
+
+                    /**
+                     * \brief The capacity of a BoundedRing constructed with capacity
+                     */
+                    static size_t roundCapacity(size_t requestedCapacity)
+                    {
+                        // The ring needs at least two slots, and a power of two so that positions wrap with a mask.
+                        size_t rounded = 2;
+                        while (rounded < requestedCapacity)
+                        {
+                            rounded <<= 1;
+                        }
+                        return rounded;
+                    }
+
+                    /**
+                     * \brief The number of values the ring holds
+                     */
+                    size_t getCapacity() const { return capacity; }
+
+                    /**
+                     * \brief Adds value to the ring without waiting
+                     *
+                     * @return true if value was moved into the ring, false if the ring is full, in which case value
+                     * is left untouched
+                     */
+                    bool tryPush(T &value)
+                    {
+                        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+                        for (;;)
+                        {
+                            Slot &slot = slots[pos & mask];
+                            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                            if (diff == 0)
+                            {
+                                // The slot is free for this lap, claim it.
+                                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                                {
+                                    slot.value = std::move(value);
+                                    slot.sequence.store(pos + 1, std::memory_order_release);
+                                    return true;
+                                }
+                            }
+                            else if (diff < 0)
+                            {
+                                return false; // The slot still holds the value of the previous lap, the ring is full.
+                            }
+                            else
+                            {
+                                pos = enqueuePos.load(std::memory_order_relaxed);
+                            }
+                        }
+                    }
+
+                    /**
+                     * \brief Takes the oldest value from the ring without waiting
+                     *
+                     * @return true if value was taken, false if the ring is empty
+                     */
+                    bool tryPop(T &value)
+                    {
+                        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                        for (;;)
+                        {
+                            Slot &slot = slots[pos & mask];
+                            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                            if (diff == 0)
+                            {
+                                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                                {
+                                    value = std::move(slot.value);
+                                    // Hand the slot back to producers for the next lap.
+                                    slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                                    return true;
+                                }
+                            }
+                            else if (diff < 0)
+                            {
+                                return false; // The slot has not been written yet, the ring is empty.
+                            }
+                            else
+                            {
+                                pos = dequeuePos.load(std::memory_order_relaxed);
+                            }
+                        }
+                    }
+
+                    /**
+                     * \brief Whether the ring has no value to take
+                     */
+                    bool isEmpty() const
+                    {
+                        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+                        return slots[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+                    }
+
+                  private:
+                    /**
+                     * \brief A slot of the ring. The sequence tells producers and consumers whose turn the slot is.
+                     */
+                    struct Slot
+                    {
+                        std::atomic<size_t> sequence;
+                        T value;
+                    };
+
+                    std::unique_ptr<Slot[]> slots;
+                    size_t capacity;
+                    size_t mask;
+                    /**
+                     * \brief Position of the next value to add, written by producers
+                     */
+                    std::atomic<size_t> enqueuePos{0};
+                    /**
+                     * \brief Keeps enqueuePos and dequeuePos on separate cache lines
+                     */
+                    char cacheLinePadding[64];
+                    /**
+                     * \brief Position of the next value to take, written by consumers
+                     */
+                    std::atomic<size_t> dequeuePos{0};
+                };
+            } // namespace Logging
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BOUNDEDRING_H
@@ -4,22 +4,32 @@
 #include "FileLogger.h"
 #include "../util/FileUtils.h"
 
+#include <functional>
 #include <iostream>
 #include <sys/stat.h> /* mkdir(2) */
 #include <thread>
 
-constexpr int TIMESTAMP_BUFFER_SIZE = 25;
-
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 using namespace Aws::Iot::DeviceClient::Util;
 
-constexpr int FileLogger::DEFAULT_WAIT_TIME_MILLISECONDS;
 constexpr char FileLogger::DEFAULT_LOG_FILE[];
 
 bool FileLogger::start(const PlainConfig &config)
 {
     setLogLevel(config.logConfig.deviceClientlogLevel);
+    setFlushPolicy(config.logConfig);
+    {
+        lock_guard<mutex> runLock(isRunningLock);
+        if (isRunning)
+        {
+            // The logging thread reads from logQueue and writes to outputStream, so a running logger keeps both and
+            // only takes the settings above and the overflow policy.
+            configureOverflowPolicy(*logQueue, config.logConfig);
+            return true;
+        }
+    }
+    configureLogQueue(logQueue, config.logConfig);
     if (!config.logConfig.deviceClientLogFile.empty())
     {
         logFile = config.logConfig.deviceClientLogFile;
@@ -83,7 +93,11 @@ bool FileLogger::start(const PlainConfig &config)
             }
         }
 
-        thread log_thread(&FileLogger::run, this);
+        {
+            lock_guard<mutex> runLock(isRunningLock);
+            isRunning = true;
+        }
+        thread log_thread(&FileLogger::run, this, ref(*logQueue), ref(*outputStream));
         log_thread.detach();
         return true;
     }
@@ -92,41 +106,9 @@ bool FileLogger::start(const PlainConfig &config)
     return false;
 }
 
-void FileLogger::writeLogMessage(unique_ptr<LogMessage> message) const
+void FileLogger::queueLog(unique_ptr<LogMessage> message)
 {
-    char time_buffer[TIMESTAMP_BUFFER_SIZE];
-    LogUtil::generateTimestamp(message->getTime(), TIMESTAMP_BUFFER_SIZE, time_buffer);
-
-    *outputStream << time_buffer << " " << LogLevelMarshaller::ToString(message->getLevel()) << " {"
-                  << message->getTag() << "}: " << message->getMessage() << endl;
-    outputStream->flush();
-}
-
-void FileLogger::run()
-{
-    unique_lock<mutex> runLock(isRunningLock);
-    isRunning = true;
-    runLock.unlock();
-
-    while (!needsShutdown)
-    {
-        unique_ptr<LogMessage> message = logQueue->getNextLog();
-
-        if (nullptr != message)
-        {
-            writeLogMessage(std::move(message));
-        }
-        this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_WAIT_TIME_MILLISECONDS));
-    }
-}
-
-void FileLogger::queueLog(
-    LogLevel level,
-    const char *tag,
-    std::chrono::time_point<std::chrono::system_clock> t,
-    const string &message)
-{
-    logQueue.get()->addLog(unique_ptr<LogMessage>(new LogMessage(level, tag, t, message)));
+    logQueue.get()->addLog(std::move(message));
 }
 
 void FileLogger::stop()
@@ -171,12 +153,5 @@ void FileLogger::flush()
     }
     runLock.unlock();
 
-    while (logQueue->hasNextLog())
-    {
-        unique_ptr<LogMessage> message = logQueue->getNextLog();
-        if (nullptr != message)
-        {
-            writeLogMessage(std::move(message));
-        }
-    }
-}
\ No newline at end of file
+    drainLogQueue(*logQueue, *outputStream);
+}
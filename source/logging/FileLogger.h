@@ -8,6 +8,7 @@
 #include <memory>
 #include <mutex>
 #include <stdio.h>
+#include <string>
 
 #include "LogLevel.h"
 #include "LogQueue.h"
@@ -32,18 +33,6 @@ namespace Aws
                      */
                     std::string logFile = DEFAULT_LOG_FILE;
 
-                    /**
-                     * \brief The default value in milliseconds for which Device client will wait after getting a
-                     * log message from logQueue
-                     */
-                    static constexpr int DEFAULT_WAIT_TIME_MILLISECONDS = 1;
-
-                    /**
-                     * \brief Flag used to notify underlying threads that they should discontinue any processing
-                     * so that the application can safely shutdown
-                     */
-                    bool needsShutdown = false;
-
                     std::mutex isRunningLock;
                     bool isRunning = false;
                     /**
@@ -56,14 +45,6 @@ namespace Aws
                      */
                     std::unique_ptr<std::ofstream> outputStream;
 
-                    /**
-                     * \brief Write the log message to the log file
-                     *
-                     * This method will write the log message to the file specified for logging
-                     * @param message the message to log
-                     */
-                    void writeLogMessage(std::unique_ptr<LogMessage> message) const;
-
                     /**
                      * \brief Creates the directories required as part of the full path to the desired log file
                      *
@@ -72,21 +53,7 @@ namespace Aws
                      */
                     void createLogDirectories();
 
-                    /**
-                     * \brief Begins processing of log messages in the LogQueue
-                     *
-                     * This method will begin processing of log messages in the LogQueue. The thread will process until
-                     * all of the messages are removed from the queue, and then will wait until new messages arrive in
-                     * the queue. This method will check to make sure the shutdown() method has not been called before
-                     * processing any additional messages in the queue.
-                     */
-                    void run();
-
-                    virtual void queueLog(
-                        LogLevel level,
-                        const char *tag,
-                        std::chrono::time_point<std::chrono::system_clock> t,
-                        const std::string &message) override;
+                    virtual void queueLog(std::unique_ptr<LogMessage> message) override;
 
                   public:
                     /**
@@ -108,6 +75,8 @@ namespace Aws
 
                     virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
 
+                    virtual LogQueue *getLogQueue() override { return logQueue.get(); }
+
                     virtual void flush() override;
                 };
             } // namespace Logging
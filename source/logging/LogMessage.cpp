@@ -0,0 +1,104 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LogMessage.h"
+#include "LogMessagePool.h"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+constexpr size_t LogMessage::INLINE_MESSAGE_SIZE;
+constexpr size_t LogMessage::INLINE_TAG_SIZE;
+constexpr size_t LogMessage::POOL_SIZE;
+
+/**
+ * The pool is never destroyed, since detached logger threads may still release LogMessages during static destruction.
+ */
+static LogMessagePool *messagePool()
+{
+    static LogMessagePool *pool = new LogMessagePool(sizeof(LogMessage), LogMessage::POOL_SIZE);
+    return pool;
+}
+
+LogMessage::LogMessage(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> time,
+    const std::string &message)
+    : level(level), time(time)
+{
+    setTag(tag);
+    if (message.size() < INLINE_MESSAGE_SIZE)
+    {
+        memcpy(inlineMessage, message.c_str(), message.size() + 1);
+    }
+    else
+    {
+        inlineMessage[0] = '\0';
+        spilledMessage = message;
+    }
+}
+
+LogMessage::LogMessage(
+    LogLevel level,
+    const char *tag,
+    std::chrono::time_point<std::chrono::system_clock> time,
+    const char *format,
+    va_list args)
+    : level(level), time(time)
+{
+    setTag(tag);
+    va_list spillArgs;
+    va_copy(spillArgs, args);
+    int length = vsnprintf(inlineMessage, INLINE_MESSAGE_SIZE, format, args);
+    if (length < 0)
+    {
+        inlineMessage[0] = '\0';
+    }
+    else if (static_cast<size_t>(length) >= INLINE_MESSAGE_SIZE)
+    {
+        // The message was truncated, format it again into a buffer long enough to hold it.
+        spilledMessage.resize(static_cast<size_t>(length));
+        vsnprintf(&spilledMessage[0], static_cast<size_t>(length) + 1, format, spillArgs);
+    }
+    va_end(spillArgs);
+}
+
+void LogMessage::setTag(const char *tag)
+{
+    if (tag == nullptr)
+    {
+        tag = "";
+    }
+    size_t length = strlen(tag);
+    if (length < INLINE_TAG_SIZE)
+    {
+        memcpy(inlineTag, tag, length + 1);
+    }
+    else
+    {
+        inlineTag[0] = '\0';
+        spilledTag.assign(tag, length);
+    }
+}
+
+void *LogMessage::operator new(size_t size)
+{
+    return size == sizeof(LogMessage) ? messagePool()->allocate() : ::operator new(size);
+}
+
+void LogMessage::operator delete(void *record, size_t size)
+{
+    if (size == sizeof(LogMessage))
+    {
+        messagePool()->release(record);
+    }
+    else
+    {
+        ::operator delete(record);
+    }
+}
@@ -7,8 +7,10 @@
 #include "LogLevel.h"
 
 #include <chrono>
+#include <cstdarg>
+#include <cstddef>
 #include <memory>
-#include <sstream>
+#include <string>
 
 namespace Aws
 {
@@ -22,38 +24,106 @@ namespace Aws
                  * \brief Represents all data that a Logger implementation requires to log data, including a LogLevel,
                  * a tag indicating the source of the log message, a time when the message was generated, and the
                  * associated message.
+                 *
+                 * A LogMessage is a fixed-size record. The message is formatted straight into the record and only
+                 * spills to the heap when it is longer than INLINE_MESSAGE_SIZE, and LogMessages created with new are
+                 * recycled through a LogMessagePool of POOL_SIZE preallocated records, so logging a message does not
+                 * allocate in steady state. While more than POOL_SIZE LogMessages are alive, the extra ones come
+                 * from the heap.
                  */
                 class LogMessage
                 {
+                  public:
+                    /**
+                     * \brief The longest message, including its terminating NULL, stored inside the record
+                     */
+                    static constexpr size_t INLINE_MESSAGE_SIZE = 200;
+                    /**
+                     * \brief The longest tag, including its terminating NULL, stored inside the record
+                     */
+                    static constexpr size_t INLINE_TAG_SIZE = 48;
+                    /**
+                     * \brief The number of records preallocated for LogMessages
+                     */
+                    static constexpr size_t POOL_SIZE = 1024;
+
                   private:
                     /**
                      * \brief The LogLevel [DEBUG, INFO, WARN, ERROR]
                      */
                     LogLevel level;
                     /**
-                     * \brief A tag used to indicate the source of the log message
+                     * \brief A tag used to indicate the source of the log message, if it fits in the record. The tag
+                     * is copied, since some callers build it at runtime.
                      */
-                    std::string tag;
+                    char inlineTag[INLINE_TAG_SIZE];
+                    /**
+                     * \brief The tag, if it does not fit in the record
+                     */
+                    std::string spilledTag;
                     /**
                      * \brief The time that the message was logged
                      */
                     std::chrono::time_point<std::chrono::system_clock> time;
                     /**
-                     * \brief The message to be logged
+                     * \brief The message to be logged, if it fits in the record
+                     */
+                    char inlineMessage[INLINE_MESSAGE_SIZE];
+                    /**
+                     * \brief The message to be logged, if it does not fit in the record
+                     */
+                    std::string spilledMessage;
+
+                    /**
+                     * \brief Copies tag into the record, or spills it to the heap if it is too long
                      */
-                    std::string message;
+                    void setTag(const char *tag);
 
                   public:
+                    /**
+                     * \brief Creates a LogMessage holding a copy of message
+                     *
+                     * @param level the log level
+                     * @param tag a tag that indicates where the log message is coming from
+                     * @param time a timestamp representing the time the message was created
+                     * @param message the message to log
+                     */
                     LogMessage(
                         LogLevel level,
-                        const std::string &tag,
+                        const char *tag,
                         std::chrono::time_point<std::chrono::system_clock> time,
-                        const std::string &message)
-                        : level(level), tag(tag), time(time), message(message)
-                    {
-                    }
+                        const std::string &message);
+
+                    /**
+                     * \brief Creates a LogMessage holding format formatted against args
+                     *
+                     * @param level the log level
+                     * @param tag a tag that indicates where the log message is coming from
+                     * @param time a timestamp representing the time the message was created
+                     * @param format the printf format of the message (The format string must be NULL terminated)
+                     * @param args the arguments formatted against format
+                     */
+                    LogMessage(
+                        LogLevel level,
+                        const char *tag,
+                        std::chrono::time_point<std::chrono::system_clock> time,
+                        const char *format,
+                        va_list args);
                     ~LogMessage() = default;
 
+                    LogMessage(const LogMessage &) = delete;
+                    LogMessage &operator=(const LogMessage &) = delete;
+
+                    /**
+                     * \brief Takes the memory of a LogMessage from the LogMessagePool, or from the heap if the pool
+                     * is exhausted
+                     */
+                    static void *operator new(size_t size);
+                    /**
+                     * \brief Returns the memory of a LogMessage to the LogMessagePool
+                     */
+                    static void operator delete(void *record, size_t size);
+
                     /**
                      * \brief Returns the LogLevel of the message
                      * @return the desired LogLevel o fthe message
@@ -63,7 +133,7 @@ namespace Aws
                      * \brief Returns the message tag
                      * @return the message tag
                      */
-                    std::string getTag() const { return tag; }
+                    const char *getTag() const { return spilledTag.empty() ? inlineTag : spilledTag.c_str(); }
                     /**
                      * \brief Returns the time that the message was generated
                      * @return the time that the message was generated
@@ -73,7 +143,10 @@ namespace Aws
                      * \brief Returns the log message
                      * @return the log message
                      */
-                    std::string &getMessage() { return message; }
+                    const char *getMessage() const
+                    {
+                        return spilledMessage.empty() ? inlineMessage : spilledMessage.c_str();
+                    }
                 };
             } // namespace Logging
         }     // namespace DeviceClient
@@ -0,0 +1,41 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LogMessagePool.h"
+
+#include <new>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+LogMessagePool::LogMessagePool(size_t recordSize, size_t records) : recordSize(recordSize), freeRecords(records)
+{
+    for (size_t i = 0; i < records; i++)
+    {
+        void *record = ::operator new(recordSize);
+        freeRecords.tryPush(record);
+    }
+}
+
+LogMessagePool::~LogMessagePool()
+{
+    void *record;
+    while (freeRecords.tryPop(record))
+    {
+        ::operator delete(record);
+    }
+}
+
+void *LogMessagePool::allocate()
+{
+    void *record;
+    return freeRecords.tryPop(record) ? record : ::operator new(recordSize);
+}
+
+void LogMessagePool::release(void *record)
+{
+    if (!freeRecords.tryPush(record))
+    {
+        ::operator delete(record);
+    }
+}
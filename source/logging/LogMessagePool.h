@@ -0,0 +1,74 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_LOGMESSAGEPOOL_H
+#define DEVICE_CLIENT_LOGMESSAGEPOOL_H
+
+#include "BoundedRing.h"
+#include <cstddef>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace Logging
+            {
+                /**
+                 * \brief A pool of preallocated fixed-size records, used to create LogMessages without going through
+                 * the heap
+                 *
+                 * Free records are kept in a lock-free BoundedRing, the same ring used by LogQueue, so any
+                 * thread may allocate and release records without taking a lock. When the pool is empty, records are
+                 * allocated on the heap, and released records are kept for reuse as long as the ring has room for
+                 * them.
+                 */
+                class LogMessagePool
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param recordSize the size in bytes of each record
+                     * @param records the number of records to preallocate, which rounded up to a power of two is also
+                     * the most free records kept
+                     */
+                    LogMessagePool(size_t recordSize, size_t records);
+                    ~LogMessagePool();
+
+                    LogMessagePool(const LogMessagePool &) = delete;
+                    LogMessagePool &operator=(const LogMessagePool &) = delete;
+
+                    /**
+                     * \brief Takes a free record from the pool, or allocates one if the pool is empty
+                     *
+                     * @return a record of recordSize bytes
+                     */
+                    void *allocate();
+
+                    /**
+                     * \brief Returns a record taken from allocate() to the pool, or frees it if the pool is full
+                     *
+                     * @param record the record
+                     */
+                    void release(void *record);
+
+                    /**
+                     * \brief Returns the size in bytes of each record
+                     */
+                    size_t getRecordSize() const { return recordSize; }
+
+                  private:
+                    size_t recordSize;
+                    /**
+                     * \brief The free records
+                     */
+                    BoundedRing<void *> freeRecords;
+                };
+            } // namespace Logging
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_LOGMESSAGEPOOL_H
@@ -2,60 +2,224 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "LogQueue.h"
+#include <cinttypes>
+#include <cstdio>
 #include <iostream>
 #include <thread>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 
+constexpr size_t LogQueue::DEFAULT_CAPACITY;
 constexpr int LogQueue::EMPTY_WAIT_TIME_MILLISECONDS;
 
-void LogQueue::addLog(unique_ptr<LogMessage> log)
+LogQueue::LogQueue(size_t requestedCapacity) : ring(requestedCapacity) {}
+
+bool LogQueue::take(unique_ptr<LogMessage> &log)
 {
-    unique_lock<mutex> addLock(queueLock);
-    logQueue.push_back(std::move(log));
-    addLock.unlock();
-    newLogNotifier.notify_one();
+    // The previous LogQueue holds the messages logged before the Logger implementation was replaced, so they go first.
+    LogQueue *previousQueue = previous.load(memory_order_acquire);
+    if (previousQueue != nullptr && previousQueue->take(log))
+    {
+        previousQueue->notifyProducers();
+        return true;
+    }
+    return ring.tryPop(log);
 }
 
-bool LogQueue::hasNextLog()
+void LogQueue::notifyConsumer()
 {
-    unique_lock<mutex> readLock(queueLock);
-    return !logQueue.empty();
+    // Pairs with the fence in waitForLog(): either the consumer sees the new message before sleeping, or this thread
+    // sees the consumer waiting.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (waitingConsumers.load(memory_order_relaxed) > 0)
+    {
+        lock_guard<mutex> lock(queueLock);
+        newLogNotifier.notify_one();
+    }
 }
 
-std::unique_ptr<LogMessage> LogQueue::getNextLog()
+void LogQueue::notifyProducers()
 {
-    unique_lock<mutex> readLock(queueLock);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (waitingProducers.load(memory_order_relaxed) > 0)
+    {
+        lock_guard<mutex> lock(queueLock);
+        spaceNotifier.notify_all();
+    }
+}
 
-    while (logQueue.empty() && !isShutdown)
+void LogQueue::waitForLog()
+{
+    unique_lock<mutex> waitLock(queueLock);
+    waitingConsumers.fetch_add(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (ring.isEmpty() && !isShutdown)
     {
-        newLogNotifier.wait_for(readLock, chrono::milliseconds(EMPTY_WAIT_TIME_MILLISECONDS));
+        newLogNotifier.wait_for(waitLock, chrono::milliseconds(EMPTY_WAIT_TIME_MILLISECONDS));
     }
+    waitingConsumers.fetch_sub(1, memory_order_relaxed);
+}
 
-    if (logQueue.empty())
+void LogQueue::addLog(unique_ptr<LogMessage> log)
+{
+    if (!ring.tryPush(log))
+    {
+        switch (overflowPolicy.load(memory_order_relaxed))
+        {
+            case OverflowPolicy::DropOldest:
+            {
+                // Another producer may take the slot freed here first, so retry until this message fits.
+                unique_ptr<LogMessage> oldest;
+                while (!ring.tryPush(log))
+                {
+                    // The null marker queued by shutdown() is not a message. Consumers no longer need it either,
+                    // since isShutdown keeps them from waiting.
+                    if (ring.tryPop(oldest) && oldest != nullptr)
+                    {
+                        oldest.reset();
+                        droppedSinceReport++;
+                        droppedTotal++;
+                    }
+                }
+                break;
+            }
+            case OverflowPolicy::DropNewest:
+                droppedSinceReport++;
+                droppedTotal++;
+                return;
+            case OverflowPolicy::Block:
+            {
+                auto deadline =
+                    chrono::steady_clock::now() + chrono::milliseconds(blockTimeoutMs.load(memory_order_relaxed));
+                bool added = false;
+                {
+                    unique_lock<mutex> waitLock(queueLock);
+                    waitingProducers.fetch_add(1, memory_order_relaxed);
+                    atomic_thread_fence(memory_order_seq_cst);
+                    while (!(added = ring.tryPush(log)) && !isShutdown &&
+                           spaceNotifier.wait_until(waitLock, deadline) != cv_status::timeout)
+                    {
+                    }
+                    added = added || ring.tryPush(log);
+                    waitingProducers.fetch_sub(1, memory_order_relaxed);
+                }
+                if (!added)
+                {
+                    droppedSinceReport++;
+                    droppedTotal++;
+                    return;
+                }
+                break;
+            }
+        }
+    }
+    notifyConsumer();
+}
+
+unique_ptr<LogMessage> LogQueue::takeDroppedReport()
+{
+    uint64_t dropped = droppedSinceReport.exchange(0);
+    if (dropped == 0)
     {
         return nullptr;
     }
-    else
+
+    char message[128];
+    snprintf(
+        message,
+        sizeof(message),
+        "Log queue full, dropped %" PRIu64 " log messages (%" PRIu64 " since start)",
+        dropped,
+        droppedTotal.load());
+    return unique_ptr<LogMessage>(new LogMessage(LogLevel::WARN, "LogQueue.cpp", chrono::system_clock::now(), message));
+}
+
+bool LogQueue::getNextLogs(deque<unique_ptr<LogMessage>> &logs)
+{
+    logs.clear();
+
+    if (!hasNextLog() && !isShutdown)
+    {
+        waitForLog();
+    }
+
+    // Take at most one ring worth of messages, so that a steady stream of messages does not hold back the writer.
+    unique_ptr<LogMessage> log;
+    for (size_t i = 0; i < ring.getCapacity() && take(log); i++)
     {
-        unique_ptr<LogMessage> message = std::move(logQueue.front());
-        logQueue.pop_front();
-        return message;
+        logs.push_back(std::move(log));
     }
+    if (!logs.empty())
+    {
+        notifyProducers();
+    }
+
+    unique_ptr<LogMessage> report = takeDroppedReport();
+    if (report)
+    {
+        logs.push_back(std::move(report));
+    }
+    return !logs.empty();
+}
+
+bool LogQueue::hasNextLog()
+{
+    LogQueue *previousQueue = previous.load(memory_order_acquire);
+    return !ring.isEmpty() || (previousQueue != nullptr && previousQueue->hasNextLog());
+}
+
+std::unique_ptr<LogMessage> LogQueue::getNextLog()
+{
+    unique_ptr<LogMessage> report = takeDroppedReport();
+    if (report)
+    {
+        return report;
+    }
+
+    unique_ptr<LogMessage> message;
+    while (!take(message))
+    {
+        if (isShutdown)
+        {
+            return nullptr;
+        }
+        waitForLog();
+    }
+    notifyProducers();
+    return message;
+}
+
+void LogQueue::setOverflowPolicy(OverflowPolicy policy, chrono::milliseconds blockTimeout)
+{
+    overflowPolicy = policy;
+    blockTimeoutMs = blockTimeout.count();
 }
 
 void LogQueue::shutdown()
 {
-    // Grab the lock in case there's active logging while we attempt to shutdown
-    unique_lock<mutex> shutdownLock(queueLock);
-    // We need to prepend the queue with a null message so that any waiting threads are interrupted and do not process
-    // any of the log messages.
-    logQueue.push_front(nullptr);
+    // Queue a null message so that any waiting threads are interrupted. If the ring is full, the shutdown flag alone
+    // stops the waiting.
+    unique_ptr<LogMessage> marker;
+    ring.tryPush(marker);
 
     isShutdown = true;
 
     // Force getNextEvent() to stop blocking regardless of whether there's actually a new event
     // so that we can safely shutdown
-    newLogNotifier.notify_one();
+    {
+        lock_guard<mutex> lock(queueLock);
+        newLogNotifier.notify_all();
+        spaceNotifier.notify_all();
+    }
+}
+
+void LogQueue::reopen()
+{
+    isShutdown = false;
+}
+
+void LogQueue::follow(LogQueue *previousQueue)
+{
+    previous.store(previousQueue, memory_order_release);
 }
@@ -4,10 +4,15 @@
 #ifndef DEVICE_CLIENT_LOGQUEUE_H
 #define DEVICE_CLIENT_LOGQUEUE_H
 
+#include "BoundedRing.h"
 #include "LogMessage.h"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <memory>
 #include <mutex>
 
 namespace Aws
@@ -21,9 +26,43 @@ namespace Aws
                 /**
                  * \brief A thread-safe queue used by our Logger implementations to queue incoming messages
                  * from multiple threads and process them in order
+                 *
+                 * Messages are kept in a fixed-capacity lock-free BoundedRing, so producers never contend on a lock
+                 * and memory use does not grow under a log storm. When the ring is full, the OverflowPolicy decides
+                 * which message is dropped. Dropped messages are counted and reported by a WARN message in the log
+                 * stream itself.
                  */
                 class LogQueue
                 {
+                  public:
+                    /**
+                     * \brief What addLog() does when the LogQueue is full
+                     */
+                    enum class OverflowPolicy
+                    {
+                        /** Discard the oldest queued message to make room for the new one */
+                        DropOldest,
+                        /** Discard the new message */
+                        DropNewest,
+                        /** Wait for room up to the block timeout, then discard the new message */
+                        Block
+                    };
+
+                    /**
+                     * \brief The default number of messages the LogQueue holds
+                     */
+                    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param capacity the number of messages the LogQueue holds, rounded up to a power of two
+                     */
+                    explicit LogQueue(size_t capacity = DEFAULT_CAPACITY);
+
+                    LogQueue(const LogQueue &) = delete;
+                    LogQueue &operator=(const LogQueue &) = delete;
+
                   private:
                     /**
                      * \brief Whether the LogQueue has been shutdown or not.
@@ -35,7 +74,22 @@ namespace Aws
                      */
                     static constexpr int EMPTY_WAIT_TIME_MILLISECONDS = 200;
                     /**
-                     * \brief a Mutex used to control multi-threaded access to the LogQueue
+                     * \brief The queued messages
+                     */
+                    BoundedRing<std::unique_ptr<LogMessage>> ring;
+
+                    std::atomic<OverflowPolicy> overflowPolicy{OverflowPolicy::DropOldest};
+                    std::atomic<int64_t> blockTimeoutMs{100};
+
+                    /**
+                     * \brief Messages dropped since the last report, and in total
+                     */
+                    std::atomic<uint64_t> droppedSinceReport{0};
+                    std::atomic<uint64_t> droppedTotal{0};
+
+                    /**
+                     * \brief a Mutex only used to sleep while the LogQueue is empty or full, never to add or take
+                     * messages
                      */
                     std::mutex queueLock;
                     /**
@@ -44,14 +98,54 @@ namespace Aws
                      */
                     std::condition_variable newLogNotifier;
                     /**
-                     * \brief Responsible for queuing the LogMessages upon arrival for processing
+                     * \brief Used to wake up producers blocked on a full LogQueue
+                     */
+                    std::condition_variable spaceNotifier;
+                    /**
+                     * \brief Number of threads sleeping on newLogNotifier and spaceNotifier, so that the other side
+                     * only takes queueLock to notify when someone is actually waiting
+                     */
+                    std::atomic<int> waitingConsumers{0};
+                    std::atomic<int> waitingProducers{0};
+
+                    /**
+                     * \brief The LogQueue of a replaced Logger implementation, see follow()
+                     */
+                    std::atomic<LogQueue *> previous{nullptr};
+
+                    /**
+                     * \brief Takes the oldest message of the previous LogQueue, if any, or else of the ring, without
+                     * waiting
+                     *
+                     * @return true if log was taken, false if both are empty
+                     */
+                    bool take(std::unique_ptr<LogMessage> &log);
+                    /**
+                     * \brief Waits up to EMPTY_WAIT_TIME_MILLISECONDS for a message, unless the LogQueue is shut down
+                     */
+                    void waitForLog();
+                    /**
+                     * \brief Wakes up a consumer waiting for a message, if any
+                     */
+                    void notifyConsumer();
+                    /**
+                     * \brief Wakes up producers waiting for room, if any
                      */
-                    std::deque<std::unique_ptr<LogMessage>> logQueue;
+                    void notifyProducers();
+                    /**
+                     * \brief Builds the WARN message reporting messages dropped since the last report
+                     *
+                     * @return the report, or null if no message was dropped
+                     */
+                    std::unique_ptr<LogMessage> takeDroppedReport();
 
                   public:
                     /**
                      * \brief Adds a single log to the LogQueue.
                      *
+                     * If the LogQueue is full, the overflow policy decides whether this or the oldest message is
+                     * dropped.
+                     *
                      * @param log the log to add to the LogQueue
                      */
                     void addLog(std::unique_ptr<LogMessage> log);
@@ -62,6 +156,19 @@ namespace Aws
                      */
                     std::unique_ptr<LogMessage> getNextLog();
 
+                    /**
+                     * \brief Gets every log message in the LogQueue at once.
+                     *
+                     * Waits up to EMPTY_WAIT_TIME_MILLISECONDS while the LogQueue is empty, then moves the pending
+                     * messages into logs, at most the capacity of the LogQueue per call. Null messages, such as the one
+                     * queued by shutdown(), are included. If messages were dropped since the last call, a WARN message
+                     * reporting them is appended.
+                     *
+                     * @param logs receives the log messages in order, replacing its content
+                     * @return true if there was a message present, false otherwise
+                     */
+                    bool getNextLogs(std::deque<std::unique_ptr<LogMessage>> &logs);
+
                     /**
                      * \brief Determine whether the LogQueue has a message available
                      *
@@ -69,6 +176,32 @@ namespace Aws
                      */
                     bool hasNextLog();
 
+                    /**
+                     * \brief Sets what addLog() does when the LogQueue is full
+                     *
+                     * @param policy the overflow policy
+                     * @param blockTimeout how long addLog() waits for room with OverflowPolicy::Block
+                     */
+                    void setOverflowPolicy(OverflowPolicy policy, std::chrono::milliseconds blockTimeout);
+
+                    /**
+                     * \brief The number of messages the LogQueue holds
+                     */
+                    size_t getCapacity() const { return ring.getCapacity(); }
+
+                    /**
+                     * \brief The capacity of a LogQueue constructed with capacity
+                     */
+                    static size_t roundCapacity(size_t capacity)
+                    {
+                        return BoundedRing<std::unique_ptr<LogMessage>>::roundCapacity(capacity);
+                    }
+
+                    /**
+                     * \brief The number of messages dropped because the LogQueue was full
+                     */
+                    uint64_t getDroppedCount() const { return droppedTotal; }
+
                     /**
                      * \brief Force all consumers to stop waiting so that they can flush the queue
                      * and end any waiting behavior that might prevent the thread from shutting down.
@@ -78,6 +211,31 @@ namespace Aws
                      * whether there is a log message or not
                      */
                     void shutdown();
+
+                    /**
+                     * \brief Undo shutdown(), so that consumers wait for messages again
+                     *
+                     * Used when a LogQueue is handed from a stopped Logger implementation to a new one.
+                     */
+                    void reopen();
+
+                    /**
+                     * \brief Makes consumers of this LogQueue also take the messages added to previousQueue, before
+                     * their own
+                     *
+                     * Used when a Logger implementation is replaced: threads still holding the replaced Logger keep
+                     * adding to its LogQueue, and those messages are handed out by the LogQueue of the new one. Must
+                     * be called before the LogQueue is handed to the new Logger implementation, and previousQueue
+                     * must outlive it.
+                     *
+                     * @param previousQueue the LogQueue of the replaced Logger implementation
+                     */
+                    void follow(LogQueue *previousQueue);
+
+                    /**
+                     * \brief The LogQueue passed to follow(), nullptr if none
+                     */
+                    LogQueue *getFollowed() const { return previous.load(std::memory_order_acquire); }
                 };
             } // namespace Logging
         }     // namespace DeviceClient
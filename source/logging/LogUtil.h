@@ -0,0 +1,41 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_LOGUTIL_H
+#define DEVICE_CLIENT_LOGUTIL_H
+
+#include "LogMessage.h"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace LogUtil
+            {
+                /**
+                 * Generates a timestamp to be applied to a log entry
+                 * @param t the current time
+                 * @param timeBuffer a buffer to store the timestamp in
+                 */
+                void generateTimestamp(
+                    std::chrono::time_point<std::chrono::system_clock> t,
+                    size_t bufferSize,
+                    char *timeBuffer);
+
+                /**
+                 * Appends a log message to buffer as one line of log output
+                 * @param buffer the buffer holding a batch of log output
+                 * @param message the message to append
+                 */
+                void appendLogLine(std::string &buffer, Logging::LogMessage &message);
+            } // namespace LogUtil
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_LOGUTIL_H
@@ -3,33 +3,143 @@
 
 #include "Logger.h"
 #include <chrono>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
 
 using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
 using namespace std;
 using namespace std::chrono;
 
-constexpr char TIMESTAMP_FORMAT[] =
-    "%Y-%m-%dT%H:%M:%S."; // ISO 8601 "2011-10-08T07:07:09.178Z", ms will be calculated last
+void Logger::setFlushPolicy(const PlainConfig::LogConfig &config)
+{
+    if (config.deviceClientLogFlushPolicy == PlainConfig::LogConfig::LOG_FLUSH_INTERVAL)
+    {
+        flushPolicy = FlushPolicy::Interval;
+    }
+    else if (config.deviceClientLogFlushPolicy == PlainConfig::LogConfig::LOG_FLUSH_ERROR)
+    {
+        flushPolicy = FlushPolicy::Error;
+    }
+    else
+    {
+        flushPolicy = FlushPolicy::Batch;
+    }
+    flushInterval = milliseconds(config.deviceClientLogFlushIntervalMs);
+}
+
+bool Logger::flushDue(bool wroteError)
+{
+    bool due = true;
+    auto now = steady_clock::now();
+    switch (flushPolicy)
+    {
+        case FlushPolicy::Batch:
+            break;
+        case FlushPolicy::Interval:
+            due = now - lastFlush >= flushInterval;
+            break;
+        case FlushPolicy::Error:
+            due = wroteError;
+            break;
+    }
+    if (due)
+    {
+        lastFlush = now;
+    }
+    return due;
+}
+
+void Logger::configureLogQueue(unique_ptr<LogQueue> &queue, const PlainConfig::LogConfig &config)
+{
+    size_t capacity = static_cast<size_t>(config.deviceClientLogQueueCapacity);
+    if (queue->getCapacity() != LogQueue::roundCapacity(capacity))
+    {
+        unique_ptr<LogQueue> resized = unique_ptr<LogQueue>(new LogQueue(capacity));
+        while (queue->hasNextLog())
+        {
+            resized->addLog(queue->getNextLog());
+        }
+        // Keep taking the messages still added to the LogQueue of a replaced Logger implementation.
+        resized->follow(queue->getFollowed());
+        queue = std::move(resized);
+    }
+    configureOverflowPolicy(*queue, config);
+}
+
+void Logger::configureOverflowPolicy(LogQueue &queue, const PlainConfig::LogConfig &config)
+{
+    LogQueue::OverflowPolicy policy = LogQueue::OverflowPolicy::DropOldest;
+    if (config.deviceClientLogOverflowPolicy == PlainConfig::LogConfig::LOG_OVERFLOW_DROP_NEWEST)
+    {
+        policy = LogQueue::OverflowPolicy::DropNewest;
+    }
+    else if (config.deviceClientLogOverflowPolicy == PlainConfig::LogConfig::LOG_OVERFLOW_BLOCK)
+    {
+        policy = LogQueue::OverflowPolicy::Block;
+    }
+    queue.setOverflowPolicy(policy, milliseconds(config.deviceClientLogOverflowBlockMs));
+}
 
-void LogUtil::generateTimestamp(
-    std::chrono::time_point<std::chrono::system_clock> t,
-    size_t bufferSize,
-    char *timeBuffer)
+bool Logger::writeLogMessages(deque<unique_ptr<LogMessage>> &messages, string &buffer, ostream &output)
 {
-    auto ms = duration_cast<milliseconds>(t.time_since_epoch()) % 1000;
-    auto timer = system_clock::to_time_t(t);
-    struct tm buf;
-    std::tm bt = *gmtime_r(&timer, &buf);
-
-    std::ostringstream time_stream;
-    time_stream << std::put_time(&bt, TIMESTAMP_FORMAT);
-    time_stream << std::setfill('0') << std::setw(3) << ms.count();
-    time_stream << "Z";
-
-    const string timestamp = time_stream.str();
-    timestamp.copy(timeBuffer, bufferSize);
-    timeBuffer[bufferSize - 1] = '\0';
+    buffer.clear();
+    bool wroteError = false;
+    for (auto &message : messages)
+    {
+        if (nullptr != message)
+        {
+            LogUtil::appendLogLine(buffer, *message);
+            wroteError = wroteError || message->getLevel() == LogLevel::ERROR;
+        }
+    }
+
+    lock_guard<mutex> lock(writeLock);
+    output.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+    return wroteError;
+}
+
+void Logger::run(LogQueue &queue, ostream &output)
+{
+    // Take every queued message at once and write them with a single write, rather than a write, a flush and a
+    // sleep per message.
+    deque<unique_ptr<LogMessage>> messages;
+    string buffer;
+    bool unflushed = false;
+    bool wroteError = false;
+    while (!needsShutdown)
+    {
+        if (queue.getNextLogs(messages))
+        {
+            wroteError = writeLogMessages(messages, buffer, output) || wroteError;
+            unflushed = true;
+        }
+
+        // getNextLogs() returns at least every 200 ms while idle, so interval flushes are not held back.
+        if (unflushed && flushDue(wroteError))
+        {
+            lock_guard<mutex> lock(writeLock);
+            output.flush();
+            unflushed = false;
+            wroteError = false;
+        }
+    }
+
+    if (unflushed)
+    {
+        lock_guard<mutex> lock(writeLock);
+        output.flush();
+    }
+}
+
+void Logger::drainLogQueue(LogQueue &queue, ostream &output)
+{
+    deque<unique_ptr<LogMessage>> messages;
+    string buffer;
+    while (queue.hasNextLog())
+    {
+        queue.getNextLogs(messages);
+        writeLogMessages(messages, buffer, output);
+    }
+
+    lock_guard<mutex> lock(writeLock);
+    output.flush();
 }
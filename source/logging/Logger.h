@@ -8,10 +8,16 @@
 #include "../util/StringUtils.h"
 #include "LogLevel.h"
 #include "LogQueue.h"
+#include "LogUtil.h"
+#include <atomic>
 #include <chrono>
 #include <cstdarg>
 #include <ctime>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
 #include <utility>
 
 namespace Aws
@@ -20,19 +26,6 @@ namespace Aws
     {
         namespace DeviceClient
         {
-            namespace LogUtil
-            {
-                /**
-                 * Generates a timestamp to be applied to a log entry
-                 * @param t the current time
-                 * @param timeBuffer a buffer to store the timestamp in
-                 */
-                void generateTimestamp(
-                    std::chrono::time_point<std::chrono::system_clock> t,
-                    size_t bufferSize,
-                    char *timeBuffer);
-            } // namespace LogUtil
-
             namespace Logging
             {
                 /**
@@ -52,7 +45,7 @@ namespace Aws
                     /**
                      * \brief The runtime log level for the IoT Device Client
                      */
-                    int logLevel = (int)LogLevel::DEBUG;
+                    std::atomic<int> logLevel{(int)LogLevel::DEBUG};
 
                     /**
                      * \brief Implemented by the underlying logger implementation to pass responsibility for managing
@@ -62,16 +55,9 @@ namespace Aws
                      * accept and eventually process the incoming log message. To reduce complications induced by
                      * multithreading, the underlying logger implementation should queue the message for processing by
                      * another thread if possible.
-                     * @param level the log level
-                     * @param tag a tag that indicates where the log message is coming from
-                     * @param t a timestamp representing the time the message was created
-                     * @param message the message to log
+                     * @param message the formatted log message
                      */
-                    virtual void queueLog(
-                        LogLevel level,
-                        const char *tag,
-                        std::chrono::time_point<std::chrono::system_clock> t,
-                        const std::string &message) = 0;
+                    virtual void queueLog(std::unique_ptr<LogMessage> message) = 0;
 
                     /**
                      * \brief Sets the level of the Logger implementation (DEBUG, INFO, WARN, ERROR)
@@ -80,10 +66,121 @@ namespace Aws
                      */
                     void setLogLevel(int level) { logLevel = level; }
 
+                    /**
+                     * \brief When log output written by the Logger implementation is flushed
+                     */
+                    enum class FlushPolicy
+                    {
+                        Batch,
+                        Interval,
+                        Error
+                    };
+                    FlushPolicy flushPolicy = FlushPolicy::Batch;
+                    std::chrono::milliseconds flushInterval{1000};
+                    std::chrono::steady_clock::time_point lastFlush;
+
+                    /**
+                     * \brief Sets the flush policy of the Logger implementation from the logging configuration
+                     *
+                     * @param config the logging configuration
+                     */
+                    void setFlushPolicy(const PlainConfig::LogConfig &config);
+
+                    /**
+                     * \brief Returns true when output written since the last flush should be flushed now
+                     *
+                     * Output is flushed after every batch, once flushInterval has passed since the last flush, or
+                     * once an ERROR message was written, depending on the flush policy. Returning true records the
+                     * flush.
+                     *
+                     * @param wroteError whether an ERROR message was written since the last flush
+                     */
+                    bool flushDue(bool wroteError);
+
+                    /**
+                     * \brief Applies the queue capacity and overflow policy of the logging configuration to queue
+                     *
+                     * If the capacity changes, queue is replaced by a new LogQueue and the pending messages are moved
+                     * into it, so this must not be called while a logging thread reads from queue.
+                     *
+                     * @param queue the LogQueue of the Logger implementation
+                     * @param config the logging configuration
+                     */
+                    static void configureLogQueue(
+                        std::unique_ptr<LogQueue> &queue,
+                        const PlainConfig::LogConfig &config);
+
+                    /**
+                     * \brief Applies the overflow policy of the logging configuration to queue, in place
+                     *
+                     * @param queue the LogQueue of the Logger implementation
+                     * @param config the logging configuration
+                     */
+                    static void configureOverflowPolicy(LogQueue &queue, const PlainConfig::LogConfig &config);
+
+                    /**
+                     * \brief Flag used to notify the logging thread that it should stop processing messages so that
+                     * the application can safely shutdown
+                     */
+                    std::atomic<bool> needsShutdown{false};
+
+                    /**
+                     * \brief Serializes writes to the output of the Logger implementation by the logging thread and
+                     * flush()
+                     */
+                    std::mutex writeLock;
+
+                    /**
+                     * \brief Writes a batch of log messages to output
+                     *
+                     * The messages are formatted into buffer, which is written to output at once. The output is
+                     * flushed according to the flush policy by the caller.
+                     *
+                     * @param messages the messages to log, null messages are skipped
+                     * @param buffer buffer reused across batches to format the messages
+                     * @param output the stream to write to
+                     * @return true if an ERROR message was written
+                     */
+                    bool writeLogMessages(
+                        std::deque<std::unique_ptr<LogMessage>> &messages,
+                        std::string &buffer,
+                        std::ostream &output);
+
+                    /**
+                     * \brief Writes the messages of queue to output until needsShutdown is set
+                     *
+                     * Run by the logging thread of Logger implementations that write text to a stream. Every queued
+                     * message is taken at once and written with a single write, and output is flushed according to
+                     * the flush policy.
+                     *
+                     * @param queue the LogQueue of the Logger implementation
+                     * @param output the stream to write to
+                     */
+                    void run(LogQueue &queue, std::ostream &output);
+
+                    /**
+                     * \brief Writes the messages left in queue to output and flushes it, from the calling thread
+                     *
+                     * @param queue the LogQueue of the Logger implementation
+                     * @param output the stream to write to
+                     */
+                    void drainLogQueue(LogQueue &queue, std::ostream &output);
+
                   public:
                     // Logger inherited by FileLogger. Make destructor virtual to avoid memory leak.
                     virtual ~Logger() = default;
 
+                    /**
+                     * \brief Whether messages of level are logged with the current logging level
+                     *
+                     * @param level the log level
+                     * @return true if messages of level are logged, false if logging them is a NOOP
+                     */
+                    bool isEnabled(LogLevel level) const
+                    {
+                        return logLevel.load(std::memory_order_relaxed) >= (int)level;
+                    }
+
                     /**
                      * \brief Formats the provided log message against variadic arguments and then
                      * passes the message to the underlying logger implementation for processing
@@ -100,8 +197,8 @@ namespace Aws
                         const char *message,
                         va_list args)
                     {
-                        std::string formattedMessage = Util::vFormatMessage(message, args);
-                        queueLog(level, tag, t, formattedMessage);
+                        // The message is formatted straight into a pooled LogMessage, see LogMessage.h
+                        queueLog(std::unique_ptr<LogMessage>(new LogMessage(level, tag, t, message, args)));
                     }
 
                     /**
@@ -245,6 +342,11 @@ namespace Aws
                      */
                     virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) = 0;
 
+                    /**
+                     * \brief The LogQueue of the logger implementation, which other threads may be adding to
+                     */
+                    virtual LogQueue *getLogQueue() = 0;
+
                     /**
                      * \brief Flush the log output from the queue synchronously
                      *
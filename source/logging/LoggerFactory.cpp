@@ -7,31 +7,89 @@ using namespace std;
 using namespace Aws::Iot::DeviceClient;
 using namespace Aws::Iot::DeviceClient::Logging;
 
+constexpr char LoggerFactory::TAG[];
+
 shared_ptr<Logger> LoggerFactory::logger = std::make_shared<StdOutLogger>();
+atomic<Logger *> LoggerFactory::activeLogger{LoggerFactory::logger.get()};
+vector<shared_ptr<Logger>> *LoggerFactory::loggers = new vector<shared_ptr<Logger>>{LoggerFactory::logger};
+mutex LoggerFactory::reconfigureLock;
+string LoggerFactory::logFile = PlainConfig::LogConfig().deviceClientLogFile;
 
 shared_ptr<Logger> LoggerFactory::getLoggerInstance()
 {
+    lock_guard<mutex> lock(reconfigureLock);
     return LoggerFactory::logger;
 }
 
+bool LoggerFactory::isLoggerType(const string &type)
+{
+    if (type == PlainConfig::LogConfig::LOG_TYPE_FILE)
+    {
+        return dynamic_cast<FileLogger *>(logger.get()) != nullptr;
+    }
+    if (type == PlainConfig::LogConfig::LOG_TYPE_BINARY)
+    {
+        return dynamic_cast<BinaryLogger *>(logger.get()) != nullptr;
+    }
+    return dynamic_cast<StdOutLogger *>(logger.get()) != nullptr;
+}
+
 bool LoggerFactory::reconfigure(const PlainConfig &config)
 {
-    if (config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_FILE &&
-        dynamic_cast<FileLogger *>(logger.get()) == nullptr)
+    lock_guard<mutex> lock(reconfigureLock);
+
+    size_t capacity = static_cast<size_t>(config.logConfig.deviceClientLogQueueCapacity);
+    bool started;
+    if (isLoggerType(config.logConfig.deviceClientLogtype) &&
+        logger->getLogQueue()->getCapacity() == LogQueue::roundCapacity(capacity) &&
+        config.logConfig.deviceClientLogFile == logFile)
+    {
+        // The logger is only replaced when its type, its queue capacity or its log file changes. Starting a running
+        // logger applies the other settings in place.
+        started = logger->start(config);
+    }
+    else
     {
-        logger->stop();
-        unique_ptr<LogQueue> logQueue = logger->takeLogQueue();
-        logger.reset(new FileLogger);
-        logger->setLogQueue(std::move(logQueue));
+        shared_ptr<Logger> next;
+        if (config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_FILE)
+        {
+            next = std::make_shared<FileLogger>();
+        }
+        else if (config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_BINARY)
+        {
+            next = std::make_shared<BinaryLogger>();
+        }
+        else
+        {
+            next = std::make_shared<StdOutLogger>();
+        }
+
+        // Other threads may still hold the current logger and keep adding to its queue, so the queue is not taken
+        // from it. The queue of the next logger hands out its messages instead, and the next logger is published
+        // before the current one stops.
+        LogQueue *previousQueue = logger->getLogQueue();
+        unique_ptr<LogQueue> logQueue = unique_ptr<LogQueue>(new LogQueue(capacity));
+        logQueue->follow(previousQueue);
+        next->setLogQueue(std::move(logQueue));
+        started = next->start(config);
+
+        loggers->push_back(next);
+        shared_ptr<Logger> previous = logger;
+        logger = next;
+        activeLogger.store(logger.get(), memory_order_release);
+
+        previous->stop();
+        previousQueue->reopen();
     }
-    else if (
-        config.logConfig.deviceClientLogtype == PlainConfig::LogConfig::LOG_TYPE_STDOUT &&
-        dynamic_cast<StdOutLogger *>(logger.get()) == nullptr)
+    logFile = config.logConfig.deviceClientLogFile;
+
+    if (config.logConfig.deviceClientlogLevel > COMPILED_LOG_LEVEL)
     {
-        logger->stop();
-        unique_ptr<LogQueue> logQueue = logger->takeLogQueue();
-        logger.reset(new StdOutLogger);
-        logger->setLogQueue(std::move(logQueue));
+        LOGM_WARN(
+            TAG,
+            "Log level %s is not compiled into this build, the most verbose level logged is %s",
+            LogLevelMarshaller::ToString(static_cast<LogLevel>(config.logConfig.deviceClientlogLevel)),
+            LogLevelMarshaller::ToString(static_cast<LogLevel>(COMPILED_LOG_LEVEL)));
     }
-    return logger->start(config);
-}
\ No newline at end of file
+    return started;
+}
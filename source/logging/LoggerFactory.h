@@ -4,6 +4,37 @@
 #ifndef DEVICE_CLIENT_LOGGERFACTORY_H
 #define DEVICE_CLIENT_LOGGERFACTORY_H
 
+/**
+ * \brief The most verbose log level compiled into the device client, as the value of its LogLevel (ERROR 0, WARN 1,
+ * INFO 2, DEBUG 3)
+ *
+ * Log statements of more verbose levels are removed by the compiler. Set by the COMPILED_LOG_LEVEL CMake option.
+ */
+#ifndef COMPILED_LOG_LEVEL
+#    define COMPILED_LOG_LEVEL 3
+#endif
+
+/**
+ * \brief Log through the given method of the active logger if level is enabled
+ *
+ * The level is checked before any argument is evaluated, so a disabled log statement neither formats its message nor
+ * reads the clock. Levels more verbose than COMPILED_LOG_LEVEL are a constant false condition and compiled out.
+ *
+ * @param level the LogLevel of the message
+ * @param method the Logger method logging at that level
+ * @param ... the arguments of the Logger method
+ */
+#define DC_LOG_AT_LEVEL(level, method, ...)                                                                            \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (static_cast<int>(Aws::Iot::DeviceClient::Logging::LogLevel::level) <= COMPILED_LOG_LEVEL &&                \
+            Aws::Iot::DeviceClient::Logging::LoggerFactory::isEnabled(                                                 \
+                Aws::Iot::DeviceClient::Logging::LogLevel::level))                                                     \
+        {                                                                                                              \
+            Aws::Iot::DeviceClient::Logging::LoggerFactory::getLogger()->method(__VA_ARGS__);                          \
+        }                                                                                                              \
+    } while (false)
+
 /**
  * \brief Log INFO message
  *
@@ -11,7 +42,8 @@
  * @param message the information message to be logged (The message string must be NULL terminated)
  */
 #define LOG_INFO(tag, message)                                                                                         \
-    LoggerFactory::getLoggerInstance().get()->info(tag, std::chrono::system_clock::now(), message)
+    DC_LOG_AT_LEVEL(INFO, info, tag, std::chrono::system_clock::now(), message)
+
 /**
  * \brief Log DEBUG message
  *
@@ -19,7 +51,8 @@
  * @param message the debug message to be logged (The message string must be NULL terminated)
  */
 #define LOG_DEBUG(tag, message)                                                                                        \
-    LoggerFactory::getLoggerInstance().get()->debug(tag, std::chrono::system_clock::now(), message)
+    DC_LOG_AT_LEVEL(DEBUG, debug, tag, std::chrono::system_clock::now(), message)
+
 /**
  * \brief Log WARN message
  *
@@ -27,7 +60,8 @@
  * @param message the warning message to be logged (The message string must be NULL terminated)
  */
 #define LOG_WARN(tag, message)                                                                                         \
-    LoggerFactory::getLoggerInstance().get()->warn(tag, std::chrono::system_clock::now(), message)
+    DC_LOG_AT_LEVEL(WARN, warn, tag, std::chrono::system_clock::now(), message)
+
 /**
  * \brief Log ERROR message
  *
@@ -35,7 +69,7 @@
  * @param message the error message to be logged (The message string must be NULL terminated)
  */
 #define LOG_ERROR(tag, message)                                                                                        \
-    LoggerFactory::getLoggerInstance().get()->error(tag, std::chrono::system_clock::now(), message)
+    DC_LOG_AT_LEVEL(ERROR, error, tag, std::chrono::system_clock::now(), message)
 
 /**
  * \brief Log INFO message
@@ -45,7 +79,8 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_INFO(tag, message, ...)                                                                                   \
-    LoggerFactory::getLoggerInstance().get()->info(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    DC_LOG_AT_LEVEL(INFO, info, tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+
 /**
  * \brief Log DEBUG message
  *
@@ -54,7 +89,8 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_DEBUG(tag, message, ...)                                                                                  \
-    LoggerFactory::getLoggerInstance().get()->debug(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    DC_LOG_AT_LEVEL(DEBUG, debug, tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+
 /**
  * \brief Log WARN message
  *
@@ -63,7 +99,8 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_WARN(tag, message, ...)                                                                                   \
-    LoggerFactory::getLoggerInstance().get()->warn(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    DC_LOG_AT_LEVEL(WARN, warn, tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+
 /**
  * \brief Log ERROR message
  *
@@ -72,14 +109,19 @@
  * @param ... additional arguments used in the format string
  */
 #define LOGM_ERROR(tag, message, ...)                                                                                  \
-    LoggerFactory::getLoggerInstance().get()->error(tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
+    DC_LOG_AT_LEVEL(ERROR, error, tag, std::chrono::system_clock::now(), message, __VA_ARGS__)
 
 #include "../config/Config.h"
+#include "BinaryLogger.h"
 #include "FileLogger.h"
 #include "Logger.h"
 #include "StdOutLogger.h"
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace Aws
 {
@@ -104,6 +146,34 @@ namespace Aws
                      * \brief The logger implementation
                      */
                     static std::shared_ptr<Logger> logger;
+                    /**
+                     * \brief The logger implementation as read by the logging macros, without touching the reference
+                     * count of logger
+                     */
+                    static std::atomic<Logger *> activeLogger;
+                    /**
+                     * \brief Every Logger implementation created by the LoggerFactory
+                     *
+                     * They are never destroyed, not even at exit, because other threads may still hold their raw
+                     * pointer, and their detached logging thread may still be running while static objects are
+                     * destroyed.
+                     */
+                    static std::vector<std::shared_ptr<Logger>> *loggers;
+                    /**
+                     * \brief Serializes reconfigure() and getLoggerInstance()
+                     */
+                    static std::mutex reconfigureLock;
+                    /**
+                     * \brief The log file of the logging configuration logger was started with
+                     */
+                    static std::string logFile;
+
+                    /**
+                     * \brief Whether logger is the implementation of the configured log type
+                     *
+                     * @param type the log type of the logging configuration
+                     */
+                    static bool isLoggerType(const std::string &type);
 
                   public:
                     /**
@@ -113,6 +183,21 @@ namespace Aws
                      */
                     static std::shared_ptr<Logger> getLoggerInstance();
 
+                    /**
+                     * \brief Returns the active logger instance without copying a shared_ptr
+                     *
+                     * The pointer stays valid for the lifetime of the process, even after reconfigure() replaced the
+                     * logger implementation.
+                     *
+                     * @return the active Logger
+                     */
+                    static Logger *getLogger() { return activeLogger.load(std::memory_order_acquire); }
+
+                    /**
+                     * \brief Whether messages of level are logged by the active logger instance
+                     */
+                    static bool isEnabled(LogLevel level) { return getLogger()->isEnabled(level); }
+
                     /**
                      * \brief Reconfigure the logger to use a new set of settings. This may include changing the
                      * log level or switching between logger implementations.
@@ -3,45 +3,26 @@
 
 #include "StdOutLogger.h"
 
+#include <functional>
 #include <iostream>
-#include <sstream>
 #include <thread>
 
-constexpr int TIMESTAMP_BUFFER_SIZE = 25;
-
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
 
-constexpr int StdOutLogger::DEFAULT_WAIT_TIME_MILLISECONDS;
-
-void StdOutLogger::writeLogMessage(unique_ptr<LogMessage> message) const
-{
-    char time_buffer[TIMESTAMP_BUFFER_SIZE];
-    LogUtil::generateTimestamp(message->getTime(), TIMESTAMP_BUFFER_SIZE, time_buffer);
-
-    cout << time_buffer << " " << LogLevelMarshaller::ToString(message->getLevel()) << " {" << message->getTag()
-         << "}: " << message->getMessage() << endl;
-}
-
-void StdOutLogger::run()
-{
-    while (!needsShutdown)
-    {
-        unique_ptr<LogMessage> message = logQueue->getNextLog();
-
-        if (nullptr != message)
-        {
-            writeLogMessage(std::move(message));
-        }
-        this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_WAIT_TIME_MILLISECONDS));
-    }
-}
-
 bool StdOutLogger::start(const PlainConfig &config)
 {
     setLogLevel(config.logConfig.deviceClientlogLevel);
+    setFlushPolicy(config.logConfig);
+    if (isRunning.exchange(true))
+    {
+        // The logging thread reads from logQueue, so a running logger keeps it and only takes its overflow policy.
+        configureOverflowPolicy(*logQueue, config.logConfig);
+        return true;
+    }
+    configureLogQueue(logQueue, config.logConfig);
 
-    thread log_thread(&StdOutLogger::run, this);
+    thread log_thread(&StdOutLogger::run, this, ref(*logQueue), ref(cout));
     log_thread.detach();
 
     return true;
@@ -76,21 +57,10 @@ void StdOutLogger::shutdown()
 
 void StdOutLogger::flush()
 {
-    while (logQueue->hasNextLog())
-    {
-        unique_ptr<LogMessage> message = logQueue->getNextLog();
-        if (nullptr != message)
-        {
-            writeLogMessage(std::move(message));
-        }
-    }
+    drainLogQueue(*logQueue, cout);
 }
 
-void StdOutLogger::queueLog(
-    LogLevel level,
-    const char *tag,
-    std::chrono::time_point<std::chrono::system_clock> t,
-    const std::string &message)
+void StdOutLogger::queueLog(unique_ptr<LogMessage> message)
 {
-    logQueue.get()->addLog(unique_ptr<LogMessage>(new LogMessage(level, tag, t, message)));
+    logQueue.get()->addLog(std::move(message));
 }
@@ -8,8 +8,11 @@
 #include "LogQueue.h"
 #include "Logger.h"
 
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <string>
 
 namespace Aws
 {
@@ -24,43 +27,18 @@ namespace Aws
                  */
                 class StdOutLogger final : public Logger
                 {
-                    /**
-                     * \brief Flag used to notify underlying threads that they should discontinue any processing
-                     * so that the application can safely shutdown
-                     */
-                    bool needsShutdown = false;
-                    /**
-                     * \brief The default value in milliseconds for which Device client will wait after getting a
-                     * log message from logQueue
-                     */
-                    static constexpr int DEFAULT_WAIT_TIME_MILLISECONDS = 1;
                     /**
                      * \brief a LogQueue instance used to queue incoming log messages for processing
                      */
                     std::unique_ptr<LogQueue> logQueue = std::unique_ptr<LogQueue>(new LogQueue);
+
                     /**
-                     * \brief Begins processing of log messages in the LogQueue
-                     *
-                     * This method will begin processing of log messages in the LogQueue. The thread will process until
-                     * all of the messages are removed from the queue, and then will wait until new messages arrive in
-                     * the queue. This method will check to make sure the shutdown() method has not been called before
-                     * processing any additional messages in the queue.
-                     */
-                    void run();
-                    /**
-                     * \brief Write the log message to standard output
-                     *
-                     * This method will write the log message to the file specified for logging
-                     * @param message the message to log
+                     * \brief Whether the logging thread has been started
                      */
-                    void writeLogMessage(std::unique_ptr<LogMessage> message) const;
+                    std::atomic<bool> isRunning{false};
 
                   protected:
-                    virtual void queueLog(
-                        LogLevel level,
-                        const char *tag,
-                        std::chrono::time_point<std::chrono::system_clock> t,
-                        const std::string &message) override;
+                    virtual void queueLog(std::unique_ptr<LogMessage> message) override;
 
                   public:
                     virtual bool start(const PlainConfig &config) override;
@@ -73,6 +51,8 @@ namespace Aws
 
                     virtual void setLogQueue(std::unique_ptr<LogQueue> logQueue) override;
 
+                    virtual LogQueue *getLogQueue() override { return logQueue.get(); }
+
                     virtual void flush() override;
                 };
             } // namespace Logging
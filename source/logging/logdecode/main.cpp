@@ -0,0 +1,28 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+// Decode a binary log file written with --log-type binary to the text the file logger would have written.
+#include <iostream>
+#include <string>
+
+#include "../BinaryLogDecoder.h"
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        cerr << "Usage: " << argv[0] << " <binary log file>" << endl;
+        return 2;
+    }
+
+    string error;
+    if (!BinaryLogDecoder::decode(argv[1], cout, error))
+    {
+        cerr << argv[0] << ": " << error << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "AddrWatcher.h"
+
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/task_scheduler.h>
+#include <aws/common/error.h>
+#include <aws/io/io.h>
+
+#if defined(__linux__)
+#    include <sys/inotify.h>
+#endif
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <utility>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char AddrWatcher::TAG[];
+
+AddrWatcher::AddrWatcher(aws_event_loop *eventLoop, const string &addr, function<void()> onCreated)
+    : mEventLoop(eventLoop), mOnCreated(move(onCreated))
+{
+    size_t slash = addr.rfind('/');
+    if (slash == string::npos)
+    {
+        mDir = ".";
+        mName = addr;
+    }
+    else
+    {
+        mDir = slash == 0 ? "/" : addr.substr(0, slash);
+        mName = addr.substr(slash + 1);
+    }
+}
+
+AddrWatcher::~AddrWatcher()
+{
+    stop();
+}
+
+bool AddrWatcher::start()
+{
+    if (mFd >= 0)
+    {
+        return true;
+    }
+#if defined(__linux__)
+    mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mFd < 0)
+    {
+        LOGM_WARN(TAG, "Unable to watch directory: %s msg: %s", mDir.c_str(), strerror(errno));
+        return false;
+    }
+    if (inotify_add_watch(mFd, mDir.c_str(), IN_CREATE | IN_MOVED_TO | IN_ATTRIB | IN_ONLYDIR) < 0)
+    {
+        LOGM_WARN(TAG, "Unable to watch directory: %s msg: %s", mDir.c_str(), strerror(errno));
+        stopOnEventLoop();
+        return false;
+    }
+
+    mIoHandle.data.fd = mFd;
+    mIoHandle.additional_data = nullptr;
+    if (aws_event_loop_subscribe_to_io_events(mEventLoop, &mIoHandle, AWS_IO_EVENT_TYPE_READABLE, onIoEvent, this) !=
+        AWS_OP_SUCCESS)
+    {
+        LOGM_WARN(TAG, "Unable to watch directory: %s msg: %s", mDir.c_str(), aws_error_str(aws_last_error()));
+        stopOnEventLoop();
+        return false;
+    }
+    mSubscribed = true;
+    LOGM_DEBUG(TAG, "Watching directory: %s for: %s", mDir.c_str(), mName.c_str());
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AddrWatcher::stop()
+{
+    if (mSubscribed && !aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        // Unsubscribing is only allowed from the event loop thread, so wait for the event loop to stop watching.
+        struct StopArgs
+        {
+            AddrWatcher *self;
+            promise<void> done;
+        } args{this, promise<void>()};
+        future<void> done = args.done.get_future();
+
+        aws_task task;
+        aws_task_init(
+            &task,
+            [](struct aws_task *, void *arg, enum aws_task_status status) {
+                auto *stopArgs = static_cast<StopArgs *>(arg);
+                if (status == AWS_TASK_STATUS_CANCELED)
+                {
+                    stopArgs->self->mSubscribed = false; // Event loop is shutting down.
+                }
+                stopArgs->self->stopOnEventLoop();
+                stopArgs->done.set_value();
+            },
+            &args,
+            __func__);
+        aws_event_loop_schedule_task_now(mEventLoop, &task);
+        done.wait();
+    }
+    else
+    {
+        stopOnEventLoop();
+    }
+}
+
+void AddrWatcher::stopOnEventLoop()
+{
+    if (mSubscribed)
+    {
+        aws_event_loop_unsubscribe_from_io_events(mEventLoop, &mIoHandle);
+        mSubscribed = false;
+    }
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+        mFd = -1;
+    }
+}
+
+void AddrWatcher::onIoEvent(aws_event_loop *, aws_io_handle *, int events, void *userData)
+{
+    auto *self = static_cast<AddrWatcher *>(userData);
+    if (events & AWS_IO_EVENT_TYPE_READABLE)
+    {
+        self->readEvents();
+    }
+}
+
+void AddrWatcher::readEvents()
+{
+#if defined(__linux__)
+    // Events are aligned for struct inotify_event, and each holds a name of at most NAME_MAX bytes.
+    alignas(struct inotify_event) char buf[4096];
+    bool created = false;
+    ssize_t len;
+    while ((len = ::read(mFd, buf, sizeof(buf))) > 0)
+    {
+        for (char *p = buf; p < buf + len;)
+        {
+            auto *event = reinterpret_cast<struct inotify_event *>(p);
+            if (event->len > 0 && mName == event->name)
+            {
+                created = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    if (created)
+    {
+        LOGM_DEBUG(TAG, "Address created directory: %s name: %s", mDir.c_str(), mName.c_str());
+        mOnCreated();
+    }
+#endif
+}
@@ -0,0 +1,100 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_ADDR_WATCHER_H
+#define DEVICE_CLIENT_ADDR_WATCHER_H
+
+#include <aws/io/event_loop.h>
+
+#include <functional>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief AddrWatcher notifies when the socket file of a sensor server appears.
+                 *
+                 * The parent directory of the address is watched with inotify from the event loop of the sensor,
+                 * and the callback is invoked when an entry named after the address is created, moved in, or has
+                 * its attributes changed, since a server may bind its socket and then change its permissions.
+                 *
+                 * Watching is best effort: when inotify is not available or the directory does not exist, start
+                 * fails and the sensor keeps polling the address every addr_poll_sec.
+                 */
+                class AddrWatcher
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param eventLoop event loop invoking the callback
+                     * @param addr path of the socket file
+                     * @param onCreated invoked from the event loop when the socket file may have appeared
+                     */
+                    AddrWatcher(aws_event_loop *eventLoop, const std::string &addr, std::function<void()> onCreated);
+
+                    virtual ~AddrWatcher();
+
+                    AddrWatcher(const AddrWatcher &) = delete;
+                    AddrWatcher &operator=(const AddrWatcher &) = delete;
+
+                    /**
+                     * \brief Start watching, if not already watching
+                     *
+                     * Called from the event loop.
+                     *
+                     * @return false when the address cannot be watched
+                     */
+                    virtual bool start();
+
+                    /**
+                     * \brief Stop watching
+                     *
+                     * When called from another thread than the event loop, blocks until the event loop has
+                     * stopped watching.
+                     */
+                    virtual void stop();
+
+                    bool isWatching() const { return mFd >= 0; }
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "AddrWatcher.cpp";
+
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    std::string mDir;
+
+                    std::string mName;
+
+                    std::function<void()> mOnCreated;
+
+                    int mFd{-1};
+
+                    aws_io_handle mIoHandle{};
+
+                    bool mSubscribed{false};
+
+                    static void onIoEvent(aws_event_loop *eventLoop, aws_io_handle *handle, int events, void *userData);
+
+                    /**
+                     * \brief Read pending inotify events, and invoke the callback once when any names the address
+                     */
+                    void readEvents();
+
+                    void stopOnEventLoop();
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_ADDR_WATCHER_H
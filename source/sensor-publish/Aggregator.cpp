@@ -0,0 +1,255 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Aggregator.h"
+
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/error.h>
+#include <aws/common/zero.h>
+#include <aws/mqtt/client.h>
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char Aggregator::TAG[];
+constexpr size_t Aggregator::RECORD_OVERHEAD;
+
+Aggregator::Aggregator(
+    aws_allocator *allocator,
+    shared_ptr<Crt::Mqtt::MqttConnection> connection,
+    aws_event_loop *eventLoop,
+    const string &topic,
+    size_t maxBytes,
+    int64_t timeMs,
+    size_t maxInflight)
+    : mConnection(connection), mEventLoop(eventLoop), mTopicName(topic), mTime(timeMs), mMaxInflight(maxInflight)
+{
+    mTopic = aws_byte_cursor_from_array(mTopicName.c_str(), mTopicName.size());
+
+    AWS_ZERO_STRUCT(mMessage);
+    if (aws_byte_buf_init(&mMessage, allocator, maxBytes) != AWS_OP_SUCCESS)
+    {
+        throw std::runtime_error{"Unable to allocate memory for aggregate message"};
+    }
+
+    // Initialize a task to publish the aggregate message once its oldest batch reaches the deadline.
+    AWS_ZERO_STRUCT(mDeadlineTask);
+    aws_task_init(
+        &mDeadlineTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Aggregator *>(arg);
+            self->onDeadlineTaskCallback();
+        },
+        this,
+        __func__);
+}
+
+Aggregator::~Aggregator()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStopped = true;
+    }
+    cancelDeadline();
+    aws_byte_buf_clean_up(&mMessage);
+}
+
+bool Aggregator::add(const string &sensorName, const aws_byte_cursor &batch)
+{
+    size_t nameLen = min(sensorName.size(), size_t(numeric_limits<uint16_t>::max()));
+    size_t recordLen = RECORD_OVERHEAD + nameLen + batch.len;
+    if (recordLen > mMessage.capacity)
+    {
+        return false;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    if (mStopped)
+    {
+        return false;
+    }
+    if (mMaxInflight > 0 && mInflight >= mMaxInflight)
+    {
+        ++mCounters.windowFull;
+        return false;
+    }
+    if (mMessage.capacity - mMessage.len < recordLen)
+    {
+        flushLocked();
+    }
+
+    if (mMessage.len == 0)
+    {
+        mOldest = Clock::now();
+        if (!mDeadlineScheduled)
+        {
+            scheduleDeadline(mOldest + mTime);
+        }
+    }
+    aws_byte_buf_write_be16(&mMessage, static_cast<uint16_t>(nameLen));
+    aws_byte_buf_write(&mMessage, reinterpret_cast<const uint8_t *>(sensorName.data()), nameLen);
+    aws_byte_buf_write_be32(&mMessage, static_cast<uint32_t>(batch.len));
+    aws_byte_buf_write(&mMessage, batch.ptr, batch.len);
+    ++mCounters.batches;
+    return true;
+}
+
+void Aggregator::flush()
+{
+    lock_guard<mutex> lock(mMutex);
+    flushLocked();
+}
+
+void Aggregator::start()
+{
+    lock_guard<mutex> lock(mMutex);
+    mStopped = false;
+}
+
+void Aggregator::stop()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStopped = true;
+        flushLocked();
+    }
+    cancelDeadline();
+}
+
+void Aggregator::cancelDeadline()
+{
+    bool deadlineScheduled;
+    {
+        // Once stopped, the deadline task is not scheduled again.
+        lock_guard<mutex> lock(mMutex);
+        deadlineScheduled = mDeadlineScheduled;
+    }
+    if (!deadlineScheduled)
+    {
+        return;
+    }
+
+    if (!aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        // Tasks may only be cancelled from the event loop thread, so wait for the event loop to cancel it.
+        struct CancelArgs
+        {
+            Aggregator *self;
+            promise<void> done;
+        } args{this, promise<void>()};
+        future<void> done = args.done.get_future();
+        aws_task task;
+        aws_task_init(
+            &task,
+            [](struct aws_task *, void *arg, enum aws_task_status) {
+                auto *cancelArgs = static_cast<CancelArgs *>(arg);
+                cancelArgs->self->cancelDeadlineOnEventLoop();
+                cancelArgs->done.set_value();
+            },
+            &args,
+            __func__);
+        aws_event_loop_schedule_task_now(mEventLoop, &task);
+        done.wait();
+    }
+    else
+    {
+        cancelDeadlineOnEventLoop();
+    }
+}
+
+void Aggregator::cancelDeadlineOnEventLoop()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mDeadlineScheduled)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mDeadlineTask);
+        mDeadlineScheduled = false;
+    }
+}
+
+void Aggregator::flushLocked()
+{
+    if (mMessage.len == 0)
+    {
+        return;
+    }
+
+    // Publish copies the payload, so the aggregate message can be reused straight away.
+    aws_byte_cursor payload = aws_byte_cursor_from_buf(&mMessage);
+    LOGM_DEBUG(TAG, "Publishing aggregate message bytes: %zu", payload.len);
+    ++mInflight;
+    uint16_t packetId = mqttPublish(&payload);
+    mMessage.len = 0;
+    if (packetId == 0)
+    {
+        onPublishComplete(packetId, aws_last_error());
+    }
+}
+
+void Aggregator::scheduleDeadline(Clock::time_point time)
+{
+    mDeadlineScheduled = true;
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    auto delay = max(time - Clock::now(), Clock::duration::zero());
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delay).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mDeadlineTask, runAtNanos);
+}
+
+void Aggregator::onDeadlineTaskCallback()
+{
+    lock_guard<mutex> lock(mMutex);
+    mDeadlineScheduled = false;
+    if (mStopped || mMessage.len == 0)
+    {
+        return;
+    }
+
+    // The message published when it filled up was replaced by a newer one, with a later deadline.
+    Clock::time_point deadline = mOldest + mTime;
+    if (Clock::now() < deadline)
+    {
+        scheduleDeadline(deadline);
+        return;
+    }
+    flushLocked();
+}
+
+void Aggregator::onPublishComplete(uint16_t packetId, int errorCode)
+{
+    --mInflight;
+    if (errorCode == AWS_OP_SUCCESS)
+    {
+        ++mCounters.published;
+        LOGM_DEBUG(TAG, "Aggregate publish complete packetId: %d", packetId);
+        return;
+    }
+    ++mCounters.publishFailed;
+    LOGM_ERROR(TAG, "Error func: %s topic: %s msg: %s", __func__, mTopicName.c_str(), aws_error_str(errorCode));
+}
+
+uint16_t Aggregator::mqttPublish(const aws_byte_cursor *payload)
+{
+    return aws_mqtt_client_connection_publish(
+        mConnection->GetUnderlyingConnection(),
+        &mTopic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        false,
+        payload,
+        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata) {
+            static_cast<Aggregator *>(userdata)->onPublishComplete(packet_id, error_code);
+        },
+        this);
+}
@@ -0,0 +1,228 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_AGGREGATOR_H
+#define DEVICE_CLIENT_AGGREGATOR_H
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/crt/Types.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Aggregator merges batches of several sensors into a single MQTT message on a shared topic.
+                 *
+                 * Low rate sensors publishing to their own topic send many small messages, each paying the per
+                 * message cost of the broker. Batches of sensors configured with aggregate are instead appended
+                 * to an aggregate message, as a sequence of records:
+                 *
+                 *     name length (big endian uint16) | sensor name | batch length (big endian uint32) | batch
+                 *
+                 * The aggregate message is published when the next batch would not fit in aggregate_max_bytes,
+                 * or aggregate_time_ms after its oldest batch was added, whichever comes first. Batches are refused
+                 * while aggregate_max_inflight aggregate messages await acknowledgement, so that they are published
+                 * by their sensor, within its own in-flight window, spool and dead-letter topic.
+                 *
+                 * Batches are added from the event loops of the sensors, so adding a batch is thread safe. The
+                 * deadline is kept by a task on the event loop of the aggregator.
+                 */
+                class Aggregator
+                {
+                  public:
+                    /**
+                     * \brief Counters describing the delivery of aggregate messages
+                     */
+                    struct Counters
+                    {
+                        /**
+                         * \brief Sensor batches added to aggregate messages
+                         */
+                        std::atomic<uint64_t> batches{0};
+
+                        /**
+                         * \brief Aggregate messages acknowledged by the broker
+                         */
+                        std::atomic<uint64_t> published{0};
+
+                        /**
+                         * \brief Aggregate messages which failed to publish
+                         */
+                        std::atomic<uint64_t> publishFailed{0};
+                        /**
+                         * \brief Batches refused because the in-flight window was full
+                         */
+                        std::atomic<uint64_t> windowFull{0};
+                    };
+
+                    /**
+                     * \brief Number of bytes added to the aggregate message for each batch, besides the batch and
+                     * the sensor name
+                     */
+                    static constexpr std::size_t RECORD_OVERHEAD = sizeof(uint16_t) + sizeof(uint32_t);
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param connection MQTT client connection
+                     * @param eventLoop event loop running the deadline task
+                     * @param topic topic of the aggregate messages
+                     * @param maxBytes size of the largest aggregate message
+                     * @param timeMs time after which the oldest batch of an aggregate message is published
+                     * @param maxInflight number of aggregate messages awaiting acknowledgement above which batches are
+                     * refused, 0 for no limit
+                     *
+                     * @throws std::runtime_error when memory cannot be allocated
+                     */
+                    Aggregator(
+                        aws_allocator *allocator,
+                        std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
+                        aws_event_loop *eventLoop,
+                        const std::string &topic,
+                        std::size_t maxBytes,
+                        int64_t timeMs,
+                        std::size_t maxInflight);
+
+                    virtual ~Aggregator();
+
+                    Aggregator(const Aggregator &) = delete;
+                    Aggregator &operator=(const Aggregator &) = delete;
+
+                    /**
+                     * \brief Add a batch of a sensor to the aggregate message
+                     *
+                     * The batch is copied, and the aggregate message published first when the batch does not fit.
+                     *
+                     * @return false when the batch alone is too large for an aggregate message, the in-flight window is
+                     * full or the aggregator is stopped, and the batch is to be published on the topic of the sensor
+                     * instead
+                     */
+                    bool add(const std::string &sensorName, const aws_byte_cursor &batch);
+
+                    /**
+                     * \brief Publish the aggregate message, if any batch was added
+                     */
+                    void flush();
+
+                    /**
+                     * \brief Start accepting batches
+                     */
+                    void start();
+
+                    /**
+                     * \brief Stop the deadline task and publish the aggregate message
+                     *
+                     * Batches added once stopped are refused, and published on the topic of their sensor. When called
+                     * from another thread than the event loop, blocks until the event loop has cancelled the deadline
+                     * task.
+                     */
+                    void stop();
+
+                    const Counters &getCounters() const { return mCounters; }
+
+                  protected:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "Aggregator.cpp";
+
+                    /**
+                     * \brief Publish payload to the aggregate topic
+                     *
+                     * @return packet id of the publish, or 0 when the publish failed to start
+                     */
+                    virtual uint16_t mqttPublish(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Callback function when the publish of an aggregate message completes
+                     */
+                    void onPublishComplete(uint16_t packetId, int errorCode);
+
+                    /**
+                     * \brief Callback function for the deadline task
+                     */
+                    void onDeadlineTaskCallback();
+
+                  private:
+                    using Clock = std::chrono::steady_clock;
+
+                    std::shared_ptr<Crt::Mqtt::MqttConnection> mConnection;
+
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    std::string mTopicName;
+
+                    aws_byte_cursor mTopic;
+
+                    std::chrono::milliseconds mTime;
+                    std::size_t mMaxInflight;
+
+                    /**
+                     * \brief Number of aggregate messages published and not yet acknowledged
+                     */
+                    std::atomic<std::size_t> mInflight{0};
+
+                    Counters mCounters;
+
+                    /**
+                     * \brief Guards the aggregate message and the deadline task state
+                     */
+                    std::mutex mMutex;
+
+                    /**
+                     * \brief Aggregate message, allocated once with a capacity of aggregate_max_bytes
+                     */
+                    aws_byte_buf mMessage;
+
+                    /**
+                     * \brief Time at which the oldest batch of the aggregate message was added
+                     */
+                    Clock::time_point mOldest;
+
+                    aws_task mDeadlineTask;
+
+                    bool mDeadlineScheduled{false};
+
+                    bool mStopped{false};
+
+                    /**
+                     * \brief Publish the aggregate message, called with mMutex held
+                     */
+                    void flushLocked();
+
+                    /**
+                     * \brief Schedule the deadline task at time, called with mMutex held
+                     */
+                    void scheduleDeadline(Clock::time_point time);
+
+                    /**
+                     * \brief Cancel the deadline task once stopped, waiting for the event loop to cancel it when
+                     * called from another thread
+                     */
+                    void cancelDeadline();
+
+                    void cancelDeadlineOnEventLoop();
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_AGGREGATOR_H
@@ -0,0 +1,383 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BatchEncoder.h"
+
+#include "../config/Config.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/zero.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * CBOR major types
+     */
+    constexpr uint8_t CBOR_UNSIGNED = 0;
+    constexpr uint8_t CBOR_BYTES = 2;
+    constexpr uint8_t CBOR_TEXT = 3;
+    constexpr uint8_t CBOR_ARRAY = 4;
+    constexpr uint8_t CBOR_MAP = 5;
+
+    /**
+     * Largest encoding of a CBOR head, an initial byte followed by a uint64
+     */
+    constexpr size_t CBOR_HEAD_MAX = 9;
+
+    /**
+     * Largest number of decimal digits in a uint64
+     */
+    constexpr size_t DECIMAL_MAX = 20;
+
+    constexpr char JSON_TS_PREFIX[] = "{\"ts\":";
+    constexpr char JSON_MSG_PREFIX[] = ",\"msg\":";
+
+    /**
+     * Escaped form of a byte in a JSON string, or 0 for a byte copied as is
+     */
+    char jsonEscape(uint8_t c)
+    {
+        switch (c)
+        {
+            case '"':
+                return '"';
+            case '\\':
+                return '\\';
+            case '\b':
+                return 'b';
+            case '\f':
+                return 'f';
+            case '\n':
+                return 'n';
+            case '\r':
+                return 'r';
+            case '\t':
+                return 't';
+            default:
+                return c < 0x20 ? 'u' : 0;
+        }
+    }
+
+    /**
+     * Length of the valid UTF-8 sequence starting with the byte at p, a byte of at least 0x80, or 0 when the byte
+     * does not start a valid sequence
+     */
+    size_t utf8SequenceLength(const uint8_t *p, const uint8_t *end)
+    {
+        size_t n;
+        if (*p >= 0xc2 && *p <= 0xdf)
+        {
+            n = 2;
+        }
+        else if ((*p & 0xf0) == 0xe0)
+        {
+            n = 3;
+        }
+        else if (*p >= 0xf0 && *p <= 0xf4)
+        {
+            n = 4;
+        }
+        else
+        {
+            return 0; // Continuation byte, overlong two byte sequence, or beyond U+10FFFF.
+        }
+        if (static_cast<size_t>(end - p) < n)
+        {
+            return 0;
+        }
+
+        uint32_t codePoint = *p & (0x7f >> n);
+        for (size_t i = 1; i < n; ++i)
+        {
+            if ((p[i] & 0xc0) != 0x80)
+            {
+                return 0;
+            }
+            codePoint = (codePoint << 6) | (p[i] & 0x3f);
+        }
+        if ((n == 3 && (codePoint < 0x800 || (codePoint >= 0xd800 && codePoint <= 0xdfff))) ||
+            (n == 4 && (codePoint < 0x10000 || codePoint > 0x10ffff)))
+        {
+            return 0; // Overlong, surrogate, or beyond U+10FFFF.
+        }
+        return n;
+    }
+} // namespace
+
+BatchEncoder::BatchEncoder(
+    aws_allocator *allocator,
+    Format format,
+    bool timestamps,
+    size_t maxBatchBytes,
+    size_t maxMessages)
+    : mFormat(format), mTimestamps(timestamps)
+{
+    switch (mFormat)
+    {
+        case Format::JsonArray:
+            // "msg", or {"ts":<ts>,"msg":"msg"}, followed by a comma.
+            mMessageOverhead = 3;
+            if (mTimestamps)
+            {
+                mMessageOverhead += sizeof(JSON_TS_PREFIX) - 1 + DECIMAL_MAX + sizeof(JSON_MSG_PREFIX) - 1 + 1;
+            }
+            break;
+        case Format::Cbor:
+            // Byte string head, or a map head with "ts" and "msg" keys and a uint value.
+            mMessageOverhead = CBOR_HEAD_MAX;
+            if (mTimestamps)
+            {
+                mMessageOverhead += 1 + 3 + CBOR_HEAD_MAX + 4;
+            }
+            break;
+        case Format::LengthPrefixed:
+            mMessageOverhead = sizeof(uint32_t) + (mTimestamps ? sizeof(uint64_t) : 0);
+            break;
+    }
+
+    // Messages are added without their delimiter, so a full batch of unescaped messages always fits.
+    AWS_ZERO_STRUCT(mOutput);
+    if (aws_byte_buf_init(&mOutput, allocator, CBOR_HEAD_MAX + maxBatchBytes + maxMessages * mMessageOverhead) !=
+        AWS_OP_SUCCESS)
+    {
+        throw std::runtime_error{"Unable to allocate memory for batch encoder"};
+    }
+}
+
+BatchEncoder::~BatchEncoder()
+{
+    aws_byte_buf_clean_up_secure(&mOutput);
+}
+
+bool BatchEncoder::ParseFormat(const string &name, Format &format)
+{
+    if (name == PlainConfig::SensorPublish::BATCH_FORMAT_JSON_ARRAY)
+    {
+        format = Format::JsonArray;
+        return true;
+    }
+    if (name == PlainConfig::SensorPublish::BATCH_FORMAT_CBOR)
+    {
+        format = Format::Cbor;
+        return true;
+    }
+    if (name == PlainConfig::SensorPublish::BATCH_FORMAT_LENGTH_PREFIXED)
+    {
+        format = Format::LengthPrefixed;
+        return true;
+    }
+    return false;
+}
+
+void BatchEncoder::begin(size_t count)
+{
+    mOutput.len = 0;
+    mFirst = true;
+    mFailed = false;
+    switch (mFormat)
+    {
+        case Format::JsonArray:
+            mOutput.buffer[mOutput.len++] = '[';
+            break;
+        case Format::Cbor:
+            writeCborHead(CBOR_ARRAY, count);
+            break;
+        case Format::LengthPrefixed:
+            break;
+    }
+}
+
+bool BatchEncoder::add(const uint8_t *message, size_t len, uint64_t timeMs)
+{
+    if (!reserve(mMessageOverhead + len))
+    {
+        return false;
+    }
+    switch (mFormat)
+    {
+        case Format::JsonArray:
+            if (!mFirst)
+            {
+                mOutput.buffer[mOutput.len++] = ',';
+            }
+            if (mTimestamps)
+            {
+                aws_byte_buf_write(
+                    &mOutput, reinterpret_cast<const uint8_t *>(JSON_TS_PREFIX), sizeof(JSON_TS_PREFIX) - 1);
+                writeDecimal(timeMs);
+                aws_byte_buf_write(
+                    &mOutput, reinterpret_cast<const uint8_t *>(JSON_MSG_PREFIX), sizeof(JSON_MSG_PREFIX) - 1);
+            }
+            if (!writeJsonString(message, len))
+            {
+                return false;
+            }
+            if (mTimestamps)
+            {
+                if (!reserve(1))
+                {
+                    return false;
+                }
+                mOutput.buffer[mOutput.len++] = '}';
+            }
+            break;
+        case Format::Cbor:
+            if (mTimestamps)
+            {
+                writeCborHead(CBOR_MAP, 2);
+                writeCborHead(CBOR_TEXT, 2);
+                aws_byte_buf_write(&mOutput, reinterpret_cast<const uint8_t *>("ts"), 2);
+                writeCborHead(CBOR_UNSIGNED, timeMs);
+                writeCborHead(CBOR_TEXT, 3);
+                aws_byte_buf_write(&mOutput, reinterpret_cast<const uint8_t *>("msg"), 3);
+            }
+            writeCborHead(CBOR_BYTES, len);
+            aws_byte_buf_write(&mOutput, message, len);
+            break;
+        case Format::LengthPrefixed:
+            if (mTimestamps)
+            {
+                aws_byte_buf_write_be64(&mOutput, timeMs);
+            }
+            aws_byte_buf_write_be32(&mOutput, static_cast<uint32_t>(len));
+            aws_byte_buf_write(&mOutput, message, len);
+            break;
+    }
+    mFirst = false;
+    return true;
+}
+
+bool BatchEncoder::finish(aws_byte_cursor &encoded)
+{
+    if (mFormat == Format::JsonArray && reserve(1))
+    {
+        mOutput.buffer[mOutput.len++] = ']';
+    }
+    encoded = aws_byte_cursor_from_buf(&mOutput);
+    return !mFailed;
+}
+
+bool BatchEncoder::reserve(size_t len)
+{
+    if (mFailed)
+    {
+        return false; // The batch already failed, nothing more is written.
+    }
+    if (mOutput.capacity - mOutput.len < len &&
+        aws_byte_buf_reserve(&mOutput, max(mOutput.capacity * 2, mOutput.len + len)) != AWS_OP_SUCCESS)
+    {
+        // Only reached when escaping makes a JSON batch larger than any previous batch.
+        mFailed = true;
+        return false;
+    }
+    return true;
+}
+
+void BatchEncoder::writeCborHead(uint8_t majorType, uint64_t value)
+{
+    uint8_t initial = static_cast<uint8_t>(majorType << 5);
+    if (value < 24)
+    {
+        aws_byte_buf_write_u8(&mOutput, static_cast<uint8_t>(initial | value));
+    }
+    else if (value <= UINT8_MAX)
+    {
+        aws_byte_buf_write_u8(&mOutput, initial | 24);
+        aws_byte_buf_write_u8(&mOutput, static_cast<uint8_t>(value));
+    }
+    else if (value <= UINT16_MAX)
+    {
+        aws_byte_buf_write_u8(&mOutput, initial | 25);
+        aws_byte_buf_write_be16(&mOutput, static_cast<uint16_t>(value));
+    }
+    else if (value <= UINT32_MAX)
+    {
+        aws_byte_buf_write_u8(&mOutput, initial | 26);
+        aws_byte_buf_write_be32(&mOutput, static_cast<uint32_t>(value));
+    }
+    else
+    {
+        aws_byte_buf_write_u8(&mOutput, initial | 27);
+        aws_byte_buf_write_be64(&mOutput, value);
+    }
+}
+
+bool BatchEncoder::writeJsonString(const uint8_t *message, size_t len)
+{
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    mOutput.buffer[mOutput.len++] = '"';
+    const uint8_t *end = message + len;
+    const uint8_t *run = message;
+    for (const uint8_t *p = message; p < end; ++p)
+    {
+        char escape = jsonEscape(*p);
+        if (escape == 0 && *p >= 0x80)
+        {
+            size_t sequence = utf8SequenceLength(p, end);
+            if (sequence > 0)
+            {
+                p += sequence - 1; // Valid UTF-8 is copied as is.
+                continue;
+            }
+            escape = 'u';
+        }
+        if (escape == 0)
+        {
+            continue;
+        }
+
+        // Copy the bytes before the escaped byte, then the escape sequence.
+        // Room for the message without escapes is reserved before the message is added.
+        if (!reserve(static_cast<size_t>(end - run) + 6))
+        {
+            return false;
+        }
+        aws_byte_buf_write(&mOutput, run, static_cast<size_t>(p - run));
+        uint8_t *out = mOutput.buffer + mOutput.len;
+        *out++ = '\\';
+        *out++ = static_cast<uint8_t>(escape);
+        if (escape == 'u' && *p >= 0x80)
+        {
+            // Not part of a valid UTF-8 sequence, replaced by U+FFFD.
+            memcpy(out, "fffd", 4);
+            out += 4;
+        }
+        else if (escape == 'u')
+        {
+            *out++ = '0';
+            *out++ = '0';
+            *out++ = static_cast<uint8_t>(HEX[*p >> 4]);
+            *out++ = static_cast<uint8_t>(HEX[*p & 0xf]);
+        }
+        mOutput.len = static_cast<size_t>(out - mOutput.buffer);
+        run = p + 1;
+    }
+    if (!reserve(static_cast<size_t>(end - run) + 1))
+    {
+        return false;
+    }
+    aws_byte_buf_write(&mOutput, run, static_cast<size_t>(end - run));
+    mOutput.buffer[mOutput.len++] = '"';
+    return true;
+}
+
+void BatchEncoder::writeDecimal(uint64_t value)
+{
+    char digits[DECIMAL_MAX];
+    size_t n = 0;
+    do
+    {
+        digits[DECIMAL_MAX - ++n] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    aws_byte_buf_write(&mOutput, reinterpret_cast<const uint8_t *>(digits + DECIMAL_MAX - n), n);
+}
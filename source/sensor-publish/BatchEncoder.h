@@ -0,0 +1,156 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BATCH_ENCODER_H
+#define DEVICE_CLIENT_BATCH_ENCODER_H
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief BatchEncoder wraps the messages of a batch in an envelope, so consumers do not have to
+                 * split the batch using the end of message delimiter.
+                 *
+                 * Messages are added without their delimiter. The supported envelopes are:
+                 *
+                 * - JsonArray: a JSON array of strings, or of {"ts":<ms>,"msg":"<message>"} objects when
+                 *   timestamps are enabled.
+                 * - Cbor: a CBOR (RFC 8949) array of byte strings, or of {"ts":<ms>,"msg":<bytes>} maps when
+                 *   timestamps are enabled.
+                 * - LengthPrefixed: each message preceded by its length as a big endian uint32, and when
+                 *   timestamps are enabled by its timestamp as a big endian uint64 before the length.
+                 *
+                 * Timestamps are milliseconds since the Unix epoch at which the message was read.
+                 *
+                 * JSON strings hold text, so JsonArray expects UTF-8 messages. Bytes which are not part of a valid
+                 * UTF-8 sequence are replaced by U+FFFD, so the batch is still valid JSON but binary messages are
+                 * not preserved. Sensors producing binary messages should use Cbor or LengthPrefixed.
+                 *
+                 * The output buffer is allocated once, sized for a full batch, so encoding a batch is a single
+                 * pass over the messages without allocation. The buffer only grows when JSON escaping makes a
+                 * batch larger than any previous batch.
+                 *
+                 * BatchEncoder is not thread safe, and is only used from the event loop of its sensor.
+                 */
+                class BatchEncoder
+                {
+                  public:
+                    enum class Format
+                    {
+                        JsonArray,
+                        Cbor,
+                        LengthPrefixed
+                    };
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param format envelope format
+                     * @param timestamps whether to include the read time of each message
+                     * @param maxBatchBytes size of the largest batch, including delimiters
+                     * @param maxMessages largest number of messages in a batch
+                     *
+                     * @throws std::runtime_error when memory cannot be allocated
+                     */
+                    BatchEncoder(
+                        aws_allocator *allocator,
+                        Format format,
+                        bool timestamps,
+                        std::size_t maxBatchBytes,
+                        std::size_t maxMessages);
+
+                    ~BatchEncoder();
+
+                    BatchEncoder(const BatchEncoder &) = delete;
+                    BatchEncoder &operator=(const BatchEncoder &) = delete;
+
+                    /**
+                     * \brief Parse the name of a batch format
+                     *
+                     * @return false when the name is not an envelope format, including raw
+                     */
+                    static bool ParseFormat(const std::string &name, Format &format);
+
+                    /**
+                     * \brief Start encoding a batch, discarding the previous batch
+                     *
+                     * @param count number of messages which will be added
+                     */
+                    void begin(std::size_t count);
+
+                    /**
+                     * \brief Add a message to the batch
+                     *
+                     * @param message message without its delimiter
+                     * @param len size of the message
+                     * @param timeMs time at which the message was read, ignored unless timestamps are enabled
+                     * @return false when the output buffer could not grow to hold the message, which fails the batch
+                     */
+                    bool add(const uint8_t *message, std::size_t len, std::uint64_t timeMs);
+
+                    /**
+                     * \brief Finish encoding the batch
+                     *
+                     * @param encoded set to a view of the encoded batch, valid until the next call to begin
+                     * @return false when a message could not be added, in which case the batch must be dropped
+                     */
+                    bool finish(aws_byte_cursor &encoded);
+
+                    /**
+                     * \brief Size of the largest encoded batch which fits the output buffer without growing it
+                     */
+                    std::size_t capacity() const { return mOutput.capacity; }
+
+                  private:
+                    Format mFormat;
+
+                    bool mTimestamps{false};
+
+                    aws_byte_buf mOutput;
+
+                    /**
+                     * \brief Largest number of bytes added to the output for a message, excluding the message
+                     */
+                    std::size_t mMessageOverhead{0};
+
+                    /**
+                     * \brief Whether the next message is the first of the batch
+                     */
+                    bool mFirst{true};
+
+                    /**
+                     * \brief Whether the output buffer could not grow to hold the batch
+                     */
+                    bool mFailed{false};
+
+                    /**
+                     * \brief Make room for len more bytes of output
+                     *
+                     * @return false when the output buffer could not grow
+                     */
+                    bool reserve(std::size_t len);
+
+                    void writeCborHead(uint8_t majorType, std::uint64_t value);
+
+                    bool writeJsonString(const uint8_t *message, std::size_t len);
+
+                    void writeDecimal(std::uint64_t value);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BATCH_ENCODER_H
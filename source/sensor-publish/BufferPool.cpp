@@ -0,0 +1,105 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BufferPool.h"
+
+#include <aws/common/zero.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+BufferPool::BufferPool(aws_allocator *allocator, size_t budgetBytes)
+    : mAllocator(allocator), mBudgetBytes(budgetBytes)
+{
+}
+
+BufferPool::~BufferPool()
+{
+    // Buffers still in use belong to sensors, which are destroyed before the pool.
+    for (auto &entry : mFree)
+    {
+        for (void *buffer : entry.second)
+        {
+            freeBuffer(buffer, entry.first);
+        }
+    }
+}
+
+void *BufferPool::acquire(size_t size)
+{
+    lock_guard<mutex> lock(mMutex);
+
+    auto it = mFree.find(size);
+    if (it != mFree.end() && !it->second.empty())
+    {
+        void *buffer = it->second.back();
+        it->second.pop_back();
+        mInUseBytes += size;
+        return buffer;
+    }
+
+    if (!makeRoom(size))
+    {
+        return nullptr;
+    }
+    void *buffer = aws_mem_acquire(mAllocator, size);
+    if (buffer == nullptr)
+    {
+        return nullptr;
+    }
+    mAllocatedBytes += size;
+    mInUseBytes += size;
+    return buffer;
+}
+
+void BufferPool::release(void *buffer, size_t size)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    mFree[size].push_back(buffer);
+    mInUseBytes -= size;
+}
+
+size_t BufferPool::allocatedBytes() const
+{
+    lock_guard<mutex> lock(mMutex);
+    return mAllocatedBytes;
+}
+
+size_t BufferPool::inUseBytes() const
+{
+    lock_guard<mutex> lock(mMutex);
+    return mInUseBytes;
+}
+
+bool BufferPool::makeRoom(size_t size)
+{
+    if (mBudgetBytes == 0)
+    {
+        return true;
+    }
+    if (mInUseBytes + size > mBudgetBytes)
+    {
+        return false; // Releasing every free buffer would not be enough.
+    }
+    for (auto &entry : mFree)
+    {
+        while (mAllocatedBytes + size > mBudgetBytes && !entry.second.empty())
+        {
+            freeBuffer(entry.second.back(), entry.first);
+            entry.second.pop_back();
+        }
+    }
+    return mAllocatedBytes + size <= mBudgetBytes;
+}
+
+void BufferPool::freeBuffer(void *buffer, size_t size)
+{
+    aws_secure_zero(buffer, size);
+    aws_mem_release(mAllocator, buffer);
+    mAllocatedBytes -= size;
+}
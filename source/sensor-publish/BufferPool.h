@@ -0,0 +1,106 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_BUFFER_POOL_H
+#define DEVICE_CLIENT_BUFFER_POOL_H
+
+#include <aws/common/allocator.h>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief BufferPool lends read buffers to sensors, bounded by a memory budget shared by all sensors.
+                 *
+                 * A sensor only holds a buffer while it has unpublished data, so idle sensors hold no buffer
+                 * memory and the memory used by sensor-publish grows with the number of busy sensors rather
+                 * than with the number of configured sensors.
+                 *
+                 * Returned buffers are kept on a free list per size and reused. When the budget is reached,
+                 * free buffers of other sizes are released to make room, and acquire fails once only buffers
+                 * in use remain.
+                 *
+                 * BufferPool is thread safe, since sensors on different event loops share the pool.
+                 */
+                class BufferPool
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param budgetBytes maximum number of bytes allocated at once, 0 for no limit
+                     */
+                    BufferPool(aws_allocator *allocator, std::size_t budgetBytes);
+
+                    ~BufferPool();
+
+                    BufferPool(const BufferPool &) = delete;
+                    BufferPool &operator=(const BufferPool &) = delete;
+
+                    /**
+                     * \brief Borrow a buffer
+                     *
+                     * @param size size of the buffer in bytes
+                     * @return the buffer, or null when the budget is exhausted
+                     */
+                    void *acquire(std::size_t size);
+
+                    /**
+                     * \brief Return a buffer previously borrowed with acquire
+                     *
+                     * @param size size the buffer was acquired with
+                     */
+                    void release(void *buffer, std::size_t size);
+
+                    std::size_t budgetBytes() const { return mBudgetBytes; }
+
+                    /**
+                     * \brief Number of bytes allocated, both in use and on the free lists
+                     */
+                    std::size_t allocatedBytes() const;
+
+                    /**
+                     * \brief Number of bytes lent to sensors
+                     */
+                    std::size_t inUseBytes() const;
+
+                  private:
+                    aws_allocator *mAllocator{nullptr};
+
+                    std::size_t mBudgetBytes{0};
+
+                    mutable std::mutex mMutex;
+
+                    /**
+                     * \brief Returned buffers by size
+                     */
+                    std::map<std::size_t, std::vector<void *>> mFree;
+
+                    std::size_t mAllocatedBytes{0};
+
+                    std::size_t mInUseBytes{0};
+
+                    /**
+                     * \brief Release free buffers of other sizes until size more bytes fit in the budget
+                     */
+                    bool makeRoom(std::size_t size);
+
+                    void freeBuffer(void *buffer, std::size_t size);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_BUFFER_POOL_H
@@ -0,0 +1,238 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CanSocket.h"
+
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/error.h>
+#include <aws/io/io.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#    include <linux/can.h>
+#    include <linux/can/raw.h>
+#    include <net/if.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char CanSocket::TAG[];
+constexpr uint32_t CanSocket::EFF_FLAG;
+constexpr uint32_t CanSocket::RTR_FLAG;
+constexpr uint32_t CanSocket::INV_FILTER;
+constexpr uint32_t CanSocket::SFF_MASK;
+constexpr uint32_t CanSocket::EFF_MASK;
+constexpr size_t CanSocket::FRAME_TEXT_MAX;
+
+namespace
+{
+    /**
+     * Maximum number of frames received with a single system call
+     */
+    constexpr size_t READ_BATCH_MAX = 64;
+
+    /**
+     * Maximum number of data bytes of a classic CAN frame
+     */
+    constexpr size_t FRAME_DATA_MAX = 8;
+
+    bool parseHex(const string &text, uint32_t &value)
+    {
+        if (text.empty() || text.size() > 8 || text.find_first_not_of("0123456789abcdefABCDEF") != string::npos)
+        {
+            return false;
+        }
+        value = static_cast<uint32_t>(strtoul(text.c_str(), nullptr, 16));
+        return true;
+    }
+
+#if defined(__linux__)
+    static_assert(sizeof(CanSocket::Filter) == sizeof(can_filter), "Filter must match struct can_filter");
+    static_assert(CanSocket::EFF_FLAG == CAN_EFF_FLAG, "EFF_FLAG must match linux/can.h");
+    static_assert(CanSocket::RTR_FLAG == CAN_RTR_FLAG, "RTR_FLAG must match linux/can.h");
+    static_assert(CanSocket::INV_FILTER == CAN_INV_FILTER, "INV_FILTER must match linux/can.h");
+#endif
+} // namespace
+
+bool CanSocket::ParseFilter(const string &text, Filter &filter)
+{
+    size_t separator = text.find_first_of(":~");
+    if (separator == string::npos || !parseHex(text.substr(0, separator), filter.id) ||
+        !parseHex(text.substr(separator + 1), filter.mask))
+    {
+        return false;
+    }
+    if (separator == 8)
+    {
+        filter.id |= EFF_FLAG;
+    }
+    if (text[separator] == '~')
+    {
+        filter.id |= INV_FILTER;
+    }
+    return true;
+}
+
+size_t CanSocket::FormatFrame(uint32_t canId, const uint8_t *data, size_t len, char *out)
+{
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    size_t n = 0;
+    bool extended = (canId & EFF_FLAG) != 0;
+    uint32_t id = canId & (extended ? EFF_MASK : SFF_MASK);
+    for (int digits = extended ? 8 : 3; digits > 0; --digits)
+    {
+        out[n++] = HEX_DIGITS[(id >> ((digits - 1) * 4)) & 0xF];
+    }
+    out[n++] = '#';
+    if (canId & RTR_FLAG)
+    {
+        out[n++] = 'R';
+        return n;
+    }
+    for (size_t i = 0; i < min(len, FRAME_DATA_MAX); ++i)
+    {
+        out[n++] = HEX_DIGITS[data[i] >> 4];
+        out[n++] = HEX_DIGITS[data[i] & 0xF];
+    }
+    return n;
+}
+
+CanSocket::CanSocket(const vector<string> &filters) : DatagramSocket(Type::Can)
+{
+    for (const auto &text : filters)
+    {
+        Filter filter;
+        if (!ParseFilter(text, filter))
+        {
+            LOGM_ERROR(TAG, "Ignoring invalid CAN filter: %s", text.c_str());
+            continue;
+        }
+        mFilters.push_back(filter);
+    }
+}
+
+bool CanSocket::open(const char *address)
+{
+#if defined(__linux__)
+    int rc = -1;
+    mFd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (mFd >= 0 && !mFilters.empty())
+    {
+        // Frames not matching any filter are dropped by the kernel before they are queued on the socket.
+        rc = setsockopt(
+            mFd,
+            SOL_CAN_RAW,
+            CAN_RAW_FILTER,
+            mFilters.data(),
+            static_cast<socklen_t>(mFilters.size() * sizeof(can_filter)));
+    }
+    if (mFd >= 0 && (mFilters.empty() || rc == 0))
+    {
+        sockaddr_can addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.can_family = AF_CAN;
+        addr.can_ifindex = static_cast<int>(if_nametoindex(address));
+        rc = addr.can_ifindex == 0 ? -1 : ::bind(mFd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+    }
+
+    if (mFd < 0 || rc != 0)
+    {
+        int errnum = errno != 0 ? errno : 1;
+        LOGM_ERROR(TAG, "Unable to open CAN interface: %s errno: %d msg: %s", address, errnum, strerror(errnum));
+        closeOnEventLoop();
+        return false;
+    }
+    return true;
+#else
+    LOGM_ERROR(TAG, "CAN sockets are not supported on this platform, interface: %s", address);
+    errno = EAFNOSUPPORT;
+    return false;
+#endif
+}
+
+int CanSocket::read_messages(
+    aws_byte_buf *buf,
+    size_t slot_size,
+    size_t *lengths,
+    size_t max_messages,
+    size_t *count,
+    size_t *truncated_bytes)
+{
+    *count = 0;
+    *truncated_bytes = 0;
+
+#if defined(__linux__)
+    // Every frame becomes a message of at most FRAME_TEXT_MAX bytes, much smaller than a datagram slot.
+    size_t frames = min(max_messages, min(READ_BATCH_MAX, (buf->capacity - buf->len) / FRAME_TEXT_MAX));
+    if (frames == 0)
+    {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    can_frame received[READ_BATCH_MAX];
+    mmsghdr messages[READ_BATCH_MAX];
+    iovec vectors[READ_BATCH_MAX];
+    memset(messages, 0, sizeof(mmsghdr) * frames);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        vectors[i].iov_base = &received[i];
+        vectors[i].iov_len = sizeof(can_frame);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int rc = recvmmsg(mFd, messages, static_cast<unsigned int>(frames), MSG_DONTWAIT, nullptr);
+    if (rc < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        if (errno == ENETDOWN || errno == ENODEV)
+        {
+            // The interface went down or was removed, reconnect once it is back.
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+        LOGM_ERROR(TAG, "Unable to receive CAN frames errno: %d msg: %s", errno, strerror(errno));
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    char *out = reinterpret_cast<char *>(buf->buffer + buf->len);
+    for (int i = 0; i < rc; ++i)
+    {
+        if (messages[i].msg_len != sizeof(can_frame))
+        {
+            continue; // Not a classic CAN frame.
+        }
+        const can_frame &frame = received[i];
+        size_t len = FormatFrame(frame.can_id, frame.data, frame.can_dlc, out);
+        if (len > slot_size)
+        {
+            *truncated_bytes += len;
+            continue;
+        }
+        out += len;
+        buf->len += len;
+        lengths[(*count)++] = len;
+    }
+    return AWS_OP_SUCCESS;
+#else
+    (void)buf;
+    (void)slot_size;
+    (void)lengths;
+    (void)max_messages;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
@@ -0,0 +1,111 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_CAN_SOCKET_H
+#define DEVICE_CLIENT_CAN_SOCKET_H
+
+#include "DatagramSocket.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief CanSocket reads CAN frames from a raw CAN socket bound to a network interface.
+                 *
+                 * The configured address is the interface name, such as can0 or vcan0. Frames not matching the
+                 * configured filters are discarded by the kernel and never reach the device client. Frames are read
+                 * in batches with recvmmsg, and each frame is turned into a message in candump compact format,
+                 * such as 123#DEADBEEF, 1F334455#1122 for extended identifiers or 123#R for remote frames.
+                 *
+                 * Only supported on Linux.
+                 */
+                class CanSocket : public DatagramSocket
+                {
+                  public:
+                    /**
+                     * \brief Kernel CAN identifier filter, with the same layout as struct can_filter
+                     */
+                    struct Filter
+                    {
+                        uint32_t id;
+                        uint32_t mask;
+                    };
+
+                    /**
+                     * \brief Flags of CAN identifiers, with the same values as in linux/can.h
+                     */
+                    static constexpr uint32_t EFF_FLAG = 0x80000000U;
+                    static constexpr uint32_t RTR_FLAG = 0x40000000U;
+                    static constexpr uint32_t INV_FILTER = 0x20000000U;
+                    static constexpr uint32_t SFF_MASK = 0x000007FFU;
+                    static constexpr uint32_t EFF_MASK = 0x1FFFFFFFU;
+
+                    /**
+                     * \brief Size of the largest message of a single frame
+                     */
+                    static constexpr std::size_t FRAME_TEXT_MAX = 25;
+
+                    /**
+                     * \brief Parse a filter of the form id:mask, or id~mask to match frames not matching id:mask
+                     *
+                     * Identifiers and masks are hexadecimal, an identifier of 8 digits matches extended frames only.
+                     *
+                     * @return false when the text is not a filter
+                     */
+                    static bool ParseFilter(const std::string &text, Filter &filter);
+
+                    /**
+                     * \brief Write a frame in candump compact format to out, which holds at least FRAME_TEXT_MAX bytes
+                     *
+                     * @return the number of bytes written, the message is not null terminated
+                     */
+                    static std::size_t FormatFrame(uint32_t canId, const uint8_t *data, std::size_t len, char *out);
+
+                    explicit CanSocket(const std::vector<std::string> &filters);
+
+                    bool waits_for_address() override { return false; }
+
+                    /**
+                     * \brief Read frames into back to back messages
+                     *
+                     * Messages are never larger than FRAME_TEXT_MAX, frames whose message is larger than slot_size
+                     * are dropped as truncated.
+                     */
+                    int read_messages(
+                        aws_byte_buf *buf,
+                        std::size_t slot_size,
+                        std::size_t *lengths,
+                        std::size_t max_messages,
+                        std::size_t *count,
+                        std::size_t *truncated_bytes) override;
+
+                  protected:
+                    /**
+                     * \brief Create the raw CAN socket, install the filters and bind it to the interface named address
+                     */
+                    bool open(const char *address) override;
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "CanSocket.cpp";
+
+                    std::vector<Filter> mFilters;
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_CAN_SOCKET_H
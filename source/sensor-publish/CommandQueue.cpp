@@ -0,0 +1,90 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CommandQueue.h"
+
+#include "../config/Config.h"
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+bool CommandQueue::ParseDropPolicy(const string &name, DropPolicy &policy)
+{
+    if (name == PlainConfig::SensorPublish::DROP_POLICY_NEWEST)
+    {
+        policy = DropPolicy::Newest;
+        return true;
+    }
+    if (name == PlainConfig::SensorPublish::DROP_POLICY_OLDEST)
+    {
+        policy = DropPolicy::Oldest;
+        return true;
+    }
+    return false;
+}
+
+CommandQueue::CommandQueue(size_t capacityBytes, DropPolicy policy) : mCapacityBytes(capacityBytes), mPolicy(policy)
+{
+}
+
+size_t CommandQueue::push(const uint8_t *data, size_t len)
+{
+    if (len > mCapacityBytes)
+    {
+        return 1;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    size_t dropped = 0;
+    if (mBytes + len > mCapacityBytes)
+    {
+        if (mPolicy == DropPolicy::Newest)
+        {
+            return 1;
+        }
+        while (mBytes + len > mCapacityBytes)
+        {
+            mBytes -= mCommands.front().size();
+            mCommands.pop_front();
+            ++dropped;
+        }
+    }
+    mCommands.emplace_back(reinterpret_cast<const char *>(data), len);
+    mBytes += len;
+    return dropped;
+}
+
+bool CommandQueue::pop(string &command)
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mCommands.empty())
+    {
+        return false;
+    }
+    command.swap(mCommands.front());
+    mCommands.pop_front();
+    mBytes -= command.size();
+    return true;
+}
+
+size_t CommandQueue::clear()
+{
+    lock_guard<mutex> lock(mMutex);
+    size_t count = mCommands.size();
+    mCommands.clear();
+    mBytes = 0;
+    return count;
+}
+
+size_t CommandQueue::size() const
+{
+    lock_guard<mutex> lock(mMutex);
+    return mCommands.size();
+}
+
+size_t CommandQueue::bytes() const
+{
+    lock_guard<mutex> lock(mMutex);
+    return mBytes;
+}
@@ -0,0 +1,100 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_COMMAND_QUEUE_H
+#define DEVICE_CLIENT_COMMAND_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief CommandQueue buffers commands received over MQTT until they are written to the sensor socket.
+                 *
+                 * The queue is bounded by the total size of the queued commands. When a command does not fit, either
+                 * the command itself or the oldest queued commands are dropped, according to the drop policy.
+                 *
+                 * CommandQueue is thread safe, since commands are pushed from the MQTT event loop and popped from
+                 * the event loop of the sensor.
+                 */
+                class CommandQueue
+                {
+                  public:
+                    enum class DropPolicy
+                    {
+                        Newest,
+                        Oldest
+                    };
+
+                    /**
+                     * \brief Parse the name of a drop policy
+                     *
+                     * @return false when the name is not a supported drop policy
+                     */
+                    static bool ParseDropPolicy(const std::string &name, DropPolicy &policy);
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param capacityBytes maximum total size of the queued commands
+                     * @param policy commands dropped when a command does not fit
+                     */
+                    CommandQueue(std::size_t capacityBytes, DropPolicy policy);
+
+                    CommandQueue(const CommandQueue &) = delete;
+                    CommandQueue &operator=(const CommandQueue &) = delete;
+
+                    /**
+                     * \brief Queue a command
+                     *
+                     * Commands larger than the capacity are always dropped.
+                     *
+                     * @return number of commands dropped, including the command itself when it was not queued
+                     */
+                    std::size_t push(const uint8_t *data, std::size_t len);
+
+                    /**
+                     * \brief Remove the oldest command
+                     *
+                     * @return false when the queue is empty
+                     */
+                    bool pop(std::string &command);
+
+                    /**
+                     * \brief Remove every command
+                     *
+                     * @return number of commands removed
+                     */
+                    std::size_t clear();
+
+                    std::size_t size() const;
+
+                    std::size_t bytes() const;
+
+                  private:
+                    const std::size_t mCapacityBytes;
+
+                    const DropPolicy mPolicy;
+
+                    mutable std::mutex mMutex;
+
+                    std::deque<std::string> mCommands;
+
+                    std::size_t mBytes{0};
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_COMMAND_QUEUE_H
@@ -0,0 +1,178 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Compressor.h"
+
+#include "../config/Config.h"
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/zero.h>
+
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+#    include <zstd.h>
+#endif
+
+#include <stdexcept>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr int Compressor::DEFLATE_LEVEL;
+constexpr int Compressor::ZSTD_LEVEL;
+constexpr char Compressor::TAG[];
+
+namespace
+{
+    /**
+     * Window bits for deflate with a gzip header and trailer
+     */
+    constexpr int GZIP_WINDOW_BITS = 15 + 16;
+
+    constexpr int DEFLATE_MEM_LEVEL = 8;
+
+    voidpf zlibAlloc(voidpf opaque, uInt items, uInt size)
+    {
+        return aws_mem_calloc(static_cast<aws_allocator *>(opaque), items, size);
+    }
+
+    void zlibFree(voidpf opaque, voidpf address)
+    {
+        aws_mem_release(static_cast<aws_allocator *>(opaque), address);
+    }
+} // namespace
+
+Compressor::Compressor(aws_allocator *allocator, Algorithm algorithm, size_t maxInputBytes)
+    : mAllocator(allocator), mAlgorithm(algorithm), mMaxInputBytes(maxInputBytes)
+{
+    AWS_ZERO_STRUCT(mDeflate);
+    if (mAlgorithm == Algorithm::Deflate)
+    {
+        mDeflate.zalloc = zlibAlloc;
+        mDeflate.zfree = zlibFree;
+        mDeflate.opaque = mAllocator;
+        if (deflateInit2(
+                &mDeflate, DEFLATE_LEVEL, Z_DEFLATED, GZIP_WINDOW_BITS, DEFLATE_MEM_LEVEL, Z_DEFAULT_STRATEGY) !=
+            Z_OK)
+        {
+            throw std::runtime_error{"Unable to initialize deflate"};
+        }
+        mOutputCapacity = deflateBound(&mDeflate, uLong(mMaxInputBytes));
+    }
+    else
+    {
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+        mZstd = ZSTD_createCCtx();
+        if (mZstd == nullptr)
+        {
+            throw std::runtime_error{"Unable to create zstd context"};
+        }
+        ZSTD_CCtx_setParameter(mZstd, ZSTD_c_compressionLevel, ZSTD_LEVEL);
+        mOutputCapacity = ZSTD_compressBound(mMaxInputBytes);
+#else
+        throw std::runtime_error{"Device client is built without zstd"};
+#endif
+    }
+
+    mOutput = static_cast<uint8_t *>(aws_mem_acquire(mAllocator, mOutputCapacity));
+    if (mOutput == nullptr)
+    {
+        if (mAlgorithm == Algorithm::Deflate)
+        {
+            deflateEnd(&mDeflate);
+        }
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+        ZSTD_freeCCtx(mZstd);
+#endif
+        throw std::runtime_error{"Unable to allocate memory for compression buffer"};
+    }
+}
+
+Compressor::~Compressor()
+{
+    if (mAlgorithm == Algorithm::Deflate)
+    {
+        deflateEnd(&mDeflate);
+    }
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+    ZSTD_freeCCtx(mZstd);
+#endif
+    aws_secure_zero(mOutput, mOutputCapacity);
+    aws_mem_release(mAllocator, mOutput);
+}
+
+bool Compressor::ParseAlgorithm(const string &name, Algorithm &algorithm)
+{
+    if (name == PlainConfig::SensorPublish::COMPRESSION_DEFLATE)
+    {
+        algorithm = Algorithm::Deflate;
+        return true;
+    }
+    if (name == PlainConfig::SensorPublish::COMPRESSION_ZSTD)
+    {
+        algorithm = Algorithm::Zstd;
+        return true;
+    }
+    return false;
+}
+
+bool Compressor::compress(const aws_byte_cursor &input, aws_byte_cursor &output)
+{
+    if (input.len == 0 || input.len > mMaxInputBytes)
+    {
+        return false;
+    }
+
+    size_t outputLen = 0;
+    bool compressed = mAlgorithm == Algorithm::Deflate ? compressDeflate(input, outputLen)
+                                                       : compressZstd(input, outputLen);
+    if (!compressed || outputLen >= input.len)
+    {
+        return false; // Publish the batch as is.
+    }
+    output = aws_byte_cursor_from_array(mOutput, outputLen);
+    return true;
+}
+
+bool Compressor::compressDeflate(const aws_byte_cursor &input, size_t &outputLen)
+{
+    // Reset keeps the allocated state, so compressing a batch does not allocate memory.
+    if (deflateReset(&mDeflate) != Z_OK)
+    {
+        return false;
+    }
+    mDeflate.next_in = input.ptr;
+    mDeflate.avail_in = uInt(input.len);
+    mDeflate.next_out = mOutput;
+    mDeflate.avail_out = uInt(mOutputCapacity);
+
+    int rc = deflate(&mDeflate, Z_FINISH);
+    if (rc != Z_STREAM_END)
+    {
+        LOGM_ERROR(TAG, "Error func: deflate rc: %d", rc);
+        return false;
+    }
+    outputLen = mOutputCapacity - mDeflate.avail_out;
+    return true;
+}
+
+bool Compressor::compressZstd(const aws_byte_cursor &input, size_t &outputLen)
+{
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+    // The context keeps its parameters and workspace between batches.
+    size_t rc = ZSTD_compress2(mZstd, mOutput, mOutputCapacity, input.ptr, input.len);
+    if (ZSTD_isError(rc))
+    {
+        LOGM_ERROR(TAG, "Error func: ZSTD_compress2 msg: %s", ZSTD_getErrorName(rc));
+        return false;
+    }
+    outputLen = rc;
+    return true;
+#else
+    (void)input;
+    (void)outputLen;
+    return false;
+#endif
+}
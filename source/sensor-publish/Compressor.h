@@ -0,0 +1,123 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_COMPRESSOR_H
+#define DEVICE_CLIENT_COMPRESSOR_H
+
+#include <aws/common/byte_buf.h>
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+struct ZSTD_CCtx_s;
+#endif
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Compressor compresses sensor batches before publishing.
+                 *
+                 * The compression context and the output buffer are allocated once, sized for the largest
+                 * batch, and reused for every batch, so compressing a batch does not allocate memory.
+                 *
+                 * Deflate output uses the gzip format (RFC 1952) and zstd output uses the zstd frame format,
+                 * so a consumer can tell compressed and uncompressed payloads apart from the leading magic
+                 * bytes (1f 8b for gzip, 28 b5 2f fd for zstd).
+                 *
+                 * Compressor is not thread safe, and is only used from the event loop of its sensor.
+                 */
+                class Compressor
+                {
+                  public:
+                    enum class Algorithm
+                    {
+                        Deflate,
+                        Zstd
+                    };
+
+                    /**
+                     * \brief Compression level used for deflate
+                     */
+                    static constexpr int DEFLATE_LEVEL = 6;
+
+                    /**
+                     * \brief Compression level used for zstd
+                     */
+                    static constexpr int ZSTD_LEVEL = 3;
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param algorithm compression algorithm
+                     * @param maxInputBytes size of the largest batch which will be compressed
+                     *
+                     * @throws std::runtime_error when the compression context cannot be created
+                     */
+                    Compressor(aws_allocator *allocator, Algorithm algorithm, std::size_t maxInputBytes);
+
+                    ~Compressor();
+
+                    Compressor(const Compressor &) = delete;
+                    Compressor &operator=(const Compressor &) = delete;
+
+                    /**
+                     * \brief Parse the name of a compression algorithm
+                     *
+                     * @return false when the name is not a supported algorithm
+                     */
+                    static bool ParseAlgorithm(const std::string &name, Algorithm &algorithm);
+
+                    /**
+                     * \brief Compress a batch
+                     *
+                     * @param input batch, no larger than the maximum input size
+                     * @param output set to a view of the compressed batch, valid until the next call
+                     * @return false when compression failed or did not make the batch smaller
+                     */
+                    bool compress(const aws_byte_cursor &input, aws_byte_cursor &output);
+
+                    /**
+                     * \brief Size of the largest batch which can be compressed
+                     */
+                    std::size_t maxInputBytes() const { return mMaxInputBytes; }
+
+                  private:
+                    static constexpr char TAG[] = "Compressor.cpp";
+
+                    aws_allocator *mAllocator{nullptr};
+
+                    Algorithm mAlgorithm;
+
+                    std::size_t mMaxInputBytes{0};
+
+                    uint8_t *mOutput{nullptr};
+
+                    std::size_t mOutputCapacity{0};
+
+                    z_stream mDeflate;
+
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+                    ZSTD_CCtx_s *mZstd{nullptr};
+#endif
+
+                    bool compressDeflate(const aws_byte_cursor &input, std::size_t &outputLen);
+
+                    bool compressZstd(const aws_byte_cursor &input, std::size_t &outputLen);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_COMPRESSOR_H
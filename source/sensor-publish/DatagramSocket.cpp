@@ -0,0 +1,463 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "DatagramSocket.h"
+
+#include "../config/Config.h"
+#include "../logging/LoggerFactory.h"
+
+#include <aws/common/error.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/io/io.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <future>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char DatagramSocket::TAG[];
+
+namespace
+{
+    /**
+     * Maximum number of messages received with a single system call
+     */
+    constexpr size_t READ_BATCH_MAX = 64;
+
+    /**
+     * Permissions of the socket file bound by the device client, sensors must be in its group to send to it
+     */
+    constexpr mode_t BOUND_SOCKET_MODE = 0660;
+
+#if defined(__linux__)
+    using MessageHeader = struct mmsghdr;
+#else
+    struct MessageHeader
+    {
+        struct msghdr msg_hdr;
+        unsigned int msg_len;
+    };
+#endif
+
+    /**
+     * Parse a loopback UDP address of the form 127.x.x.x:port
+     */
+    bool parseLoopbackAddress(const char *address, sockaddr_in &addr)
+    {
+        const char *colon = strrchr(address, ':');
+        if (colon == nullptr)
+        {
+            return false;
+        }
+        string host(address, colon);
+        char *end = nullptr;
+        long port = strtol(colon + 1, &end, 10);
+        if (end == colon + 1 || *end != '\0' || port < 1 || port > 65535)
+        {
+            return false;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+        {
+            return false;
+        }
+        return (ntohl(addr.sin_addr.s_addr) >> 24) == 127;
+    }
+
+    /**
+     * Create a non-blocking socket which is not inherited by child processes
+     */
+    int createSocket(int domain, int type)
+    {
+        int fd = socket(domain, type, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) != 0)
+        {
+            int errnum = errno;
+            ::close(fd);
+            errno = errnum;
+            return -1;
+        }
+        return fd;
+    }
+} // namespace
+
+bool DatagramSocket::ParseType(const string &name, Type &type)
+{
+    if (name == PlainConfig::SensorPublish::ADDR_TYPE_DGRAM)
+    {
+        type = Type::UnixDatagram;
+    }
+    else if (name == PlainConfig::SensorPublish::ADDR_TYPE_SEQPACKET)
+    {
+        type = Type::UnixSeqPacket;
+    }
+    else if (name == PlainConfig::SensorPublish::ADDR_TYPE_UDP)
+    {
+        type = Type::Udp;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+DatagramSocket::DatagramSocket(Type type) : mType(type) {}
+
+DatagramSocket::~DatagramSocket()
+{
+    if (is_open())
+    {
+        close();
+    }
+}
+
+void DatagramSocket::init(aws_allocator *)
+{
+    // The socket type is fixed at construction and no memory is allocated.
+}
+
+int DatagramSocket::connect(
+    const struct aws_socket_endpoint *remote_endpoint,
+    struct aws_event_loop *event_loop,
+    aws_socket_on_connection_result_fn *on_connection_result,
+    void *user_data)
+{
+    if (is_open())
+    {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+    if (!open(remote_endpoint->address))
+    {
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    mEventLoop = event_loop;
+    mIoHandle.data.fd = mFd;
+    mIoHandle.additional_data = nullptr;
+
+    // Binding and connecting a local socket complete immediately.
+    on_connection_result(nullptr, AWS_OP_SUCCESS, user_data);
+    return AWS_OP_SUCCESS;
+}
+
+bool DatagramSocket::open(const char *address)
+{
+    int rc = -1;
+    if (mType == Type::Udp)
+    {
+        sockaddr_in addr;
+        if (!parseLoopbackAddress(address, addr))
+        {
+            LOGM_ERROR(TAG, "Invalid loopback UDP address: %s", address);
+            errno = EINVAL;
+            return false;
+        }
+        mFd = createSocket(AF_INET, SOCK_DGRAM);
+        if (mFd >= 0)
+        {
+            rc = ::bind(mFd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+        }
+    }
+    else
+    {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", address);
+
+        if (mType == Type::UnixSeqPacket)
+        {
+            mFd = createSocket(AF_UNIX, SOCK_SEQPACKET);
+            if (mFd >= 0)
+            {
+                rc = ::connect(mFd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+            }
+        }
+        else
+        {
+            // Replace a socket file left behind by a previous run, but never any other kind of file.
+            struct stat st;
+            if (lstat(addr.sun_path, &st) == 0 && S_ISSOCK(st.st_mode))
+            {
+                unlink(addr.sun_path);
+            }
+            mFd = createSocket(AF_UNIX, SOCK_DGRAM);
+            if (mFd >= 0)
+            {
+                rc = ::bind(mFd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+                if (rc == 0)
+                {
+                    mBoundPath = addr.sun_path;
+                    rc = chmod(addr.sun_path, BOUND_SOCKET_MODE);
+                }
+            }
+        }
+    }
+
+    if (mFd < 0 || rc != 0)
+    {
+        int errnum = errno != 0 ? errno : 1;
+        LOGM_ERROR(TAG, "Unable to open socket address: %s errno: %d msg: %s", address, errnum, strerror(errnum));
+        closeOnEventLoop();
+        return false;
+    }
+    return true;
+}
+
+int DatagramSocket::subscribe_to_readable_events(aws_socket_on_readable_fn *on_readable, void *user_data)
+{
+    if (!is_open() || mSubscribed)
+    {
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    mOnReadable = on_readable;
+    mUserData = user_data;
+    if (aws_event_loop_subscribe_to_io_events(mEventLoop, &mIoHandle, AWS_IO_EVENT_TYPE_READABLE, onIoEvent, this) !=
+        AWS_OP_SUCCESS)
+    {
+        return AWS_OP_ERR;
+    }
+    mSubscribed = true;
+    return AWS_OP_SUCCESS;
+}
+
+void DatagramSocket::onIoEvent(aws_event_loop *, aws_io_handle *, int events, void *userData)
+{
+    auto *self = static_cast<DatagramSocket *>(userData);
+    if (events & AWS_IO_EVENT_TYPE_READABLE)
+    {
+        // Hang up is detected by the next read once buffered messages are consumed.
+        self->mOnReadable(nullptr, AWS_OP_SUCCESS, self->mUserData);
+    }
+    else if (events & (AWS_IO_EVENT_TYPE_REMOTE_HANG_UP | AWS_IO_EVENT_TYPE_CLOSED | AWS_IO_EVENT_TYPE_ERROR))
+    {
+        self->mOnReadable(nullptr, AWS_IO_SOCKET_CLOSED, self->mUserData);
+    }
+}
+
+int DatagramSocket::read(aws_byte_buf *buf, size_t *amount_read)
+{
+    *amount_read = 0;
+    ssize_t rc = recv(mFd, buf->buffer + buf->len, buf->capacity - buf->len, 0);
+    if (rc < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        if (errno == ECONNRESET)
+        {
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+    if (rc == 0 && mType == Type::UnixSeqPacket)
+    {
+        return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+    }
+    buf->len += static_cast<size_t>(rc);
+    *amount_read = static_cast<size_t>(rc);
+    return AWS_OP_SUCCESS;
+}
+
+int DatagramSocket::read_messages(
+    aws_byte_buf *buf,
+    size_t slot_size,
+    size_t *lengths,
+    size_t max_messages,
+    size_t *count,
+    size_t *truncated_bytes)
+{
+    *count = 0;
+    *truncated_bytes = 0;
+
+    // Each message is received into its own slot of slot_size bytes.
+    uint8_t *base = buf->buffer + buf->len;
+    size_t slots = min(max_messages, min(READ_BATCH_MAX, (buf->capacity - buf->len) / slot_size));
+    if (slots == 0)
+    {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    MessageHeader messages[READ_BATCH_MAX];
+    iovec vectors[READ_BATCH_MAX];
+    memset(messages, 0, sizeof(MessageHeader) * slots);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        vectors[i].iov_base = base + i * slot_size;
+        vectors[i].iov_len = slot_size;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+#if defined(__linux__)
+    // MSG_TRUNC returns the real length of truncated messages.
+    int received = recvmmsg(mFd, messages, static_cast<unsigned int>(slots), MSG_DONTWAIT | MSG_TRUNC, nullptr);
+#else
+    int received = 0;
+    while (static_cast<size_t>(received) < slots)
+    {
+        ssize_t rc = recvmsg(mFd, &messages[received].msg_hdr, MSG_DONTWAIT);
+        if (rc < 0)
+        {
+            received = received == 0 ? -1 : received;
+            break;
+        }
+        messages[received].msg_len = static_cast<unsigned int>(rc);
+        ++received;
+    }
+#endif
+    if (received < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        if (errno == ECONNRESET)
+        {
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+        LOGM_ERROR(TAG, "Unable to receive messages errno: %d msg: %s", errno, strerror(errno));
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+
+    // Move the messages back to back, dropping truncated and empty messages.
+    uint8_t *out = base;
+    for (int i = 0; i < received; ++i)
+    {
+        size_t len = messages[i].msg_len;
+        if (messages[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            *truncated_bytes += len;
+            continue;
+        }
+        if (len == 0)
+        {
+            if (mType == Type::UnixSeqPacket)
+            {
+                // End of stream, reported once the messages before it are consumed.
+                if (*count == 0 && *truncated_bytes == 0)
+                {
+                    return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+                }
+                break;
+            }
+            continue;
+        }
+        uint8_t *slot = base + static_cast<size_t>(i) * slot_size;
+        if (out != slot)
+        {
+            memmove(out, slot, len);
+        }
+        out += len;
+        lengths[(*count)++] = len;
+    }
+    buf->len += static_cast<size_t>(out - base);
+    return AWS_OP_SUCCESS;
+}
+
+int DatagramSocket::write(const aws_byte_cursor *cursor, aws_socket_on_write_completed_fn *written_fn, void *user_data)
+{
+    if (mType != Type::UnixSeqPacket)
+    {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    int flags = MSG_DONTWAIT;
+#if defined(MSG_NOSIGNAL)
+    flags |= MSG_NOSIGNAL; // Report a closed peer as EPIPE rather than raising SIGPIPE.
+#endif
+    ssize_t rc = send(mFd, cursor->ptr, cursor->len, flags);
+    if (rc < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        if (errno == EPIPE || errno == ECONNRESET)
+        {
+            return aws_raise_error(AWS_IO_SOCKET_CLOSED);
+        }
+        return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+    written_fn(nullptr, AWS_OP_SUCCESS, static_cast<size_t>(rc), user_data);
+    return AWS_OP_SUCCESS;
+}
+
+int DatagramSocket::close()
+{
+    if (mSubscribed && !aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        // Unsubscribing is only allowed from the event loop thread, so wait for the event loop to close the socket.
+        struct CloseArgs
+        {
+            DatagramSocket *self;
+            promise<void> done;
+        } args{this, promise<void>()};
+        future<void> done = args.done.get_future();
+
+        aws_task task;
+        aws_task_init(
+            &task,
+            [](struct aws_task *, void *arg, enum aws_task_status status) {
+                auto *closeArgs = static_cast<CloseArgs *>(arg);
+                if (status == AWS_TASK_STATUS_CANCELED)
+                {
+                    closeArgs->self->mSubscribed = false; // Event loop is shutting down.
+                }
+                closeArgs->self->closeOnEventLoop();
+                closeArgs->done.set_value();
+            },
+            &args,
+            __func__);
+        aws_event_loop_schedule_task_now(mEventLoop, &task);
+        done.wait();
+    }
+    else
+    {
+        closeOnEventLoop();
+    }
+    return AWS_OP_SUCCESS;
+}
+
+void DatagramSocket::closeOnEventLoop()
+{
+    if (mSubscribed)
+    {
+        aws_event_loop_unsubscribe_from_io_events(mEventLoop, &mIoHandle);
+        mSubscribed = false;
+    }
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+        mFd = -1;
+    }
+    if (!mBoundPath.empty())
+    {
+        unlink(mBoundPath.c_str());
+        mBoundPath.clear();
+    }
+}
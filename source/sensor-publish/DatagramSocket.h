@@ -0,0 +1,159 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_DATAGRAM_SOCKET_H
+#define DEVICE_CLIENT_DATAGRAM_SOCKET_H
+
+#include "Socket.h"
+
+#include <aws/io/event_loop.h>
+
+#include <cstddef>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief DatagramSocket reads sensor messages from a message based socket.
+                 *
+                 * The kernel preserves message boundaries, so every read returns whole messages and no end of
+                 * message delimiter is scanned for. Messages are read in batches with recvmmsg where available.
+                 *
+                 * - Unix datagram and UDP sockets are bound by the device client at the configured address, and
+                 *   sensors send messages to it. A stale socket file left at the address is replaced.
+                 * - Unix seqpacket sockets are connected to the sensor server at the configured address, as for
+                 *   stream sockets.
+                 * - Raw CAN sockets are bound to a network interface by the CanSocket subclass.
+                 *
+                 * UDP sockets are only bound to loopback addresses.
+                 */
+                class DatagramSocket : public Socket
+                {
+                  public:
+                    enum class Type
+                    {
+                        UnixDatagram,
+                        UnixSeqPacket,
+                        Udp,
+                        Can
+                    };
+
+                    /**
+                     * \brief Parse the socket type from its configuration name
+                     *
+                     * @return false when the name is not a message based socket type
+                     */
+                    static bool ParseType(const std::string &name, Type &type);
+
+                    explicit DatagramSocket(Type type);
+
+                    ~DatagramSocket() override;
+
+                    DatagramSocket(const DatagramSocket &) = delete;
+                    DatagramSocket &operator=(const DatagramSocket &) = delete;
+
+                    void init(aws_allocator *allocator) override;
+
+                    /**
+                     * \brief Bind or connect the socket to remote_endpoint
+                     *
+                     * Completes synchronously: on_connection_result is invoked before returning on success.
+                     */
+                    int connect(
+                        const struct aws_socket_endpoint *remote_endpoint,
+                        struct aws_event_loop *event_loop,
+                        aws_socket_on_connection_result_fn *on_connection_result,
+                        void *user_data) override;
+
+                    int subscribe_to_readable_events(aws_socket_on_readable_fn *on_readable, void *user_data) override;
+
+                    bool is_open() override { return mFd >= 0; }
+
+                    /**
+                     * \brief Read a single message
+                     */
+                    int read(aws_byte_buf *buf, std::size_t *amount_read) override;
+
+                    /**
+                     * \brief Close the socket and remove the socket file it is bound to, if any
+                     *
+                     * Must be called from the event loop thread once subscribed, otherwise blocks until the
+                     * event loop has unsubscribed the socket.
+                     */
+                    int close() override;
+
+                    void clean_up() override {}
+
+                    bool is_message_based() override { return true; }
+
+                    bool waits_for_address() override { return mType == Type::UnixSeqPacket; }
+
+                    int read_messages(
+                        aws_byte_buf *buf,
+                        std::size_t slot_size,
+                        std::size_t *lengths,
+                        std::size_t max_messages,
+                        std::size_t *count,
+                        std::size_t *truncated_bytes) override;
+
+                    /**
+                     * \brief Send a single message to the connected peer
+                     *
+                     * Only supported for UnixSeqPacket, since sockets bound to their address have no single peer.
+                     * Completes synchronously: written_fn is invoked before returning on success.
+                     */
+                    int write(
+                        const aws_byte_cursor *cursor,
+                        aws_socket_on_write_completed_fn *written_fn,
+                        void *user_data) override;
+
+                  protected:
+                    Type mType;
+
+                    int mFd{-1};
+
+                    /**
+                     * \brief Create the socket and bind or connect it to address
+                     */
+                    virtual bool open(const char *address);
+
+                    /**
+                     * \brief Unsubscribe from the event loop and close the file descriptor
+                     */
+                    void closeOnEventLoop();
+
+                  private:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "DatagramSocket.cpp";
+
+                    aws_io_handle mIoHandle{};
+
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    bool mSubscribed{false};
+
+                    aws_socket_on_readable_fn *mOnReadable{nullptr};
+
+                    void *mUserData{nullptr};
+
+                    /**
+                     * \brief Path of the socket file bound by this socket, empty when not bound to a path
+                     */
+                    std::string mBoundPath;
+
+                    static void onIoEvent(aws_event_loop *eventLoop, aws_io_handle *handle, int events, void *userData);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_DATAGRAM_SOCKET_H
@@ -0,0 +1,416 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "EomScanner.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr size_t EomScanner::UNBOUNDED_LOOKBEHIND;
+constexpr size_t EomScanner::HORSPOOL_MIN_LENGTH;
+constexpr size_t EomScanner::SWAR_MAX_SET_SIZE;
+
+namespace
+{
+    /**
+     * \brief Characters with special meaning in an ECMAScript pattern outside of a character class.
+     */
+    bool isSyntaxChar(char c) { return c != '\0' && strchr("^$\\.*+?()[]{}|", c) != nullptr; }
+
+    int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    /**
+     * \brief Parse an escape sequence that denotes exactly one byte.
+     *
+     * On entry pattern[pos] is the backslash. On success pos is advanced past the escape sequence.
+     * Escapes for character classes (\d, \s, \w, ...), assertions and back references are rejected.
+     */
+    bool parseEscape(const string &pattern, size_t &pos, bool inClass, char &out)
+    {
+        if (pos + 1 >= pattern.size())
+        {
+            return false;
+        }
+        char c = pattern[pos + 1];
+        size_t len = 2;
+        switch (c)
+        {
+            case 'n':
+                out = '\n';
+                break;
+            case 'r':
+                out = '\r';
+                break;
+            case 't':
+                out = '\t';
+                break;
+            case 'f':
+                out = '\f';
+                break;
+            case 'v':
+                out = '\v';
+                break;
+            case 'b':
+                if (!inClass)
+                {
+                    return false; // Word boundary assertion.
+                }
+                out = '\b';
+                break;
+            case '0':
+                if (pos + 2 < pattern.size() && isdigit(static_cast<unsigned char>(pattern[pos + 2])))
+                {
+                    return false;
+                }
+                out = '\0';
+                break;
+            case 'x':
+            {
+                if (pos + 3 >= pattern.size())
+                {
+                    return false;
+                }
+                int hi = hexValue(pattern[pos + 2]);
+                int lo = hexValue(pattern[pos + 3]);
+                if (hi < 0 || lo < 0)
+                {
+                    return false;
+                }
+                out = static_cast<char>(hi * 16 + lo);
+                len = 4;
+                break;
+            }
+            default:
+                if (c == '\0' || isalnum(static_cast<unsigned char>(c)) || c == '_')
+                {
+                    return false;
+                }
+                out = c; // Identity escape.
+                break;
+        }
+        pos += len;
+        return true;
+    }
+
+    /**
+     * \brief Parse one member of a character class. On success pos is advanced past the member.
+     */
+    bool parseClassAtom(const string &pattern, size_t &pos, char &out)
+    {
+        char c = pattern[pos];
+        if (c == '\\')
+        {
+            return parseEscape(pattern, pos, true, out);
+        }
+        if (c == '[')
+        {
+            return false; // Named classes such as [:digit:] are left to std::regex.
+        }
+        out = c;
+        ++pos;
+        return true;
+    }
+} // namespace
+
+EomScanner::EomScanner(const string &pattern)
+{
+    if (!parse(pattern))
+    {
+        mMode = Mode::Regex;
+        mRegex = regex(pattern);
+        return;
+    }
+
+    if (mMode == Mode::Literal && mLiteral.size() >= HORSPOOL_MIN_LENGTH)
+    {
+        const size_t last = mLiteral.size() - 1;
+        mShift.fill(mLiteral.size());
+        for (size_t i = 0; i < last; ++i)
+        {
+            mShift[static_cast<unsigned char>(mLiteral[i])] = last - i;
+        }
+    }
+
+    if (mMode == Mode::ByteSet || mMode == Mode::ByteSetRun)
+    {
+        for (size_t i = 0; i < mSet.size(); ++i)
+        {
+            if (mSet[i])
+            {
+                mSetBytes.push_back(static_cast<char>(i));
+            }
+        }
+    }
+}
+
+bool EomScanner::parse(const string &pattern)
+{
+    if (pattern.empty())
+    {
+        return false;
+    }
+
+    size_t pos = 0;
+    if (pattern[0] == '[')
+    {
+        // Single character class, optionally repeated.
+        pos = 1;
+        bool negate = false;
+        if (pos < pattern.size() && pattern[pos] == '^')
+        {
+            negate = true;
+            ++pos;
+        }
+        if (pos < pattern.size() && pattern[pos] == ']')
+        {
+            return false; // Empty class.
+        }
+        while (pos < pattern.size() && pattern[pos] != ']')
+        {
+            char lo;
+            if (!parseClassAtom(pattern, pos, lo))
+            {
+                return false;
+            }
+            if (pos + 1 < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']')
+            {
+                ++pos;
+                char hi;
+                if (!parseClassAtom(pattern, pos, hi))
+                {
+                    return false;
+                }
+                // Leave ranges whose ordering depends on the signedness of char to std::regex.
+                auto ulo = static_cast<unsigned char>(lo), uhi = static_cast<unsigned char>(hi);
+                if (ulo > uhi || uhi >= 0x80)
+                {
+                    return false;
+                }
+                for (unsigned int b = ulo; b <= uhi; ++b)
+                {
+                    mSet[b] = true;
+                }
+            }
+            else
+            {
+                mSet[static_cast<unsigned char>(lo)] = true;
+            }
+        }
+        if (pos >= pattern.size())
+        {
+            return false; // Unterminated class.
+        }
+        ++pos;
+        if (negate)
+        {
+            for (auto &member : mSet)
+            {
+                member = !member;
+            }
+        }
+    }
+    else
+    {
+        // Sequence of literal characters.
+        while (pos < pattern.size())
+        {
+            char c = pattern[pos];
+            if (c == '\\')
+            {
+                if (!parseEscape(pattern, pos, false, c))
+                {
+                    return false;
+                }
+            }
+            else if (c == '+' && mLiteral.size() == 1 && pos + 1 == pattern.size())
+            {
+                break; // Repeated single character, handled below.
+            }
+            else if (isSyntaxChar(c))
+            {
+                return false;
+            }
+            else
+            {
+                ++pos;
+            }
+            mLiteral.push_back(c);
+        }
+        if (pos == pattern.size())
+        {
+            mMode = mLiteral.size() == 1 ? Mode::Byte : Mode::Literal;
+            return true;
+        }
+        mSet[static_cast<unsigned char>(mLiteral[0])] = true;
+        mLiteral.clear();
+    }
+
+    if (pos == pattern.size())
+    {
+        mMode = Mode::ByteSet;
+    }
+    else if (pattern[pos] == '+' && pos + 1 == pattern.size())
+    {
+        mMode = Mode::ByteSetRun;
+    }
+    else
+    {
+        mSet.fill(false);
+        return false;
+    }
+    return true;
+}
+
+size_t EomScanner::lookbehind() const
+{
+    switch (mMode)
+    {
+        case Mode::Literal:
+            return mLiteral.size() - 1;
+        case Mode::Regex:
+            return UNBOUNDED_LOOKBEHIND;
+        default:
+            return 0;
+    }
+}
+
+const char *EomScanner::delimiterBegin(const char *begin, const char *end) const
+{
+    switch (mMode)
+    {
+        case Mode::Byte:
+        case Mode::Literal:
+            if (static_cast<size_t>(end - begin) >= mLiteral.size() &&
+                memcmp(end - mLiteral.size(), mLiteral.data(), mLiteral.size()) == 0)
+            {
+                return end - mLiteral.size();
+            }
+            return end;
+        case Mode::ByteSet:
+            return end > begin && inSet(end[-1]) ? end - 1 : end;
+        case Mode::ByteSetRun:
+        {
+            const char *p = end;
+            while (p > begin && inSet(p[-1]))
+            {
+                --p;
+            }
+            return p;
+        }
+        case Mode::Regex:
+        default:
+        {
+            // The message holds exactly one match, the delimiter at its end.
+            const char *delimiter = end;
+            for (auto m = cregex_iterator(begin, end, mRegex), mend = cregex_iterator(); m != mend; ++m)
+            {
+                if ((*m).position() + (*m).length() == end - begin)
+                {
+                    delimiter = begin + (*m).position();
+                }
+            }
+            return delimiter;
+        }
+    }
+}
+
+const char *EomScanner::findInSet(const char *p, const char *end) const
+{
+    if (mSetBytes.size() == 1)
+    {
+        const void *m = memchr(p, mSetBytes[0], static_cast<size_t>(end - p));
+        return m == nullptr ? end : static_cast<const char *>(m);
+    }
+
+    if (!mSetBytes.empty() && mSetBytes.size() <= SWAR_MAX_SET_SIZE)
+    {
+        // Test eight bytes at a time for a byte equal to any member of the set.
+        // A byte of (w ^ pattern) is zero where w contains the member, and
+        // (x - ones) & ~x & highs is non-zero exactly when x contains a zero byte.
+        constexpr uint64_t ones = 0x0101010101010101ULL;
+        constexpr uint64_t highs = 0x8080808080808080ULL;
+        uint64_t patterns[SWAR_MAX_SET_SIZE];
+        for (size_t i = 0; i < mSetBytes.size(); ++i)
+        {
+            patterns[i] = ones * static_cast<unsigned char>(mSetBytes[i]);
+        }
+        while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t)))
+        {
+            uint64_t w;
+            memcpy(&w, p, sizeof(w));
+            uint64_t hit = 0;
+            for (size_t i = 0; i < mSetBytes.size(); ++i)
+            {
+                uint64_t x = w ^ patterns[i];
+                hit |= (x - ones) & ~x & highs;
+            }
+            if (hit != 0)
+            {
+                break;
+            }
+            p += sizeof(w);
+        }
+    }
+
+    while (p < end && !inSet(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+const char *EomScanner::findLiteral(const char *p, const char *end) const
+{
+    const size_t len = mLiteral.size();
+    if (len < HORSPOOL_MIN_LENGTH)
+    {
+        // Anchor on the first byte using memchr, then verify the remainder.
+        while (static_cast<size_t>(end - p) >= len)
+        {
+            const void *m = memchr(p, mLiteral[0], static_cast<size_t>(end - p) - (len - 1));
+            if (m == nullptr)
+            {
+                return nullptr;
+            }
+            const char *q = static_cast<const char *>(m);
+            if (memcmp(q + 1, mLiteral.data() + 1, len - 1) == 0)
+            {
+                return q;
+            }
+            p = q + 1;
+        }
+        return nullptr;
+    }
+
+    const size_t last = len - 1;
+    const char lastByte = mLiteral[last];
+    while (static_cast<size_t>(end - p) >= len)
+    {
+        char c = p[last];
+        if (c == lastByte && memcmp(p, mLiteral.data(), last) == 0)
+        {
+            return p;
+        }
+        p += mShift[static_cast<unsigned char>(c)];
+    }
+    return nullptr;
+}
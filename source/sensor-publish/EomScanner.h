@@ -0,0 +1,232 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_EOM_SCANNER_H
+#define DEVICE_CLIENT_EOM_SCANNER_H
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <regex>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief EomScanner finds end of message boundaries in sensor data.
+                 *
+                 * The eom_delimiter is analyzed once at construction and the cheapest search
+                 * strategy that produces the same matches as std::regex is selected:
+                 *
+                 * - Byte: a single literal character such as `\n`, searched using memchr.
+                 * - Literal: a multi-character literal such as `\r\n`, searched by anchoring on the
+                 *   first character with memchr, or using Horspool for longer delimiters.
+                 * - ByteSet: a single character class such as `[,;]`, where every byte is a match.
+                 * - ByteSetRun: a repeated character class such as `[\r\n]+`, where every maximal run of
+                 *   bytes from the class is a match.
+                 * - Regex: any other pattern falls back to std::regex.
+                 */
+                class EomScanner
+                {
+                  public:
+                    enum class Mode
+                    {
+                        Byte,
+                        Literal,
+                        ByteSet,
+                        ByteSetRun,
+                        Regex
+                    };
+
+                    /**
+                     * \brief Returned by lookbehind() when a match may begin anywhere before the new data.
+                     */
+                    static constexpr std::size_t UNBOUNDED_LOOKBEHIND = std::numeric_limits<std::size_t>::max();
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param pattern the eom_delimiter, a regular expression in ECMAScript syntax
+                     *
+                     * @throws std::regex_error when the pattern requires std::regex and is not a valid
+                     * regular expression
+                     */
+                    explicit EomScanner(const std::string &pattern);
+
+                    /**
+                     * \brief Search strategy selected for the pattern
+                     */
+                    Mode getMode() const { return mMode; }
+
+                    /**
+                     * \brief Number of previously scanned bytes that must be rescanned when new data arrives
+                     *
+                     * A literal delimiter may straddle two reads, so the last (length - 1) bytes of the
+                     * previous read are scanned again. For Regex there is no bound.
+                     */
+                    std::size_t lookbehind() const;
+
+                    /**
+                     * \brief Find where the delimiter terminating a complete message begins
+                     *
+                     * @param begin start of the message
+                     * @param end one-past the end of the delimiter, as reported by scan()
+                     * @return start of the delimiter, or end when no delimiter ends at end
+                     */
+                    const char *delimiterBegin(const char *begin, const char *end) const;
+
+                    /**
+                     * \brief Scan [begin, end) for end of message boundaries
+                     *
+                     * @param begin start of data to scan
+                     * @param end one-past the end of data to scan
+                     * @param onMatch invoked with the offset from begin of one-past the end of each match;
+                     * returning false stops the scan
+                     */
+                    template <typename OnMatch> void scan(const char *begin, const char *end, OnMatch onMatch) const
+                    {
+                        switch (mMode)
+                        {
+                            case Mode::Byte:
+                            case Mode::Literal:
+                                scanLiteral(begin, end, onMatch);
+                                break;
+                            case Mode::ByteSet:
+                            case Mode::ByteSetRun:
+                                scanByteSet(begin, end, onMatch);
+                                break;
+                            case Mode::Regex:
+                                scanRegex(begin, end, onMatch);
+                                break;
+                        }
+                    }
+
+                  private:
+                    /**
+                     * \brief Delimiters at least this long are searched using Horspool instead of memchr.
+                     */
+                    static constexpr std::size_t HORSPOOL_MIN_LENGTH = 4;
+
+                    /**
+                     * \brief Byte sets no larger than this are searched a machine word at a time.
+                     */
+                    static constexpr std::size_t SWAR_MAX_SET_SIZE = 3;
+
+                    Mode mMode{Mode::Regex};
+
+                    /**
+                     * \brief Literal delimiter bytes for Byte and Literal modes
+                     */
+                    std::string mLiteral;
+
+                    /**
+                     * \brief Horspool bad character shift table for long literals
+                     */
+                    std::array<std::size_t, 256> mShift{};
+
+                    /**
+                     * \brief Membership table for ByteSet and ByteSetRun modes
+                     */
+                    std::array<bool, 256> mSet{};
+
+                    /**
+                     * \brief Members of the byte set, used for word at a time search of small sets
+                     */
+                    std::string mSetBytes;
+
+                    /**
+                     * \brief Compiled pattern for Regex mode
+                     */
+                    std::regex mRegex;
+
+                    /**
+                     * \brief Parse the pattern as a literal or a single character class
+                     *
+                     * @return true when a fast path applies to the pattern
+                     */
+                    bool parse(const std::string &pattern);
+
+                    /**
+                     * \brief Find the first byte in [p, end) belonging to the byte set
+                     */
+                    const char *findInSet(const char *p, const char *end) const;
+
+                    /**
+                     * \brief Find the first occurrence of the literal in [p, end)
+                     */
+                    const char *findLiteral(const char *p, const char *end) const;
+
+                    bool inSet(char c) const { return mSet[static_cast<unsigned char>(c)]; }
+
+                    template <typename OnMatch>
+                    void scanLiteral(const char *begin, const char *end, OnMatch &onMatch) const
+                    {
+                        const std::size_t len = mLiteral.size();
+                        const char *p = begin;
+                        while (static_cast<std::size_t>(end - p) >= len)
+                        {
+                            const char *m = findLiteral(p, end);
+                            if (m == nullptr)
+                            {
+                                return;
+                            }
+                            p = m + len;
+                            if (!onMatch(static_cast<std::size_t>(p - begin)))
+                            {
+                                return;
+                            }
+                        }
+                    }
+
+                    template <typename OnMatch>
+                    void scanByteSet(const char *begin, const char *end, OnMatch &onMatch) const
+                    {
+                        const char *p = begin;
+                        while (p < end)
+                        {
+                            p = findInSet(p, end);
+                            if (p == end)
+                            {
+                                return;
+                            }
+                            ++p;
+                            if (mMode == Mode::ByteSetRun)
+                            {
+                                while (p < end && inSet(*p))
+                                {
+                                    ++p;
+                                }
+                            }
+                            if (!onMatch(static_cast<std::size_t>(p - begin)))
+                            {
+                                return;
+                            }
+                        }
+                    }
+
+                    template <typename OnMatch>
+                    void scanRegex(const char *begin, const char *end, OnMatch &onMatch) const
+                    {
+                        for (auto m = std::cregex_iterator(begin, end, mRegex), mend = std::cregex_iterator();
+                             m != mend;
+                             ++m)
+                        {
+                            if (!onMatch(static_cast<std::size_t>((*m).position() + (*m).length())))
+                            {
+                                return;
+                            }
+                        }
+                    }
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_EOM_SCANNER_H
@@ -0,0 +1,230 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "FieldParser.h"
+
+#include "../config/Config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * Longest number parsed from a message, longer values are not found
+     */
+    constexpr size_t NUMBER_MAX = 63;
+
+    /**
+     * Most digits of a CSV column number
+     */
+    constexpr size_t COLUMN_DIGITS_MAX = 4;
+
+    const char *skipSpace(const char *p, const char *end)
+    {
+        while (p < end && isspace(static_cast<unsigned char>(*p)))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    /**
+     * Skip a JSON string starting at its opening quote
+     *
+     * @return one past the closing quote, or end when the string is not terminated
+     */
+    const char *skipString(const char *p, const char *end)
+    {
+        for (++p; p < end; ++p)
+        {
+            if (*p == '\\')
+            {
+                ++p;
+            }
+            else if (*p == '"')
+            {
+                return p + 1;
+            }
+        }
+        return end;
+    }
+} // namespace
+
+FieldParser::FieldParser(Format format, const vector<string> &fields) : mFormat(format)
+{
+    for (const auto &name : fields)
+    {
+        Field field;
+        field.name = name;
+        if (mFormat == Format::Csv && !ParseColumn(name, field.column))
+        {
+            throw std::runtime_error{"Invalid CSV column: " + name};
+        }
+        mFields.push_back(field);
+    }
+}
+
+bool FieldParser::ParseFormat(const string &name, Format &format)
+{
+    if (name == PlainConfig::SensorPublish::FIELD_FORMAT_JSON)
+    {
+        format = Format::Json;
+        return true;
+    }
+    if (name == PlainConfig::SensorPublish::FIELD_FORMAT_CSV)
+    {
+        format = Format::Csv;
+        return true;
+    }
+    return false;
+}
+
+bool FieldParser::ParseColumn(const string &field, size_t &column)
+{
+    if (field.empty() || field.size() > COLUMN_DIGITS_MAX ||
+        !all_of(field.begin(), field.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)) != 0; }))
+    {
+        return false;
+    }
+    column = static_cast<size_t>(stoul(field));
+    return true;
+}
+
+size_t FieldParser::parse(const uint8_t *message, size_t len)
+{
+    for (auto &field : mFields)
+    {
+        field.found = false;
+    }
+
+    const char *begin = reinterpret_cast<const char *>(message);
+    if (mFormat == Format::Json)
+    {
+        parseJson(begin, begin + len);
+    }
+    else
+    {
+        parseCsv(begin, begin + len);
+    }
+    return static_cast<size_t>(
+        count_if(mFields.begin(), mFields.end(), [](const Field &field) { return field.found; }));
+}
+
+void FieldParser::parseJson(const char *begin, const char *end)
+{
+    // Walk the message once, tracking the nesting depth, and look up each key of the top level object.
+    int depth = 0;
+    const char *p = begin;
+    while (p < end)
+    {
+        char c = *p;
+        if (c == '{' || c == '[')
+        {
+            ++depth;
+            ++p;
+        }
+        else if (c == '}' || c == ']')
+        {
+            --depth;
+            ++p;
+        }
+        else if (c == '"')
+        {
+            const char *keyBegin = p + 1;
+            p = skipString(p, end);
+            const char *keyEnd = p - 1;
+            const char *value = skipSpace(p, end);
+            if (depth != 1 || value == end || *value != ':')
+            {
+                continue; // A string value, or a key of a nested object.
+            }
+            value = skipSpace(value + 1, end);
+            const char *valueEnd = value;
+            while (valueEnd < end && *valueEnd != ',' && *valueEnd != '}' && *valueEnd != ']' &&
+                   !isspace(static_cast<unsigned char>(*valueEnd)))
+            {
+                ++valueEnd;
+            }
+            size_t keyLen = static_cast<size_t>(keyEnd - keyBegin);
+            for (auto &field : mFields)
+            {
+                if (field.name.size() == keyLen && memcmp(field.name.data(), keyBegin, keyLen) == 0)
+                {
+                    parseValue(field, value, valueEnd);
+                }
+            }
+            p = value;
+        }
+        else
+        {
+            ++p;
+        }
+    }
+}
+
+void FieldParser::parseCsv(const char *begin, const char *end)
+{
+    size_t column = 0;
+    const char *p = begin;
+    while (p <= end)
+    {
+        const char *columnEnd = static_cast<const char *>(memchr(p, ',', static_cast<size_t>(end - p)));
+        if (columnEnd == nullptr)
+        {
+            columnEnd = end;
+        }
+
+        const char *valueBegin = skipSpace(p, columnEnd);
+        const char *valueEnd = columnEnd;
+        while (valueEnd > valueBegin && isspace(static_cast<unsigned char>(valueEnd[-1])))
+        {
+            --valueEnd;
+        }
+        if (valueEnd - valueBegin >= 2 && *valueBegin == '"' && valueEnd[-1] == '"')
+        {
+            ++valueBegin;
+            --valueEnd;
+        }
+        for (auto &field : mFields)
+        {
+            if (field.column == column)
+            {
+                parseValue(field, valueBegin, valueEnd);
+            }
+        }
+
+        p = columnEnd + 1;
+        ++column;
+    }
+}
+
+void FieldParser::parseValue(Field &field, const char *begin, const char *end)
+{
+    size_t len = static_cast<size_t>(end - begin);
+    if (len == 0 || len > NUMBER_MAX)
+    {
+        return;
+    }
+
+    // The message is not null terminated, so the number is copied before being parsed.
+    char number[NUMBER_MAX + 1];
+    memcpy(number, begin, len);
+    number[len] = '\0';
+    char *parsedEnd = nullptr;
+    double value = strtod(number, &parsedEnd);
+    if (parsedEnd != number + len || !isfinite(value))
+    {
+        return;
+    }
+    field.found = true;
+    field.value = value;
+}
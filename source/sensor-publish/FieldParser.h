@@ -0,0 +1,114 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_FIELD_PARSER_H
+#define DEVICE_CLIENT_FIELD_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief FieldParser reads configured numeric fields from a message with a single pass, without
+                 * allocating memory.
+                 *
+                 * - Json: the value of a top level key of a JSON object message. Keys are compared as they
+                 *   appear in the message, without unescaping.
+                 * - Csv: the value of a column, numbered from 0, of a comma separated message. Surrounding
+                 *   spaces and double quotes are ignored.
+                 *
+                 * Values which are missing or are not finite numbers are not found.
+                 */
+                class FieldParser
+                {
+                  public:
+                    enum class Format
+                    {
+                        Json,
+                        Csv
+                    };
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param format format of the messages
+                     * @param fields JSON keys, or CSV column numbers, of the fields to read
+                     *
+                     * @throws std::runtime_error when a CSV field is not a column number
+                     */
+                    FieldParser(Format format, const std::vector<std::string> &fields);
+
+                    /**
+                     * \brief Parse the name of a message format
+                     *
+                     * @return false when the name is not a message format
+                     */
+                    static bool ParseFormat(const std::string &name, Format &format);
+
+                    /**
+                     * \brief Parse a CSV column number
+                     *
+                     * @return false when the field is not a column number
+                     */
+                    static bool ParseColumn(const std::string &field, std::size_t &column);
+
+                    /**
+                     * \brief Read the fields of a message, replacing the values of the previous message
+                     *
+                     * @param message message without its delimiter
+                     * @param len size of the message
+                     * @return number of fields found
+                     */
+                    std::size_t parse(const uint8_t *message, std::size_t len);
+
+                    std::size_t size() const { return mFields.size(); }
+
+                    const std::string &name(std::size_t i) const { return mFields[i].name; }
+
+                    /**
+                     * \brief Whether the i-th field was found in the last parsed message
+                     */
+                    bool found(std::size_t i) const { return mFields[i].found; }
+
+                    /**
+                     * \brief Value of the i-th field in the last parsed message, only valid when found
+                     */
+                    double value(std::size_t i) const { return mFields[i].value; }
+
+                  private:
+                    struct Field
+                    {
+                        std::string name;
+                        std::size_t column{0};
+                        bool found{false};
+                        double value{0};
+                    };
+
+                    Format mFormat;
+
+                    std::vector<Field> mFields;
+
+                    void parseJson(const char *begin, const char *end);
+
+                    void parseCsv(const char *begin, const char *end);
+
+                    /**
+                     * \brief Store the number in [begin, end) as the value of field, when it is a number
+                     */
+                    static void parseValue(Field &field, const char *begin, const char *end);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_FIELD_PARSER_H
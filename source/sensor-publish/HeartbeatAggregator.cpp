@@ -0,0 +1,164 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "HeartbeatAggregator.h"
+
+#include "../logging/LoggerFactory.h"
+#include "StatsReporter.h"
+
+#include <aws/common/clock.h>
+#include <aws/common/error.h>
+#include <aws/common/zero.h>
+#include <aws/mqtt/client.h>
+
+#include <cinttypes>
+#include <cstdio>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char HeartbeatAggregator::TAG[];
+
+HeartbeatAggregator::HeartbeatAggregator(
+    shared_ptr<Crt::Mqtt::MqttConnection> connection,
+    aws_event_loop *eventLoop,
+    const vector<unique_ptr<Sensor>> &sensors,
+    const string &topic,
+    int64_t intervalSec)
+    : mConnection(connection), mEventLoop(eventLoop), mSensors(sensors), mTopicName(topic), mInterval(intervalSec)
+{
+    mTopic = aws_byte_cursor_from_array(mTopicName.c_str(), mTopicName.size());
+
+    // Initialize a task to publish the heartbeat every interval.
+    AWS_ZERO_STRUCT(mHeartbeatTask);
+    aws_task_init(
+        &mHeartbeatTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<HeartbeatAggregator *>(arg);
+            self->onHeartbeatTaskCallback();
+        },
+        this,
+        __func__);
+}
+
+void HeartbeatAggregator::start()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (!mStopped)
+    {
+        return;
+    }
+    mStopped = false;
+    scheduleHeartbeat();
+}
+
+void HeartbeatAggregator::stop()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mStopped)
+    {
+        return;
+    }
+    mStopped = true;
+    if (aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mHeartbeatTask);
+    }
+}
+
+string HeartbeatAggregator::format(uint64_t timeMs) const
+{
+    string document;
+    for (const auto &sensor : mSensors)
+    {
+        // Only connected sensors are healthy, the heartbeat of other sensors is missing.
+        if (sensor->getState() != SensorState::Connected)
+        {
+            continue;
+        }
+        const SensorCounters &counters = sensor->getCounters();
+        document += document.empty() ? "{\"time_ms\":" + to_string(timeMs) + ",\"sensors\":[{\"name\":" : ",{\"name\":";
+        StatsReporter::AppendJsonString(document, sensor->getName());
+
+        char members[256];
+        snprintf(
+            members,
+            sizeof(members),
+            ",\"state\":\"connected\",\"bytes_read\":%" PRIu64 ",\"batches\":%" PRIu64
+            ",\"dropped_messages\":%" PRIu64 ",\"discarded_bytes\":%" PRIu64 ",\"publish_failed\":%" PRIu64 "}",
+            counters.bytesRead.load(),
+            counters.batches.load(),
+            counters.droppedDuplicate.load() + counters.droppedDeadband.load() + counters.droppedRateLimited.load(),
+            counters.discardedBytes.load(),
+            counters.publishFailed.load());
+        document += members;
+    }
+    if (!document.empty())
+    {
+        document += "]}";
+    }
+    return document;
+}
+
+void HeartbeatAggregator::scheduleHeartbeat()
+{
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(mInterval).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mHeartbeatTask, runAtNanos);
+}
+
+void HeartbeatAggregator::onHeartbeatTaskCallback()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mStopped)
+    {
+        return;
+    }
+    scheduleHeartbeat();
+
+    uint64_t now = 0;
+    aws_sys_clock_get_ticks(&now);
+    string document = format(aws_timestamp_convert(now, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr));
+    if (document.empty())
+    {
+        return; // No sensor is connected.
+    }
+
+    // Publish copies the payload, so the document does not need to outlive the publish.
+    aws_byte_cursor payload = aws_byte_cursor_from_array(document.data(), document.size());
+    if (mqttPublish(&payload) == 0)
+    {
+        LOGM_WARN(
+            TAG,
+            "Unable to publish heartbeat topic: %s msg: %s",
+            mTopicName.c_str(),
+            aws_error_str(aws_last_error()));
+    }
+}
+
+uint16_t HeartbeatAggregator::mqttPublish(const aws_byte_cursor *payload)
+{
+    return aws_mqtt_client_connection_publish(
+        mConnection->GetUnderlyingConnection(),
+        &mTopic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        false,
+        payload,
+        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *) {
+            if (error_code != AWS_OP_SUCCESS)
+            {
+                LOGM_ERROR(TAG, "Error heartbeat packetId: %d msg: %s", packet_id, aws_error_str(error_code));
+            }
+            else
+            {
+                LOGM_DEBUG(TAG, "Publish heartbeat packetId: %d", packet_id);
+            }
+        },
+        nullptr);
+}
@@ -0,0 +1,130 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_HEARTBEAT_AGGREGATOR_H
+#define DEVICE_CLIENT_HEARTBEAT_AGGREGATOR_H
+
+#include "Sensor.h"
+
+#include <aws/common/task_scheduler.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief HeartbeatAggregator publishes one heartbeat message for every sensor of the feature.
+                 *
+                 * Every interval, a single message lists each connected sensor with its state and counters:
+                 *
+                 *     {"time_ms":1650000000000,"sensors":[{"name":"my-sensor","state":"connected",
+                 *      "bytes_read":4096,"batches":12,"dropped_messages":3,"discarded_bytes":0,"publish_failed":0}]}
+                 *
+                 * Counters are cumulative since the device client started. No message is published while no
+                 * sensor is connected, in the same way as the heartbeat of a single sensor.
+                 */
+                class HeartbeatAggregator
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param connection MQTT client connection
+                     * @param eventLoop event loop running the heartbeat task
+                     * @param sensors sensors to report, owned by the caller and outliving the aggregator
+                     * @param topic topic the heartbeat is published to
+                     * @param intervalSec interval between heartbeats
+                     */
+                    HeartbeatAggregator(
+                        std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
+                        aws_event_loop *eventLoop,
+                        const std::vector<std::unique_ptr<Sensor>> &sensors,
+                        const std::string &topic,
+                        int64_t intervalSec);
+
+                    virtual ~HeartbeatAggregator() = default;
+
+                    HeartbeatAggregator(const HeartbeatAggregator &) = delete;
+                    HeartbeatAggregator &operator=(const HeartbeatAggregator &) = delete;
+
+                    /**
+                     * \brief Start publishing the heartbeat every interval
+                     */
+                    void start();
+
+                    /**
+                     * \brief Stop publishing the heartbeat
+                     */
+                    void stop();
+
+                    /**
+                     * \brief Format the heartbeat of every connected sensor as a JSON document
+                     *
+                     * @return an empty string when no sensor is connected
+                     */
+                    std::string format(uint64_t timeMs) const;
+
+                  protected:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "HeartbeatAggregator.cpp";
+
+                    /**
+                     * \brief Publish payload to the heartbeat topic
+                     *
+                     * @return packet id of the publish, or 0 when the publish failed to start
+                     */
+                    virtual uint16_t mqttPublish(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Callback function for the heartbeat task
+                     */
+                    void onHeartbeatTaskCallback();
+
+                  private:
+                    std::shared_ptr<Crt::Mqtt::MqttConnection> mConnection;
+
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    const std::vector<std::unique_ptr<Sensor>> &mSensors;
+
+                    std::string mTopicName;
+
+                    aws_byte_cursor mTopic;
+
+                    std::chrono::seconds mInterval;
+
+                    /**
+                     * \brief Guards the heartbeat task state
+                     */
+                    std::mutex mMutex;
+
+                    aws_task mHeartbeatTask;
+
+                    bool mStopped{true};
+
+                    /**
+                     * \brief Schedule the heartbeat task one interval from now, called with mMutex held
+                     */
+                    void scheduleHeartbeat();
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_HEARTBEAT_AGGREGATOR_H
@@ -14,6 +14,7 @@
 #include <aws/io/event_loop.h>
 #include <aws/mqtt/client.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 
@@ -26,7 +27,7 @@ using namespace Aws::Iot::DeviceClient::SensorPublish;
 constexpr char HeartbeatTask::TAG[];
 
 HeartbeatTask::HeartbeatTask(
-    const SensorState &state,
+    const atomic<SensorState> &state,
     const PlainConfig::SensorPublish::SensorSettings &settings,
     shared_ptr<Crt::Mqtt::MqttConnection> connection,
     aws_event_loop *eventLoop)
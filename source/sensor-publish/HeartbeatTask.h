@@ -9,6 +9,7 @@
 
 #include <aws/crt/Types.h>
 
+#include <atomic>
 #include <memory>
 
 namespace Aws
@@ -38,7 +39,7 @@ namespace Aws
                     /**
                      * \brief State machine of the sensor
                      */
-                    const SensorState &mState;
+                    const std::atomic<SensorState> &mState;
 
                     /**
                      * \brief Settings associated with the sensor
@@ -100,7 +101,7 @@ namespace Aws
                      * @param eventLoop the event loop for the heartbeat
                      */
                     HeartbeatTask(
-                        const SensorState &state,
+                        const std::atomic<SensorState> &state,
                         const PlainConfig::SensorPublish::SensorSettings &settings,
                         std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
                         aws_event_loop *eventLoop);
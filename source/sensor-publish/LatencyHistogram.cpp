@@ -0,0 +1,90 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr unsigned LatencyHistogram::SUB_BUCKET_BITS;
+constexpr size_t LatencyHistogram::SUB_BUCKETS;
+constexpr unsigned LatencyHistogram::MAX_BITS;
+constexpr size_t LatencyHistogram::BUCKETS;
+
+size_t LatencyHistogram::BucketOf(uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return static_cast<size_t>(value);
+    }
+    value = std::min(value, (uint64_t(1) << MAX_BITS) - 1);
+
+    // The top SUB_BUCKET_BITS bits of the value select the bucket within its power of two.
+    unsigned msb = 63U - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t LatencyHistogram::BucketMax(size_t bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>(bucket / SUB_BUCKETS) - 1;
+    uint64_t lowest = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lowest + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t valueUs)
+{
+    mBuckets[BucketOf(valueUs)].fetch_add(1, memory_order_relaxed);
+    mCount.fetch_add(1, memory_order_relaxed);
+
+    uint64_t largest = mMax.load(memory_order_relaxed);
+    while (valueUs > largest && !mMax.compare_exchange_weak(largest, valueUs, memory_order_relaxed))
+    {
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double p) const
+{
+    // Buckets may be recorded to while they are summed, so rank against the sum rather than mCount.
+    uint64_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        counts[i] = mBuckets[i].load(memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    double fraction = std::min(std::max(p, 0.0), 1.0);
+    uint64_t rank = std::max(uint64_t(1), static_cast<uint64_t>(ceil(fraction * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return std::min(BucketMax(i), max());
+        }
+    }
+    return max();
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.count = count();
+    snapshot.p50 = percentile(0.5);
+    snapshot.p99 = percentile(0.99);
+    snapshot.max = max();
+    return snapshot;
+}
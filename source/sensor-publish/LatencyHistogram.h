@@ -0,0 +1,113 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_LATENCY_HISTOGRAM_H
+#define DEVICE_CLIENT_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief LatencyHistogram counts latencies, in microseconds, in fixed log-linear buckets.
+                 *
+                 * As in HDR histograms, every power of two is split into SUB_BUCKETS buckets of equal width,
+                 * so a percentile is reported within 1/SUB_BUCKETS of the recorded value whatever its
+                 * magnitude. Values up to 15 are counted exactly, values from 2^MAX_BITS are counted in the
+                 * last bucket.
+                 *
+                 * Recording is lock-free and may happen from any thread, concurrently with reads. Counts are
+                 * cumulative since construction.
+                 */
+                class LatencyHistogram
+                {
+                  public:
+                    static constexpr unsigned SUB_BUCKET_BITS = 4;
+
+                    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BUCKET_BITS;
+
+                    static constexpr unsigned MAX_BITS = 32;
+
+                    static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+                    /**
+                     * \brief Summary of the histogram at one point in time
+                     */
+                    struct Snapshot
+                    {
+                        uint64_t count{0};
+                        uint64_t p50{0};
+                        uint64_t p99{0};
+                        uint64_t max{0};
+                    };
+
+                    /**
+                     * \brief Index of the bucket counting value
+                     */
+                    static std::size_t BucketOf(uint64_t value);
+
+                    /**
+                     * \brief Largest value counted by bucket
+                     */
+                    static uint64_t BucketMax(std::size_t bucket);
+
+                    LatencyHistogram() = default;
+
+                    LatencyHistogram(const LatencyHistogram &) = delete;
+                    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+                    void record(uint64_t valueUs);
+
+                    /**
+                     * \brief Value at or below which the fraction p of recorded values lie
+                     *
+                     * Reported as the largest value of its bucket, never more than the largest recorded value.
+                     *
+                     * @return 0 when nothing was recorded
+                     */
+                    uint64_t percentile(double p) const;
+
+                    uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+
+                    uint64_t max() const { return mMax.load(std::memory_order_relaxed); }
+
+                    Snapshot snapshot() const;
+
+                  private:
+                    std::atomic<uint64_t> mBuckets[BUCKETS]{};
+
+                    std::atomic<uint64_t> mCount{0};
+
+                    std::atomic<uint64_t> mMax{0};
+                };
+
+                /**
+                 * \brief Latencies of the batches of a sensor published to its topic
+                 *
+                 * - queue: from the read of the oldest message of a batch until the batch is submitted to the
+                 *   MQTT client, the time spent buffered by the sensor.
+                 * - ack: from submission until the broker acknowledges the batch.
+                 * - total: from the read until the acknowledgement.
+                 *
+                 * Spooled batches only count towards ack, since their read time is not kept.
+                 */
+                struct SensorLatency
+                {
+                    LatencyHistogram queue;
+                    LatencyHistogram ack;
+                    LatencyHistogram total;
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_LATENCY_HISTOGRAM_H
@@ -0,0 +1,118 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "MessageFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hashMessage(const uint8_t *message, size_t len)
+    {
+        uint64_t hash = FNV_OFFSET_BASIS;
+        for (size_t i = 0; i < len; ++i)
+        {
+            hash = (hash ^ message[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+} // namespace
+
+MessageFilter::MessageFilter(
+    bool dropDuplicates,
+    unique_ptr<FieldParser> deadbandFields,
+    double deadband,
+    uint64_t maxRate)
+    : mDropDuplicates(dropDuplicates), mDeadbandFields(move(deadbandFields)), mDeadband(deadband),
+      mMaxRate(maxRate), mTokens(static_cast<double>(maxRate))
+{
+    if (mDeadbandFields)
+    {
+        mLastValues.assign(mDeadbandFields->size(), numeric_limits<double>::quiet_NaN());
+    }
+}
+
+MessageFilter::Verdict MessageFilter::check(const uint8_t *message, size_t len, Clock::time_point now)
+{
+    uint64_t hash = 0;
+    if (mDropDuplicates)
+    {
+        hash = hashMessage(message, len);
+        if (mHasLast && len == mLastLen && hash == mLastHash)
+        {
+            return Verdict::Duplicate;
+        }
+    }
+
+    if (mDeadbandFields && mDeadbandFields->parse(message, len) > 0 && withinDeadband())
+    {
+        return Verdict::Deadband;
+    }
+
+    if (mMaxRate > 0)
+    {
+        refill(now);
+        if (mTokens < 1)
+        {
+            return Verdict::RateLimited;
+        }
+        mTokens -= 1;
+    }
+
+    // Only kept messages update the filters, since they are the messages consumers see.
+    if (mDropDuplicates)
+    {
+        mHasLast = true;
+        mLastLen = len;
+        mLastHash = hash;
+    }
+    if (mDeadbandFields)
+    {
+        for (size_t i = 0; i < mLastValues.size(); ++i)
+        {
+            if (mDeadbandFields->found(i))
+            {
+                mLastValues[i] = mDeadbandFields->value(i);
+            }
+        }
+    }
+    return Verdict::Keep;
+}
+
+bool MessageFilter::withinDeadband() const
+{
+    for (size_t i = 0; i < mLastValues.size(); ++i)
+    {
+        // A field without a kept value yet always passes, as NaN compares false.
+        if (mDeadbandFields->found(i) && !(fabs(mDeadbandFields->value(i) - mLastValues[i]) <= mDeadband))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MessageFilter::refill(Clock::time_point now)
+{
+    if (mLastRefill == Clock::time_point{})
+    {
+        mLastRefill = now;
+        return;
+    }
+    if (now <= mLastRefill)
+    {
+        return;
+    }
+    double elapsedSec = chrono::duration<double>(now - mLastRefill).count();
+    mTokens = min(static_cast<double>(mMaxRate), mTokens + elapsedSec * static_cast<double>(mMaxRate));
+    mLastRefill = now;
+}
@@ -0,0 +1,115 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_MESSAGE_FILTER_H
+#define DEVICE_CLIENT_MESSAGE_FILTER_H
+
+#include "FieldParser.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief MessageFilter decides which messages of a sensor are kept before they are batched.
+                 *
+                 * Filters are applied in order, and a message is kept only when every enabled filter keeps it:
+                 *
+                 * - Duplicates: a message identical to the last kept message is dropped. Messages are compared
+                 *   by length and a 64-bit FNV-1a hash, so no copy of the last message is held.
+                 * - Deadband: a message is dropped when it holds at least one of the deadband fields, and every
+                 *   field it holds changed by at most the deadband since the last kept value of that field.
+                 * - Rate: a token bucket keeps at most maxRate messages per second, with bursts of up to one
+                 *   second worth of messages.
+                 *
+                 * The state of the filters is only updated by kept messages, so consumers never see two
+                 * identical messages in a row, and deadbands are measured from values they have seen.
+                 *
+                 * MessageFilter is not thread safe, and is only used from the event loop of its sensor.
+                 */
+                class MessageFilter
+                {
+                  public:
+                    using Clock = std::chrono::steady_clock;
+
+                    enum class Verdict
+                    {
+                        Keep,
+                        Duplicate,
+                        Deadband,
+                        RateLimited
+                    };
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param dropDuplicates whether to drop repeats of the last kept message
+                     * @param deadbandFields parser of the deadband fields, null to disable the deadband filter
+                     * @param deadband largest change of a field which is dropped
+                     * @param maxRate largest number of messages kept per second, 0 to disable the rate filter
+                     */
+                    MessageFilter(
+                        bool dropDuplicates,
+                        std::unique_ptr<FieldParser> deadbandFields,
+                        double deadband,
+                        std::uint64_t maxRate);
+
+                    /**
+                     * \brief Decide whether a message is kept
+                     *
+                     * @param message message without its delimiter
+                     * @param len size of the message
+                     * @param now time at which the message is filtered
+                     */
+                    Verdict check(const uint8_t *message, std::size_t len, Clock::time_point now);
+
+                  private:
+                    bool mDropDuplicates;
+
+                    std::unique_ptr<FieldParser> mDeadbandFields;
+
+                    double mDeadband;
+
+                    std::uint64_t mMaxRate;
+
+                    bool mHasLast{false};
+
+                    std::size_t mLastLen{0};
+
+                    std::uint64_t mLastHash{0};
+
+                    /**
+                     * \brief Last kept value of each deadband field, NaN until a value is kept
+                     */
+                    std::vector<double> mLastValues;
+
+                    double mTokens{0};
+
+                    Clock::time_point mLastRefill;
+
+                    /**
+                     * \brief Whether the deadband fields of the last parsed message are all within the deadband
+                     */
+                    bool withinDeadband() const;
+
+                    /**
+                     * \brief Add the tokens earned since the last refill, up to one second worth of messages
+                     */
+                    void refill(Clock::time_point now);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_MESSAGE_FILTER_H
@@ -0,0 +1,262 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "RingBuffer.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/zero.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * Offset of the boundaries in the block, after the data rounded up to their alignment
+     */
+    size_t eomOffset(size_t capacity)
+    {
+        constexpr size_t align = alignof(uint64_t);
+        return (capacity + align - 1) / align * align;
+    }
+} // namespace
+
+RingBuffer::RingBuffer(
+    aws_allocator *allocator,
+    size_t capacity,
+    size_t eomCapacity,
+    bool eomTimes,
+    shared_ptr<BufferPool> pool)
+    : mAllocator(allocator), mPool(move(pool)), mEomTimesEnabled(eomTimes), mCapacity(capacity),
+      mEomCapacity(max<size_t>(eomCapacity, 1))
+{
+    mBlockSize = eomOffset(mCapacity) + mEomCapacity * sizeof(size_t);
+    if (mEomTimesEnabled)
+    {
+        mBlockSize += mEomCapacity * sizeof(uint64_t);
+    }
+
+    if (!mPool)
+    {
+        void *block = aws_mem_acquire(mAllocator, mBlockSize);
+        if (block == nullptr)
+        {
+            throw std::runtime_error{"Unable to allocate memory for read buffer"};
+        }
+        attach(block);
+    }
+}
+
+RingBuffer::~RingBuffer()
+{
+    if (mPool)
+    {
+        releaseBlock();
+    }
+    else
+    {
+        aws_secure_zero(mBlock, mBlockSize);
+        aws_mem_release(mAllocator, mBlock);
+    }
+}
+
+aws_byte_buf RingBuffer::writableSpace(size_t minSpace)
+{
+    if (!acquireBlock())
+    {
+        return aws_byte_buf_from_empty_array(nullptr, 0);
+    }
+    if (!mWrapped && mTail + minSpace > mCapacity)
+    {
+        wrap(minSpace);
+    }
+    size_t limit = mWrapped ? mHead : mCapacity;
+    return aws_byte_buf_from_empty_array(mData + mTail, limit - mTail);
+}
+
+void RingBuffer::commitWrite(size_t count)
+{
+    mTail += count;
+}
+
+bool RingBuffer::full(size_t minSpace) const
+{
+    if (mWrapped)
+    {
+        return mHead - mTail < minSpace;
+    }
+    return mTail + minSpace > mCapacity && !canWrap(minSpace);
+}
+
+size_t RingBuffer::size() const
+{
+    if (mWrapped)
+    {
+        return (mWrapEnd - mHead) + mTail;
+    }
+    return mTail - mHead;
+}
+
+size_t RingBuffer::messageBegin() const
+{
+    if (hasEomInWriteSegment())
+    {
+        return eomAt(mEomCount - 1);
+    }
+    return mWrapped ? 0 : mHead;
+}
+
+aws_byte_cursor RingBuffer::partialMessage() const
+{
+    size_t begin = messageBegin();
+    return aws_byte_cursor_from_array(mData + begin, mTail - begin);
+}
+
+bool RingBuffer::pushEom(size_t offset, uint64_t timeMs)
+{
+    if (eomFull())
+    {
+        return false;
+    }
+    size_t index = (mEomFront + mEomCount) % mEomCapacity;
+    mEoms[index] = offset;
+    if (mEomTimes != nullptr)
+    {
+        mEomTimes[index] = timeMs;
+    }
+    ++mEomCount;
+    return true;
+}
+
+aws_byte_cursor RingBuffer::peek(size_t &count) const
+{
+    count = min(count, mWrapped ? mEomBeforeWrap : mEomCount);
+    size_t end = count == 0 ? mHead : eomAt(count - 1);
+    return aws_byte_cursor_from_array(mData + mHead, end - mHead);
+}
+
+void RingBuffer::consume(size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    mHead = eomAt(count - 1);
+    mEomFront = (mEomFront + count) % mEomCapacity;
+    mEomCount -= count;
+
+    if (mWrapped)
+    {
+        mEomBeforeWrap -= count;
+        if (mEomBeforeWrap == 0)
+        {
+            // Front segment is fully published, the write segment becomes the only segment.
+            mWrapped = false;
+            mWrapEnd = 0;
+            mHead = 0;
+        }
+    }
+
+    if (!mWrapped && mHead == mTail)
+    {
+        // Buffer is empty, so start again from the beginning without copying.
+        mHead = mTail = mScanned = 0;
+        releaseBlock();
+    }
+}
+
+void RingBuffer::reset()
+{
+    mHead = mTail = mScanned = 0;
+    mWrapped = false;
+    mWrapEnd = 0;
+    mEomFront = mEomCount = mEomBeforeWrap = 0;
+    releaseBlock();
+}
+
+void RingBuffer::releaseIfEmpty()
+{
+    if (size() == 0)
+    {
+        reset();
+    }
+}
+
+void RingBuffer::attach(void *block)
+{
+    mBlock = block;
+    auto *bytes = static_cast<uint8_t *>(block);
+    mData = block == nullptr ? nullptr : bytes;
+    mEoms = block == nullptr ? nullptr : reinterpret_cast<size_t *>(bytes + eomOffset(mCapacity));
+    mEomTimes = block == nullptr || !mEomTimesEnabled
+                    ? nullptr
+                    : reinterpret_cast<uint64_t *>(bytes + eomOffset(mCapacity) + mEomCapacity * sizeof(size_t));
+}
+
+bool RingBuffer::acquireBlock()
+{
+    if (mBlock == nullptr)
+    {
+        attach(mPool->acquire(mBlockSize));
+    }
+    return mBlock != nullptr;
+}
+
+void RingBuffer::releaseBlock()
+{
+    if (mPool && mBlock != nullptr)
+    {
+        mPool->release(mBlock, mBlockSize);
+        attach(nullptr);
+    }
+}
+
+size_t RingBuffer::lastEom() const
+{
+    return mEomCount == 0 ? mHead : eomAt(mEomCount - 1);
+}
+
+bool RingBuffer::canWrap(size_t minSpace) const
+{
+    if (mWrapped || mTail + minSpace <= mCapacity || mHead == 0)
+    {
+        return false;
+    }
+    // Without complete messages the partial message may be moved over itself,
+    // otherwise it must fit before the oldest unpublished message, leaving minSpace free after it.
+    size_t partial = mTail - lastEom();
+    size_t limit = mEomCount == 0 ? mCapacity : mHead;
+    return partial < limit && limit - partial >= minSpace;
+}
+
+bool RingBuffer::wrap(size_t minSpace)
+{
+    if (!canWrap(minSpace))
+    {
+        return false;
+    }
+
+    size_t from = lastEom();
+    size_t partial = mTail - from;
+    memmove(mData, mData + from, partial);
+    mScanned -= from;
+    mTail = partial;
+
+    if (mEomCount == 0)
+    {
+        mHead = 0;
+    }
+    else
+    {
+        mWrapped = true;
+        mWrapEnd = from;
+        mEomBeforeWrap = mEomCount;
+    }
+    return true;
+}
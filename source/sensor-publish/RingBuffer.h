@@ -0,0 +1,327 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_RING_BUFFER_H
+#define DEVICE_CLIENT_RING_BUFFER_H
+
+#include "BufferPool.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief RingBuffer holds sensor data between reading from the socket and publishing.
+                 *
+                 * Data is read directly into free space and published directly from the buffer, so complete
+                 * messages are never moved. The buffer holds at most two contiguous segments:
+                 *
+                 * - The front segment [head, wrapEnd) of complete messages waiting to be published.
+                 * - The write segment, where the socket reads into and where end of message boundaries are
+                 *   scanned.
+                 *
+                 * When the write segment reaches the end of the buffer and there is free space at the start,
+                 * the unterminated message at the end (if any) is moved to the start of the buffer and
+                 * reading continues from there. This is the only copy, and is bounded by the size of one
+                 * partial message. A view of complete messages never spans the wrap point.
+                 *
+                 * End of message boundaries are kept in a fixed capacity ring of buffer offsets, optionally
+                 * paired with the time at which each message was read.
+                 *
+                 * The data and boundaries share a single block of memory. When a pool is given, the block is
+                 * borrowed from the pool on the first write and returned as soon as the buffer is empty, so an
+                 * idle buffer holds no memory.
+                 */
+                class RingBuffer
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param capacity size of data buffer in bytes
+                     * @param eomCapacity maximum number of end of message boundaries held at once
+                     * @param eomTimes whether to store the read time of each boundary
+                     * @param pool pool to borrow the block from while data is buffered, null to allocate the block
+                     * once for the lifetime of the buffer
+                     *
+                     * @throws std::runtime_error when memory cannot be allocated without a pool
+                     */
+                    RingBuffer(
+                        aws_allocator *allocator,
+                        std::size_t capacity,
+                        std::size_t eomCapacity,
+                        bool eomTimes = false,
+                        std::shared_ptr<BufferPool> pool = nullptr);
+
+                    ~RingBuffer();
+
+                    RingBuffer(const RingBuffer &) = delete;
+                    RingBuffer &operator=(const RingBuffer &) = delete;
+
+                    /**
+                     * \brief Contiguous free space for the next read, wrapping to the start if required.
+                     *
+                     * @param minSpace wrap to the start when less than minSpace bytes are free at the end
+                     * @return an empty buffer whose capacity is the free space, capacity is 0 when full or when
+                     * no block could be borrowed from the pool
+                     */
+                    aws_byte_buf writableSpace(std::size_t minSpace = 1);
+
+                    /**
+                     * \brief Whether the buffer holds its block of memory
+                     */
+                    bool allocated() const { return mBlock != nullptr; }
+
+                    /**
+                     * \brief Size of the block of memory holding the data and boundaries
+                     */
+                    std::size_t blockSize() const { return mBlockSize; }
+
+                    /**
+                     * \brief Append count bytes previously read into writableSpace()
+                     */
+                    void commitWrite(std::size_t count);
+
+                    /**
+                     * \brief Whether less than minSpace contiguous bytes are available for reading
+                     */
+                    bool full(std::size_t minSpace = 1) const;
+
+                    /**
+                     * \brief Total number of unpublished bytes
+                     */
+                    std::size_t size() const;
+
+                    std::size_t capacity() const { return mCapacity; }
+
+                    const uint8_t *data() const { return mData; }
+
+                    /**
+                     * \brief Offset one-past the end of data in the write segment
+                     */
+                    std::size_t writeEnd() const { return mTail; }
+
+                    /**
+                     * \brief Offset up to which the write segment has been scanned for end of message
+                     */
+                    std::size_t scanned() const { return mScanned; }
+
+                    void setScanned(std::size_t offset) { mScanned = offset; }
+
+                    /**
+                     * \brief Offset of the start of the unterminated message in the write segment
+                     */
+                    std::size_t messageBegin() const;
+
+                    /**
+                     * \brief Contiguous view of the unterminated message in the write segment
+                     */
+                    aws_byte_cursor partialMessage() const;
+
+                    /**
+                     * \brief Whether the write segment contains an end of message boundary
+                     */
+                    bool hasEomInWriteSegment() const { return mEomCount > mEomBeforeWrap; }
+
+                    /**
+                     * \brief Store an end of message boundary
+                     *
+                     * @param offset offset in buffer of one-past the end of the boundary
+                     * @param timeMs time at which the message was read, ignored unless read times are stored
+                     * @return false when the boundary ring is full
+                     */
+                    bool pushEom(std::size_t offset, std::uint64_t timeMs = 0);
+
+                    std::size_t eomCount() const { return mEomCount; }
+
+                    bool eomFull() const { return mEomCount == mEomCapacity; }
+
+                    std::size_t eomCapacity() const { return mEomCapacity; }
+
+                    /**
+                     * \brief Offset of the i-th end of message boundary, starting from the oldest
+                     */
+                    std::size_t eomAt(std::size_t i) const { return mEoms[(mEomFront + i) % mEomCapacity]; }
+
+                    /**
+                     * \brief Read time of the i-th end of message boundary, or 0 when read times are not stored
+                     */
+                    std::uint64_t eomTimeAt(std::size_t i) const
+                    {
+                        return mEomTimes == nullptr ? 0 : mEomTimes[(mEomFront + i) % mEomCapacity];
+                    }
+
+                    /**
+                     * \brief Contiguous view of the oldest complete messages
+                     *
+                     * @param count number of messages requested, updated to the number of messages in the
+                     * view, which is smaller when the requested messages span the wrap point
+                     */
+                    aws_byte_cursor peek(std::size_t &count) const;
+
+                    /**
+                     * \brief Release the oldest count complete messages
+                     */
+                    void consume(std::size_t count);
+
+                    /**
+                     * \brief Remove complete messages of the write segment
+                     *
+                     * Kept messages and the unterminated message are moved back over removed messages, so the
+                     * write segment stays contiguous. Each byte after the first removed message is moved once.
+                     *
+                     * @param first index of the first boundary to consider, which must be in the write segment
+                     * and not before the scanned offset
+                     * @param remove invoked with the offset of the start and one-past the end of each message,
+                     * returning true removes the message
+                     * @return number of removed messages
+                     */
+                    template <typename Remove> std::size_t removeMessages(std::size_t first, Remove remove)
+                    {
+                        std::size_t begin = first > (mWrapped ? mEomBeforeWrap : 0) ? eomAt(first - 1)
+                                                                                    : (mWrapped ? 0 : mHead);
+                        std::size_t out = begin;
+                        std::size_t kept = first;
+                        for (std::size_t i = first; i < mEomCount; ++i)
+                        {
+                            std::size_t end = eomAt(i);
+                            if (!remove(begin, end))
+                            {
+                                std::uint64_t timeMs = eomTimeAt(i);
+                                std::memmove(mData + out, mData + begin, end - begin);
+                                out += end - begin;
+                                std::size_t index = (mEomFront + kept) % mEomCapacity;
+                                mEoms[index] = out;
+                                if (mEomTimes != nullptr)
+                                {
+                                    mEomTimes[index] = timeMs;
+                                }
+                                ++kept;
+                            }
+                            begin = end;
+                        }
+
+                        std::size_t removed = mEomCount - kept;
+                        if (out != begin)
+                        {
+                            std::memmove(mData + out, mData + begin, mTail - begin);
+                            mTail -= begin - out;
+                            mScanned -= begin - out;
+                        }
+                        mEomCount = kept;
+                        return removed;
+                    }
+
+                    /**
+                     * \brief Discard all data and boundaries
+                     */
+                    void reset();
+
+                    /**
+                     * \brief Return the block to the pool when no data is buffered
+                     */
+                    void releaseIfEmpty();
+
+                  private:
+                    aws_allocator *mAllocator{nullptr};
+
+                    std::shared_ptr<BufferPool> mPool;
+
+                    /**
+                     * \brief Block holding the data followed by the boundaries, null while not borrowed from the pool
+                     */
+                    void *mBlock{nullptr};
+
+                    std::size_t mBlockSize{0};
+
+                    bool mEomTimesEnabled{false};
+
+                    uint8_t *mData{nullptr};
+
+                    std::size_t mCapacity{0};
+
+                    /**
+                     * \brief Offset of the oldest unpublished byte
+                     */
+                    std::size_t mHead{0};
+
+                    /**
+                     * \brief Offset one-past the end of data in the write segment
+                     */
+                    std::size_t mTail{0};
+
+                    std::size_t mScanned{0};
+
+                    /**
+                     * \brief Whether the write segment has wrapped to the start of the buffer
+                     */
+                    bool mWrapped{false};
+
+                    /**
+                     * \brief When wrapped, offset one-past the end of the front segment
+                     */
+                    std::size_t mWrapEnd{0};
+
+                    std::size_t *mEoms{nullptr};
+
+                    /**
+                     * \brief Read time of each boundary in milliseconds since the epoch, null when not stored
+                     */
+                    std::uint64_t *mEomTimes{nullptr};
+
+                    std::size_t mEomCapacity{0};
+
+                    std::size_t mEomFront{0};
+
+                    std::size_t mEomCount{0};
+
+                    /**
+                     * \brief When wrapped, number of boundaries belonging to the front segment
+                     */
+                    std::size_t mEomBeforeWrap{0};
+
+                    /**
+                     * \brief Offset one-past the end of the newest boundary, or head if there is none
+                     */
+                    std::size_t lastEom() const;
+
+                    /**
+                     * \brief Point the data and boundaries into the block
+                     */
+                    void attach(void *block);
+
+                    /**
+                     * \brief Borrow the block from the pool, if not already held
+                     */
+                    bool acquireBlock();
+
+                    /**
+                     * \brief Return the block to the pool, if borrowed from one
+                     */
+                    void releaseBlock();
+
+                    /**
+                     * \brief Move the write segment to the start of the buffer, if possible
+                     */
+                    bool wrap(std::size_t minSpace);
+
+                    bool canWrap(std::size_t minSpace) const;
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_RING_BUFFER_H
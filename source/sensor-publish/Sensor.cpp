@@ -8,6 +8,7 @@
 
 #include <aws/common/allocator.h>
 #include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
 #include <aws/common/error.h>
 #include <aws/common/task_scheduler.h>
 #include <aws/common/zero.h>
@@ -20,8 +21,11 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdio>
-#include <cstring>
+#include <future>
+#include <mutex>
+#include <set>
 #include <stdexcept>
+#include <utility>
 
 using namespace std;
 using namespace Aws::Iot;
@@ -31,25 +35,85 @@ using namespace Aws::Iot::DeviceClient::SensorPublish;
 using namespace Aws::Crt::Mqtt;
 
 constexpr char Sensor::TAG[];
+constexpr size_t Sensor::EOM_BOUNDS_CAPACITY;
+constexpr int Sensor::DEAD_LETTER_MAX_ATTEMPTS;
+constexpr size_t Sensor::DEAD_LETTER_MAX_PENDING;
+constexpr int64_t Sensor::DEAD_LETTER_RETRY_DELAY_MS;
+constexpr int64_t Sensor::SPOOL_TASK_INTERVAL_MS;
+constexpr int64_t Sensor::READ_RETRY_INTERVAL_MS;
+constexpr size_t Sensor::READ_MESSAGES_MAX;
+constexpr int64_t Sensor::WRITE_RETRY_INTERVAL_MS;
+
+namespace
+{
+    /**
+     * Whether messages are wrapped in an envelope which includes the time each message was read
+     */
+    bool hasBatchTimestamps(const PlainConfig::SensorPublish::SensorSettings &settings)
+    {
+        BatchEncoder::Format format;
+        return settings.batchTimestamps.value() && settings.batchFormat.has_value() &&
+               BatchEncoder::ParseFormat(settings.batchFormat.value(), format);
+    }
+
+    /**
+     * Milliseconds since the epoch
+     */
+    uint64_t epochMs()
+    {
+        uint64_t now = 0;
+        aws_sys_clock_get_ticks(&now);
+        return aws_timestamp_convert(now, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr);
+    }
+
+    /**
+     * Microseconds from begin to end
+     */
+    uint64_t latencyUs(chrono::steady_clock::time_point begin, chrono::steady_clock::time_point end)
+    {
+        return end > begin ? static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(end - begin).count())
+                           : 0;
+    }
+} // namespace
 
 Sensor::Sensor(
     const PlainConfig::SensorPublish::SensorSettings &settings,
     aws_allocator *allocator,
     shared_ptr<Crt::Mqtt::MqttConnection> connection,
     aws_event_loop *eventLoop,
-    shared_ptr<Socket> socket)
+    shared_ptr<Socket> socket,
+    shared_ptr<BufferPool> bufferPool,
+    shared_ptr<Aggregator> aggregator)
     : mSettings(settings), mAllocator(allocator), mConnection(connection), mEventLoop(eventLoop), mSocket(socket),
-      mEomPattern(settings.eomDelimiter.value()), mHeartbeatTask(mState, mSettings, mConnection, mEventLoop)
+      mReadBuf(
+          allocator,
+          size_t(settings.bufferCapacity.value()),
+          min(size_t(settings.bufferCapacity.value()), max(size_t(settings.bufferSize.value()), EOM_BOUNDS_CAPACITY)),
+          hasBatchTimestamps(settings),
+          bufferPool),
+      mEomScanner(settings.eomDelimiter.has_value() ? settings.eomDelimiter.value() : string()),
+      mAggregator(aggregator), mHeartbeatTask(mState, mSettings, mConnection, mEventLoop)
 {
-    // Handle out of memory when allocating read buffer.
-    AWS_ZERO_STRUCT(mReadBuf);
-    if (aws_byte_buf_init(&mReadBuf, mAllocator, mSettings.bufferCapacity.value()) != AWS_OP_SUCCESS)
+    // A read buffer larger than the budget of the pool could never be borrowed.
+    if (bufferPool && bufferPool->budgetBytes() > 0 && mReadBuf.blockSize() > bufferPool->budgetBytes())
+    {
+        throw std::runtime_error{"Read buffer exceeds the memory budget"};
+    }
+
+    // Message based sockets read whole messages, so a read needs room for the largest message.
+    mMessageBased = mSocket->is_message_based();
+    if (mMessageBased)
     {
-        throw std::runtime_error{"Unable to allocate memory for read buffer"};
+        mMinReadSpace = size_t(mSettings.maxMessageBytes.value());
     }
 
     // Since topic never changes, initialize a cursor with statically allocated memory.
     mTopic = aws_byte_cursor_from_c_str(mSettings.mqttTopic->c_str());
+    AWS_ZERO_STRUCT(mDeadLetterTopic);
+    if (mSettings.mqttDeadLetterTopic.has_value())
+    {
+        mDeadLetterTopic = aws_byte_cursor_from_c_str(mSettings.mqttDeadLetterTopic->c_str());
+    }
 
     // Initialize a task to connect to sensor socket from the event loop.
     // Only needs to be done once.
@@ -62,29 +126,229 @@ Sensor::Sensor(
                 return; // Ignore canceled tasks.
             }
             auto *self = static_cast<Sensor *>(arg);
+            self->mConnectScheduled = false;
             self->onConnectTaskCallback();
         },
         this,
         __func__);
+
+    // Watch for the socket file, so the sensor reconnects as soon as the sensor server creates it.
+    if (mSocket->waits_for_address())
+    {
+        mAddrWatcher.reset(new AddrWatcher(mEventLoop, mSettings.addr.value(), [this]() { onAddrCreated(); }));
+    }
+
+    // Initialize a task to drain and flush the spool from the event loop.
+    AWS_ZERO_STRUCT(mSpoolTask);
+    aws_task_init(
+        &mSpoolTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->onSpoolTaskCallback();
+        },
+        this,
+        __func__);
+
+    // Initialize a task to read again once a buffer may be available from the buffer pool.
+    AWS_ZERO_STRUCT(mReadRetryTask);
+    aws_task_init(
+        &mReadRetryTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->mReadRetryScheduled = false;
+            if (self->mState == SensorState::Connected)
+            {
+                self->onReadableCallback(AWS_OP_SUCCESS);
+            }
+        },
+        this,
+        __func__);
+
+    // Initialize a task to publish buffered messages once the publish timeout expires.
+    AWS_ZERO_STRUCT(mFlushTask);
+    aws_task_init(
+        &mFlushTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->mFlushScheduled = false;
+            self->publish();
+        },
+        this,
+        __func__);
+
+    // Initialize a task to resume reading once acknowledgements drain the in-flight window.
+    AWS_ZERO_STRUCT(mResumeTask);
+    aws_task_init(
+        &mResumeTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->onResumeTaskCallback();
+        },
+        this,
+        __func__);
+
+    // Initialize a task to write commands received from the MQTT client event loop.
+    AWS_ZERO_STRUCT(mWriteTask);
+    aws_task_init(
+        &mWriteTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<Sensor *>(arg);
+            self->mWriteScheduled = false;
+            self->writeCommands();
+        },
+        this,
+        __func__);
+    mMaxInflight = size_t(mSettings.maxInflight.value());
+    mReadBudgetBytes = size_t(mSettings.readBudgetBytes.value());
+
+    if (mSettings.spoolDir.has_value() && !mSettings.spoolDir->empty())
+    {
+        mSpool.reset(new Spool(mSettings.spoolDir.value(), size_t(mSettings.spoolMaxBytes.value())));
+        if (!mSpool->open())
+        {
+            LOGM_ERROR(TAG, "Unable to open spool, spooling is disabled sensor name: %s", mSettings.name->c_str());
+            mSpool.reset();
+        }
+    }
+
+    BatchEncoder::Format format;
+    if (mSettings.batchFormat.has_value() && BatchEncoder::ParseFormat(mSettings.batchFormat.value(), format))
+    {
+        // A batch never holds more messages than buffer_size or the boundary ring.
+        size_t maxMessages = mReadBuf.eomCapacity();
+        if (mSettings.bufferSize.value() > 0)
+        {
+            maxMessages = min(maxMessages, size_t(mSettings.bufferSize.value()));
+        }
+        mBatchEncoder.reset(new BatchEncoder(
+            mAllocator,
+            format,
+            mSettings.batchTimestamps.value(),
+            size_t(mSettings.bufferCapacity.value()),
+            maxMessages));
+    }
+
+    FieldParser::Format summaryFormat;
+    if (!mSettings.summaryFields.empty() && mSettings.summaryFormat.has_value() &&
+        FieldParser::ParseFormat(mSettings.summaryFormat.value(), summaryFormat))
+    {
+        mSummary.reset(new WindowSummary(
+            mAllocator, summaryFormat, mSettings.summaryFields, uint64_t(mSettings.summaryWindowMs.value())));
+    }
+
+    AWS_ZERO_STRUCT(mJoinBuf);
+    AWS_ZERO_STRUCT(mCommandTopic);
+    if (mSettings.mqttCommandTopic.has_value() && !mSettings.mqttCommandTopic->empty())
+    {
+        CommandQueue::DropPolicy policy = CommandQueue::DropPolicy::Oldest;
+        if (mSettings.commandDropPolicy.has_value())
+        {
+            CommandQueue::ParseDropPolicy(mSettings.commandDropPolicy.value(), policy);
+        }
+        mCommands.reset(new CommandQueue(size_t(mSettings.commandBufferBytes.value()), policy));
+        mCommandTopic = aws_byte_cursor_from_c_str(mSettings.mqttCommandTopic->c_str());
+    }
+
+    // Filters are created only when configured, so sensors without filters do not hash or parse messages.
+    unique_ptr<FieldParser> deadbandFields;
+    FieldParser::Format deadbandFormat;
+    if (!mSettings.deadbandFields.empty() && mSettings.deadbandFormat.has_value() &&
+        FieldParser::ParseFormat(mSettings.deadbandFormat.value(), deadbandFormat))
+    {
+        deadbandFields.reset(new FieldParser(deadbandFormat, mSettings.deadbandFields));
+    }
+    if (mSettings.dropDuplicates.value() || deadbandFields || mSettings.maxMessageRate.value() > 0)
+    {
+        mFilter.reset(new MessageFilter(
+            mSettings.dropDuplicates.value(),
+            move(deadbandFields),
+            mSettings.deadband.value(),
+            uint64_t(max<int64_t>(mSettings.maxMessageRate.value(), 0))));
+    }
+
+    Compressor::Algorithm algorithm;
+    if (mSettings.compression.has_value() && Compressor::ParseAlgorithm(mSettings.compression.value(), algorithm))
+    {
+        try
+        {
+            // Envelopes are larger than the raw messages they hold, so size the compressor for a full envelope.
+            size_t maxInputBytes =
+                mBatchEncoder ? mBatchEncoder->capacity() : size_t(mSettings.bufferCapacity.value());
+            mCompressor.reset(new Compressor(mAllocator, algorithm, maxInputBytes));
+        }
+        catch (const std::exception &e)
+        {
+            LOGM_ERROR(
+                TAG,
+                "Unable to create compressor, compression is disabled sensor name: %s error: %s",
+                mSettings.name->c_str(),
+                e.what());
+        }
+    }
 }
 
 Sensor::~Sensor()
 {
+    if (mAddrWatcher)
+    {
+        mAddrWatcher->stop();
+    }
     if (mSocket->is_open())
     {
         mState = SensorState::NotConnected;
         mSocket->close();
     }
     mSocket->clean_up();
-    mHeartbeatTask.stop();
-    aws_byte_buf_clean_up_secure(&mReadBuf);
+    cancelTasks();
+    aws_byte_buf_clean_up(&mJoinBuf);
 }
 
 int Sensor::start()
 {
     LOGM_DEBUG(TAG, "Starting sensor name: %s", mSettings.name->c_str());
+    mStarted = true;
     connect();
     mHeartbeatTask.start();
+    if (mCommands && !mCommandSubscribed)
+    {
+        if (mqttSubscribe(&mCommandTopic) == 0)
+        {
+            LOGM_ERROR(
+                TAG,
+                "Error subscribing to command topic sensor name: %s msg: %s",
+                mSettings.name->c_str(),
+                aws_error_str(aws_last_error()));
+        }
+        else
+        {
+            mCommandSubscribed = true;
+        }
+    }
+    if (mSpool && !mSpoolTaskStarted)
+    {
+        mSpoolTaskStarted = true;
+        scheduleSpoolTask();
+    }
     return Feature::SUCCESS;
 }
 
@@ -92,11 +356,91 @@ int Sensor::stop()
 {
     LOGM_DEBUG(TAG, "Stopping sensor name: %s", mSettings.name->c_str());
     close();
-    reset();
-    mHeartbeatTask.stop();
+    if (mAddrWatcher)
+    {
+        mAddrWatcher->stop();
+    }
+    if (mCommandSubscribed)
+    {
+        mqttUnsubscribe(&mCommandTopic);
+        mCommandSubscribed = false;
+    }
+    cancelTasks();
+    mStarted = false;
+    if (mCommands)
+    {
+        mCommands->clear();
+        mCommandPending = false;
+    }
     return Feature::SUCCESS;
 }
 
+void Sensor::cancelTasks()
+{
+    bool scheduled = mStarted || mConnectScheduled || mSpoolTaskStarted || mReadRetryScheduled || mFlushScheduled ||
+                     mResumeScheduled || mWriteScheduled || hasDeadLetterRetries();
+    if (scheduled && !aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        // Tasks may only be cancelled from the event loop thread, so wait for the event loop to cancel them.
+        struct CancelArgs
+        {
+            Sensor *self;
+            promise<void> done;
+        } args{this, promise<void>()};
+        future<void> done = args.done.get_future();
+        aws_task task;
+        aws_task_init(
+            &task,
+            [](struct aws_task *, void *arg, enum aws_task_status) {
+                // Also cancel when the event loop is shutting down, so that no task is left pointing at the sensor.
+                auto *cancelArgs = static_cast<CancelArgs *>(arg);
+                cancelArgs->self->cancelTasksOnEventLoop();
+                cancelArgs->done.set_value();
+            },
+            &args,
+            __func__);
+        aws_event_loop_schedule_task_now(mEventLoop, &task);
+        done.wait();
+    }
+    else
+    {
+        cancelTasksOnEventLoop();
+    }
+}
+
+void Sensor::cancelTasksOnEventLoop()
+{
+    // Acknowledgements only schedule the resume task while reading is paused.
+    mReadPaused = false;
+    mHeartbeatTask.stop();
+    auto cancel = [this](aws_task &task, atomic<bool> &scheduled) {
+        if (scheduled.exchange(false))
+        {
+            aws_event_loop_cancel_task(mEventLoop, &task);
+        }
+    };
+    cancel(mConnectTask, mConnectScheduled);
+    cancel(mSpoolTask, mSpoolTaskStarted);
+    cancel(mReadRetryTask, mReadRetryScheduled);
+    cancel(mFlushTask, mFlushScheduled);
+    cancel(mResumeTask, mResumeScheduled);
+    cancel(mWriteTask, mWriteScheduled);
+
+    // Cancelling runs the retry task, which drops the batch and takes its context out of mDeadLetterRetries.
+    set<PublishContext *> retries;
+    {
+        lock_guard<mutex> lock(mDeadLetterRetryLock);
+        retries.swap(mDeadLetterRetries);
+    }
+    for (PublishContext *context : retries)
+    {
+        aws_event_loop_cancel_task(mEventLoop, &context->retryTask);
+    }
+
+    // No task can touch the read buffer anymore, so its block can go back to the buffer pool.
+    reset();
+}
+
 string Sensor::getName() const
 {
     return mSettings.name.value();
@@ -123,26 +467,35 @@ void Sensor::connect(bool delay)
     // Schedule task to cnnect to sensor socket.
     if (delay && mSettings.addrPollSec.value() > 0)
     {
+        // Poll the address in case the socket file cannot be watched, or exists but the server is not listening yet.
+        if (mAddrWatcher)
+        {
+            mAddrWatcher->start();
+        }
+
         // Schedule task in the future.
         uint64_t runAtNanos;
         aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
         chrono::seconds delaySec(mSettings.addrPollSec.value());
         runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delaySec).count();
         aws_event_loop_schedule_task_future(mEventLoop, &mConnectTask, runAtNanos);
+        mConnectDelayed = true;
+        mConnectScheduled = true;
     }
     else
     {
+        mConnectDelayed = false;
         // Schedule task immediately.
         aws_event_loop_schedule_task_now(mEventLoop, &mConnectTask);
+        mConnectScheduled = true;
     }
 }
 
 void Sensor::onConnectTaskCallback()
 {
-    aws_socket_options socket_options;
-    socket_options.type = AWS_SOCKET_STREAM;
-    socket_options.domain = AWS_SOCKET_LOCAL;
-    mSocket->init(mAllocator, &socket_options);
+    mConnectDelayed = false;
+
+    mSocket->init(mAllocator);
 
     aws_socket_endpoint endpoint{};
     AWS_ZERO_STRUCT(endpoint);
@@ -174,6 +527,20 @@ void Sensor::onConnectTaskCallback()
     }
 }
 
+void Sensor::onAddrCreated()
+{
+    if (mState != SensorState::Connecting || !mConnectDelayed)
+    {
+        return; // Ignore while connected, or while a connect attempt is already due.
+    }
+
+    // Replace the pending poll with an immediate connect.
+    LOGM_DEBUG(TAG, "Address created, reconnecting sensor name: %s", mSettings.name->c_str());
+    aws_event_loop_cancel_task(mEventLoop, &mConnectTask);
+    mConnectDelayed = false;
+    aws_event_loop_schedule_task_now(mEventLoop, &mConnectTask);
+}
+
 void Sensor::onConnectionResultCallback(int error_code)
 {
     if (error_code)
@@ -193,6 +560,12 @@ void Sensor::onConnectionResultCallback(int error_code)
         mState = SensorState::Connected;
         LOGM_DEBUG(TAG, "Success sensor name: %s func: %s", mSettings.name->c_str(), __func__);
 
+        // Stop watching the socket file until the connection is lost.
+        if (mAddrWatcher)
+        {
+            mAddrWatcher->stop();
+        }
+
         // Publish any previously buffered data.
         publish();
 
@@ -210,6 +583,12 @@ void Sensor::onConnectionResultCallback(int error_code)
                 self->onReadableCallback(error_code);
             },
             this);
+
+        // Write commands received while disconnected.
+        if (mCommands)
+        {
+            writeCommands();
+        }
     }
 }
 
@@ -237,39 +616,42 @@ void Sensor::onReadableCallback(int error_code)
         //
         // This behavior is equivalent to using epoll on Linux with socket
         // added as EPOLLET (edge-triggered) and reading until receiving EAGAIN.
+        //
+        // A sensor which keeps the socket readable would hold the event loop
+        // shared with other sensors, so reading yields once the read budget
+        // is used up and continues from a task.
+        size_t budgetUsed = 0;
         bool readWouldBlock = false;
         while (!readWouldBlock)
         {
-            size_t numRead = 0, startPos = mReadBuf.len;
-            int rc = mSocket->read(&mReadBuf, &numRead);
-            if (rc == AWS_OP_SUCCESS)
+            if (pauseIfWindowFull())
             {
-                LOGM_DEBUG(TAG, "Read sensor name: %s bytes: %zu", mSettings.name->c_str(), numRead);
-
-                // Scan the buffer for end of message boundaries.
-                // If the buffer is empty, then start scan from start of read.
-                // If the buffer is not empty, then start from one past end of last message.
-                const char *pbuf = reinterpret_cast<char *>(mReadBuf.buffer);
-                auto beginPos = mEomBounds.empty() ? startPos : mEomBounds.back();
-                for (auto m = cregex_iterator(pbuf + beginPos, pbuf + startPos + numRead, mEomPattern),
-                          mend = cregex_iterator();
-                     m != mend;
-                     ++m)
-                {
-                    // Store the position of one-past the end of the match.
-                    mEomBounds.emplace(beginPos + (*m).position() + (*m).length());
-                }
+                // Leave the data in the socket until acknowledgements drain the in-flight window.
+                return;
+            }
 
-                // Invoke publish to check whether batch limits are breached.
-                publish();
+            // Read directly into the free space of the ring buffer.
+            // A read which reaches the end of the buffer continues at the start on the next iteration.
+            aws_byte_buf readBuf = mReadBuf.writableSpace(mMinReadSpace);
+            if (!mReadBuf.allocated())
+            {
+                // Every buffer of the shared buffer pool is in use, so leave the data in the socket and
+                // read again once other sensors had a chance to publish.
+                LOGM_DEBUG(TAG, "No read buffer available, deferring read sensor name: %s", mSettings.name->c_str());
+                ++mCounters.readDeferred;
+                scheduleReadRetry();
+                return;
             }
-            else
+            int rc = mMessageBased ? readMessages(readBuf) : readStream(readBuf);
+            if (rc != AWS_OP_SUCCESS)
             {
                 int lastError = aws_last_error();
                 if (lastError == AWS_IO_READ_WOULD_BLOCK)
                 {
                     // Wait for socket to become readable again before trying to read.
+                    // Return the read buffer to the pool while there is nothing buffered.
                     readWouldBlock = true;
+                    mReadBuf.releaseIfEmpty();
                 }
                 else
                 {
@@ -291,136 +673,1052 @@ void Sensor::onReadableCallback(int error_code)
                     return;
                 }
             }
+            else
+            {
+                budgetUsed += readBuf.len;
+                mCounters.bytesRead += readBuf.len;
+                if (mReadBudgetBytes > 0 && budgetUsed >= mReadBudgetBytes)
+                {
+                    yieldRead();
+                    return;
+                }
+            }
         }
     }
 }
 
-void Sensor::publish()
+int Sensor::readStream(aws_byte_buf &readBuf)
 {
-    // Check whether limits are breached and, if so, compute bufferSize and numBatches.
-    size_t bufferSize, numBatches;
-    if (!needPublish(bufferSize, numBatches))
+    size_t numRead = 0;
+    if (mSocket->read(&readBuf, &numRead) != AWS_OP_SUCCESS)
     {
-        LOGM_DEBUG(TAG, "Nothing to publish sensor name: %s", mSettings.name->c_str());
-        return;
+        return AWS_OP_ERR;
     }
+    LOGM_DEBUG(TAG, "Read sensor name: %s bytes: %zu", mSettings.name->c_str(), numRead);
+    mReadBuf.commitWrite(numRead);
+    updateReadTime();
 
-    size_t startPos = 0, lastEom = 0;
-    while (numBatches > 0)
+    // Scan for end of message boundaries and invoke publish to check whether batch limits are
+    // breached. Repeat while publishing frees space in a full boundary ring.
+    bool scanComplete;
+    do
     {
-        // Publish complete messages in bufferSize increments.
-        size_t numToPub = min(mEomBounds.size(), bufferSize);
-        for (size_t i = 0; i < numToPub; ++i)
+        scanComplete = scanForEom();
+        publish();
+    } while (!scanComplete && !mReadBuf.eomFull());
+    return AWS_OP_SUCCESS;
+}
+
+int Sensor::readMessages(aws_byte_buf &readBuf)
+{
+    // Every message needs a slot of the largest message size and a boundary.
+    size_t maxMessages = min(
+        READ_MESSAGES_MAX, min(readBuf.capacity / mMinReadSpace, mReadBuf.eomCapacity() - mReadBuf.eomCount()));
+    if (maxMessages == 0)
+    {
+        // Publish to make room, and read again later when publishing was not enough.
+        publish();
+        readBuf = mReadBuf.writableSpace(mMinReadSpace);
+        maxMessages = min(
+            READ_MESSAGES_MAX, min(readBuf.capacity / mMinReadSpace, mReadBuf.eomCapacity() - mReadBuf.eomCount()));
+        if (maxMessages == 0)
         {
-            lastEom = mEomBounds.front();
-            mEomBounds.pop();
+            scheduleReadRetry();
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
         }
+    }
 
-        // Create a shallow copy of a buffer up to the lastEom.
-        aws_byte_cursor pubBuf = aws_byte_cursor_from_array(mReadBuf.buffer + startPos, lastEom);
-        LOGM_DEBUG(TAG, "Publish sensor name: %s bytes: %zu", mSettings.name->c_str(), pubBuf.len);
-
-        // Publish buffer.
-        publishOneMessage(&pubBuf);
-
-        // Update start of next message to 1-past end of current message.
-        startPos = lastEom;
+    size_t lengths[READ_MESSAGES_MAX];
+    size_t count = 0, truncatedBytes = 0;
+    if (mSocket->read_messages(&readBuf, mMinReadSpace, lengths, maxMessages, &count, &truncatedBytes) !=
+        AWS_OP_SUCCESS)
+    {
+        return AWS_OP_ERR;
+    }
+    LOGM_DEBUG(TAG, "Read sensor name: %s messages: %zu bytes: %zu", mSettings.name->c_str(), count, readBuf.len);
+    if (truncatedBytes > 0)
+    {
+        LOGM_ERROR(
+            TAG,
+            "Message exceeds %s, discarding %zu bytes sensor name: %s",
+            PlainConfig::SensorPublish::JSON_MAX_MESSAGE_BYTES,
+            truncatedBytes,
+            mSettings.name->c_str());
+        mCounters.discardedBytes += truncatedBytes;
+    }
+    updateReadTime();
 
-        --numBatches;
+    // Message boundaries are known from the socket, so there is nothing to scan.
+    size_t first = mReadBuf.eomCount();
+    size_t offset = mReadBuf.writeEnd();
+    for (size_t i = 0; i < count; ++i)
+    {
+        offset += lengths[i];
+        mReadBuf.pushEom(offset, mReadTimeMs);
     }
+    mReadBuf.commitWrite(readBuf.len);
+    mReadBuf.setScanned(mReadBuf.writeEnd());
+    filterMessages(first);
+    publish();
+    return AWS_OP_SUCCESS;
+}
 
-    if (mEomBounds.empty())
+void Sensor::updateReadTime()
+{
+    mLastReadTime = LatencyClock::now();
+    if (mReadBuf.eomCount() == 0)
+    {
+        mBatchReadTime = mLastReadTime;
+    }
+    if (mBatchEncoder && mSettings.batchTimestamps.value())
     {
-        // Advance the lastEom to the start of the buffer.
-        size_t count = mReadBuf.len - lastEom;
-        std::memcpy(mReadBuf.buffer, mReadBuf.buffer + lastEom, count);
-        mReadBuf.len = count;
+        mReadTimeMs = epochMs();
     }
+}
 
-    // Update the publish timeout.
-    if (mSettings.bufferTimeMs.value() > 0)
+void Sensor::scheduleReadRetry()
+{
+    if (mReadRetryScheduled)
     {
-        chrono::milliseconds delayMs(mSettings.bufferTimeMs.value());
-        mNextPublishTimeout = chrono::high_resolution_clock::now() + delayMs;
+        return;
     }
+    mReadRetryScheduled = true;
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    chrono::milliseconds delayMs(READ_RETRY_INTERVAL_MS);
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mReadRetryTask, runAtNanos);
 }
 
-bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
+void Sensor::yieldRead()
 {
-    // Buffer size is the number of messages published in a single batch.
-    bufferSize = size_t(mSettings.bufferSize.value());
-    if (bufferSize == 0)
+    ++mCounters.readYielded;
+    if (mReadRetryScheduled)
     {
-        // Publish all buffered messages as a single batch.
-        bufferSize = mEomBounds.size();
+        return;
     }
+    mReadRetryScheduled = true;
+    aws_event_loop_schedule_task_now(mEventLoop, &mReadRetryTask);
+}
 
-    // Compute number of batches based on the total available messages.
-    numBatches = mEomBounds.empty() ? 0 : mEomBounds.size() / bufferSize;
+bool Sensor::scanForEom()
+{
+    size_t startPos = mReadBuf.scanned(), endPos = mReadBuf.writeEnd();
+    if (startPos == endPos)
+    {
+        return true;
+    }
 
-    if (numBatches < 1)
+    // Scan the buffer for end of message boundaries.
+    // If the buffer is empty, then start scan from start of read.
+    // If the buffer is not empty, then start from one past end of last message.
+    // Delimiters with a bounded length only need to rescan enough of the previous
+    // read to find a delimiter that straddles both reads.
+    const char *pbuf = reinterpret_cast<const char *>(mReadBuf.data());
+    size_t beginPos = mReadBuf.hasEomInWriteSegment() ? mReadBuf.messageBegin() : startPos;
+    size_t lookbehind = mEomScanner.lookbehind();
+    if (lookbehind != EomScanner::UNBOUNDED_LOOKBEHIND)
     {
-        if (!mEomBounds.empty())
-        {
-            // Check other circumstances in which we must publish at least one batch.
-            if (chrono::high_resolution_clock::now() > mNextPublishTimeout)
-            {
-                numBatches = 1; // Publish timeout.
-            }
-            else if (mReadBuf.len == mReadBuf.capacity)
-            {
-                numBatches = 1; // Buffer full.
-            }
-        }
-        else
-        {
-            // Discard unpublished data when buffer is full and we haven't
-            // found any end of message delimeters in the buffer.
-            if (mReadBuf.len == mReadBuf.capacity)
-            {
-                LOGM_ERROR(
-                    TAG,
-                    "Buffer is full and no end of message delimeter detected, discarding %zu bytes of unpublished "
-                    "messages sensor name: %s",
-                    mReadBuf.len,
-                    mSettings.name->c_str());
-                aws_byte_buf_reset(&mReadBuf, false);
-            }
-        }
+        beginPos = max(mReadBuf.messageBegin(), startPos - min(startPos, lookbehind));
     }
 
-    return numBatches > 0;
+    bool complete = true;
+    size_t first = mReadBuf.eomCount();
+    mEomScanner.scan(pbuf + beginPos, pbuf + endPos, [this, beginPos, &complete](size_t eom) {
+        // Store the position of one-past the end of the match.
+        complete = mReadBuf.pushEom(beginPos + eom, mReadTimeMs);
+        return complete;
+    });
+
+    // When the boundary ring is full, resume scanning after the last stored boundary.
+    mReadBuf.setScanned(complete ? endPos : mReadBuf.messageBegin());
+    filterMessages(first);
+    return complete;
 }
 
-void Sensor::publishOneMessage(const aws_byte_cursor *payload)
+void Sensor::filterMessages(size_t first)
 {
-    aws_mqtt_client_connection_publish(
-        mConnection->GetUnderlyingConnection(),
-        &mTopic,
-        AWS_MQTT_QOS_AT_LEAST_ONCE,
-        false,
-        payload,
-        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata) {
-            auto *self = static_cast<Sensor *>(userdata);
-            if (error_code)
+    if (!mFilter || first == mReadBuf.eomCount())
+    {
+        return;
+    }
+
+    // Messages are filtered as soon as their boundary is found, so dropped messages never take part in a batch.
+    auto now = MessageFilter::Clock::now();
+    const char *pbuf = reinterpret_cast<const char *>(mReadBuf.data());
+    size_t removed = mReadBuf.removeMessages(first, [this, pbuf, now](size_t begin, size_t end) {
+        const char *message = pbuf + begin;
+        const char *delimiter = mMessageBased ? pbuf + end : mEomScanner.delimiterBegin(message, pbuf + end);
+        size_t len = static_cast<size_t>(delimiter - message);
+        switch (mFilter->check(reinterpret_cast<const uint8_t *>(message), len, now))
+        {
+            case MessageFilter::Verdict::Keep:
+                return false;
+            case MessageFilter::Verdict::Duplicate:
+                ++mCounters.droppedDuplicate;
+                break;
+            case MessageFilter::Verdict::Deadband:
+                ++mCounters.droppedDeadband;
+                break;
+            case MessageFilter::Verdict::RateLimited:
+                ++mCounters.droppedRateLimited;
+                break;
+        }
+        return true;
+    });
+    if (removed > 0)
+    {
+        LOGM_DEBUG(TAG, "Filtered sensor name: %s dropped messages: %zu", mSettings.name->c_str(), removed);
+    }
+}
+
+void Sensor::publish()
+{
+    if (mSummary)
+    {
+        summarize();
+        return;
+    }
+
+    // Check whether limits are breached and, if so, compute bufferSize and numBatches.
+    size_t bufferSize, numBatches;
+    if (!needPublish(bufferSize, numBatches))
+    {
+        LOGM_DEBUG(TAG, "Nothing to publish sensor name: %s", mSettings.name->c_str());
+        scheduleFlush();
+        return;
+    }
+
+    while (numBatches > 0)
+    {
+        if (pauseIfWindowFull())
+        {
+            break; // Remaining messages are published once acknowledgements drain the in-flight window.
+        }
+
+        // Publish complete messages in bufferSize increments.
+        size_t numToPub = min(mReadBuf.eomCount(), bufferSize);
+        size_t count = numToPub;
+        // Create a shallow copy of a buffer up to the last end of message in the batch.
+        aws_byte_cursor pubBuf = mReadBuf.peek(count);
+        if (count < numToPub)
+        {
+            publishWrappedBatch(numToPub);
+        }
+        else
+        {
+            aws_byte_cursor batch = pubBuf;
+            if (!mBatchEncoder || encodeBatch(batch, count, pubBuf))
+            {
+                LOGM_DEBUG(TAG, "Publish sensor name: %s bytes: %zu", mSettings.name->c_str(), pubBuf.len);
+
+                // Publish buffer.
+                publishOneMessage(&pubBuf, mBatchReadTime);
+            }
+
+            // Release published messages.
+            mReadBuf.consume(count);
+        }
+
+        // Messages left over were most likely completed by the most recent read.
+        if (mReadBuf.eomCount() > 0)
+        {
+            mBatchReadTime = mLastReadTime;
+        }
+
+        --numBatches;
+    }
+
+    // Update the publish timeout.
+    if (mSettings.bufferTimeMs.value() > 0)
+    {
+        chrono::milliseconds delayMs(mSettings.bufferTimeMs.value());
+        mNextPublishTimeout = chrono::high_resolution_clock::now() + delayMs;
+    }
+    scheduleFlush();
+}
+
+bool Sensor::inflightWindowFull() const
+{
+    return mMaxInflight > 0 && mInflight >= mMaxInflight;
+}
+
+bool Sensor::pauseIfWindowFull()
+{
+    if (!inflightWindowFull())
+    {
+        return false;
+    }
+    if (!mReadPaused)
+    {
+        mPausedSince = chrono::steady_clock::now();
+        ++mCounters.windowFull;
+        LOGM_DEBUG(
+            TAG,
+            "In-flight window full, pausing reads sensor name: %s in-flight: %zu",
+            mSettings.name->c_str(),
+            mMaxInflight);
+        mReadPaused = true;
+    }
+
+    // An acknowledgement which arrived before reading was paused did not schedule the resume task.
+    if (!inflightWindowFull() && !mResumeScheduled.exchange(true))
+    {
+        aws_event_loop_schedule_task_now(mEventLoop, &mResumeTask);
+    }
+    return true;
+}
+
+void Sensor::releaseInflight()
+{
+    size_t inflight = --mInflight;
+    if (mReadPaused && inflight < mMaxInflight && !mResumeScheduled.exchange(true))
+    {
+        aws_event_loop_schedule_task_now(mEventLoop, &mResumeTask);
+    }
+}
+
+void Sensor::onResumeTaskCallback()
+{
+    mResumeScheduled = false;
+    if (!mReadPaused || inflightWindowFull())
+    {
+        return; // Still full, the next acknowledgement schedules the task again.
+    }
+
+    mReadPaused = false;
+    auto pausedMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - mPausedSince);
+    mCounters.windowFullMs += static_cast<uint64_t>(pausedMs.count());
+    LOGM_DEBUG(TAG, "In-flight window has room, resuming reads sensor name: %s", mSettings.name->c_str());
+
+    // Publish messages held back by the window, then read the data left in the socket.
+    publish();
+    if (mState == SensorState::Connected)
+    {
+        onReadableCallback(AWS_OP_SUCCESS);
+    }
+}
+
+void Sensor::scheduleFlush()
+{
+    if (mFlushScheduled)
+    {
+        return;
+    }
+
+    chrono::nanoseconds delay;
+    if (mSummary)
+    {
+        // The summary is published once the window ends, even when no more messages are read.
+        if (mSummary->empty())
+        {
+            return;
+        }
+        uint64_t windowEnd = mSummary->windowEnd();
+        delay = chrono::milliseconds(windowEnd - min(epochMs(), windowEnd));
+    }
+    else
+    {
+        if (mSettings.bufferTimeMs.value() <= 0 || mReadBuf.eomCount() == 0)
+        {
+            return;
+        }
+        delay = chrono::duration_cast<chrono::nanoseconds>(
+            max(mNextPublishTimeout - chrono::high_resolution_clock::now(), TimePointT::duration::zero()));
+    }
+
+    // The task may run before the timeout expires when the timeout was pushed back by a publish,
+    // in which case publish schedules it again.
+    mFlushScheduled = true;
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    runAtNanos += delay.count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mFlushTask, runAtNanos);
+}
+
+template <typename MessageFn> void Sensor::forEachMessage(const aws_byte_cursor &batch, size_t count, MessageFn fn)
+{
+    const char *data = reinterpret_cast<const char *>(mReadBuf.data());
+    const char *begin = reinterpret_cast<const char *>(batch.ptr);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const char *end = data + mReadBuf.eomAt(i);
+        const char *delimiter = mMessageBased ? end : mEomScanner.delimiterBegin(begin, end);
+        fn(reinterpret_cast<const uint8_t *>(begin), static_cast<size_t>(delimiter - begin), i);
+        begin = end;
+    }
+}
+
+bool Sensor::encodeBatch(const aws_byte_cursor &batch, size_t count, aws_byte_cursor &encoded)
+{
+    // Messages are added without their end of message delimiter.
+    mBatchEncoder->begin(count);
+    forEachMessage(batch, count, [this](const uint8_t *message, size_t len, size_t i) {
+        mBatchEncoder->add(message, len, mReadBuf.eomTimeAt(i));
+    });
+    return finishBatch(count, encoded);
+}
+
+bool Sensor::finishBatch(size_t count, aws_byte_cursor &encoded)
+{
+    if (mBatchEncoder->finish(encoded))
+    {
+        return true;
+    }
+    ++mCounters.encodeFailed;
+    LOGM_ERROR(
+        TAG,
+        "Unable to allocate memory for the batch envelope, dropping %zu messages sensor name: %s",
+        count,
+        mSettings.name->c_str());
+    return false;
+}
+
+void Sensor::publishWrappedBatch(size_t count)
+{
+    size_t numMessages = count;
+    // The batch spans the wrap point of the buffer, so its two parts are joined, in the batch envelope or in a copy,
+    // and published as one message. Each part is released once it has been added.
+    if (mBatchEncoder)
+    {
+        mBatchEncoder->begin(count);
+    }
+    else if (
+        mJoinBuf.buffer == nullptr &&
+        aws_byte_buf_init(&mJoinBuf, mAllocator, size_t(mSettings.bufferCapacity.value())) != AWS_OP_SUCCESS)
+    {
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: aws_byte_buf_init msg: %s, publishing the batch in two parts",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        while (count > 0)
+        {
+            size_t partCount = count;
+            aws_byte_cursor part = mReadBuf.peek(partCount);
+            publishOneMessage(&part, mBatchReadTime);
+            mReadBuf.consume(partCount);
+            count -= partCount;
+        }
+        return;
+    }
+
+    aws_byte_buf_reset(&mJoinBuf, false);
+    while (count > 0)
+    {
+        size_t partCount = count;
+        aws_byte_cursor part = mReadBuf.peek(partCount);
+        if (mBatchEncoder)
+        {
+            forEachMessage(part, partCount, [this](const uint8_t *message, size_t len, size_t i) {
+                mBatchEncoder->add(message, len, mReadBuf.eomTimeAt(i));
+            });
+        }
+        else
+        {
+            aws_byte_buf_append(&mJoinBuf, &part);
+        }
+        mReadBuf.consume(partCount);
+        count -= partCount;
+    }
+
+    aws_byte_cursor pubBuf = aws_byte_cursor_from_buf(&mJoinBuf);
+    if (mBatchEncoder && !finishBatch(numMessages, pubBuf))
+    {
+        return;
+    }
+    LOGM_DEBUG(TAG, "Publish sensor name: %s bytes: %zu", mSettings.name->c_str(), pubBuf.len);
+    publishOneMessage(&pubBuf, mBatchReadTime);
+}
+
+void Sensor::summarize()
+{
+    // Publish the summary of a window which has ended before adding messages of the next window.
+    uint64_t nowMs = epochMs();
+    if (!mSummary->empty() && nowMs >= mSummary->windowEnd())
+    {
+        aws_byte_cursor summary = mSummary->finish();
+        LOGM_DEBUG(TAG, "Publish summary sensor name: %s bytes: %zu", mSettings.name->c_str(), summary.len);
+        publishOneMessage(&summary);
+    }
+
+    // Messages are only needed until they are added to the summary, so they are released straight away.
+    while (mReadBuf.eomCount() > 0)
+    {
+        size_t count = mReadBuf.eomCount();
+        aws_byte_cursor messages = mReadBuf.peek(count);
+        forEachMessage(messages, count, [this, nowMs](const uint8_t *message, size_t len, size_t) {
+            mSummary->add(message, len, nowMs);
+        });
+        mReadBuf.consume(count);
+    }
+    discardIfFullWithoutEom();
+    scheduleFlush();
+}
+
+bool Sensor::needPublish(size_t &bufferSize, size_t &numBatches)
+{
+    // Buffer size is the number of messages published in a single batch.
+    bufferSize = size_t(mSettings.bufferSize.value());
+    if (bufferSize == 0)
+    {
+        // Publish all buffered messages as a single batch.
+        bufferSize = mReadBuf.eomCount();
+    }
+
+    // Compute number of batches based on the total available messages.
+    numBatches = mReadBuf.eomCount() == 0 ? 0 : mReadBuf.eomCount() / bufferSize;
+
+    if (numBatches < 1)
+    {
+        if (mReadBuf.eomCount() > 0)
+        {
+            // Check other circumstances in which we must publish at least one batch.
+            if (chrono::high_resolution_clock::now() > mNextPublishTimeout)
+            {
+                numBatches = 1; // Publish timeout.
+            }
+            else if (mReadBuf.full(mMinReadSpace) || mReadBuf.eomFull())
+            {
+                numBatches = 1; // Buffer full.
+            }
+        }
+        else
+        {
+            discardIfFullWithoutEom();
+        }
+    }
+
+    return numBatches > 0;
+}
+
+void Sensor::discardIfFullWithoutEom()
+{
+    // Discard unpublished data when buffer is full and we haven't
+    // found any end of message delimeters in the buffer.
+    if (mReadBuf.eomCount() == 0 && mReadBuf.full())
+    {
+        LOGM_ERROR(
+            TAG,
+            "Buffer is full and no end of message delimeter detected, discarding %zu bytes of unpublished "
+            "messages sensor name: %s",
+            mReadBuf.size(),
+            mSettings.name->c_str());
+        mCounters.discardedBytes += mReadBuf.size();
+        aws_byte_cursor discarded = mReadBuf.partialMessage();
+        publishDeadLetter(&discarded);
+        mReadBuf.reset();
+    }
+}
+
+Sensor::PublishContext::PublishContext(Sensor *sensor) : sensor(sensor)
+{
+    AWS_ZERO_STRUCT(payload);
+}
+
+Sensor::PublishContext::~PublishContext()
+{
+    aws_byte_buf_clean_up(&payload);
+}
+
+void Sensor::publishOneMessage(const aws_byte_cursor *payload, LatencyClock::time_point readTime)
+{
+    ++mCounters.batches;
+
+    // Aggregated batches are published with batches of other sensors. A batch too large to be aggregated, or
+    // refused while the aggregate in-flight window is full, is published to the sensor topic. Batches are spooled
+    // rather than aggregated while the MQTT connection is interrupted.
+    bool spooling = mSpool && !mMqttConnected;
+    if (mAggregator && !spooling && mAggregator->add(mSettings.name.value(), *payload))
+    {
+        ++mCounters.aggregated;
+        return;
+    }
+
+    aws_byte_cursor compressed;
+    if (mCompressor && payload->len > mCompressor->maxInputBytes())
+    {
+        // A JSON envelope grows past its initial size when messages need escaping.
+        ++mCounters.compressionSkipped;
+        LOGM_DEBUG(
+            TAG,
+            "Batch too large to compress sensor name: %s size: %zu limit: %zu",
+            mSettings.name->c_str(),
+            payload->len,
+            mCompressor->maxInputBytes());
+    }
+    else if (
+        mCompressor && payload->len >= size_t(mSettings.compressionMinBytes.value()) &&
+        mCompressor->compress(*payload, compressed))
+    {
+        ++mCounters.compressedBatches;
+        mCounters.uncompressedBytes += payload->len;
+        mCounters.compressedBytes += compressed.len;
+        LOGM_DEBUG(
+            TAG,
+            "Compressed batch sensor name: %s original size: %zu compressed size: %zu",
+            mSettings.name->c_str(),
+            payload->len,
+            compressed.len);
+        payload = &compressed;
+    }
+
+    if (spooling)
+    {
+        if (mSpool->append(payload->ptr, payload->len))
+        {
+            ++mCounters.spooled;
+            mCounters.spoolEvicted = mSpool->evictedRecords();
+            return;
+        }
+        // Unable to spool, leave the batch to the MQTT client offline queue.
+    }
+    publishToTopic(payload, readTime);
+}
+
+void Sensor::publishToTopic(const aws_byte_cursor *payload, LatencyClock::time_point readTime)
+{
+    auto *context = new PublishContext(this);
+    context->readTime = readTime;
+    context->submitTime = LatencyClock::now();
+    if (readTime != LatencyClock::time_point())
+    {
+        mLatency.queue.record(latencyUs(readTime, context->submitTime));
+    }
+    if (mDeadLetterTopic.len > 0 &&
+        aws_byte_buf_init_copy_from_cursor(&context->payload, mAllocator, *payload) != AWS_OP_SUCCESS)
+    {
+        // Without a copy of the payload a failed publish cannot be sent to the dead-letter topic, publish anyway.
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: aws_byte_buf_init_copy_from_cursor msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+    }
+
+    // Hold a slot of the in-flight window until the publish completes.
+    context->inflight = true;
+    ++mInflight;
+    uint16_t packetId = mqttPublish(&mTopic, payload, context);
+    if (packetId == 0)
+    {
+        onPublishComplete(context, packetId, aws_last_error());
+    }
+}
+
+void Sensor::onConnectionStateChanged(bool connected)
+{
+    mMqttConnected = connected;
+    if (mSpool)
+    {
+        LOGM_INFO(
+            TAG,
+            "MQTT connection %s, %s spooled batches sensor name: %s",
+            connected ? "resumed" : "interrupted",
+            connected ? "draining" : "writing",
+            mSettings.name->c_str());
+    }
+}
+
+void Sensor::scheduleSpoolTask()
+{
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    chrono::milliseconds delayMs(SPOOL_TASK_INTERVAL_MS);
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mSpoolTask, runAtNanos);
+}
+
+void Sensor::onSpoolTaskCallback()
+{
+    // Spool task has been stopped.
+    if (!mSpoolTaskStarted)
+    {
+        return;
+    }
+
+    drainSpool();
+    mSpool->maybeSync();
+
+    scheduleSpoolTask();
+}
+
+void Sensor::drainSpool()
+{
+    if (!mMqttConnected)
+    {
+        mSpoolCredit = 0; // Start draining slowly once the connection resumes.
+        return;
+    }
+
+    int64_t rate = mSettings.spoolDrainRate.value();
+    mSpoolCredit = min(mSpoolCredit + rate * SPOOL_TASK_INTERVAL_MS, rate * 1000);
+
+    size_t drained = 0;
+    const uint8_t *data;
+    size_t len;
+    while (mSpoolCredit >= 1000 && mMqttConnected && !inflightWindowFull() && mSpool->peek(&data, &len))
+    {
+        // Publish copies the payload, so the record can be released straight away.
+        aws_byte_cursor payload = aws_byte_cursor_from_array(data, len);
+        publishToTopic(&payload);
+        mSpool->pop();
+        mSpoolCredit -= 1000;
+        ++drained;
+    }
+
+    if (drained > 0)
+    {
+        mCounters.spoolDrained += drained;
+        LOGM_DEBUG(
+            TAG,
+            "Drained spooled batches: %zu remaining: %zu sensor name: %s",
+            drained,
+            mSpool->records(),
+            mSettings.name->c_str());
+        if (mSpool->empty())
+        {
+            LOGM_INFO(TAG, "Spool drained sensor name: %s", mSettings.name->c_str());
+        }
+    }
+}
+
+void Sensor::publishDeadLetter(const aws_byte_cursor *payload)
+{
+    if (mDeadLetterTopic.len == 0 || payload->len == 0)
+    {
+        return;
+    }
+
+    if (!reserveDeadLetter(payload->len))
+    {
+        return;
+    }
+
+    auto *context = new PublishContext(this);
+    if (aws_byte_buf_init_copy_from_cursor(&context->payload, mAllocator, *payload) != AWS_OP_SUCCESS)
+    {
+        ++mCounters.deadLetterFailed;
+        LOGM_ERROR(
+            TAG,
+            "Error sensor name: %s func: aws_byte_buf_init_copy_from_cursor msg: %s",
+            mSettings.name->c_str(),
+            aws_error_str(aws_last_error()));
+        --mDeadLetterPending;
+        delete context;
+        return;
+    }
+    context->deadLetter = true;
+    retryDeadLetter(context);
+}
+
+bool Sensor::reserveDeadLetter(size_t len)
+{
+    if (mDeadLetterPending.fetch_add(1) >= DEAD_LETTER_MAX_PENDING)
+    {
+        --mDeadLetterPending;
+        ++mCounters.deadLetterFailed;
+        LOGM_ERROR(
+            TAG,
+            "Too many pending dead-letter publishes, dropping %zu bytes sensor name: %s",
+            len,
+            mSettings.name->c_str());
+        return false;
+    }
+    return true;
+}
+
+void Sensor::retryDeadLetter(PublishContext *context)
+{
+    if (context->attempts >= DEAD_LETTER_MAX_ATTEMPTS)
+    {
+        // Retry budget exhausted.
+        --mDeadLetterPending;
+        ++mCounters.deadLetterFailed;
+        LOGM_ERROR(
+            TAG,
+            "Dead-letter retry budget exhausted, dropping %zu bytes sensor name: %s",
+            context->payload.len,
+            mSettings.name->c_str());
+        delete context;
+        return;
+    }
+
+    if (context->attempts == 0)
+    {
+        publishDeadLetterAttempt(context);
+        return;
+    }
+
+    // Back off before retrying, so that an outage of the MQTT client is not met with a burst of attempts.
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    chrono::milliseconds delayMs = mDeadLetterRetryDelay * (1 << (context->attempts - 1));
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(delayMs).count();
+    aws_task_init(
+        &context->retryTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            auto *context = static_cast<PublishContext *>(arg);
+            context->sensor->onDeadLetterRetryTaskCallback(context, status);
+        },
+        context,
+        "SensorDeadLetterRetry");
+    {
+        lock_guard<mutex> lock(mDeadLetterRetryLock);
+        mDeadLetterRetries.insert(context);
+    }
+    aws_event_loop_schedule_task_future(mEventLoop, &context->retryTask, runAtNanos);
+}
+
+void Sensor::publishDeadLetterAttempt(PublishContext *context)
+{
+    ++context->attempts;
+    aws_byte_cursor payload = aws_byte_cursor_from_buf(&context->payload);
+    if (mqttPublish(&mDeadLetterTopic, &payload, context) != 0)
+    {
+        return; // Completion callback owns the context.
+    }
+    LOGM_ERROR(
+        TAG,
+        "Error sensor name: %s func: %s msg: %s",
+        mSettings.name->c_str(),
+        __func__,
+        aws_error_str(aws_last_error()));
+    retryDeadLetter(context);
+}
+
+void Sensor::onDeadLetterRetryTaskCallback(PublishContext *context, aws_task_status status)
+{
+    {
+        lock_guard<mutex> lock(mDeadLetterRetryLock);
+        mDeadLetterRetries.erase(context);
+    }
+    if (status == AWS_TASK_STATUS_CANCELED)
+    {
+        // Sensor is stopping, give up on the remaining attempts.
+        context->attempts = DEAD_LETTER_MAX_ATTEMPTS;
+        retryDeadLetter(context);
+        return;
+    }
+    publishDeadLetterAttempt(context);
+}
+
+bool Sensor::hasDeadLetterRetries()
+{
+    lock_guard<mutex> lock(mDeadLetterRetryLock);
+    return !mDeadLetterRetries.empty();
+}
+
+void Sensor::onPublishComplete(PublishContext *context, uint16_t packetId, int errorCode)
+{
+    if (context->inflight)
+    {
+        context->inflight = false;
+        releaseInflight();
+    }
+
+    if (errorCode == AWS_OP_SUCCESS)
+    {
+        if (context->deadLetter)
+        {
+            --mDeadLetterPending;
+            ++mCounters.deadLettered;
+            LOGM_DEBUG(
+                TAG, "Dead-letter publish complete sensor name: %s packetId: %d", mSettings.name->c_str(), packetId);
+        }
+        else
+        {
+            ++mCounters.published;
+            auto now = LatencyClock::now();
+            mLatency.ack.record(latencyUs(context->submitTime, now));
+            if (context->readTime != LatencyClock::time_point())
+            {
+                mLatency.total.record(latencyUs(context->readTime, now));
+            }
+            LOGM_DEBUG(TAG, "Publish complete sensor name: %s packetId: %d", mSettings.name->c_str(), packetId);
+        }
+        delete context;
+        return;
+    }
+
+    LOGM_ERROR(
+        TAG,
+        "Error sensor name: %s func: %s topic: %s msg: %s",
+        mSettings.name->c_str(),
+        __func__,
+        context->deadLetter ? mSettings.mqttDeadLetterTopic->c_str() : mSettings.mqttTopic->c_str(),
+        aws_error_str(errorCode));
+
+    if (!context->deadLetter)
+    {
+        ++mCounters.publishFailed;
+        if (context->payload.len == 0)
+        {
+            delete context; // No dead-letter topic, discard the message data.
+            return;
+        }
+        if (!reserveDeadLetter(context->payload.len))
+        {
+            delete context;
+            return;
+        }
+        // Reuse the copy of the payload for the dead-letter topic.
+        context->deadLetter = true;
+    }
+    retryDeadLetter(context);
+}
+
+uint16_t Sensor::mqttPublish(const aws_byte_cursor *topic, const aws_byte_cursor *payload, PublishContext *context)
+{
+    return aws_mqtt_client_connection_publish(
+        mConnection->GetUnderlyingConnection(),
+        topic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        false,
+        payload,
+        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *userdata) {
+            auto *context = static_cast<PublishContext *>(userdata);
+            context->sensor->onPublishComplete(context, packet_id, error_code);
+        },
+        context);
+}
+
+uint16_t Sensor::mqttSubscribe(const aws_byte_cursor *topic)
+{
+    return aws_mqtt_client_connection_subscribe(
+        mConnection->GetUnderlyingConnection(),
+        topic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        [](struct aws_mqtt_client_connection *,
+           const struct aws_byte_cursor *,
+           const struct aws_byte_cursor *payload,
+           bool,
+           enum aws_mqtt_qos,
+           bool,
+           void *userdata) { static_cast<Sensor *>(userdata)->onCommandReceived(payload); },
+        this,
+        nullptr,
+        [](struct aws_mqtt_client_connection *,
+           uint16_t,
+           const struct aws_byte_cursor *,
+           enum aws_mqtt_qos qos,
+           int error_code,
+           void *userdata) {
+            auto *self = static_cast<Sensor *>(userdata);
+            if (error_code != AWS_OP_SUCCESS || qos == AWS_MQTT_QOS_FAILURE)
             {
-                // Log an error, but otherwise discard the message data.
                 LOGM_ERROR(
                     TAG,
-                    "Error sensor name: %s func: %s msg: %s",
+                    "Error subscribing to command topic sensor name: %s msg: %s",
                     self->mSettings.name->c_str(),
-                    __func__,
-                    aws_error_str(error_code));
-            }
-            else
-            {
-                LOGM_DEBUG(
-                    TAG, "Publish complete sensor name: %s packetId: %d", self->mSettings.name->c_str(), packet_id);
+                    error_code != AWS_OP_SUCCESS ? aws_error_str(error_code) : "rejected by broker");
             }
         },
         this);
 }
 
+void Sensor::mqttUnsubscribe(const aws_byte_cursor *topic)
+{
+    aws_mqtt_client_connection_unsubscribe(mConnection->GetUnderlyingConnection(), topic, nullptr, nullptr);
+}
+
+void Sensor::onCommandReceived(const aws_byte_cursor *payload)
+{
+    size_t dropped = mCommands->push(payload->ptr, payload->len);
+    if (dropped > 0)
+    {
+        mCounters.droppedCommands += dropped;
+        LOGM_WARN(TAG, "Command buffer full, dropped %zu commands sensor name: %s", dropped, mSettings.name->c_str());
+    }
+    scheduleWrite(0);
+}
+
+void Sensor::scheduleWrite(int64_t delayMs)
+{
+    if (mWriteScheduled.exchange(true))
+    {
+        return; // The scheduled task writes every queued command.
+    }
+    if (delayMs > 0)
+    {
+        uint64_t runAtNanos;
+        aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+        runAtNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::milliseconds(delayMs)).count();
+        aws_event_loop_schedule_task_future(mEventLoop, &mWriteTask, runAtNanos);
+    }
+    else
+    {
+        aws_event_loop_schedule_task_now(mEventLoop, &mWriteTask);
+    }
+}
+
+void Sensor::writeCommands()
+{
+    // Commands wait in the queue while disconnected, and are written once the sensor reconnects.
+    mInWriteCommands = true;
+    while (mState == SensorState::Connected && !mCommandWriting)
+    {
+        if (!mCommandPending)
+        {
+            if (!mCommands->pop(mCommand))
+            {
+                break;
+            }
+            mCommandPending = true;
+        }
+
+        aws_byte_cursor cursor = aws_byte_cursor_from_array(mCommand.data(), mCommand.size());
+        mCommandWriting = true;
+        int rc = mSocket->write(
+            &cursor,
+            [](struct aws_socket *, int error_code, size_t, void *user_data) {
+                static_cast<Sensor *>(user_data)->onCommandWritten(error_code);
+            },
+            this);
+        if (rc != AWS_OP_SUCCESS)
+        {
+            mCommandWriting = false;
+            int errorCode = aws_last_error();
+            if (errorCode == AWS_IO_READ_WOULD_BLOCK)
+            {
+                // Keep the command until the sensor drains its socket.
+                scheduleWrite(WRITE_RETRY_INTERVAL_MS);
+                break;
+            }
+            mCommandPending = false;
+            ++mCounters.droppedCommands;
+            LOGM_ERROR(
+                TAG,
+                "Error writing command sensor name: %s msg: %s",
+                mSettings.name->c_str(),
+                aws_error_str(errorCode));
+        }
+    }
+    mInWriteCommands = false;
+}
+
+void Sensor::onCommandWritten(int errorCode)
+{
+    mCommandWriting = false;
+    mCommandPending = false;
+    if (errorCode != AWS_OP_SUCCESS)
+    {
+        ++mCounters.droppedCommands;
+        LOGM_ERROR(
+            TAG, "Error writing command sensor name: %s msg: %s", mSettings.name->c_str(), aws_error_str(errorCode));
+    }
+    else
+    {
+        ++mCounters.commandsWritten;
+    }
+
+    // Asynchronous completions continue with the next command, synchronous ones return to the loop of writeCommands.
+    if (!mInWriteCommands)
+    {
+        writeCommands();
+    }
+}
+
 void Sensor::close()
 {
     if (mSocket->is_open())
@@ -444,9 +1742,5 @@ void Sensor::close()
 
 void Sensor::reset()
 {
-    aws_byte_buf_reset(&mReadBuf, false);
-    while (!mEomBounds.empty())
-    {
-        mEomBounds.pop();
-    }
+    mReadBuf.reset();
 }
@@ -5,18 +5,32 @@
 #define DEVICE_CLIENT_SENSOR_H
 
 #include "../config/Config.h"
+#include "AddrWatcher.h"
+#include "Aggregator.h"
+#include "BatchEncoder.h"
+#include "BufferPool.h"
+#include "CommandQueue.h"
+#include "Compressor.h"
+#include "EomScanner.h"
 #include "HeartbeatTask.h"
+#include "LatencyHistogram.h"
+#include "MessageFilter.h"
+#include "RingBuffer.h"
+#include "SensorCounters.h"
 #include "SensorState.h"
 #include "Socket.h"
+#include "Spool.h"
+#include "WindowSummary.h"
 
 #include <aws/crt/Types.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
-#include <queue>
-#include <regex>
+#include <mutex>
+#include <set>
 #include <string>
 
 namespace Aws
@@ -66,23 +80,64 @@ namespace Aws
                     std::shared_ptr<Socket> mSocket;
 
                     /**
-                     * \brief Buffer for reading sensor data
+                     * \brief Minimum number of end of message boundaries held in the read buffer
                      *
-                     * Buffer is allocated once and never larger than AWS IoT maximum message size.
+                     * The boundary ring is sized to hold at least one full batch.
                      */
-                    aws_byte_buf mReadBuf;
+                    static constexpr size_t EOM_BOUNDS_CAPACITY = 4096;
 
                     /**
-                     * \brief End of message boundaries in read buffer
+                     * \brief Buffer for reading sensor data and its end of message boundaries
                      *
-                     * Stores index in buffer of one-past the end of the boundary.
+                     * Buffer is never larger than AWS IoT maximum message size. When sensors share a buffer pool,
+                     * the buffer memory is only held while data is buffered, otherwise it is allocated once.
                      */
-                    std::queue<size_t> mEomBounds;
+                    RingBuffer mReadBuf;
 
                     /**
-                     * \brief Pattern used to identify end of message boundary
+                     * \brief Whether the socket preserves message boundaries, so no end of message delimiter is scanned
                      */
-                    std::regex mEomPattern;
+                    bool mMessageBased{false};
+
+                    /**
+                     * \brief Contiguous free space required for a read, the largest message for message based sockets
+                     */
+                    size_t mMinReadSpace{1};
+
+                    /**
+                     * \brief Maximum number of messages read from a message based socket at once
+                     */
+                    static constexpr size_t READ_MESSAGES_MAX = 64;
+
+                    /**
+                     * \brief Delay before reading again when no buffer was available from the buffer pool
+                     */
+                    static constexpr int64_t READ_RETRY_INTERVAL_MS = 10;
+
+                    /**
+                     * \brief Task for reading again once the buffer pool may have a buffer available, or once
+                     * other tasks of the event loop had a chance to run after the read budget was used up
+                     */
+                    aws_task mReadRetryTask;
+
+                    /**
+                     * \brief Whether the read retry task is scheduled
+                     *
+                     * Set only from the event loop, atomic so that stop() may check it from another thread.
+                     */
+                    std::atomic<bool> mReadRetryScheduled{false};
+
+                    /**
+                     * \brief Number of bytes read in a single readable callback before yielding the event loop
+                     *
+                     * 0 when reading continues until the socket would block.
+                     */
+                    size_t mReadBudgetBytes{0};
+
+                    /**
+                     * \brief Scanner used to identify end of message boundary
+                     */
+                    EomScanner mEomScanner;
 
                     using TimePointT = std::chrono::high_resolution_clock::time_point;
 
@@ -91,15 +146,319 @@ namespace Aws
                      */
                     aws_byte_cursor mTopic;
 
+                    /**
+                     * \brief Aggregator merging batches of several sensors on a shared topic, instead of mTopic
+                     *
+                     * Null unless the sensor is configured with aggregate.
+                     */
+                    std::shared_ptr<Aggregator> mAggregator;
+
+                    /**
+                     * \brief MQTT topic for batches which could not be published to mTopic
+                     *
+                     * Empty when no dead-letter topic is configured.
+                     */
+                    aws_byte_cursor mDeadLetterTopic;
+
+                    /**
+                     * \brief Maximum number of attempts to publish a batch to the dead-letter topic
+                     */
+                    static constexpr int DEAD_LETTER_MAX_ATTEMPTS = 3;
+
+                    /**
+                     * \brief Delay before the second attempt to publish a batch to the dead-letter topic, doubled
+                     * for each further attempt
+                     */
+                    static constexpr int64_t DEAD_LETTER_RETRY_DELAY_MS = 1000;
+
+                    /**
+                     * \brief Delay before the second attempt to publish a batch to the dead-letter topic
+                     */
+                    std::chrono::milliseconds mDeadLetterRetryDelay{DEAD_LETTER_RETRY_DELAY_MS};
+
+                    /**
+                     * \brief Maximum number of batches being published to the dead-letter topic at once
+                     *
+                     * Bounds the memory held by copies of failed batches during a prolonged outage.
+                     */
+                    static constexpr size_t DEAD_LETTER_MAX_PENDING = 32;
+
+                    /**
+                     * \brief Number of batches being published to the dead-letter topic
+                     */
+                    std::atomic<size_t> mDeadLetterPending{0};
+
+                    /**
+                     * \brief Delivery counters
+                     */
+                    SensorCounters mCounters;
+
+                    /**
+                     * \brief Latencies of batches published to the sensor topic
+                     */
+                    SensorLatency mLatency;
+
+                    using LatencyClock = std::chrono::steady_clock;
+
+                    /**
+                     * \brief Time of the read which completed the oldest buffered message, only used from the
+                     * event loop
+                     *
+                     * Messages left over after a batch was published are taken as read by the most recent read.
+                     */
+                    LatencyClock::time_point mBatchReadTime;
+
+                    /**
+                     * \brief Time of the most recent read, only used from the event loop
+                     */
+                    LatencyClock::time_point mLastReadTime;
+
+                    /**
+                     * \brief Maximum number of batches published to the sensor topic and not yet acknowledged
+                     *
+                     * 0 when the number of unacknowledged batches is not limited.
+                     */
+                    size_t mMaxInflight{0};
+
+                    /**
+                     * \brief Number of batches published to the sensor topic and not yet acknowledged
+                     */
+                    std::atomic<size_t> mInflight{0};
+
+                    /**
+                     * \brief Whether reading is paused until acknowledgements drain the in-flight window
+                     */
+                    std::atomic<bool> mReadPaused{false};
+
+                    /**
+                     * \brief Time at which reading was paused, only used from the event loop
+                     */
+                    std::chrono::steady_clock::time_point mPausedSince;
+
+                    /**
+                     * \brief Task for resuming reading once the in-flight window has room
+                     */
+                    aws_task mResumeTask;
+
+                    std::atomic<bool> mResumeScheduled{false};
+
+                    /**
+                     * \brief State carried from a publish to its completion callback
+                     */
+                    struct PublishContext
+                    {
+                        explicit PublishContext(Sensor *sensor);
+                        ~PublishContext();
+
+                        Sensor *sensor{nullptr};
+
+                        /**
+                         * \brief Copy of the payload, held only when a dead-letter topic is configured
+                         */
+                        aws_byte_buf payload;
+
+                        /**
+                         * \brief Whether the payload is being published to the dead-letter topic
+                         */
+                        bool deadLetter{false};
+
+                        /**
+                         * \brief Number of attempts made to publish to the dead-letter topic
+                         */
+                        int attempts{0};
+
+                        /**
+                         * \brief Whether the publish holds a slot of the in-flight window
+                         */
+                        bool inflight{false};
+
+                        /**
+                         * \brief Task for the next attempt to publish to the dead-letter topic
+                         */
+                        aws_task retryTask;
+
+                        /**
+                         * \brief Read time of the oldest message of the batch, unset when not known
+                         */
+                        LatencyClock::time_point readTime;
+
+                        /**
+                         * \brief Time the batch was submitted to the MQTT client
+                         */
+                        LatencyClock::time_point submitTime;
+                    };
+
+                    /**
+                     * \brief Guards mDeadLetterRetries, which completion callbacks update from the MQTT client thread
+                     */
+                    std::mutex mDeadLetterRetryLock;
+
+                    /**
+                     * \brief Contexts whose retry task is scheduled on the event loop
+                     */
+                    std::set<PublishContext *> mDeadLetterRetries;
+
+                    /**
+                     * \brief Spool for batches published while the MQTT connection is down
+                     *
+                     * Null when no spool directory is configured. Only used from the event loop.
+                     */
+                    std::unique_ptr<Spool> mSpool;
+
+                    /**
+                     * \brief Whether the MQTT connection is up, updated from the MQTT client event loop
+                     */
+                    std::atomic<bool> mMqttConnected{true};
+
+                    /**
+                     * \brief Interval between runs of the spool task
+                     */
+                    static constexpr int64_t SPOOL_TASK_INTERVAL_MS = 100;
+
+                    /**
+                     * \brief Task for draining and flushing the spool
+                     */
+                    aws_task mSpoolTask;
+
+                    std::atomic<bool> mSpoolTaskStarted{false};
+
+                    /**
+                     * \brief Spooled batches which may be drained, in thousandths of a batch
+                     *
+                     * Accrues at the drain rate while connected, up to one second worth of batches.
+                     */
+                    int64_t mSpoolCredit{0};
+
+                    /**
+                     * \brief Encoder for batch envelopes, null when batches are published raw
+                     *
+                     * Only used from the event loop.
+                     */
+                    std::unique_ptr<BatchEncoder> mBatchEncoder;
+
+                    /**
+                     * \brief Buffer joining the two parts of a raw batch spanning the wrap point of mReadBuf
+                     *
+                     * Allocated with buffer_capacity bytes on the first such batch and reused for the following ones.
+                     * Only used from the event loop.
+                     */
+                    aws_byte_buf mJoinBuf;
+
+                    /**
+                     * \brief Summary of the current window, null when messages are published
+                     *
+                     * Only used from the event loop.
+                     */
+                    std::unique_ptr<WindowSummary> mSummary;
+
+                    /**
+                     * \brief Filters dropping messages before they are batched, null when no filter is configured
+                     *
+                     * Only used from the event loop.
+                     */
+                    std::unique_ptr<MessageFilter> mFilter;
+
+                    /**
+                     * \brief Time of the most recent read in milliseconds since the epoch
+                     *
+                     * Only updated when batch timestamps are enabled.
+                     */
+                    uint64_t mReadTimeMs{0};
+
+                    /**
+                     * \brief Compressor for batches, null when compression is not configured
+                     *
+                     * Only used from the event loop.
+                     */
+                    std::unique_ptr<Compressor> mCompressor;
+
+                    /**
+                     * \brief Commands received on the command topic and not yet written to the socket
+                     *
+                     * Null when no command topic is configured.
+                     */
+                    std::unique_ptr<CommandQueue> mCommands;
+
+                    /**
+                     * \brief MQTT topic for commands written to the sensor socket
+                     */
+                    aws_byte_cursor mCommandTopic;
+
+                    /**
+                     * \brief Whether the sensor is subscribed to the command topic
+                     */
+                    bool mCommandSubscribed{false};
+
+                    /**
+                     * \brief Delay before writing again when the socket buffer is full
+                     */
+                    static constexpr int64_t WRITE_RETRY_INTERVAL_MS = 10;
+
+                    /**
+                     * \brief Task for writing queued commands to the socket from the event loop
+                     */
+                    aws_task mWriteTask;
+
+                    /**
+                     * \brief Whether the write task is scheduled, set from the MQTT client event loop
+                     */
+                    std::atomic<bool> mWriteScheduled{false};
+
+                    /**
+                     * \brief Command taken from the queue, kept until written or dropped
+                     *
+                     * Only used from the event loop, as are the flags below.
+                     */
+                    std::string mCommand;
+
+                    /**
+                     * \brief Whether mCommand holds a command which was not written yet
+                     */
+                    bool mCommandPending{false};
+
+                    /**
+                     * \brief Whether a write of mCommand has not completed yet
+                     */
+                    bool mCommandWriting{false};
+
+                    /**
+                     * \brief Whether writeCommands is on the stack, so a synchronous write completion does not
+                     * recurse into it
+                     */
+                    bool mInWriteCommands{false};
+
                     /**
                      * \brief Absolute time after which next batch must be published
                      */
                     TimePointT mNextPublishTimeout;
 
+                    /**
+                     * \brief Task for publishing buffered messages once the publish timeout expires without a read
+                     */
+                    aws_task mFlushTask;
+
+                    /**
+                     * \brief Whether the flush task is scheduled
+                     *
+                     * Set only from the event loop, atomic so that stop() may check it from another thread.
+                     */
+                    std::atomic<bool> mFlushScheduled{false};
+
                     /**
                      * \brief State machine for the Sensor
+                     *
+                     * Changed only from the event loop, atomic so that the feature heartbeat may read it from
+                     * another event loop.
                      */
-                    SensorState mState{SensorState::NotConnected};
+                    std::atomic<SensorState> mState{SensorState::NotConnected};
+
+                    /**
+                     * \brief Whether the sensor was started and not stopped since
+                     *
+                     * Tasks may be scheduled at any time while started, so stopping from another thread than the event
+                     * loop then always waits for the event loop to cancel them.
+                     */
+                    std::atomic<bool> mStarted{false};
 
                     /**
                      * \brief Task for publishing heartbeat to MQTT
@@ -111,6 +470,28 @@ namespace Aws
                      */
                     aws_task mConnectTask;
 
+                    /**
+                     * \brief Whether the connect task is scheduled, atomic so that stop() may check it from another
+                     * thread
+                     */
+                    std::atomic<bool> mConnectScheduled{false};
+
+                    /**
+                     * \brief Whether the connect task is scheduled addr_poll_sec in the future
+                     *
+                     * Only used from the event loop.
+                     */
+                    bool mConnectDelayed{false};
+
+                    /**
+                     * \brief Watcher for the socket file of the sensor server, null when the socket does not connect to
+                     * a socket file
+                     *
+                     * Started while waiting to reconnect, so the sensor reconnects as soon as the server creates its
+                     * socket instead of on the next poll.
+                     */
+                    std::unique_ptr<AddrWatcher> mAddrWatcher;
+
                     /**
                      * \brief Connect to the sensor
                      */
@@ -121,6 +502,11 @@ namespace Aws
                      */
                     void onConnectTaskCallback();
 
+                    /**
+                     * \brief Callback function when the socket file of the sensor server may have been created
+                     */
+                    void onAddrCreated();
+
                     /**
                      * \brief Callback function for connect
                      */
@@ -131,11 +517,91 @@ namespace Aws
                      */
                     void onReadableCallback(int error_code);
 
+                    /**
+                     * \brief Schedule a read after READ_RETRY_INTERVAL_MS, leaving the data in the socket until then
+                     */
+                    virtual void scheduleReadRetry();
+
+                    /**
+                     * \brief Yield the event loop once the read budget is used up, and continue reading from a task
+                     *
+                     * The socket is edge triggered and was not drained, so no further readable event is raised
+                     * for the data left in it.
+                     */
+                    void yieldRead();
+
+                    /**
+                     * \brief Read from a stream socket into readBuf, scan for end of message boundaries and publish
+                     *
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with the error raised by the socket
+                     */
+                    int readStream(aws_byte_buf &readBuf);
+
+                    /**
+                     * \brief Read whole messages from a message based socket into readBuf and publish
+                     *
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with the error raised by the socket
+                     */
+                    int readMessages(aws_byte_buf &readBuf);
+
+                    /**
+                     * \brief Record the time of the most recent read for latency tracing, and for batch timestamps
+                     * when enabled
+                     *
+                     * Called after each read, before the messages it completed are added to the boundary ring.
+                     */
+                    void updateReadTime();
+
+                    /**
+                     * \brief Scan unscanned data in the read buffer for end of message boundaries
+                     *
+                     * @return false when scanning stopped because the boundary ring is full
+                     */
+                    bool scanForEom();
+
+                    /**
+                     * \brief Remove the complete messages dropped by the filters, starting from the first-th boundary
+                     */
+                    void filterMessages(size_t first);
+
                     /**
                      * \brief Publish buffered messages
                      */
                     virtual void publish();
 
+                    /**
+                     * \brief Whether the in-flight window is full
+                     */
+                    bool inflightWindowFull() const;
+
+                    /**
+                     * \brief Pause reading and publishing while the in-flight window is full
+                     *
+                     * Data is left in the socket, so the socket buffer pushes back on the sensor.
+                     *
+                     * @return true when paused
+                     */
+                    bool pauseIfWindowFull();
+
+                    /**
+                     * \brief Release the in-flight window slot of a completed publish
+                     *
+                     * Called from the MQTT client event loop, schedules the resume task when reading is paused.
+                     */
+                    void releaseInflight();
+
+                    /**
+                     * \brief Callback function for resume task
+                     */
+                    void onResumeTaskCallback();
+
+                    /**
+                     * \brief Schedule the flush task at the publish timeout, when messages are buffered
+                     *
+                     * Bounds the time messages are buffered by buffer_time_ms, even when no more data is read.
+                     */
+                    void scheduleFlush();
+
                     /**
                      * \brief Check whether publish limits are breached
                      *
@@ -147,9 +613,172 @@ namespace Aws
                     bool needPublish(size_t &bufferSize, size_t &numBatches);
 
                     /**
-                     * \brief Publish one message
+                     * \brief Discard the buffered data when the buffer is full without an end of message
+                     */
+                    void discardIfFullWithoutEom();
+
+                    /**
+                     * \brief Invoke fn(message, len, index) for each of the oldest count complete messages, held in
+                     * batch, without its end of message delimiter
+                     */
+                    template <typename MessageFn>
+                    void forEachMessage(const aws_byte_cursor &batch, size_t count, MessageFn fn);
+
+                    /**
+                     * \brief Wrap the oldest count complete messages, held in batch, in the batch envelope
+                     *
+                     * @param encoded set to a view of the encoded batch, valid until the next batch is encoded
+                     * @return false when the batch envelope could not be allocated and the batch is dropped
+                     */
+                    bool encodeBatch(const aws_byte_cursor &batch, size_t count, aws_byte_cursor &encoded);
+
+                    /**
+                     * \brief Finish the batch envelope of count messages, counting and logging a failed batch
+                     *
+                     * @param encoded set to a view of the encoded batch
+                     * @return false when the batch envelope could not be allocated and the batch is dropped
+                     */
+                    bool finishBatch(size_t count, aws_byte_cursor &encoded);
+
+                    /**
+                     * \brief Publish the oldest count complete messages as one message when they span the wrap point
+                     * of the buffer, and release them
+                     */
+                    void publishWrappedBatch(size_t count);
+
+                    /**
+                     * \brief Add every complete message to the window summary and release it, and publish the
+                     * summary of the window once it has ended
+                     */
+                    void summarize();
+
+                    /**
+                     * \brief Publish one message, or spool it while the MQTT connection is down
+                     *
+                     * The message is compressed first when compression is configured.
+                     *
+                     * @param readTime read time of the oldest message of a batch, unset when not known
                      */
-                    void publishOneMessage(const aws_byte_cursor *payload);
+                    void publishOneMessage(
+                        const aws_byte_cursor *payload,
+                        LatencyClock::time_point readTime = LatencyClock::time_point());
+
+                    /**
+                     * \brief Publish one message to the sensor topic
+                     */
+                    void publishToTopic(
+                        const aws_byte_cursor *payload,
+                        LatencyClock::time_point readTime = LatencyClock::time_point());
+
+                    /**
+                     * \brief Schedule the next run of the spool task
+                     */
+                    void scheduleSpoolTask();
+
+                    /**
+                     * \brief Callback function for spool task
+                     */
+                    void onSpoolTaskCallback();
+
+                    /**
+                     * \brief Publish spooled batches, limited by the drain rate
+                     */
+                    void drainSpool();
+
+                    /**
+                     * \brief Publish a copy of the payload to the dead-letter topic, if configured
+                     */
+                    void publishDeadLetter(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Reserve one of the pending dead-letter publishes
+                     *
+                     * @param len size of the batch, used for logging when the batch is dropped
+                     * @return false when too many dead-letter publishes are pending
+                     */
+                    bool reserveDeadLetter(size_t len);
+
+                    /**
+                     * \brief Publish to the dead-letter topic, at once for the first attempt and from a delayed task
+                     * for the following ones, until accepted or the retry budget is exhausted
+                     *
+                     * Takes ownership of the context.
+                     */
+                    void retryDeadLetter(PublishContext *context);
+
+                    /**
+                     * \brief Make one attempt to publish to the dead-letter topic
+                     *
+                     * Takes ownership of the context.
+                     */
+                    void publishDeadLetterAttempt(PublishContext *context);
+
+                    /**
+                     * \brief Callback function for the task of a dead-letter retry
+                     *
+                     * Takes ownership of the context. A cancelled retry drops the batch.
+                     */
+                    void onDeadLetterRetryTaskCallback(PublishContext *context, aws_task_status status);
+
+                    /**
+                     * \brief Whether a dead-letter retry task is scheduled on the event loop
+                     */
+                    bool hasDeadLetterRetries();
+
+                    /**
+                     * \brief Callback function when a publish completes
+                     *
+                     * Takes ownership of the context.
+                     */
+                    void onPublishComplete(PublishContext *context, uint16_t packetId, int errorCode);
+
+                    /**
+                     * \brief Publish payload to topic with QoS 1
+                     *
+                     * @return packet id, or 0 when the publish could not be queued
+                     */
+                    virtual uint16_t mqttPublish(
+                        const aws_byte_cursor *topic,
+                        const aws_byte_cursor *payload,
+                        PublishContext *context);
+
+                    /**
+                     * \brief Subscribe to the command topic with QoS 1
+                     *
+                     * @return packet id, or 0 when the subscribe could not be queued
+                     */
+                    virtual uint16_t mqttSubscribe(const aws_byte_cursor *topic);
+
+                    /**
+                     * \brief Unsubscribe from the command topic
+                     */
+                    virtual void mqttUnsubscribe(const aws_byte_cursor *topic);
+
+                    /**
+                     * \brief Callback function when a command is received, invoked from the MQTT client event loop
+                     *
+                     * Queues the command and schedules the write task on the event loop of the sensor.
+                     */
+                    void onCommandReceived(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Schedule the write task, unless already scheduled
+                     *
+                     * @param delayMs delay before the task runs, 0 to run it as soon as possible
+                     */
+                    void scheduleWrite(int64_t delayMs);
+
+                    /**
+                     * \brief Write queued commands to the socket one at a time while connected
+                     *
+                     * A command the socket cannot take yet is kept, and written again after WRITE_RETRY_INTERVAL_MS.
+                     */
+                    void writeCommands();
+
+                    /**
+                     * \brief Callback function when a write of mCommand completes
+                     */
+                    void onCommandWritten(int errorCode);
 
                     /**
                      * \brief Close connection to server
@@ -161,18 +790,36 @@ namespace Aws
                      */
                     void reset();
 
+                    /**
+                     * \brief Cancel the tasks scheduled on the event loop
+                     *
+                     * When called from another thread than the event loop while tasks are scheduled, blocks until the
+                     * event loop has cancelled them, so that none runs once the sensor is stopped or destroyed.
+                     */
+                    void cancelTasks();
+
+                    /**
+                     * \brief Cancel the tasks scheduled on the event loop and reset the read state, from the event loop
+                     */
+                    void cancelTasksOnEventLoop();
+
                   public:
                     /**
                      * \brief Constructor
                      *
                      * @param settings the settings for this sensor
+                     * @param bufferPool pool shared by sensors to borrow the read buffer from while data is
+                     * buffered, null to allocate the read buffer once
+                     * @param aggregator aggregator to add batches to, null to publish batches to mqtt_topic
                      */
                     Sensor(
                         const PlainConfig::SensorPublish::SensorSettings &settings,
                         aws_allocator *allocator,
                         std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
                         aws_event_loop *eventLoop,
-                        std::shared_ptr<Socket> socket);
+                        std::shared_ptr<Socket> socket,
+                        std::shared_ptr<BufferPool> bufferPool = nullptr,
+                        std::shared_ptr<Aggregator> aggregator = nullptr);
 
                     virtual ~Sensor();
 
@@ -200,6 +847,29 @@ namespace Aws
                      * @return a string value representing the sensor name
                      */
                     std::string getName() const;
+
+                    /**
+                     * \brief Delivery counters
+                     */
+                    const SensorCounters &getCounters() const { return mCounters; }
+
+                    /**
+                     * \brief State of the connection to the sensor
+                     */
+                    SensorState getState() const { return mState; }
+
+                    /**
+                     * \brief Latencies of batches published to the sensor topic
+                     */
+                    const SensorLatency &getLatency() const { return mLatency; }
+
+                    /**
+                     * \brief Notify the sensor that the MQTT connection was interrupted or resumed
+                     *
+                     * While the connection is down, batches are written to the spool, if configured.
+                     * Once it resumes, spooled batches are published at the configured drain rate.
+                     */
+                    void onConnectionStateChanged(bool connected);
                 };
             } // namespace SensorPublish
         }     // namespace DeviceClient
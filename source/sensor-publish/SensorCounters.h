@@ -0,0 +1,155 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SENSOR_COUNTERS_H
+#define DEVICE_CLIENT_SENSOR_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Counters describing the delivery of sensor data
+                 *
+                 * Counters are updated from both the sensor event loop and MQTT completion callbacks.
+                 */
+                struct SensorCounters
+                {
+                    /**
+                     * \brief Bytes read from the sensor
+                     */
+                    std::atomic<uint64_t> bytesRead{0};
+
+                    /**
+                     * \brief Batches handed off for publishing, whether published, aggregated or spooled
+                     */
+                    std::atomic<uint64_t> batches{0};
+
+                    /**
+                     * \brief Batches acknowledged by the broker on the sensor topic
+                     */
+                    std::atomic<uint64_t> published{0};
+
+                    /**
+                     * \brief Batches which failed to publish to the sensor topic
+                     */
+                    std::atomic<uint64_t> publishFailed{0};
+
+                    /**
+                     * \brief Batches acknowledged by the broker on the dead-letter topic
+                     */
+                    std::atomic<uint64_t> deadLettered{0};
+
+                    /**
+                     * \brief Batches lost after the dead-letter retry budget was exhausted or too many were pending
+                     */
+                    std::atomic<uint64_t> deadLetterFailed{0};
+
+                    /**
+                     * \brief Bytes discarded because the buffer was full without an end of message delimiter
+                     */
+                    std::atomic<uint64_t> discardedBytes{0};
+
+                    /**
+                     * \brief Batches written to the spool while the MQTT connection was down
+                     */
+                    std::atomic<uint64_t> spooled{0};
+
+                    /**
+                     * \brief Spooled batches published after the MQTT connection resumed
+                     */
+                    std::atomic<uint64_t> spoolDrained{0};
+
+                    /**
+                     * \brief Spooled batches lost because the spool reached its size limit
+                     */
+                    std::atomic<uint64_t> spoolEvicted{0};
+
+                    /**
+                     * \brief Batches published compressed
+                     */
+                    std::atomic<uint64_t> compressedBatches{0};
+
+                    /**
+                     * \brief Size of compressed batches before compression
+                     */
+                    std::atomic<uint64_t> uncompressedBytes{0};
+
+                    /**
+                     * \brief Size of compressed batches after compression
+                     */
+                    std::atomic<uint64_t> compressedBytes{0};
+
+                    /**
+                     * \brief Batches published uncompressed because they were larger than the compressor input limit
+                     */
+                    std::atomic<uint64_t> compressionSkipped{0};
+
+                    /**
+                     * \brief Batches dropped because the batch envelope could not be allocated
+                     */
+                    std::atomic<uint64_t> encodeFailed{0};
+
+                    /**
+                     * \brief Reads deferred because every buffer of the shared buffer pool was in use
+                     */
+                    std::atomic<uint64_t> readDeferred{0};
+
+                    /**
+                     * \brief Times reading paused because the in-flight publish window was full
+                     */
+                    std::atomic<uint64_t> windowFull{0};
+
+                    /**
+                     * \brief Total time reading was paused because the in-flight publish window was full
+                     */
+                    std::atomic<uint64_t> windowFullMs{0};
+
+                    /**
+                     * \brief Times reading yielded the event loop because the read budget was used up
+                     */
+                    std::atomic<uint64_t> readYielded{0};
+
+                    /**
+                     * \brief Batches added to an aggregate message instead of being published to the sensor topic
+                     */
+                    std::atomic<uint64_t> aggregated{0};
+
+                    /**
+                     * \brief Messages dropped because they repeated the last kept message
+                     */
+                    std::atomic<uint64_t> droppedDuplicate{0};
+
+                    /**
+                     * \brief Messages dropped because their deadband fields changed by at most the deadband
+                     */
+                    std::atomic<uint64_t> droppedDeadband{0};
+
+                    /**
+                     * \brief Messages dropped because the sensor exceeded max_message_rate
+                     */
+                    std::atomic<uint64_t> droppedRateLimited{0};
+
+                    /**
+                     * \brief Commands received on the command topic and written to the sensor socket
+                     */
+                    std::atomic<uint64_t> commandsWritten{0};
+
+                    /**
+                     * \brief Commands dropped because the command buffer was full or the write failed
+                     */
+                    std::atomic<uint64_t> droppedCommands{0};
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SENSOR_COUNTERS_H
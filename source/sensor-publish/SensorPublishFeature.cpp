@@ -4,9 +4,18 @@
 #include "SensorPublishFeature.h"
 
 #include "../logging/LoggerFactory.h"
+#include "CanSocket.h"
+#include "DatagramSocket.h"
 
 #include <aws/common/error.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/common/zero.h>
+#include <aws/io/event_loop.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
 #include <stdexcept>
 
 using namespace std;
@@ -28,17 +37,85 @@ int SensorPublishFeature::init(
     mResourceManager = manager;
     mBaseNotifier = notifier;
 
-    for (auto &setting : config.sensorPublish.settings)
+    // Create the event loops dedicated to sensors, if configured.
+    vector<aws_event_loop *> eventLoops;
+    auto threads = static_cast<uint16_t>(config.sensorPublish.eventLoopThreads.value());
+    if (threads > 0)
     {
+        mEventLoopGroup.reset(new Crt::Io::EventLoopGroup(threads, mResourceManager->getAllocator()));
+        if (!*mEventLoopGroup)
+        {
+            LOGM_ERROR(
+                TAG,
+                "Unable to create sensor event loop group, sensors share the MQTT event loop msg: %s",
+                aws_error_str(mEventLoopGroup->LastError()));
+            mEventLoopGroup.reset();
+        }
+        else
+        {
+            const auto &cpus = config.sensorPublish.eventLoopCpus;
+            for (uint16_t i = 0; i < threads; ++i)
+            {
+                eventLoops.push_back(aws_event_loop_group_get_loop_at(mEventLoopGroup->GetUnderlyingHandle(), i));
+                if (!cpus.empty())
+                {
+                    pinEventLoop(eventLoops.back(), static_cast<int>(cpus[i % cpus.size()]));
+                }
+            }
+        }
+    }
+
+    // Sensors borrow their read buffers from a pool shared by all sensors.
+    mBufferPool = make_shared<BufferPool>(
+        mResourceManager->getAllocator(), static_cast<size_t>(config.sensorPublish.memoryBudgetBytes.value()));
+
+    // Sensors configured with aggregate publish their batches through an aggregator shared by all sensors.
+    const auto &aggregateTopic = config.sensorPublish.aggregateTopic;
+    if (aggregateTopic.has_value() && !aggregateTopic->empty())
+    {
+        try
+        {
+            mAggregator = make_shared<Aggregator>(
+                mResourceManager->getAllocator(),
+                mResourceManager->getConnection(),
+                mResourceManager->getNextEventLoop(),
+                aggregateTopic.value(),
+                static_cast<size_t>(config.sensorPublish.aggregateMaxBytes.value()),
+                config.sensorPublish.aggregateTimeMs.value(),
+                static_cast<size_t>(config.sensorPublish.aggregateMaxInflight.value()));
+        }
+        catch (const std::exception &e)
+        {
+            LOGM_ERROR(
+                TAG, "Error initializing aggregator, sensors publish to their own topic message: %s", e.what());
+        }
+    }
+
+    const auto &settings = config.sensorPublish.settings;
+    vector<size_t> placement = PlaceSensors(settings, eventLoops.size());
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        const auto &setting = settings[i];
         if (setting.enabled)
         {
             try
             {
-                auto *eventLoop = mResourceManager->getNextEventLoop();
+                auto *eventLoop =
+                    eventLoops.empty() ? mResourceManager->getNextEventLoop() : eventLoops[placement[i]];
+                if (!eventLoops.empty())
+                {
+                    LOGM_DEBUG(
+                        TAG, "Placing sensor: %s on sensor event loop: %zu", setting.name->c_str(), placement[i]);
+                }
                 if (eventLoop)
                 {
                     mSensors.emplace_back(createSensor(
-                        setting, mResourceManager->getAllocator(), mResourceManager->getConnection(), eventLoop));
+                        setting,
+                        mResourceManager->getAllocator(),
+                        mResourceManager->getConnection(),
+                        eventLoop,
+                        mBufferPool,
+                        setting.aggregate.value() ? mAggregator : nullptr));
                 }
                 else
                 {
@@ -52,6 +129,40 @@ int SensorPublishFeature::init(
         }
     }
 
+    // Report sensor statistics, if configured.
+    const auto &statsFile = config.sensorPublish.statsFile;
+    const auto &statsTopic = config.sensorPublish.statsTopic;
+    if ((statsFile.has_value() && !statsFile->empty()) || (statsTopic.has_value() && !statsTopic->empty()))
+    {
+        mStatsReporter.reset(new StatsReporter(
+            mResourceManager->getConnection(),
+            mResourceManager->getNextEventLoop(),
+            mSensors,
+            statsFile.has_value() ? statsFile.value() : string(),
+            statsTopic.has_value() ? statsTopic.value() : string(),
+            config.sensorPublish.statsIntervalSec.value()));
+    }
+
+    // Publish one heartbeat for every sensor, if configured.
+    const auto &heartbeatTopic = config.sensorPublish.heartbeatTopic;
+    if (heartbeatTopic.has_value() && !heartbeatTopic->empty())
+    {
+        mHeartbeatAggregator.reset(new HeartbeatAggregator(
+            mResourceManager->getConnection(),
+            mResourceManager->getNextEventLoop(),
+            mSensors,
+            heartbeatTopic.value(),
+            config.sensorPublish.heartbeatIntervalSec.value()));
+    }
+
+    // Sensors spool batches while the MQTT connection is down, and drain them once it resumes.
+    mResourceManager->addConnectionStateListener([this](bool connected) {
+        for (auto &sensor : mSensors)
+        {
+            sensor->onConnectionStateChanged(connected);
+        }
+    });
+
     return Feature::SUCCESS;
 }
 
@@ -59,10 +170,26 @@ std::unique_ptr<Sensor> SensorPublishFeature::createSensor(
     const PlainConfig::SensorPublish::SensorSettings &settings,
     aws_allocator *allocator,
     std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
-    aws_event_loop *eventLoop) const
+    aws_event_loop *eventLoop,
+    std::shared_ptr<BufferPool> bufferPool,
+    std::shared_ptr<Aggregator> aggregator) const
 {
+    std::shared_ptr<Socket> socket;
+    DatagramSocket::Type type;
+    if (settings.addrType.has_value() && settings.addrType.value() == PlainConfig::SensorPublish::ADDR_TYPE_CAN)
+    {
+        socket = std::make_shared<CanSocket>(settings.canFilters);
+    }
+    else if (settings.addrType.has_value() && DatagramSocket::ParseType(settings.addrType.value(), type))
+    {
+        socket = std::make_shared<DatagramSocket>(type);
+    }
+    else
+    {
+        socket = std::make_shared<AwsSocket>();
+    }
     return std::unique_ptr<Sensor>(
-        new Sensor(settings, allocator, connection, eventLoop, std::make_shared<AwsSocket>()));
+        new Sensor(settings, allocator, connection, eventLoop, socket, bufferPool, aggregator));
 }
 
 std::string SensorPublishFeature::getName()
@@ -76,10 +203,92 @@ std::size_t SensorPublishFeature::getSensorsSize() const
     return mSensors.size();
 }
 
+std::vector<std::size_t> SensorPublishFeature::PlaceSensors(
+    const std::vector<PlainConfig::SensorPublish::SensorSettings> &settings,
+    std::size_t loopCount)
+{
+    vector<size_t> placement(settings.size(), 0);
+    if (loopCount == 0)
+    {
+        return placement;
+    }
+
+    // Place pinned sensors first, so that the remaining sensors balance around them.
+    vector<size_t> load(loopCount, 0);
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        if (settings[i].enabled && settings[i].eventLoop.has_value())
+        {
+            placement[i] = static_cast<size_t>(settings[i].eventLoop.value()) % loopCount;
+            ++load[placement[i]];
+        }
+    }
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        if (settings[i].enabled && !settings[i].eventLoop.has_value())
+        {
+            placement[i] = static_cast<size_t>(min_element(load.begin(), load.end()) - load.begin());
+            ++load[placement[i]];
+        }
+    }
+    return placement;
+}
+
+void SensorPublishFeature::pinEventLoop(aws_event_loop *eventLoop, int cpu)
+{
+#if defined(__linux__)
+    // The affinity of a thread can only be set portably from the thread itself,
+    // so set it from a task run on the event loop.
+    struct AffinityTask
+    {
+        aws_task task;
+        int cpu;
+    };
+    auto *affinity = new AffinityTask;
+    AWS_ZERO_STRUCT(affinity->task);
+    affinity->cpu = cpu;
+    aws_task_init(
+        &affinity->task,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            std::unique_ptr<AffinityTask> affinity(static_cast<AffinityTask *>(arg));
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            int rc = EINVAL;
+            if (affinity->cpu < CPU_SETSIZE)
+            {
+                cpu_set_t cpuSet;
+                CPU_ZERO(&cpuSet);
+                CPU_SET(affinity->cpu, &cpuSet);
+                rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+            }
+            if (rc != 0)
+            {
+                LOGM_WARN(TAG, "Unable to pin sensor event loop to CPU: %d msg: %s", affinity->cpu, strerror(rc));
+            }
+            else
+            {
+                LOGM_DEBUG(TAG, "Pinned sensor event loop to CPU: %d", affinity->cpu);
+            }
+        },
+        affinity,
+        __func__);
+    aws_event_loop_schedule_task_now(eventLoop, &affinity->task);
+#else
+    LOGM_WARN(TAG, "Pinning sensor event loops to CPU: %d is not supported on this platform", cpu);
+#endif
+}
+
 int SensorPublishFeature::start()
 {
     LOGM_INFO(TAG, "Starting %s", getName().c_str());
 
+    if (mAggregator)
+    {
+        mAggregator->start();
+    }
+
     for (auto &sensor : mSensors)
     {
         if (sensor->start() != SharedCrtResourceManager::SUCCESS)
@@ -88,6 +297,16 @@ int SensorPublishFeature::start()
         }
     }
 
+    if (mStatsReporter)
+    {
+        mStatsReporter->start();
+    }
+
+    if (mHeartbeatAggregator)
+    {
+        mHeartbeatAggregator->start();
+    }
+
     mBaseNotifier->onEvent(static_cast<Feature *>(this), ClientBaseEventNotification::FEATURE_STARTED);
 
     return Feature::SUCCESS;
@@ -97,6 +316,11 @@ int SensorPublishFeature::stop()
 {
     LOGM_INFO(TAG, "Stopping %s", getName().c_str());
 
+    if (mHeartbeatAggregator)
+    {
+        mHeartbeatAggregator->stop();
+    }
+
     for (auto &sensor : mSensors)
     {
         if (sensor->stop() != SharedCrtResourceManager::SUCCESS)
@@ -105,6 +329,18 @@ int SensorPublishFeature::stop()
         }
     }
 
+    // Publish the batches aggregated so far, later batches are published to the topic of their sensor.
+    if (mAggregator)
+    {
+        mAggregator->stop();
+    }
+
+    // Write the final statistics once the sensors have stopped.
+    if (mStatsReporter)
+    {
+        mStatsReporter->stop();
+    }
+
     mBaseNotifier->onEvent(static_cast<Feature *>(this), ClientBaseEventNotification::FEATURE_STOPPED);
 
     return Feature::SUCCESS;
@@ -8,7 +8,13 @@
 #include "../Feature.h"
 #include "../SharedCrtResourceManager.h"
 #include "../config/Config.h"
+#include "Aggregator.h"
+#include "BufferPool.h"
+#include "HeartbeatAggregator.h"
 #include "Sensor.h"
+#include "StatsReporter.h"
+
+#include <aws/crt/io/EventLoopGroup.h>
 
 #include <cstddef>
 #include <memory>
@@ -30,6 +36,22 @@ namespace Aws
                  * Each Sensor reads and publishes independently of other sensors.
                  *
                  * SensorPublish notifies all Sensor instances in the list to stop and start.
+                 *
+                 * When event_loop_threads is configured, sensors run on a dedicated event loop group instead of
+                 * the event loop of the MQTT connection, so reading and parsing sensor data does not delay MQTT
+                 * keep alives and acknowledgements.
+                 *
+                 * Sensors borrow their read buffer from a shared pool only while they have data buffered, so a
+                 * device with hundreds of mostly idle sensors uses memory bounded by memory_budget_bytes.
+                 *
+                 * When aggregate_topic is configured, batches of sensors configured with aggregate are merged
+                 * into aggregate messages on that topic rather than published one message per batch.
+                 *
+                 * When stats_file or stats_topic is configured, the publish latencies of every sensor are
+                 * reported every stats_interval_sec.
+                 *
+                 * When heartbeat_topic is configured, a single heartbeat listing every connected sensor and its
+                 * counters is published every heartbeat_interval_sec, in place of one heartbeat per sensor.
                  */
                 class SensorPublishFeature : public Feature
                 {
@@ -50,11 +72,48 @@ namespace Aws
                      */
                     std::shared_ptr<ClientBaseNotifier> mBaseNotifier;
 
+                    /**
+                     * \brief Event loop group dedicated to sensors, null when sensors share the MQTT event loop
+                     *
+                     * Declared before the sensors, so that sensors are destroyed first.
+                     */
+                    std::unique_ptr<Aws::Crt::Io::EventLoopGroup> mEventLoopGroup;
+
+                    /**
+                     * \brief Pool of read buffers shared by all sensors, bounded by memory_budget_bytes
+                     *
+                     * Declared before the sensors, so that sensors return their buffers before it is destroyed.
+                     */
+                    std::shared_ptr<BufferPool> mBufferPool;
+
+                    /**
+                     * \brief Aggregator shared by sensors configured with aggregate, null when aggregate_topic is
+                     * not configured
+                     *
+                     * Declared before the sensors, so that sensors are destroyed first.
+                     */
+                    std::shared_ptr<Aggregator> mAggregator;
+
                     /**
                      * \brief List of sensors
                      */
                     std::vector<std::unique_ptr<Sensor>> mSensors;
 
+                    /**
+                     * \brief Reporter of sensor statistics, null when neither stats_file nor stats_topic is
+                     * configured
+                     *
+                     * Declared after the sensors, so that it is destroyed before the sensors it reports.
+                     */
+                    std::unique_ptr<StatsReporter> mStatsReporter;
+
+                    /**
+                     * \brief Publisher of the heartbeat of every sensor, null when heartbeat_topic is not configured
+                     *
+                     * Declared after the sensors, so that it is destroyed before the sensors it reports.
+                     */
+                    std::unique_ptr<HeartbeatAggregator> mHeartbeatAggregator;
+
                     /**
                      * \brief createSensor is a factory function for sensors
                      */
@@ -62,7 +121,14 @@ namespace Aws
                         const PlainConfig::SensorPublish::SensorSettings &settings,
                         aws_allocator *allocator,
                         std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
-                        aws_event_loop *eventLoop) const;
+                        aws_event_loop *eventLoop,
+                        std::shared_ptr<BufferPool> bufferPool,
+                        std::shared_ptr<Aggregator> aggregator) const;
+
+                    /**
+                     * \brief Pin the thread of an event loop to a CPU
+                     */
+                    static void pinEventLoop(aws_event_loop *eventLoop, int cpu);
 
                   public:
                     static constexpr char NAME[] = "Sensor Publish";
@@ -115,6 +181,21 @@ namespace Aws
                      * \brief Returns the number of initialized sensors
                      */
                     std::size_t getSensorsSize() const;
+
+                    /**
+                     * \brief Place each sensor on one of the sensor event loops
+                     *
+                     * A sensor configured with event_loop is pinned to that loop. Every other sensor is placed on
+                     * the loop with the fewest sensors, in configuration order, which is round robin when no
+                     * sensor is pinned.
+                     *
+                     * @param settings the settings for each sensor, disabled sensors are not placed
+                     * @param loopCount number of sensor event loops
+                     * @return index of the event loop of each entry in settings
+                     */
+                    static std::vector<std::size_t> PlaceSensors(
+                        const std::vector<PlainConfig::SensorPublish::SensorSettings> &settings,
+                        std::size_t loopCount);
                 };
             } // namespace SensorPublish
         }     // namespace DeviceClient
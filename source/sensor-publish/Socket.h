@@ -6,6 +6,7 @@
 
 #include <cstddef>
 
+#include <aws/common/error.h>
 #include <aws/common/zero.h>
 #include <aws/io/socket.h>
 
@@ -24,7 +25,10 @@ namespace Aws
                 {
                   public:
                     virtual ~Socket() = default;
-                    virtual void init(aws_allocator *allocator, aws_socket_options *options) = 0;
+                    /**
+                     * \brief Prepare the socket for connect, each implementation chooses its own socket options
+                     */
+                    virtual void init(aws_allocator *allocator) = 0;
                     virtual int connect(
                         const struct aws_socket_endpoint *remote_endpoint,
                         struct aws_event_loop *event_loop,
@@ -37,6 +41,62 @@ namespace Aws
                     virtual int read(aws_byte_buf *buf, std::size_t *amount_read) = 0;
                     virtual int close() = 0;
                     virtual void clean_up() = 0;
+
+                    /**
+                     * \brief Whether every read returns whole messages, so no end of message delimiter is used
+                     */
+                    virtual bool is_message_based() { return false; }
+
+                    /**
+                     * \brief Whether connecting fails until the sensor server has created the socket file at the
+                     * address
+                     */
+                    virtual bool waits_for_address() { return true; }
+
+                    /**
+                     * \brief Read whole messages, stored back to back after the data already in buf
+                     *
+                     * Only supported when is_message_based() is true.
+                     *
+                     * @param buf buffer to read into
+                     * @param slot_size largest message read, larger messages are truncated by the kernel and dropped
+                     * @param lengths set to the length of each message read
+                     * @param max_messages maximum number of messages read, and size of lengths
+                     * @param count set to the number of messages read
+                     * @param truncated_bytes set to the number of bytes of the messages dropped because they were
+                     * larger than slot_size
+                     *
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with AWS_IO_READ_WOULD_BLOCK when no message is available
+                     */
+                    virtual int read_messages(
+                        aws_byte_buf *buf,
+                        std::size_t slot_size,
+                        std::size_t *lengths,
+                        std::size_t max_messages,
+                        std::size_t *count,
+                        std::size_t *truncated_bytes)
+                    {
+                        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+                    }
+
+                    /**
+                     * \brief Write data to the connected peer without blocking
+                     *
+                     * The data must stay valid until written_fn is invoked, which may happen before write returns.
+                     *
+                     * @return AWS_OP_SUCCESS, or AWS_OP_ERR with AWS_IO_READ_WOULD_BLOCK when the socket buffer is
+                     * full and the write should be retried later. aws-c-io has no error code for a write that would
+                     * block: aws_socket_write queues the data instead. Implementations writing directly to a
+                     * non-blocking socket reuse the read error code, so callers handle EAGAIN alike for reads and
+                     * writes.
+                     */
+                    virtual int write(
+                        const aws_byte_cursor *cursor,
+                        aws_socket_on_write_completed_fn *written_fn,
+                        void *user_data)
+                    {
+                        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+                    }
                 };
 
                 /**
@@ -54,12 +114,16 @@ namespace Aws
                     AwsSocket &operator=(const AwsSocket &) = delete;
 
                     /**
-                     * \brief init wraps aws_socket_init
+                     * \brief init wraps aws_socket_init, for the Unix domain stream socket of addr_type stream
                      */
-                    void init(aws_allocator *allocator, aws_socket_options *options) override
+                    void init(aws_allocator *allocator) override
                     {
+                        aws_socket_options options;
+                        AWS_ZERO_STRUCT(options);
+                        options.type = AWS_SOCKET_STREAM;
+                        options.domain = AWS_SOCKET_LOCAL;
                         AWS_ZERO_STRUCT(socket);
-                        aws_socket_init(&socket, allocator, options);
+                        aws_socket_init(&socket, allocator, &options);
                     }
 
                     /**
@@ -101,6 +165,17 @@ namespace Aws
                      */
                     int close() override { return aws_socket_close(&socket); }
 
+                    /**
+                     * \brief write wraps aws_socket_write
+                     */
+                    int write(
+                        const aws_byte_cursor *cursor,
+                        aws_socket_on_write_completed_fn *written_fn,
+                        void *user_data) override
+                    {
+                        return aws_socket_write(&socket, cursor, written_fn, user_data);
+                    }
+
                     /**
                      * \brief clean_up wraps aws_socket_clean_up
                      */
@@ -0,0 +1,462 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Spool.h"
+
+#include "../logging/LoggerFactory.h"
+#include "../util/FileUtils.h"
+#include "../util/StringUtils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+using namespace Aws::Iot::DeviceClient::Util;
+
+constexpr size_t Spool::SEGMENT_BYTES_MAX;
+constexpr size_t Spool::SEGMENT_BYTES_MIN;
+constexpr size_t Spool::SYNC_BYTES;
+constexpr int64_t Spool::SYNC_INTERVAL_MS;
+constexpr char Spool::TAG[];
+constexpr char Spool::SEGMENT_SUFFIX[];
+
+namespace
+{
+    struct RecordHeader
+    {
+        uint32_t length;
+        uint32_t flags;
+    };
+
+    constexpr uint32_t RECORD_CONSUMED = 1;
+
+    constexpr size_t RECORD_ALIGN = 8;
+
+    /**
+     * Number of hex digits in a segment file name
+     */
+    constexpr size_t SEQ_DIGITS = 16;
+
+    size_t recordSpan(size_t len)
+    {
+        return sizeof(RecordHeader) + ((len + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1));
+    }
+
+    RecordHeader readHeader(const uint8_t *record)
+    {
+        RecordHeader header;
+        memcpy(&header, record, sizeof(header));
+        return header;
+    }
+} // namespace
+
+Spool::Spool(const string &dir, size_t maxBytes)
+    : mDir(FileUtils::ExtractExpandedPath(dir)),
+      mSegmentBytes(min(SEGMENT_BYTES_MAX, max(SEGMENT_BYTES_MIN, maxBytes / 4))),
+      mPageSize(size_t(sysconf(_SC_PAGESIZE))), mLastSync(chrono::steady_clock::now())
+{
+    // At least two segments, so that eviction never removes the segment being written.
+    mMaxBytes = max(maxBytes, 2 * mSegmentBytes);
+}
+
+Spool::~Spool()
+{
+    sync();
+    for (auto &segment : mSegments)
+    {
+        unmap(segment);
+    }
+}
+
+bool Spool::open()
+{
+    if (!FileUtils::CreateDirectoryWithPermissions(mDir.c_str(), S_IRWXU))
+    {
+        return false;
+    }
+
+    DIR *dir = opendir(mDir.c_str());
+    if (dir == nullptr)
+    {
+        LOGM_ERROR(TAG, "Unable to open spool directory %s: %s", Sanitize(mDir).c_str(), strerror(errno));
+        return false;
+    }
+    vector<uint64_t> seqs;
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+        const char *name = entry->d_name;
+        if (!isxdigit(static_cast<unsigned char>(name[0])))
+        {
+            continue;
+        }
+        char *end = nullptr;
+        uint64_t seq = strtoull(name, &end, 16);
+        if (end == name + SEQ_DIGITS && strcmp(end, SEGMENT_SUFFIX) == 0)
+        {
+            seqs.push_back(seq);
+        }
+    }
+    closedir(dir);
+    sort(seqs.begin(), seqs.end());
+
+    for (auto seq : seqs)
+    {
+        mNextSeq = seq + 1;
+        Segment segment;
+        segment.seq = seq;
+        if (!recover(segment))
+        {
+            continue;
+        }
+        if (segment.records == 0 && seq != seqs.back())
+        {
+            // Fully consumed segment left by a previous run.
+            unmap(segment);
+            unlink(segmentPath(seq).c_str());
+            continue;
+        }
+        mRecords += segment.records;
+        mBytes += segment.bytes;
+        mSegments.push_back(segment);
+    }
+
+    // Only the oldest segment is read and only the newest segment is written.
+    for (size_t i = 1; i + 1 < mSegments.size(); ++i)
+    {
+        unmap(mSegments[i]);
+    }
+    mSyncedOffset = mSegments.empty() ? 0 : mSegments.back().writeOffset;
+
+    if (mRecords > 0)
+    {
+        LOGM_INFO(
+            TAG, "Recovered %zu spooled records (%zu bytes) from %s", mRecords, mBytes, Sanitize(mDir).c_str());
+    }
+    return true;
+}
+
+bool Spool::append(const uint8_t *data, size_t len)
+{
+    if (len == 0)
+    {
+        return true;
+    }
+    size_t span = recordSpan(len);
+    if (span > mSegmentBytes)
+    {
+        LOGM_ERROR(TAG, "Unable to spool %zu bytes, larger than segment size %zu", len, mSegmentBytes);
+        return false;
+    }
+
+    if (mSegments.empty() || mSegments.back().map == nullptr ||
+        mSegments.back().size - mSegments.back().writeOffset < span)
+    {
+        if (!rotate())
+        {
+            return false;
+        }
+    }
+
+    Segment &segment = mSegments.back();
+    uint8_t *record = segment.map + segment.writeOffset;
+    memcpy(record + sizeof(RecordHeader), data, len);
+    if (segment.size - segment.writeOffset - span >= sizeof(RecordHeader))
+    {
+        // Terminate the data, in case the segment holds a torn record from before a crash.
+        memset(record + span, 0, sizeof(RecordHeader));
+    }
+    // Header is written last, so that a record is never visible before its payload.
+    RecordHeader header{uint32_t(len), 0};
+    memcpy(record, &header, sizeof(header));
+
+    segment.writeOffset += span;
+    ++segment.records;
+    segment.bytes += len;
+    ++mRecords;
+    mBytes += len;
+    mUnsyncedBytes += span;
+
+    maybeSync();
+    return true;
+}
+
+bool Spool::peek(const uint8_t **data, size_t *len)
+{
+    while (!mSegments.empty())
+    {
+        Segment &segment = mSegments.front();
+        if (segment.records > 0)
+        {
+            if (segment.map == nullptr && !map(segment))
+            {
+                removeOldest(); // Unreadable segment.
+                continue;
+            }
+            RecordHeader header = readHeader(segment.map + segment.readOffset);
+            *data = segment.map + segment.readOffset + sizeof(RecordHeader);
+            *len = header.length;
+            return true;
+        }
+        if (mSegments.size() == 1)
+        {
+            return false; // Keep writing to the newest segment.
+        }
+        removeOldest(); // Fully consumed.
+    }
+    return false;
+}
+
+void Spool::pop()
+{
+    const uint8_t *data;
+    size_t len;
+    if (!peek(&data, &len))
+    {
+        return;
+    }
+
+    Segment &segment = mSegments.front();
+    uint8_t *record = segment.map + segment.readOffset;
+    uint32_t flags = RECORD_CONSUMED;
+    memcpy(record + offsetof(RecordHeader, flags), &flags, sizeof(flags));
+
+    segment.readOffset += recordSpan(len);
+    --segment.records;
+    segment.bytes -= len;
+    --mRecords;
+    mBytes -= len;
+    mConsumedDirty = true;
+}
+
+void Spool::maybeSync()
+{
+    if (mUnsyncedBytes >= SYNC_BYTES)
+    {
+        sync();
+    }
+    else if (
+        (mUnsyncedBytes > 0 || mConsumedDirty) &&
+        chrono::steady_clock::now() - mLastSync >= chrono::milliseconds(SYNC_INTERVAL_MS))
+    {
+        sync();
+    }
+}
+
+void Spool::sync()
+{
+    if (!mSegments.empty())
+    {
+        Segment &newest = mSegments.back();
+        if (mUnsyncedBytes > 0 && newest.map != nullptr)
+        {
+            size_t begin = mSyncedOffset - mSyncedOffset % mPageSize;
+            size_t end = min(newest.size, newest.writeOffset + sizeof(RecordHeader));
+            if (msync(newest.map + begin, end - begin, MS_SYNC) != 0)
+            {
+                LOGM_ERROR(TAG, "Unable to flush spool %s: %s", Sanitize(mDir).c_str(), strerror(errno));
+            }
+            mSyncedOffset = newest.writeOffset;
+        }
+
+        // Consumed markers are only an optimization to avoid repeating records after a restart,
+        // so they are left to be written back by the kernel.
+        Segment &oldest = mSegments.front();
+        if (mConsumedDirty && oldest.map != nullptr)
+        {
+            msync(oldest.map, oldest.size, MS_ASYNC);
+        }
+    }
+    mUnsyncedBytes = 0;
+    mConsumedDirty = false;
+    mLastSync = chrono::steady_clock::now();
+}
+
+string Spool::segmentPath(uint64_t seq) const
+{
+    char name[SEQ_DIGITS + sizeof(SEGMENT_SUFFIX)];
+    snprintf(name, sizeof(name), "%016" PRIx64 "%s", seq, SEGMENT_SUFFIX);
+    return mDir + "/" + name;
+}
+
+bool Spool::recover(Segment &segment)
+{
+    if (!map(segment))
+    {
+        return false;
+    }
+
+    size_t offset = 0;
+    bool unconsumed = false;
+    while (segment.size - offset >= sizeof(RecordHeader))
+    {
+        RecordHeader header = readHeader(segment.map + offset);
+        if (header.length == 0)
+        {
+            break;
+        }
+        size_t span = recordSpan(header.length);
+        if (span > segment.size - offset)
+        {
+            LOGM_WARN(
+                TAG, "Ignoring truncated record in spool segment %s", Sanitize(segmentPath(segment.seq)).c_str());
+            break;
+        }
+        if (header.flags & RECORD_CONSUMED)
+        {
+            if (!unconsumed)
+            {
+                segment.readOffset = offset + span;
+            }
+        }
+        else
+        {
+            unconsumed = true;
+            ++segment.records;
+            segment.bytes += header.length;
+        }
+        offset += span;
+    }
+    segment.writeOffset = offset;
+    return true;
+}
+
+bool Spool::map(Segment &segment) const
+{
+    string path = segmentPath(segment.seq);
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LOGM_ERROR(TAG, "Unable to open spool segment %s: %s", Sanitize(path).c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat info;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && size_t(info.st_size) >= sizeof(RecordHeader))
+    {
+        addr = mmap(nullptr, size_t(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    int mapError = errno;
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        LOGM_ERROR(TAG, "Unable to map spool segment %s: %s", Sanitize(path).c_str(), strerror(mapError));
+        return false;
+    }
+
+    segment.map = static_cast<uint8_t *>(addr);
+    segment.size = size_t(info.st_size);
+    return true;
+}
+
+void Spool::unmap(Segment &segment) const
+{
+    if (segment.map != nullptr)
+    {
+        munmap(segment.map, segment.size);
+        segment.map = nullptr;
+    }
+}
+
+bool Spool::rotate()
+{
+    sync();
+    if (mSegments.size() > 1)
+    {
+        unmap(mSegments.back()); // Newest segment is read again only once it is the oldest.
+    }
+
+    size_t total = mSegmentBytes;
+    for (const auto &segment : mSegments)
+    {
+        total += segment.size;
+    }
+    while (!mSegments.empty() && total > mMaxBytes)
+    {
+        total -= mSegments.front().size;
+        removeOldest();
+    }
+
+    Segment segment;
+    segment.seq = mNextSeq;
+    string path = segmentPath(segment.seq);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        LOGM_ERROR(TAG, "Unable to create spool segment %s: %s", Sanitize(path).c_str(), strerror(errno));
+        return false;
+    }
+
+    // Allocate blocks up front, so that running out of space fails here instead of faulting on write.
+    int rc = posix_fallocate(fd, 0, off_t(mSegmentBytes));
+    if (rc == EOPNOTSUPP || rc == EINVAL)
+    {
+        rc = ftruncate(fd, off_t(mSegmentBytes)) == 0 ? 0 : errno;
+    }
+    void *addr = MAP_FAILED;
+    if (rc == 0)
+    {
+        addr = mmap(nullptr, mSegmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        rc = addr == MAP_FAILED ? errno : 0;
+    }
+    close(fd);
+    if (rc != 0)
+    {
+        LOGM_ERROR(TAG, "Unable to allocate spool segment %s: %s", Sanitize(path).c_str(), strerror(rc));
+        unlink(path.c_str());
+        return false;
+    }
+
+    // Persist the new directory entry with the next flush of its data.
+    int dirFd = ::open(mDir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        close(dirFd);
+    }
+
+    segment.map = static_cast<uint8_t *>(addr);
+    segment.size = mSegmentBytes;
+    mSegments.push_back(segment);
+    ++mNextSeq;
+    mSyncedOffset = 0;
+    return true;
+}
+
+void Spool::removeOldest()
+{
+    Segment &segment = mSegments.front();
+    if (segment.records > 0)
+    {
+        LOGM_WARN(
+            TAG,
+            "Spool %s is full, evicting %zu records (%zu bytes)",
+            Sanitize(mDir).c_str(),
+            segment.records,
+            segment.bytes);
+        mEvictedRecords += segment.records;
+        mRecords -= segment.records;
+        mBytes -= segment.bytes;
+    }
+    unmap(segment);
+    string path = segmentPath(segment.seq);
+    if (unlink(path.c_str()) != 0)
+    {
+        LOGM_ERROR(TAG, "Unable to remove spool segment %s: %s", Sanitize(path).c_str(), strerror(errno));
+    }
+    mSegments.pop_front();
+}
@@ -0,0 +1,235 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_SPOOL_H
+#define DEVICE_CLIENT_SPOOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief Spool stores batches on disk while the MQTT connection is down.
+                 *
+                 * The spool is an append-only log split into fixed size, memory-mapped segment files named by
+                 * an increasing sequence number. Batches are appended to the newest segment and read back in
+                 * order from the oldest segment.
+                 *
+                 * Each record is an 8 byte header (payload length, flags) followed by the payload, padded to a
+                 * multiple of 8 bytes. A zero length marks the end of data in a segment. A record which has been
+                 * read back is marked consumed in its header, so the read position survives a restart. Segments
+                 * whose records are all consumed are deleted.
+                 *
+                 * When appending a new segment would exceed the size cap, the oldest segment is evicted along
+                 * with any records in it which have not been read back.
+                 *
+                 * Writes are flushed to storage with msync in batches, either once enough data has been written
+                 * or once enough time has passed since the previous flush, so that a high rate of small batches
+                 * does not result in one flush per batch. A crash can lose at most the data written since the
+                 * previous flush, and may repeat records which were read back since the previous flush.
+                 *
+                 * Spool is not thread safe, and is only used from the event loop of its sensor.
+                 */
+                class Spool
+                {
+                  public:
+                    /**
+                     * \brief Largest segment size
+                     */
+                    static constexpr std::size_t SEGMENT_BYTES_MAX = 4 * 1024 * 1024;
+
+                    /**
+                     * \brief Smallest segment size, large enough for the largest batch accepted by AWS IoT
+                     */
+                    static constexpr std::size_t SEGMENT_BYTES_MIN = 256 * 1024;
+
+                    /**
+                     * \brief Number of unflushed bytes which triggers a flush
+                     */
+                    static constexpr std::size_t SYNC_BYTES = 1024 * 1024;
+
+                    /**
+                     * \brief Maximum time between a write and its flush
+                     */
+                    static constexpr int64_t SYNC_INTERVAL_MS = 1000;
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param dir directory holding the segment files
+                     * @param maxBytes maximum total size of segment files
+                     */
+                    Spool(const std::string &dir, std::size_t maxBytes);
+
+                    ~Spool();
+
+                    Spool(const Spool &) = delete;
+                    Spool &operator=(const Spool &) = delete;
+
+                    /**
+                     * \brief Create the spool directory if required, and recover segments left by a previous run
+                     *
+                     * @return false when the spool cannot be used
+                     */
+                    bool open();
+
+                    /**
+                     * \brief Append a batch
+                     *
+                     * @return false when the batch could not be stored
+                     */
+                    bool append(const uint8_t *data, std::size_t len);
+
+                    /**
+                     * \brief Whether there are no records waiting to be read back
+                     */
+                    bool empty() const { return mRecords == 0; }
+
+                    /**
+                     * \brief View the oldest record
+                     *
+                     * The view is valid until the next call to pop() or append().
+                     *
+                     * @return false when the spool is empty
+                     */
+                    bool peek(const uint8_t **data, std::size_t *len);
+
+                    /**
+                     * \brief Mark the oldest record consumed
+                     */
+                    void pop();
+
+                    /**
+                     * \brief Flush when enough data was written or enough time passed since the previous flush
+                     */
+                    void maybeSync();
+
+                    /**
+                     * \brief Flush written data and consumed markers to storage
+                     */
+                    void sync();
+
+                    /**
+                     * \brief Number of records waiting to be read back
+                     */
+                    std::size_t records() const { return mRecords; }
+
+                    /**
+                     * \brief Number of payload bytes waiting to be read back
+                     */
+                    std::size_t bytes() const { return mBytes; }
+
+                    /**
+                     * \brief Number of records lost to eviction since construction
+                     */
+                    uint64_t evictedRecords() const { return mEvictedRecords; }
+
+                    std::size_t segmentBytes() const { return mSegmentBytes; }
+
+                  private:
+                    static constexpr char TAG[] = "Spool.cpp";
+
+                    static constexpr char SEGMENT_SUFFIX[] = ".seg";
+
+                    struct Segment
+                    {
+                        uint64_t seq{0};
+                        uint8_t *map{nullptr};
+                        std::size_t size{0};
+
+                        /**
+                         * \brief Offset of the oldest record which is not consumed
+                         */
+                        std::size_t readOffset{0};
+
+                        /**
+                         * \brief Offset one-past the end of the newest record
+                         */
+                        std::size_t writeOffset{0};
+
+                        /**
+                         * \brief Number of records which are not consumed
+                         */
+                        std::size_t records{0};
+
+                        /**
+                         * \brief Number of payload bytes in records which are not consumed
+                         */
+                        std::size_t bytes{0};
+                    };
+
+                    std::string mDir;
+
+                    std::size_t mMaxBytes{0};
+
+                    std::size_t mSegmentBytes{0};
+
+                    std::size_t mPageSize{0};
+
+                    uint64_t mNextSeq{1};
+
+                    /**
+                     * \brief Segments from oldest to newest, only the oldest and the newest are mapped
+                     */
+                    std::deque<Segment> mSegments;
+
+                    std::size_t mRecords{0};
+
+                    std::size_t mBytes{0};
+
+                    uint64_t mEvictedRecords{0};
+
+                    /**
+                     * \brief Offset in the newest segment up to which data has been flushed
+                     */
+                    std::size_t mSyncedOffset{0};
+
+                    std::size_t mUnsyncedBytes{0};
+
+                    /**
+                     * \brief Whether records were marked consumed since the previous flush
+                     */
+                    bool mConsumedDirty{false};
+
+                    std::chrono::steady_clock::time_point mLastSync;
+
+                    std::string segmentPath(uint64_t seq) const;
+
+                    /**
+                     * \brief Open and map an existing segment, and recover its read and write offsets
+                     */
+                    bool recover(Segment &segment);
+
+                    /**
+                     * \brief Map an existing segment, the mapping remains valid after its file is closed
+                     */
+                    bool map(Segment &segment) const;
+
+                    void unmap(Segment &segment) const;
+
+                    /**
+                     * \brief Flush and start a new newest segment, evicting the oldest segments when required
+                     */
+                    bool rotate();
+
+                    /**
+                     * \brief Delete the oldest segment, counting its records which are not consumed as evicted
+                     */
+                    void removeOldest();
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_SPOOL_H
@@ -0,0 +1,245 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "StatsReporter.h"
+
+#include "../logging/LoggerFactory.h"
+#include "../util/FileUtils.h"
+
+#include <aws/common/clock.h>
+#include <aws/common/error.h>
+#include <aws/common/zero.h>
+#include <aws/mqtt/client.h>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::Logging;
+using namespace Aws::Iot::DeviceClient::Util;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+constexpr char StatsReporter::TAG[];
+
+namespace
+{
+    /**
+     * Permissions of the stats file
+     */
+    constexpr mode_t STATS_FILE_MODE = 0640;
+
+    /**
+     * Append the summary of histogram to out as the JSON member key
+     */
+    void appendHistogram(string &out, const char *key, const LatencyHistogram &histogram)
+    {
+        LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+        char member[160];
+        snprintf(
+            member,
+            sizeof(member),
+            "\"%s\":{\"count\":%" PRIu64 ",\"p50\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+            key,
+            snapshot.count,
+            snapshot.p50,
+            snapshot.p99,
+            snapshot.max);
+        out += member;
+    }
+} // namespace
+
+void StatsReporter::AppendJsonString(string &out, const string &value)
+{
+    out += '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+StatsReporter::StatsReporter(
+    shared_ptr<Crt::Mqtt::MqttConnection> connection,
+    aws_event_loop *eventLoop,
+    const vector<unique_ptr<Sensor>> &sensors,
+    const string &file,
+    const string &topic,
+    int64_t intervalSec)
+    : mConnection(connection), mEventLoop(eventLoop), mSensors(sensors),
+      mFile(file.empty() ? file : FileUtils::ExtractExpandedPath(file)), mTopicName(topic), mInterval(intervalSec)
+{
+    mTopic = aws_byte_cursor_from_array(mTopicName.c_str(), mTopicName.size());
+
+    // Initialize a task to report the statistics every interval.
+    AWS_ZERO_STRUCT(mReportTask);
+    aws_task_init(
+        &mReportTask,
+        [](struct aws_task *, void *arg, enum aws_task_status status) {
+            if (status == AWS_TASK_STATUS_CANCELED)
+            {
+                return; // Ignore canceled tasks.
+            }
+            auto *self = static_cast<StatsReporter *>(arg);
+            self->onReportTaskCallback();
+        },
+        this,
+        __func__);
+}
+
+void StatsReporter::start()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (!mStopped)
+    {
+        return;
+    }
+    mStopped = false;
+    scheduleReport();
+}
+
+void StatsReporter::stop()
+{
+    lock_guard<mutex> lock(mMutex);
+    if (mStopped)
+    {
+        return;
+    }
+    mStopped = true;
+    if (aws_event_loop_thread_is_callers_thread(mEventLoop))
+    {
+        aws_event_loop_cancel_task(mEventLoop, &mReportTask);
+    }
+
+    // Leave the statistics of the last run behind for inspection.
+    if (!mFile.empty())
+    {
+        uint64_t now = 0;
+        aws_sys_clock_get_ticks(&now);
+        writeFile(format(aws_timestamp_convert(now, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr)));
+    }
+}
+
+string StatsReporter::format(uint64_t timeMs) const
+{
+    string document = "{\"time_ms\":" + to_string(timeMs) + ",\"sensors\":[";
+    for (size_t i = 0; i < mSensors.size(); ++i)
+    {
+        const SensorLatency &latency = mSensors[i]->getLatency();
+        document += i == 0 ? "{\"name\":" : ",{\"name\":";
+        AppendJsonString(document, mSensors[i]->getName());
+        document += ",\"latency_us\":{";
+        appendHistogram(document, "queue", latency.queue);
+        document += ',';
+        appendHistogram(document, "ack", latency.ack);
+        document += ',';
+        appendHistogram(document, "total", latency.total);
+        document += "}}";
+    }
+    document += "]}";
+    return document;
+}
+
+void StatsReporter::report()
+{
+    uint64_t now = 0;
+    aws_sys_clock_get_ticks(&now);
+    string document = format(aws_timestamp_convert(now, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, nullptr));
+
+    if (!mFile.empty())
+    {
+        writeFile(document);
+    }
+    if (mTopic.len > 0)
+    {
+        // Publish copies the payload, so the document does not need to outlive the publish.
+        aws_byte_cursor payload = aws_byte_cursor_from_array(document.data(), document.size());
+        if (mqttPublish(&payload) == 0)
+        {
+            LOGM_WARN(
+                TAG,
+                "Unable to publish statistics topic: %s msg: %s",
+                mTopicName.c_str(),
+                aws_error_str(aws_last_error()));
+        }
+    }
+}
+
+bool StatsReporter::writeFile(const string &document) const
+{
+    // Write a temporary file and rename it over the stats file, so readers never see a partial document.
+    string tmpPath = mFile + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, STATS_FILE_MODE);
+    if (fd < 0)
+    {
+        LOGM_ERROR(TAG, "Unable to open stats file: %s errno: %d msg: %s", tmpPath.c_str(), errno, strerror(errno));
+        return false;
+    }
+    bool written = ::write(fd, document.data(), document.size()) == static_cast<ssize_t>(document.size());
+    int errnum = errno;
+    ::close(fd);
+    if (!written || rename(tmpPath.c_str(), mFile.c_str()) != 0)
+    {
+        errnum = written ? errno : errnum;
+        LOGM_ERROR(TAG, "Unable to write stats file: %s errno: %d msg: %s", mFile.c_str(), errnum, strerror(errnum));
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void StatsReporter::scheduleReport()
+{
+    uint64_t runAtNanos;
+    aws_event_loop_current_clock_time(mEventLoop, &runAtNanos);
+    runAtNanos += chrono::duration_cast<chrono::nanoseconds>(mInterval).count();
+    aws_event_loop_schedule_task_future(mEventLoop, &mReportTask, runAtNanos);
+}
+
+void StatsReporter::onReportTaskCallback()
+{
+    // Holding the lock while reporting keeps the final report written by stop from being overwritten.
+    lock_guard<mutex> lock(mMutex);
+    if (mStopped)
+    {
+        return;
+    }
+    scheduleReport();
+    report();
+}
+
+uint16_t StatsReporter::mqttPublish(const aws_byte_cursor *payload)
+{
+    return aws_mqtt_client_connection_publish(
+        mConnection->GetUnderlyingConnection(),
+        &mTopic,
+        AWS_MQTT_QOS_AT_LEAST_ONCE,
+        false,
+        payload,
+        [](struct aws_mqtt_client_connection *, uint16_t packet_id, int error_code, void *) {
+            // Statistics are not retried, the next report supersedes them.
+            if (error_code != AWS_OP_SUCCESS)
+            {
+                LOGM_WARN(
+                    TAG, "Statistics publish failed packetId: %d msg: %s", packet_id, aws_error_str(error_code));
+            }
+        },
+        nullptr);
+}
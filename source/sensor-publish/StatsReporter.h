@@ -0,0 +1,150 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_STATS_REPORTER_H
+#define DEVICE_CLIENT_STATS_REPORTER_H
+
+#include "Sensor.h"
+
+#include <aws/common/task_scheduler.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief StatsReporter periodically reports the statistics of every sensor.
+                 *
+                 * The statistics are a JSON document holding the publish latency percentiles of each sensor:
+                 *
+                 *     {"time_ms":1650000000000,"sensors":[{"name":"my-sensor","latency_us":{
+                 *      "queue":{"count":10,"p50":1000,"p99":2047,"max":2001},"ack":{...},"total":{...}}}]}
+                 *
+                 * The document is written to stats_file, replacing the previous document atomically so readers
+                 * never see a partial document, and published to stats_topic, when configured.
+                 */
+                class StatsReporter
+                {
+                  public:
+                    /**
+                     * \brief Append value to out as a JSON string, escaping quotes, backslashes and control
+                     * characters
+                     */
+                    static void AppendJsonString(std::string &out, const std::string &value);
+
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param connection MQTT client connection
+                     * @param eventLoop event loop running the report task
+                     * @param sensors sensors to report, owned by the caller and outliving the reporter
+                     * @param file path of the stats file, empty when not written
+                     * @param topic topic the statistics are published to, empty when not published
+                     * @param intervalSec interval between reports
+                     */
+                    StatsReporter(
+                        std::shared_ptr<Crt::Mqtt::MqttConnection> connection,
+                        aws_event_loop *eventLoop,
+                        const std::vector<std::unique_ptr<Sensor>> &sensors,
+                        const std::string &file,
+                        const std::string &topic,
+                        int64_t intervalSec);
+
+                    virtual ~StatsReporter() = default;
+
+                    StatsReporter(const StatsReporter &) = delete;
+                    StatsReporter &operator=(const StatsReporter &) = delete;
+
+                    /**
+                     * \brief Start reporting every interval
+                     */
+                    void start();
+
+                    /**
+                     * \brief Stop the report task, and write the stats file a last time
+                     */
+                    void stop();
+
+                    /**
+                     * \brief Format the statistics of every sensor as a JSON document
+                     */
+                    std::string format(uint64_t timeMs) const;
+
+                    /**
+                     * \brief Write the statistics to the stats file and publish them to the stats topic
+                     */
+                    void report();
+
+                  protected:
+                    /**
+                     * \brief Used by the logger to specify source of log messages.
+                     */
+                    static constexpr char TAG[] = "StatsReporter.cpp";
+
+                    /**
+                     * \brief Publish payload to the stats topic
+                     *
+                     * @return packet id of the publish, or 0 when the publish failed to start
+                     */
+                    virtual uint16_t mqttPublish(const aws_byte_cursor *payload);
+
+                    /**
+                     * \brief Replace the stats file with document
+                     *
+                     * @return false when the file could not be written
+                     */
+                    bool writeFile(const std::string &document) const;
+
+                    /**
+                     * \brief Callback function for the report task
+                     */
+                    void onReportTaskCallback();
+
+                  private:
+                    std::shared_ptr<Crt::Mqtt::MqttConnection> mConnection;
+
+                    aws_event_loop *mEventLoop{nullptr};
+
+                    const std::vector<std::unique_ptr<Sensor>> &mSensors;
+
+                    std::string mFile;
+
+                    std::string mTopicName;
+
+                    aws_byte_cursor mTopic;
+
+                    std::chrono::seconds mInterval;
+
+                    /**
+                     * \brief Guards the report task state
+                     */
+                    std::mutex mMutex;
+
+                    aws_task mReportTask;
+
+                    bool mStopped{true};
+
+                    /**
+                     * \brief Schedule the report task one interval from now, called with mMutex held
+                     */
+                    void scheduleReport();
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_STATS_REPORTER_H
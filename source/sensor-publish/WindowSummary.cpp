@@ -0,0 +1,134 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "WindowSummary.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/zero.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * Largest number of bytes written for a number or a counter
+     */
+    constexpr size_t NUMBER_TEXT_MAX = 32;
+} // namespace
+
+WindowSummary::WindowSummary(
+    aws_allocator *allocator,
+    FieldParser::Format format,
+    const vector<string> &fields,
+    uint64_t windowMs)
+    : mParser(format, fields), mWindowMs(max(windowMs, uint64_t(1))), mFields(fields.size())
+{
+    // The output of a window is bounded by the number of fields, so it is allocated once.
+    size_t capacity = 64 + 3 * NUMBER_TEXT_MAX;
+    for (const auto &name : fields)
+    {
+        capacity += name.size() + 64 + 4 * NUMBER_TEXT_MAX;
+    }
+
+    AWS_ZERO_STRUCT(mOutput);
+    if (aws_byte_buf_init(&mOutput, allocator, capacity) != AWS_OP_SUCCESS)
+    {
+        throw std::runtime_error{"Unable to allocate memory for window summary"};
+    }
+}
+
+WindowSummary::~WindowSummary()
+{
+    aws_byte_buf_clean_up(&mOutput);
+}
+
+void WindowSummary::add(const uint8_t *message, size_t len, uint64_t timeMs)
+{
+    if (mMessages == 0)
+    {
+        mWindowStart = timeMs - timeMs % mWindowMs;
+    }
+    ++mMessages;
+
+    mParser.parse(message, len);
+    for (size_t i = 0; i < mFields.size(); ++i)
+    {
+        if (!mParser.found(i))
+        {
+            continue;
+        }
+        Field &field = mFields[i];
+        double value = mParser.value(i);
+        if (field.count == 0)
+        {
+            field.min = value;
+            field.max = value;
+        }
+        else
+        {
+            field.min = min(field.min, value);
+            field.max = max(field.max, value);
+        }
+        field.sum += value;
+        ++field.count;
+    }
+}
+
+aws_byte_cursor WindowSummary::finish()
+{
+    char text[3 * NUMBER_TEXT_MAX];
+    mOutput.len = 0;
+    snprintf(
+        text,
+        sizeof(text),
+        "{\"ts\":%" PRIu64 ",\"window_ms\":%" PRIu64 ",\"messages\":%" PRIu64,
+        mWindowStart,
+        mWindowMs,
+        mMessages);
+    write(text);
+    write(",\"fields\":{");
+    for (size_t i = 0; i < mFields.size(); ++i)
+    {
+        Field &field = mFields[i];
+        write(i == 0 ? "\"" : ",\"");
+        write(mParser.name(i).c_str());
+        snprintf(text, sizeof(text), "\":{\"count\":%" PRIu64, field.count);
+        write(text);
+        if (field.count > 0)
+        {
+            write(",\"min\":");
+            writeNumber(field.min);
+            write(",\"max\":");
+            writeNumber(field.max);
+            write(",\"mean\":");
+            writeNumber(field.sum / static_cast<double>(field.count));
+        }
+        write("}");
+
+        field.count = 0;
+        field.sum = 0;
+    }
+    write("}}");
+
+    mMessages = 0;
+    return aws_byte_cursor_from_buf(&mOutput);
+}
+
+void WindowSummary::write(const char *text)
+{
+    aws_byte_buf_write(&mOutput, reinterpret_cast<const uint8_t *>(text), strlen(text));
+}
+
+void WindowSummary::writeNumber(double value)
+{
+    char text[NUMBER_TEXT_MAX];
+    snprintf(text, sizeof(text), "%.15g", value);
+    write(text);
+}
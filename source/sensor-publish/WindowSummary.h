@@ -0,0 +1,125 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEVICE_CLIENT_WINDOW_SUMMARY_H
+#define DEVICE_CLIENT_WINDOW_SUMMARY_H
+
+#include "FieldParser.h"
+
+#include <aws/common/byte_buf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+    namespace Iot
+    {
+        namespace DeviceClient
+        {
+            namespace SensorPublish
+            {
+                /**
+                 * \brief WindowSummary reduces the messages of a tumbling time window to the count, minimum,
+                 * maximum and mean of configured numeric fields.
+                 *
+                 * Fields are read from each message by a FieldParser, and values which are missing or are not
+                 * numbers are not counted.
+                 *
+                 * Windows are aligned to multiples of the window length since the Unix epoch. The summary of a
+                 * window is encoded as a JSON object:
+                 *
+                 *     {"ts":<window start ms>,"window_ms":<length>,"messages":<count>,
+                 *      "fields":{"<field>":{"count":<n>,"min":<v>,"max":<v>,"mean":<v>},...}}
+                 *
+                 * where min, max and mean are omitted for fields without any value in the window.
+                 *
+                 * WindowSummary is not thread safe, and is only used from the event loop of its sensor.
+                 */
+                class WindowSummary
+                {
+                  public:
+                    /**
+                     * \brief Constructor
+                     *
+                     * @param allocator memory allocator
+                     * @param format format of the messages
+                     * @param fields JSON keys, or CSV column numbers, of the fields to summarize
+                     * @param windowMs length of a window
+                     *
+                     * @throws std::runtime_error when memory cannot be allocated, or when a CSV field is not a
+                     * column number
+                     */
+                    WindowSummary(
+                        aws_allocator *allocator,
+                        FieldParser::Format format,
+                        const std::vector<std::string> &fields,
+                        std::uint64_t windowMs);
+
+                    ~WindowSummary();
+
+                    WindowSummary(const WindowSummary &) = delete;
+                    WindowSummary &operator=(const WindowSummary &) = delete;
+
+                    /**
+                     * \brief Add a message to the window, starting the window when it is empty
+                     *
+                     * @param message message without its delimiter
+                     * @param len size of the message
+                     * @param timeMs time since the Unix epoch at which the message was read
+                     */
+                    void add(const uint8_t *message, std::size_t len, std::uint64_t timeMs);
+
+                    /**
+                     * \brief Whether no message was added to the window
+                     */
+                    bool empty() const { return mMessages == 0; }
+
+                    /**
+                     * \brief Time since the Unix epoch at which the window ends, only valid when not empty
+                     */
+                    std::uint64_t windowEnd() const { return mWindowStart + mWindowMs; }
+
+                    /**
+                     * \brief Encode the summary of the window, and start a new empty window
+                     *
+                     * @return view of the encoded summary, valid until the next call to finish
+                     */
+                    aws_byte_cursor finish();
+
+                  private:
+                    /**
+                     * \brief Accumulator of the values of a single field
+                     */
+                    struct Field
+                    {
+                        std::uint64_t count{0};
+                        double min{0};
+                        double max{0};
+                        double sum{0};
+                    };
+
+                    FieldParser mParser;
+
+                    std::uint64_t mWindowMs;
+
+                    std::uint64_t mWindowStart{0};
+
+                    std::uint64_t mMessages{0};
+
+                    std::vector<Field> mFields;
+
+                    aws_byte_buf mOutput;
+
+                    void write(const char *text);
+
+                    void writeNumber(double value);
+                };
+            } // namespace SensorPublish
+        }     // namespace DeviceClient
+    }         // namespace Iot
+} // namespace Aws
+
+#endif // DEVICE_CLIENT_WINDOW_SUMMARY_H
@@ -822,6 +822,31 @@ TEST_F(ConfigTestFixture, LoggingConfigurationCLI)
     ASSERT_STREQ("./client.log", config.logConfig.deviceClientLogFile.c_str());
 }
 
+TEST_F(ConfigTestFixture, BinaryLoggingConfigurationJson)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "type": "Binary",
+        "file": "/tmp/client.blog"
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    ASSERT_STREQ("binary", config.logConfig.deviceClientLogtype.c_str());
+    ASSERT_STREQ("/tmp/client.blog", config.logConfig.deviceClientLogFile.c_str());
+    ASSERT_THROW(config.logConfig.ParseDeviceClientLogType("syslog"), std::invalid_argument);
+}
+
 TEST_F(ConfigTestFixture, SDKLoggingConfigurationCLIDefaults)
 {
     CliArgs cliArgs;
@@ -907,6 +932,72 @@ TEST_F(ConfigTestFixture, SDKLoggingConfigurationJson)
     ASSERT_STREQ("device-client.log", config.logConfig.deviceClientLogFile.c_str());
 }
 
+TEST_F(ConfigTestFixture, LogFlushPolicyJson)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "logging": {
+        "type": "FILE",
+        "flush-policy": "Interval",
+        "flush-interval-ms": 250
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    ASSERT_STREQ("batch", config.logConfig.deviceClientLogFlushPolicy.c_str());
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_STREQ("interval", config.logConfig.deviceClientLogFlushPolicy.c_str());
+    ASSERT_EQ(250, config.logConfig.deviceClientLogFlushIntervalMs);
+
+    PlainConfig::LogConfig logConfig;
+    ASSERT_FALSE(logConfig.LoadFromJson(JsonObject(R"({"flush-policy": "never"})").View()));
+
+    config.logConfig.deviceClientLogFlushIntervalMs = 0;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
+TEST_F(ConfigTestFixture, LogQueueOverflowJson)
+{
+    constexpr char jsonString[] = R"(
+{
+    "logging": {
+        "queue-capacity": 1024,
+        "overflow-policy": "Block",
+        "overflow-block-ms": 20
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    ASSERT_EQ(4096, config.logConfig.deviceClientLogQueueCapacity);
+    ASSERT_STREQ("drop-oldest", config.logConfig.deviceClientLogOverflowPolicy.c_str());
+    config.LoadFromJson(jsonView);
+
+    ASSERT_TRUE(config.logConfig.Validate());
+    ASSERT_EQ(1024, config.logConfig.deviceClientLogQueueCapacity);
+    ASSERT_STREQ("block", config.logConfig.deviceClientLogOverflowPolicy.c_str());
+    ASSERT_EQ(20, config.logConfig.deviceClientLogOverflowBlockMs);
+
+    PlainConfig::LogConfig logConfig;
+    ASSERT_FALSE(logConfig.LoadFromJson(JsonObject(R"({"overflow-policy": "grow"})").View()));
+
+    config.logConfig.deviceClientLogOverflowBlockMs = -1;
+    ASSERT_FALSE(config.logConfig.Validate());
+    config.logConfig.deviceClientLogOverflowBlockMs = 0;
+    config.logConfig.deviceClientLogQueueCapacity = 0;
+    ASSERT_FALSE(config.logConfig.Validate());
+}
+
 TEST_F(ConfigTestFixture, FleetProvisioningMinimumConfig)
 {
     constexpr char jsonString[] = R"(
@@ -1426,6 +1517,816 @@ TEST_F(ConfigTestFixture, SensorPublishInvalidConfigBufferCapacityTooSmall)
     ASSERT_FALSE(settings.enabled);
 }
 
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigSpool)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/sensors/my-sensor-spool",
+                "spool_max_bytes": 1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/sensors/my-sensor-spool-2",
+                "spool_drain_rate": 0
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_max_bytes": 1,
+                "spool_drain_rate": 0
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/sensors/my-shared-spool"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "spool_dir": "/tmp/sensors/my-shared-spool/"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_EQ(config.sensorPublish.settings.size(), 5);
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled); // Spool max bytes too small.
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // Spool drain rate not positive.
+    ASSERT_TRUE(config.sensorPublish.settings[2].enabled);  // Spool settings ignored without a spool directory.
+    ASSERT_FALSE(config.sensorPublish.settings[2].spoolDir.has_value());
+    ASSERT_TRUE(config.sensorPublish.settings[3].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[4].enabled); // Spool directory used by another sensor.
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigCompression)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "lz4"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "deflate",
+                "compression_min_bytes": -1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "compression": "deflate"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_EQ(config.sensorPublish.settings.size(), 3);
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled); // Unknown compression algorithm.
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // Compression minimum size negative.
+    ASSERT_TRUE(config.sensorPublish.settings[2].enabled);
+    ASSERT_EQ(
+        config.sensorPublish.settings[2].compressionMinBytes.value(),
+        PlainConfig::SensorPublish::COMPRESSION_MIN_BYTES);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigBatchFormat)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "batch_format": "xml"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "batch_format": "cbor",
+                "batch_timestamps": true
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_EQ(config.sensorPublish.settings.size(), 2);
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled); // Unknown batch format.
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);
+    ASSERT_TRUE(config.sensorPublish.settings[1].batchTimestamps.value());
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigEventLoop)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "event_loop_threads": 2,
+        "event_loop_cpus": [1, 2],
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "event_loop": 2
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "event_loop": 1
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_EQ(config.sensorPublish.eventLoopThreads.value(), 2);
+    ASSERT_EQ(config.sensorPublish.eventLoopCpus, (std::vector<int64_t>{1, 2}));
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled); // Event loop out of range.
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);
+
+    // When the thread count is out of range, then every sensor is disabled.
+    config.sensorPublish.eventLoopThreads = PlainConfig::SensorPublish::EVENT_LOOP_THREADS_MAX + 1;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishSensorsDir)
+{
+    // Sensor definition files are appended to the sensors array in file name order.
+    const string sensorsDir = addrPathValid + "/definitions";
+    FileUtils::CreateDirectoryWithPermissions(sensorsDir.c_str(), S_IRWXU);
+    const vector<string> files = {"b-sensor.json", "a-sensor.json", "c-sensor.json", "notes.txt"};
+    for (const auto &file : files)
+    {
+        ofstream definition(sensorsDir + "/" + file);
+        definition << R"({"addr": "/tmp/sensors/my-sensor-server", "eom_delimiter": "[\r\n]+", "mqtt_topic": "t"})";
+        definition.close();
+        chmod((sensorsDir + "/" + file).c_str(), file == "c-sensor.json" ? 0644 : 0600);
+    }
+
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "max_sensors": 3,
+        "sensors_dir": "/tmp/sensors/definitions",
+        "memory_budget_bytes": 1048576,
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+    for (const auto &file : files)
+    {
+        std::remove((sensorsDir + "/" + file).c_str());
+    }
+    std::remove(sensorsDir.c_str());
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_EQ(config.sensorPublish.memoryBudgetBytes.value(), 1048576);
+    ASSERT_EQ(config.sensorPublish.settings.size(), 3); // c-sensor.json has the wrong permissions.
+    ASSERT_EQ(config.sensorPublish.settings[0].name.value(), "1");
+    ASSERT_TRUE(config.sensorPublish.settings[0].definitionFile.empty());
+    ASSERT_EQ(config.sensorPublish.settings[1].name.value(), "a-sensor");
+    ASSERT_EQ(config.sensorPublish.settings[1].definitionFile, sensorsDir + "/a-sensor.json");
+    ASSERT_EQ(config.sensorPublish.settings[2].name.value(), "b-sensor");
+    ASSERT_TRUE(config.sensorPublish.settings[2].enabled);
+
+    // Entries from sensors_dir are not serialized.
+    JsonObject serialized;
+    config.sensorPublish.SerializeToObject(serialized);
+    ASSERT_EQ(serialized.View().GetArray(PlainConfig::SensorPublish::JSON_SENSORS).size(), 1);
+
+    // When there are more entries than max_sensors, then every sensor is disabled.
+    config.sensorPublish.maxSensors = 2;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigAddrType)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "127.0.0.1:5140",
+                "addr_type": "udp",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "10.0.0.1:5140",
+                "addr_type": "udp",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "127.0.0.1:0",
+                "addr_type": "udp",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "addr_type": "raw",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "addr_type": "stream",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "127.0.0.1:5141",
+                "addr_type": "udp",
+                "max_message_bytes": 0,
+                "mqtt_topic": "my-sensor-data"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);  // Message based sockets need no eom_delimiter.
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // UDP address is not a loopback address.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // UDP port is out of range.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Unknown address type.
+    ASSERT_FALSE(config.sensorPublish.settings[4].enabled); // Stream sockets need an eom_delimiter.
+    ASSERT_FALSE(config.sensorPublish.settings[5].enabled); // Message size is out of range.
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigMemoryBudget)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "memory_budget_bytes": 65536,
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "buffer_capacity": 16384
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled); // Default buffer capacity exceeds the budget.
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);
+
+    // When the budget or the maximum number of sensors is out of range, then every sensor is disabled.
+    config.sensorPublish.memoryBudgetBytes = -1;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+
+    config.sensorPublish.settings[1].enabled = true;
+    config.sensorPublish.memoryBudgetBytes = 0;
+    config.sensorPublish.maxSensors = PlainConfig::SensorPublish::MAX_SENSORS_LIMIT + 1;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigAggregate)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "aggregate": true
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // No aggregate_topic.
+
+    config.sensorPublish.settings[1].enabled = true;
+    config.sensorPublish.aggregateTopic = "aggregate-data";
+    ASSERT_TRUE(config.sensorPublish.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);
+
+    // When an aggregated sensor compresses its batches, then the sensor is disabled.
+    config.sensorPublish.settings[1].compression = "deflate";
+    ASSERT_TRUE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+
+    config.sensorPublish.settings[1].enabled = true;
+    config.sensorPublish.settings[1].compression = "none";
+    ASSERT_TRUE(config.sensorPublish.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[1].enabled);
+
+    // When an aggregated sensor has a dead letter topic, then the sensor is disabled.
+    config.sensorPublish.settings[1].mqttDeadLetterTopic = "my-sensor-dead-letter";
+    ASSERT_TRUE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled);
+
+    // When the aggregate in-flight window is negative, then every sensor is disabled.
+    config.sensorPublish.aggregateMaxInflight = -1;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+
+    // When the aggregate message size exceeds the broker limit, then every sensor is disabled.
+    config.sensorPublish.settings[0].enabled = true;
+    config.sensorPublish.aggregateMaxInflight = 0;
+    config.sensorPublish.aggregateMaxBytes = PlainConfig::SensorPublish::BUF_CAPACITY_BYTES + 1;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigStats)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "stats_file": "/tmp/sensor-stats.json",
+        "stats_topic": "sensor-stats",
+        "stats_interval_sec": 10,
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_STREQ(config.sensorPublish.statsFile->c_str(), "/tmp/sensor-stats.json");
+    ASSERT_STREQ(config.sensorPublish.statsTopic->c_str(), "sensor-stats");
+    ASSERT_EQ(config.sensorPublish.statsIntervalSec.value(), 10);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+
+    // When the stats file directory does not exist, then every sensor is disabled.
+    config.sensorPublish.statsFile = "/tmp/aws-iot-device-client-missing-dir/sensor-stats.json";
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+
+    config.sensorPublish.settings[0].enabled = true;
+    config.sensorPublish.statsFile = "/tmp/sensor-stats.json";
+    config.sensorPublish.statsIntervalSec = 0;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+
+    config.sensorPublish.settings[0].enabled = true;
+    config.sensorPublish.statsIntervalSec = 10;
+    config.sensorPublish.statsTopic = std::string(1024, 't'); // Exceeds the topic length limit.
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigHeartbeat)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "heartbeat_topic": "sensor-heartbeat",
+        "heartbeat_interval_sec": 60,
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_STREQ(config.sensorPublish.heartbeatTopic->c_str(), "sensor-heartbeat");
+    ASSERT_EQ(config.sensorPublish.heartbeatIntervalSec.value(), 60);
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+
+    // When the heartbeat interval is not positive, then every sensor is disabled.
+    config.sensorPublish.heartbeatIntervalSec = 0;
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+
+    config.sensorPublish.settings[0].enabled = true;
+    config.sensorPublish.heartbeatIntervalSec = 60;
+    config.sensorPublish.heartbeatTopic = std::string(1024, 't'); // Exceeds the topic length limit.
+    ASSERT_FALSE(config.sensorPublish.Validate());
+    ASSERT_FALSE(config.sensorPublish.settings[0].enabled);
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigSummary)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "summary_format": "json",
+                "summary_fields": ["temp", "rh"]
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "summary_format": "csv",
+                "summary_fields": ["temp"]
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "summary_fields": ["temp"]
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "summary_format": "csv",
+                "summary_fields": ["2"],
+                "summary_window_ms": 0
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].summaryWindowMs.value(), 1000);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // Not a CSV column.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // No summary_format.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Window is not positive.
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigFilters)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "drop_duplicates": true,
+                "deadband_format": "csv",
+                "deadband_fields": ["0", "2"],
+                "deadband": 0.25,
+                "max_message_rate": 50
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "deadband_fields": ["temp"],
+                "deadband": 1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "deadband_format": "json",
+                "deadband_fields": ["temp"],
+                "deadband": -1
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "max_message_rate": -1
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].deadband.value(), 0.25);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // No deadband_format.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // Negative deadband.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Negative max_message_rate.
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigCommands)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_command_topic": "my-sensor-commands",
+                "command_buffer_bytes": 1024,
+                "command_drop_policy": "newest"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "addr_type": "dgram",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_command_topic": "my-sensor-commands"
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_command_topic": "my-sensor-commands",
+                "command_buffer_bytes": 0
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "mqtt_command_topic": "my-sensor-commands",
+                "command_drop_policy": "random"
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].mqttCommandTopic.value(), "my-sensor-commands");
+    ASSERT_EQ(config.sensorPublish.settings[0].commandBufferBytes.value(), 1024);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // Bound socket has no peer to write to.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // Empty command buffer.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Unknown drop policy.
+}
+
+TEST_F(ConfigTestFixture, SensorPublishInvalidConfigCan)
+{
+    constexpr char jsonString[] = R"(
+{
+    "endpoint": "endpoint value",
+    "cert": "/tmp/aws-iot-device-client-test-file",
+    "root-ca": "/tmp/aws-iot-device-client-test/AmazonRootCA1.pem",
+    "key": "/tmp/aws-iot-device-client-test-file",
+    "thing-name": "thing-name value",
+    "sensor-publish": {
+        "sensors": [
+            {
+                "addr": "vcan0",
+                "addr_type": "can",
+                "mqtt_topic": "my-sensor-data",
+                "max_message_bytes": 32,
+                "can_filters": ["123:7FF", "00000100~1FFFFFF0"]
+            },
+            {
+                "addr": "/tmp/sensors/vcan0",
+                "addr_type": "can",
+                "mqtt_topic": "my-sensor-data"
+            },
+            {
+                "addr": "vcan0",
+                "addr_type": "can",
+                "mqtt_topic": "my-sensor-data",
+                "max_message_bytes": 16
+            },
+            {
+                "addr": "vcan0",
+                "addr_type": "can",
+                "mqtt_topic": "my-sensor-data",
+                "can_filters": ["123"]
+            },
+            {
+                "addr": "/tmp/sensors/my-sensor-server",
+                "eom_delimiter": "[\r\n]+",
+                "mqtt_topic": "my-sensor-data",
+                "can_filters": ["123:7FF"]
+            }
+        ]
+    }
+})";
+    JsonObject jsonObject(jsonString);
+    JsonView jsonView = jsonObject.View();
+
+    PlainConfig config;
+    config.LoadFromJson(jsonView);
+
+#if defined(EXCLUDE_SENSOR_PUBLISH)
+    GTEST_SKIP();
+#endif
+    ASSERT_TRUE(config.Validate());
+    ASSERT_TRUE(config.sensorPublish.settings[0].enabled);
+    ASSERT_EQ(config.sensorPublish.settings[0].canFilters.size(), 2);
+    ASSERT_FALSE(config.sensorPublish.settings[1].enabled); // Not an interface name.
+    ASSERT_FALSE(config.sensorPublish.settings[2].enabled); // Frames do not fit max_message_bytes.
+    ASSERT_FALSE(config.sensorPublish.settings[3].enabled); // Filter without mask.
+    ASSERT_FALSE(config.sensorPublish.settings[4].enabled); // Filters of a non CAN socket.
+}
+
 TEST_F(ConfigTestFixture, SensorPublishDisableFeature)
 {
     constexpr char jsonString[] = R"(
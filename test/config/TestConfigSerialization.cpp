@@ -33,6 +33,11 @@ TEST(SerializeConfigTestFixture, SerializeCompleteConfigTest)
         "level": "INFO",
         "type": "file",
         "file": "./aws-iot-device-client.log",
+        "flush-policy": "batch",
+        "flush-interval-ms": 1000,
+        "queue-capacity": 4096,
+        "overflow-policy": "drop-oldest",
+        "overflow-block-ms": 100,
         "enable-sdk-logging": false,
         "sdk-log-level": "TRACE",
         "sdk-log-file": "/var/log/aws-iot-device-client/sdk.log"
@@ -91,30 +96,83 @@ TEST(SerializeConfigTestFixture, SerializeCompleteConfigTest)
                 "enabled": true,
                 "addr": "address_1",
                 "addr_poll_sec": 10,
+                "max_message_bytes": 4096,
                 "buffer_time_ms": 0,
                 "buffer_size": 0,
                 "buffer_capacity": 128000,
+                "max_inflight": 32,
+                "read_budget_bytes": 65536,
                 "eom_delimiter": "delim_1",
                 "mqtt_topic": "topic_1",
                 "mqtt_dead_letter_topic": "dead_letter_topic_1",
                 "mqtt_heartbeat_topic": "heart_beat_topic_1",
-                "heartbeat_time_sec": 300
+                "heartbeat_time_sec": 300,
+                "spool_dir": "spool_dir_1",
+                "spool_max_bytes": 67108864,
+                "spool_drain_rate": 10,
+                "compression": "deflate",
+                "compression_min_bytes": 512,
+                "batch_format": "json_array",
+                "batch_timestamps": true,
+                "event_loop": 1,
+                "aggregate": true,
+                "summary_format": "csv",
+                "summary_fields": ["1", "3"],
+                "summary_window_ms": 1000,
+                "drop_duplicates": true,
+                "deadband_format": "json",
+                "deadband_fields": ["temp"],
+                "deadband": 0.5,
+                "max_message_rate": 100,
+                "mqtt_command_topic": "command_topic_1",
+                "command_buffer_bytes": 16384,
+                "command_drop_policy": "newest"
             },
             {
                 "name": "sensor_2",
                 "enabled": true,
                 "addr": "address_2",
                 "addr_poll_sec": 1,
+                "addr_type": "dgram",
+                "max_message_bytes": 512,
                 "buffer_time_ms": 1,
                 "buffer_size": 1,
                 "buffer_capacity": 1,
+                "max_inflight": 0,
+                "read_budget_bytes": 0,
                 "eom_delimiter": "delim_2",
                 "mqtt_topic": "topic_2",
                 "mqtt_dead_letter_topic": "dead_letter_topic_2",
                 "mqtt_heartbeat_topic": "heart_beat_topic_2",
-                "heartbeat_time_sec": 10
+                "heartbeat_time_sec": 10,
+                "spool_dir": "spool_dir_2",
+                "spool_max_bytes": 1048576,
+                "spool_drain_rate": 1,
+                "compression": "none",
+                "compression_min_bytes": 0,
+                "batch_timestamps": false,
+                "aggregate": false,
+                "summary_window_ms": 500,
+                "drop_duplicates": false,
+                "deadband": 0,
+                "max_message_rate": 0,
+                "command_buffer_bytes": 1024,
+                "can_filters": ["123:7FF", "00000100~1FFFFFF0"]
             }
-        ]
+        ],
+        "event_loop_threads": 2,
+        "event_loop_cpus": [2, 3],
+        "max_sensors": 200,
+        "memory_budget_bytes": 4194304,
+        "aggregate_topic": "aggregate_topic",
+        "aggregate_max_bytes": 64000,
+        "aggregate_time_ms": 500,
+        "aggregate_max_inflight": 16,
+        "stats_file": "/var/log/aws-iot-device-client/sensor-stats.json",
+        "stats_topic": "stats_topic",
+        "stats_interval_sec": 30,
+        "heartbeat_topic": "heartbeat_topic",
+        "heartbeat_interval_sec": 60
     }
 })";
     // Initializing allocator, so we can use CJSON lib from SDK in our unit tests.
@@ -141,6 +199,11 @@ TEST(SerializeConfigTestFixture, SerializeBasicConfigTest)
         "level": "DEBUG",
         "type": "file",
         "file": "./aws-iot-device-client.log",
+        "flush-policy": "batch",
+        "flush-interval-ms": 1000,
+        "queue-capacity": 4096,
+        "overflow-policy": "drop-oldest",
+        "overflow-block-ms": 100,
         "enable-sdk-logging": false,
         "sdk-log-level": "TRACE",
         "sdk-log-file": "/var/log/aws-iot-device-client/sdk.log"
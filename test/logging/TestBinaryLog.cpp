@@ -0,0 +1,212 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/BinaryLogDecoder.h"
+#include "../../source/logging/BinaryLogFormat.h"
+#include "../../source/logging/BinaryLogger.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+constexpr char BINARY_LOG_FILE[] = "/tmp/aws-iot-device-client-test-binary-log/device-client.blog";
+
+/**
+ * Encodes the arguments and formats them back, returning the message, or "<unsupported>" if they cannot be encoded.
+ */
+static string roundTrip(const char *format, ...)
+{
+    char buffer[BinaryLogFormat::MAX_RECORD_SIZE];
+    va_list args;
+    va_start(args, format);
+    int size = BinaryLogFormat::encodeArguments(format, args, buffer, sizeof(buffer));
+    va_end(args);
+    if (size < 0)
+    {
+        return "<unsupported>";
+    }
+
+    string message;
+    EXPECT_TRUE(BinaryLogFormat::formatArguments(format, buffer, static_cast<size_t>(size), message));
+    return message;
+}
+
+static string decode(const string &path)
+{
+    ostringstream output;
+    string error;
+    EXPECT_TRUE(BinaryLogDecoder::decode(path, output, error)) << error;
+    return output.str();
+}
+
+static vector<string> messagesOf(const string &decoded)
+{
+    vector<string> messages;
+    istringstream lines(decoded);
+    string line;
+    while (getline(lines, line))
+    {
+        messages.push_back(line.substr(line.find("}: ") + 3));
+    }
+    return messages;
+}
+
+static PlainConfig binaryLogConfig()
+{
+    PlainConfig config;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_BINARY;
+    config.logConfig.deviceClientLogFile = BINARY_LOG_FILE;
+    config.logConfig.deviceClientlogLevel = static_cast<int>(Logging::LogLevel::DEBUG);
+    return config;
+}
+
+TEST(BinaryLogFormat, roundTripsArguments)
+{
+    ASSERT_EQ("Message 1 of test", roundTrip("Message %d of %s", 1, "test"));
+    ASSERT_EQ("-5 4294967295 ff 0XFF 17", roundTrip("%ld %u %x %#X %o", -5L, 4294967295u, 255, 255, 15));
+    ASSERT_EQ("42 -7 65535", roundTrip("%zu %hhd %hu", static_cast<size_t>(42), -7, 65535));
+    ASSERT_EQ("[   12] [12   ] [00012]", roundTrip("[%*d] [%-5d] [%05d]", 5, 12, 12, 12));
+    ASSERT_EQ("abc ab ab", roundTrip("%.3s %.*s %.2s", "abcdef", 2, "abcdef", "ab"));
+    ASSERT_EQ("3.142 1.500000e+00 0.25", roundTrip("%.3f %e %g", 3.14159, 1.5, 0.25));
+    ASSERT_EQ("100% x (null)", roundTrip("100%% %c %s", 'x', static_cast<const char *>(nullptr)));
+    ASSERT_EQ("0x1234 (nil)", roundTrip("%p %p", reinterpret_cast<void *>(0x1234), static_cast<void *>(nullptr)));
+}
+
+TEST(BinaryLogFormat, rejectsUnsupportedArguments)
+{
+    ASSERT_EQ("<unsupported>", roundTrip("%ls", L"wide"));
+    ASSERT_EQ("<unsupported>", roundTrip("%2$s %1$s", "a", "b"));
+
+    string tooLong(BinaryLogFormat::MAX_RECORD_SIZE, 'x');
+    ASSERT_EQ("<unsupported>", roundTrip("%s", tooLong.c_str()));
+}
+
+TEST(BinaryLogger, decodesLoggedMessages)
+{
+    BinaryLogger logger;
+    auto t = chrono::system_clock::now();
+    // Logged before start, so written already formatted.
+    logger.info("TAG", t, "Queued message %d", 1);
+    ASSERT_TRUE(logger.start(binaryLogConfig()));
+
+    logger.error("TAG", t, "Message %d of %s", 2, "test");
+    logger.debug("OTHER", t, "Pointer %p", static_cast<void *>(nullptr));
+    // Cannot be encoded, so formatted when logged instead.
+    logger.warn("TAG", t, "Wide %ls", L"text");
+    logger.flush();
+
+    LogMessage expected(Logging::LogLevel::INFO, "TAG", t, "Queued message 1");
+    string firstLine;
+    LogUtil::appendLogLine(firstLine, expected);
+
+    string decoded = decode(BINARY_LOG_FILE);
+    ASSERT_EQ(0u, decoded.find(firstLine));
+    ASSERT_NE(string::npos, decoded.find("[ERROR] {TAG}: Message 2 of test\n"));
+    ASSERT_NE(string::npos, decoded.find("[DEBUG] {OTHER}: Pointer (nil)\n"));
+    ASSERT_NE(string::npos, decoded.find("[WARN]  {TAG}: Wide text\n"));
+    ASSERT_EQ(4u, messagesOf(decoded).size());
+}
+
+TEST(BinaryLogger, recordsMessagesAndTagsBuiltAtRuntime)
+{
+    BinaryLogger logger;
+    ASSERT_TRUE(logger.start(binaryLogConfig()));
+
+    // Both messages, and both tags, are built in the same buffer.
+    char message[32];
+    char tag[16];
+    snprintf(message, sizeof(message), "first line");
+    snprintf(tag, sizeof(tag), "pid 1");
+    logger.info(tag, chrono::system_clock::now(), message);
+    snprintf(message, sizeof(message), "second line");
+    snprintf(tag, sizeof(tag), "pid 2");
+    logger.info(tag, chrono::system_clock::now(), message);
+    logger.flush();
+
+    string decoded = decode(BINARY_LOG_FILE);
+    ASSERT_NE(string::npos, decoded.find("{pid 1}: first line\n"));
+    ASSERT_NE(string::npos, decoded.find("{pid 2}: second line\n"));
+}
+
+TEST(BinaryLogger, keepsTheNewestMessagesWhenTheRingWraps)
+{
+    BinaryLogger logger;
+    ASSERT_TRUE(logger.start(binaryLogConfig()));
+    // Several laps of the ring, with messages of varying length so that records straddle block boundaries.
+    constexpr int count = 400000;
+    string padding(64, '.');
+    for (int i = 0; i < count; i++)
+    {
+        logger.info("TAG", chrono::system_clock::now(), "Message %d %.*s", i, i % 64, padding.c_str());
+    }
+    logger.flush();
+
+    vector<string> messages = messagesOf(decode(BINARY_LOG_FILE));
+    ASSERT_LT(messages.size(), static_cast<size_t>(count));
+    ASSERT_GT(messages.size(), static_cast<size_t>(count / 10));
+
+    int first = count - static_cast<int>(messages.size());
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        int number = first + static_cast<int>(i);
+        ASSERT_EQ("Message " + to_string(number) + " " + padding.substr(0, number % 64), messages[i]);
+    }
+}
+
+TEST(BinaryLogger, recordsMessagesFromConcurrentThreads)
+{
+    BinaryLogger logger;
+    ASSERT_TRUE(logger.start(binaryLogConfig()));
+
+    constexpr int threadCount = 4;
+    constexpr int messageCount = 20000;
+    vector<thread> threads;
+    for (int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&logger, i]() {
+            for (int j = 0; j < messageCount; j++)
+            {
+                logger.info("TAG", chrono::system_clock::now(), "Thread %d message %d", i, j);
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    logger.flush();
+
+    vector<int> next(threadCount, 0);
+    for (const string &message : messagesOf(decode(BINARY_LOG_FILE)))
+    {
+        int thread;
+        int number;
+        ASSERT_EQ(2, sscanf(message.c_str(), "Thread %d message %d", &thread, &number)) << message;
+        ASSERT_LT(static_cast<size_t>(thread), next.size());
+        ASSERT_EQ(next[thread]++, number);
+    }
+    ASSERT_EQ(vector<int>(threadCount, messageCount), next);
+}
+
+TEST(BinaryLogDecoder, rejectsOtherFiles)
+{
+    ostringstream output;
+    string error;
+    ASSERT_FALSE(BinaryLogDecoder::decode("/tmp/aws-iot-device-client-test-missing.blog", output, error));
+    ASSERT_FALSE(error.empty());
+
+    FILE *file = fopen("/tmp/aws-iot-device-client-test-text.log", "w");
+    ASSERT_NE(nullptr, file);
+    fputs("2023-01-01T00:00:00.000Z [INFO] {TAG}: a text log file, long enough to hold a file header\n", file);
+    fclose(file);
+    ASSERT_FALSE(BinaryLogDecoder::decode("/tmp/aws-iot-device-client-test-text.log", output, error));
+}
@@ -0,0 +1,188 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/logging/LogMessagePool.h"
+#include "../../source/logging/Logger.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::Logging;
+
+/**
+ * Counts the allocations made by the current thread while countAllocations is set.
+ */
+static thread_local bool countAllocations = false;
+static thread_local size_t allocations = 0;
+
+void *operator new(size_t size)
+{
+    if (countAllocations)
+    {
+        allocations++;
+    }
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+/**
+ * Counts the allocations made by the current thread while it is alive.
+ */
+class AllocationCounter
+{
+  public:
+    AllocationCounter()
+    {
+        allocations = 0;
+        countAllocations = true;
+    }
+    ~AllocationCounter() { countAllocations = false; }
+
+    size_t count() const { return allocations; }
+};
+
+static unique_ptr<LogMessage> format(const char *message, ...)
+{
+    va_list args;
+    va_start(args, message);
+    unique_ptr<LogMessage> log(
+        new LogMessage(Logging::LogLevel::INFO, "TAG", chrono::system_clock::now(), message, args));
+    va_end(args);
+    return log;
+}
+
+TEST(LogMessage, formatsIntoRecord)
+{
+    unique_ptr<LogMessage> log = format("Message %d of %s", 1, "test");
+    ASSERT_EQ(Logging::LogLevel::INFO, log->getLevel());
+    ASSERT_STREQ("TAG", log->getTag());
+    ASSERT_STREQ("Message 1 of test", log->getMessage());
+}
+
+TEST(LogMessage, spillsLongMessages)
+{
+    string longArgument(LogMessage::INLINE_MESSAGE_SIZE * 2, 'x');
+    ASSERT_STREQ(("Message " + longArgument).c_str(), format("Message %s", longArgument.c_str())->getMessage());
+
+    // A message exactly filling the record still fits in it.
+    string fitting(LogMessage::INLINE_MESSAGE_SIZE - 1, 'y');
+    ASSERT_STREQ(fitting.c_str(), format("%s", fitting.c_str())->getMessage());
+
+    string copied(LogMessage::INLINE_MESSAGE_SIZE, 'z');
+    LogMessage log(Logging::LogLevel::DEBUG, "TAG", chrono::system_clock::now(), copied);
+    ASSERT_STREQ(copied.c_str(), log.getMessage());
+}
+
+TEST(LogMessage, copiesTag)
+{
+    unique_ptr<LogMessage> log;
+    {
+        string tag = "pid " + to_string(1234);
+        log = unique_ptr<LogMessage>(
+            new LogMessage(Logging::LogLevel::INFO, tag.c_str(), chrono::system_clock::now(), "Message"));
+    }
+    ASSERT_STREQ("pid 1234", log->getTag());
+
+    string longTag(LogMessage::INLINE_TAG_SIZE, 't');
+    LogMessage spilled(Logging::LogLevel::INFO, longTag.c_str(), chrono::system_clock::now(), "Message");
+    longTag[0] = 'x';
+    ASSERT_STREQ(string(LogMessage::INLINE_TAG_SIZE, 't').c_str(), spilled.getTag());
+}
+
+TEST(LogMessagePool, reusesReleasedRecords)
+{
+    LogMessagePool pool(sizeof(LogMessage), 2);
+    void *first = pool.allocate();
+    void *second = pool.allocate();
+    ASSERT_NE(first, second);
+
+    // Once the preallocated records are taken, records come from the heap and are kept when released.
+    void *third;
+    {
+        AllocationCounter counter;
+        third = pool.allocate();
+        ASSERT_EQ(1u, counter.count());
+    }
+
+    pool.release(first);
+    pool.release(third);
+    // The pool is full, so this record is freed.
+    pool.release(second);
+
+    {
+        AllocationCounter counter;
+        ASSERT_EQ(first, pool.allocate());
+        ASSERT_EQ(third, pool.allocate());
+        ASSERT_EQ(0u, counter.count());
+    }
+    pool.release(first);
+    pool.release(third);
+}
+
+class QueueLogger : public Logger
+{
+  public:
+    LogQueue queue;
+
+    bool start(const PlainConfig &) override { return true; }
+    void stop() override {}
+    void shutdown() override {}
+    unique_ptr<LogQueue> takeLogQueue() override { return unique_ptr<LogQueue>(new LogQueue); }
+    void setLogQueue(unique_ptr<LogQueue>) override {}
+    LogQueue *getLogQueue() override { return &queue; }
+    void flush() override {}
+
+    void drain()
+    {
+        while (queue.hasNextLog())
+        {
+            queue.getNextLog();
+        }
+    }
+
+  protected:
+    void queueLog(unique_ptr<LogMessage> message) override { queue.addLog(std::move(message)); }
+};
+
+TEST(LogMessage, steadyStateLoggingDoesNotAllocate)
+{
+    constexpr int batchSize = 64;
+    QueueLogger logger;
+    // Warm up with a full batch of messages, so that the pool holds enough released records for the test however
+    // many records other tests still hold.
+    for (int i = 0; i < batchSize; i++)
+    {
+        logger.info("TAG", chrono::system_clock::now(), "Message %d", i);
+    }
+    logger.drain();
+
+    AllocationCounter counter;
+    for (int i = 0; i < 10000; i++)
+    {
+        logger.info("TAG", chrono::system_clock::now(), "Message %d of %s", i, "the allocation test");
+        if (i % batchSize == batchSize - 1)
+        {
+            logger.drain();
+        }
+    }
+    ASSERT_EQ(0u, counter.count());
+}
@@ -4,7 +4,13 @@
 #include "../../source/logging/LogQueue.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace std;
 using namespace Aws::Iot::DeviceClient::Logging;
@@ -58,8 +64,8 @@ class LogQueueTest : public ::testing::Test
 TEST_F(LogQueueTest, queuesMessages)
 {
     ASSERT_TRUE(logQueue->hasNextLog());
-    ASSERT_STREQ("Message 1", logQueue->getNextLog()->getMessage().c_str());
-    ASSERT_STREQ("Message 2", logQueue->getNextLog()->getMessage().c_str());
+    ASSERT_STREQ("Message 1", logQueue->getNextLog()->getMessage());
+    ASSERT_STREQ("Message 2", logQueue->getNextLog()->getMessage());
 }
 
 TEST_F(LogQueueTest, removesMessagesFromQueue)
@@ -109,3 +115,242 @@ TEST_F(LogQueueTest, readsAllMessagesWithNullAtBeginning)
 
     ASSERT_EQ(5, counter);
 }
+
+TEST_F(LogQueueTest, getsAllMessagesAtOnce)
+{
+    deque<unique_ptr<LogMessage>> logs;
+    ASSERT_TRUE(logQueue->getNextLogs(logs));
+    ASSERT_EQ(2, logs.size());
+    ASSERT_STREQ("Message 1", logs[0]->getMessage());
+    ASSERT_STREQ("Message 2", logs[1]->getMessage());
+    ASSERT_FALSE(logQueue->hasNextLog());
+
+    // Messages queued after the swap are returned by the next call, and the previous batch is replaced.
+    logQueue->addLog(
+        unique_ptr<LogMessage>(new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), "Message 3")));
+    ASSERT_TRUE(logQueue->getNextLogs(logs));
+    ASSERT_EQ(1, logs.size());
+    ASSERT_STREQ("Message 3", logs[0]->getMessage());
+
+    // Once shut down, the queue returns the shutdown marker, then nothing without waiting.
+    logQueue->shutdown();
+    ASSERT_TRUE(logQueue->getNextLogs(logs));
+    ASSERT_EQ(1, logs.size());
+    ASSERT_TRUE(nullptr == logs[0]);
+    ASSERT_FALSE(logQueue->getNextLogs(logs));
+    ASSERT_TRUE(logs.empty());
+}
+
+static unique_ptr<LogMessage> makeLog(const string &message)
+{
+    return unique_ptr<LogMessage>(new LogMessage(LogLevel::DEBUG, "TAG", std::chrono::system_clock::now(), message));
+}
+
+TEST(LogQueueOverflow, followsPreviousQueue)
+{
+    LogQueue previous(4);
+    previous.addLog(makeLog("Message 0"));
+    LogQueue queue(8);
+    queue.follow(&previous);
+    queue.addLog(makeLog("Message 1"));
+
+    // The messages of the previous queue go first, including those added to it after the switch.
+    deque<unique_ptr<LogMessage>> logs;
+    ASSERT_TRUE(queue.getNextLogs(logs));
+    ASSERT_EQ(2, logs.size());
+    ASSERT_STREQ("Message 0", logs[0]->getMessage());
+    ASSERT_STREQ("Message 1", logs[1]->getMessage());
+
+    previous.addLog(makeLog("Message 2"));
+    ASSERT_TRUE(queue.hasNextLog());
+    ASSERT_STREQ("Message 2", queue.getNextLog()->getMessage());
+    ASSERT_FALSE(queue.hasNextLog());
+}
+
+TEST(LogQueueOverflow, roundsCapacityToPowerOfTwo)
+{
+    ASSERT_EQ(2, LogQueue(0).getCapacity());
+    ASSERT_EQ(4, LogQueue(3).getCapacity());
+    ASSERT_EQ(4096, LogQueue().getCapacity());
+    ASSERT_EQ(LogQueue::roundCapacity(1000), LogQueue(1000).getCapacity());
+}
+
+TEST(LogQueueOverflow, dropsOldestAndReportsDrops)
+{
+    LogQueue queue(4);
+    for (int i = 0; i < 6; i++)
+    {
+        queue.addLog(makeLog("Message " + to_string(i)));
+    }
+    ASSERT_EQ(2, queue.getDroppedCount());
+
+    // The newest messages are kept, followed by a report of the dropped ones.
+    deque<unique_ptr<LogMessage>> logs;
+    ASSERT_TRUE(queue.getNextLogs(logs));
+    ASSERT_EQ(5, logs.size());
+    ASSERT_STREQ("Message 2", logs[0]->getMessage());
+    ASSERT_STREQ("Message 5", logs[3]->getMessage());
+    ASSERT_EQ(LogLevel::WARN, logs[4]->getLevel());
+    ASSERT_STREQ("Log queue full, dropped 2 log messages (2 since start)", logs[4]->getMessage());
+
+    // Drops are only reported once.
+    queue.addLog(makeLog("Message 6"));
+    ASSERT_TRUE(queue.getNextLogs(logs));
+    ASSERT_EQ(1, logs.size());
+}
+
+TEST(LogQueueOverflow, dropOldestKeepsShutdownMarkerOutOfDrops)
+{
+    LogQueue queue(2);
+    queue.shutdown();
+    queue.addLog(makeLog("Message 0"));
+    queue.addLog(makeLog("Message 1"));
+
+    // Making room discards the shutdown marker, which is not reported as a dropped message.
+    ASSERT_EQ(0, queue.getDroppedCount());
+    deque<unique_ptr<LogMessage>> logs;
+    ASSERT_TRUE(queue.getNextLogs(logs));
+    ASSERT_EQ(2, logs.size());
+    ASSERT_STREQ("Message 0", logs[0]->getMessage());
+    ASSERT_STREQ("Message 1", logs[1]->getMessage());
+
+    // The shut down queue still returns without waiting.
+    ASSERT_FALSE(queue.getNextLogs(logs));
+    ASSERT_TRUE(nullptr == queue.getNextLog());
+}
+
+TEST(LogQueueOverflow, dropsNewest)
+{
+    LogQueue queue(4);
+    queue.setOverflowPolicy(LogQueue::OverflowPolicy::DropNewest, chrono::milliseconds(0));
+    for (int i = 0; i < 6; i++)
+    {
+        queue.addLog(makeLog("Message " + to_string(i)));
+    }
+    ASSERT_EQ(2, queue.getDroppedCount());
+    ASSERT_STREQ("Log queue full, dropped 2 log messages (2 since start)", queue.getNextLog()->getMessage());
+    ASSERT_STREQ("Message 0", queue.getNextLog()->getMessage());
+}
+
+TEST(LogQueueOverflow, blocksUntilRoomOrTimeout)
+{
+    LogQueue queue(2);
+    queue.setOverflowPolicy(LogQueue::OverflowPolicy::Block, chrono::milliseconds(50));
+    queue.addLog(makeLog("Message 0"));
+    queue.addLog(makeLog("Message 1"));
+
+    // When nobody takes a message, the producer gives up after the timeout and drops its message.
+    auto start = chrono::steady_clock::now();
+    queue.addLog(makeLog("Message 2"));
+    ASSERT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(50));
+    ASSERT_EQ(1, queue.getDroppedCount());
+
+    // When a message is taken, the waiting producer adds its message.
+    queue.setOverflowPolicy(LogQueue::OverflowPolicy::Block, chrono::milliseconds(5000));
+    thread producer([&queue]() { queue.addLog(makeLog("Message 3")); });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    ASSERT_EQ(LogLevel::WARN, queue.getNextLog()->getLevel());
+    ASSERT_STREQ("Message 0", queue.getNextLog()->getMessage());
+    producer.join();
+    ASSERT_EQ(1, queue.getDroppedCount());
+
+    deque<unique_ptr<LogMessage>> logs;
+    ASSERT_TRUE(queue.getNextLogs(logs));
+    ASSERT_STREQ("Message 1", logs[0]->getMessage());
+    ASSERT_STREQ("Message 3", logs[1]->getMessage());
+}
+
+TEST(LogQueueOverflow, returnsWhenIdle)
+{
+    // getNextLogs() does not wait longer than EMPTY_WAIT_TIME_MILLISECONDS, so writers can flush while idle.
+    LogQueue queue;
+    deque<unique_ptr<LogMessage>> logs;
+    auto start = chrono::steady_clock::now();
+    ASSERT_FALSE(queue.getNextLogs(logs));
+    ASSERT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(1000));
+}
+
+TEST(LogQueueOverflow, concurrentProducersKeepOrderPerThread)
+{
+    constexpr int producers = 8;
+    constexpr int perProducer = 5000;
+    LogQueue queue(64);
+    queue.setOverflowPolicy(LogQueue::OverflowPolicy::Block, chrono::milliseconds(60000));
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < perProducer; i++)
+            {
+                queue.addLog(makeLog(to_string(p) + " " + to_string(i)));
+            }
+        });
+    }
+
+    vector<int> next(producers, 0);
+    deque<unique_ptr<LogMessage>> logs;
+    int received = 0;
+    while (received < producers * perProducer)
+    {
+        queue.getNextLogs(logs);
+        for (auto &log : logs)
+        {
+            int p = 0;
+            int i = 0;
+            ASSERT_EQ(2, sscanf(log->getMessage(), "%d %d", &p, &i));
+            ASSERT_EQ(next[p]++, i);
+            received++;
+        }
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(0, queue.getDroppedCount());
+}
+
+/**
+ * Messages per second queued by 8 producer threads while one consumer drains the queue.
+ * Run with --gtest_also_run_disabled_tests --gtest_filter='LogQueueOverflow.DISABLED_*'
+ */
+TEST(LogQueueOverflow, DISABLED_BenchmarkContention)
+{
+    constexpr int producers = 8;
+    constexpr int perProducer = 200000;
+    LogQueue queue;
+
+    atomic<bool> done{false};
+    thread consumer([&queue, &done]() {
+        deque<unique_ptr<LogMessage>> logs;
+        while (!done || queue.hasNextLog())
+        {
+            queue.getNextLogs(logs);
+        }
+    });
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue]() {
+            for (int i = 0; i < perProducer; i++)
+            {
+                queue.addLog(makeLog("Message of the contention benchmark"));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    done = true;
+    consumer.join();
+
+    printf(
+        "producers: %d messages/s: %.0f dropped: %llu\n",
+        producers,
+        producers * perProducer / elapsed.count(),
+        static_cast<unsigned long long>(queue.getDroppedCount()));
+}
@@ -2,10 +2,20 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "../../source/logging/FileLogger.h"
+#include "../../source/logging/LoggerFactory.h"
 #include "../../source/logging/StdOutLogger.h"
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+
 using namespace std;
+using namespace Aws::Iot::DeviceClient;
 using namespace Aws::Iot::DeviceClient::Logging;
 
 TEST(Logging, swapsLogQueue)
@@ -38,3 +48,182 @@ TEST(Logging, queueNotNullAfterTake)
     ASSERT_TRUE(NULL != stdOutLogger->takeLogQueue());
     ASSERT_FALSE(stdOutLogger->takeLogQueue()->hasNextLog());
 }
+
+class FlushPolicyLogger : public Logger
+{
+  public:
+    using Logger::flushDue;
+    using Logger::setFlushPolicy;
+
+    bool start(const PlainConfig &) override { return true; }
+    void stop() override {}
+    void shutdown() override {}
+    unique_ptr<LogQueue> takeLogQueue() override { return unique_ptr<LogQueue>(new LogQueue); }
+    void setLogQueue(unique_ptr<LogQueue>) override {}
+    LogQueue *getLogQueue() override { return nullptr; }
+    void flush() override {}
+
+  protected:
+    void queueLog(unique_ptr<LogMessage>) override {}
+};
+
+TEST(Logging, flushPolicy)
+{
+    PlainConfig::LogConfig config;
+    FlushPolicyLogger logger;
+
+    // By default, every batch is flushed.
+    logger.setFlushPolicy(config);
+    ASSERT_TRUE(logger.flushDue(false));
+    ASSERT_TRUE(logger.flushDue(false));
+
+    config.deviceClientLogFlushPolicy = PlainConfig::LogConfig::LOG_FLUSH_ERROR;
+    logger.setFlushPolicy(config);
+    ASSERT_FALSE(logger.flushDue(false));
+    ASSERT_TRUE(logger.flushDue(true));
+
+    // The first batch after the interval is flushed, later batches wait for the next interval.
+    config.deviceClientLogFlushPolicy = PlainConfig::LogConfig::LOG_FLUSH_INTERVAL;
+    config.deviceClientLogFlushIntervalMs = 50;
+    logger.setFlushPolicy(config);
+    this_thread::sleep_for(chrono::milliseconds(60));
+    ASSERT_TRUE(logger.flushDue(false));
+    ASSERT_FALSE(logger.flushDue(true));
+    this_thread::sleep_for(chrono::milliseconds(60));
+    ASSERT_TRUE(logger.flushDue(false));
+}
+
+class LevelLogger : public FlushPolicyLogger
+{
+  public:
+    using Logger::setLogLevel;
+};
+
+TEST(Logging, isEnabled)
+{
+    LevelLogger logger;
+    ASSERT_TRUE(logger.isEnabled(Logging::LogLevel::DEBUG));
+
+    logger.setLogLevel((int)Logging::LogLevel::WARN);
+    ASSERT_TRUE(logger.isEnabled(Logging::LogLevel::ERROR));
+    ASSERT_TRUE(logger.isEnabled(Logging::LogLevel::WARN));
+    ASSERT_FALSE(logger.isEnabled(Logging::LogLevel::INFO));
+    ASSERT_FALSE(logger.isEnabled(Logging::LogLevel::DEBUG));
+}
+
+static int countEvaluation(int &evaluations)
+{
+    return ++evaluations;
+}
+
+TEST(Logging, disabledLevelSkipsArguments)
+{
+    constexpr char TAG[] = "TestLogging.cpp";
+    PlainConfig config;
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::WARN;
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    ASSERT_FALSE(LoggerFactory::isEnabled(Logging::LogLevel::INFO));
+
+    int evaluations = 0;
+    LOGM_DEBUG(TAG, "Evaluation %d", countEvaluation(evaluations));
+    LOGM_INFO(TAG, "Evaluation %d", countEvaluation(evaluations));
+    LOG_INFO(TAG, "Not logged");
+    ASSERT_EQ(0, evaluations);
+
+    LOGM_WARN(TAG, "Evaluation %d", countEvaluation(evaluations));
+    LOGM_ERROR(TAG, "Evaluation %d", countEvaluation(evaluations));
+    // A build with COMPILED_LOG_LEVEL ERROR drops the WARN statement at compile time.
+    ASSERT_EQ(COMPILED_LOG_LEVEL >= (int)Logging::LogLevel::WARN ? 2 : 1, evaluations);
+
+    config.logConfig.deviceClientlogLevel = (int)Logging::LogLevel::DEBUG;
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    ASSERT_TRUE(LoggerFactory::isEnabled(Logging::LogLevel::DEBUG));
+}
+
+TEST(Logging, replacedLoggerStillDelivers)
+{
+    PlainConfig config;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_FILE;
+    config.logConfig.deviceClientLogFile = "/tmp/aws-iot-device-client-test/replaced-logger.log";
+    remove(config.logConfig.deviceClientLogFile.c_str());
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    Logger *replaced = LoggerFactory::getLogger();
+
+    // The logger is reused while its type and queue capacity stay the same.
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    ASSERT_EQ(replaced, LoggerFactory::getLogger());
+
+    config.logConfig.deviceClientLogQueueCapacity = 1024;
+    config.logConfig.deviceClientLogFile = "/tmp/aws-iot-device-client-test/next-logger.log";
+    remove(config.logConfig.deviceClientLogFile.c_str());
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    Logger *next = LoggerFactory::getLogger();
+    ASSERT_NE(replaced, next);
+
+    // Let the logging thread of the replaced logger exit, then log through the stale pointer.
+    this_thread::sleep_for(chrono::milliseconds(300));
+    replaced->error("TAG", std::chrono::system_clock::now(), "Logged through the replaced logger");
+    next->flush();
+
+    ifstream file(config.logConfig.deviceClientLogFile);
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    ASSERT_NE(string::npos, contents.find("Logged through the replaced logger"));
+
+    ASSERT_TRUE(LoggerFactory::reconfigure(PlainConfig()));
+}
+
+TEST(Logging, startingRunningLoggerKeepsLogQueue)
+{
+    PlainConfig config;
+    config.logConfig.deviceClientLogtype = PlainConfig::LogConfig::LOG_TYPE_FILE;
+    config.logConfig.deviceClientLogFile = "/tmp/aws-iot-device-client-test/running-logger.log";
+    ASSERT_TRUE(LoggerFactory::reconfigure(config));
+    Logger *logger = LoggerFactory::getLogger();
+    LogQueue *queue = logger->getLogQueue();
+    size_t capacity = queue->getCapacity();
+
+    // The logging thread reads from the queue, so a running logger does not resize it.
+    config.logConfig.deviceClientLogQueueCapacity = static_cast<int64_t>(capacity * 4);
+    config.logConfig.deviceClientLogOverflowPolicy = PlainConfig::LogConfig::LOG_OVERFLOW_DROP_NEWEST;
+    ASSERT_TRUE(logger->start(config));
+    ASSERT_EQ(queue, logger->getLogQueue());
+    ASSERT_EQ(capacity, logger->getLogQueue()->getCapacity());
+
+    logger->error("TAG", std::chrono::system_clock::now(), "Logged after restart");
+    logger->flush();
+    ifstream file(config.logConfig.deviceClientLogFile);
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    ASSERT_NE(string::npos, contents.find("Logged after restart"));
+
+    ASSERT_TRUE(LoggerFactory::reconfigure(PlainConfig()));
+}
+
+/**
+ * Lines per second written by FileLogger.
+ * Run with --gtest_also_run_disabled_tests --gtest_filter='Logging.DISABLED_*'
+ */
+TEST(Logging, DISABLED_BenchmarkFileLoggerThroughput)
+{
+    constexpr int lines = 200000;
+    for (const char *policy : {PlainConfig::LogConfig::LOG_FLUSH_BATCH, PlainConfig::LogConfig::LOG_FLUSH_INTERVAL})
+    {
+        PlainConfig config;
+        config.logConfig.deviceClientLogFile = "/tmp/aws-iot-device-client-benchmark/device-client.log";
+        config.logConfig.deviceClientLogFlushPolicy = policy;
+        remove(config.logConfig.deviceClientLogFile.c_str());
+
+        unique_ptr<Logger> logger = unique_ptr<Logger>(new FileLogger);
+        ASSERT_TRUE(logger->start(config));
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < lines; ++i)
+        {
+            logger->info("TAG", std::chrono::system_clock::now(), "Message %d of the throughput benchmark", i);
+        }
+        logger->shutdown();
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        printf("policy: %-8s lines/s: %.0f\n", policy, lines / elapsed.count());
+
+        // Let the logging thread observe the shutdown before the logger is destroyed.
+        this_thread::sleep_for(chrono::milliseconds(400));
+    }
+}
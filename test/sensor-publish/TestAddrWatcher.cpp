@@ -0,0 +1,109 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/AddrWatcher.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/clock.h>
+#include <aws/common/task_scheduler.h>
+#include <aws/io/event_loop.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class AddrWatcherTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/aws-iot-device-client-addr-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirTemplate));
+        dir = dirTemplate;
+
+        eventLoop = aws_event_loop_new_default(aws_default_allocator(), aws_high_res_clock_get_ticks);
+        aws_event_loop_run(eventLoop);
+    }
+
+    void TearDown() override
+    {
+        aws_event_loop_stop(eventLoop);
+        aws_event_loop_wait_for_stop_completion(eventLoop);
+        aws_event_loop_destroy(eventLoop);
+        rmdir(dir.c_str());
+    }
+
+    bool startOnEventLoop(AddrWatcher &watcher)
+    {
+        struct StartArgs
+        {
+            AddrWatcher *watcher;
+            promise<bool> started;
+        } args{&watcher, promise<bool>()};
+        future<bool> started = args.started.get_future();
+
+        aws_task task;
+        aws_task_init(
+            &task,
+            [](struct aws_task *, void *arg, enum aws_task_status) {
+                auto *startArgs = static_cast<StartArgs *>(arg);
+                startArgs->started.set_value(startArgs->watcher->start());
+            },
+            &args,
+            __func__);
+        aws_event_loop_schedule_task_now(eventLoop, &task);
+        return started.get();
+    }
+
+    void create(const string &name)
+    {
+        FILE *file = fopen((dir + "/" + name).c_str(), "w");
+        ASSERT_NE(nullptr, file);
+        fclose(file);
+    }
+
+    string dir;
+    aws_event_loop *eventLoop;
+};
+
+TEST_F(AddrWatcherTest, NotifiesWhenAddrCreated)
+{
+    // When files are created in the directory of the address, then only the address is notified.
+    atomic<int> created{0};
+    AddrWatcher watcher(eventLoop, dir + "/sensor", [&created]() { ++created; });
+    ASSERT_TRUE(startOnEventLoop(watcher));
+    ASSERT_TRUE(watcher.isWatching());
+
+    create("other");
+    this_thread::sleep_for(chrono::milliseconds{50});
+    ASSERT_EQ(created, 0);
+
+    create("sensor");
+    for (int i = 0; i < 1000 && created == 0; ++i)
+    {
+        this_thread::sleep_for(chrono::milliseconds{1});
+    }
+    ASSERT_EQ(created, 1);
+
+    watcher.stop();
+    ASSERT_FALSE(watcher.isWatching());
+    unlink((dir + "/other").c_str());
+    unlink((dir + "/sensor").c_str());
+}
+
+TEST_F(AddrWatcherTest, MissingDirectory)
+{
+    // When the directory of the address does not exist, then the address cannot be watched.
+    AddrWatcher watcher(eventLoop, dir + "/missing/sensor", []() {});
+    ASSERT_FALSE(startOnEventLoop(watcher));
+    ASSERT_FALSE(watcher.isWatching());
+}
@@ -0,0 +1,198 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/Aggregator.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/clock.h>
+#include <aws/io/event_loop.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class MockAggregator : public Aggregator
+{
+  public:
+    MockAggregator(
+        aws_allocator *allocator,
+        aws_event_loop *eventLoop,
+        size_t maxBytes,
+        int64_t timeMs,
+        size_t maxInflight = 0)
+        : Aggregator(allocator, nullptr, eventLoop, "aggregate-data", maxBytes, timeMs, maxInflight)
+    {
+    }
+
+    uint16_t mqttPublish(const aws_byte_cursor *payload) override
+    {
+        published.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+        publishTimes.push_back(chrono::steady_clock::now());
+        return static_cast<uint16_t>(published.size());
+    }
+
+    void call_onPublishComplete(size_t index, int errorCode)
+    {
+        onPublishComplete(static_cast<uint16_t>(index + 1), errorCode);
+    }
+
+    vector<string> published;
+    vector<chrono::steady_clock::time_point> publishTimes;
+};
+
+/**
+ * Split an aggregate message into its (sensor name, batch) records
+ */
+static vector<pair<string, string>> decode(const string &message)
+{
+    vector<pair<string, string>> records;
+    size_t pos = 0;
+    auto readBe = [&message, &pos](size_t bytes) {
+        size_t value = 0;
+        for (size_t i = 0; i < bytes; ++i)
+        {
+            value = (value << 8) | static_cast<uint8_t>(message[pos++]);
+        }
+        return value;
+    };
+    while (pos < message.size())
+    {
+        size_t nameLen = readBe(2);
+        string name = message.substr(pos, nameLen);
+        pos += nameLen;
+        size_t batchLen = readBe(4);
+        records.emplace_back(name, message.substr(pos, batchLen));
+        pos += batchLen;
+    }
+    return records;
+}
+
+class AggregatorTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        allocator = aws_default_allocator();
+        eventLoop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+        aws_event_loop_run(eventLoop);
+    }
+
+    void TearDown() override { aws_event_loop_destroy(eventLoop); }
+
+    static aws_byte_cursor cursor(const string &batch)
+    {
+        return aws_byte_cursor_from_array(batch.data(), batch.size());
+    }
+
+    aws_allocator *allocator;
+    aws_event_loop *eventLoop;
+};
+
+TEST_F(AggregatorTest, MergesBatchesOfSeveralSensors)
+{
+    // When several sensors add a batch, then a single message holds every batch tagged with its sensor name.
+    MockAggregator aggregator(allocator, eventLoop, 128000, 1000);
+    vector<pair<string, string>> expected;
+    for (int i = 0; i < 30; ++i)
+    {
+        expected.emplace_back("sensor-" + to_string(i), "reading " + to_string(i) + "\n");
+        ASSERT_TRUE(aggregator.add(expected.back().first, AggregatorTest::cursor(expected.back().second)));
+    }
+    ASSERT_TRUE(aggregator.published.empty());
+
+    aggregator.flush();
+    ASSERT_EQ(aggregator.published.size(), 1);
+    ASSERT_EQ(decode(aggregator.published[0]), expected);
+    ASSERT_EQ(aggregator.getCounters().batches, 30);
+
+    aggregator.flush(); // Nothing left to publish.
+    ASSERT_EQ(aggregator.published.size(), 1);
+    aggregator.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    ASSERT_EQ(aggregator.getCounters().published, 1);
+}
+
+TEST_F(AggregatorTest, PublishesWhenNextBatchDoesNotFit)
+{
+    // When the next batch would exceed the message size, then the message is published first,
+    // and a batch too large for any message is refused.
+    constexpr size_t maxBytes = 1024;
+    MockAggregator aggregator(allocator, eventLoop, maxBytes, 1000);
+    string batch(300, 'x');
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(aggregator.add("sensor", AggregatorTest::cursor(batch)));
+    }
+    ASSERT_EQ(aggregator.published.size(), 1);
+    ASSERT_EQ(decode(aggregator.published[0]).size(), 3);
+    ASSERT_LE(aggregator.published[0].size(), maxBytes);
+
+    ASSERT_FALSE(aggregator.add("sensor", AggregatorTest::cursor(string(maxBytes, 'y'))));
+    aggregator.stop();
+    ASSERT_EQ(aggregator.published.size(), 2);
+    ASSERT_EQ(decode(aggregator.published[1]).size(), 1);
+
+    // Batches are refused once stopped.
+    ASSERT_FALSE(aggregator.add("sensor", AggregatorTest::cursor(batch)));
+}
+
+TEST_F(AggregatorTest, PublishesAtDeadline)
+{
+    // When no more batches are added, then the message is published once the oldest batch reaches the deadline.
+    constexpr int64_t timeMs = 50;
+    MockAggregator aggregator(allocator, eventLoop, 128000, timeMs);
+
+    auto addTime = chrono::steady_clock::now();
+    ASSERT_TRUE(aggregator.add("sensor-1", AggregatorTest::cursor("a")));
+    this_thread::sleep_for(chrono::milliseconds{timeMs / 2});
+    ASSERT_TRUE(aggregator.add("sensor-2", AggregatorTest::cursor("b")));
+    this_thread::sleep_for(chrono::milliseconds{timeMs * 4});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_EQ(aggregator.published.size(), 1);
+    ASSERT_EQ(decode(aggregator.published[0]).size(), 2);
+    auto latency = chrono::duration_cast<chrono::milliseconds>(aggregator.publishTimes[0] - addTime).count();
+    ASSERT_GE(latency, timeMs - 1);
+    ASSERT_LT(latency, timeMs * 3);
+}
+
+TEST_F(AggregatorTest, RefusesBatchesWhileWindowFull)
+{
+    // When the in-flight window is full of unacknowledged aggregate messages, then batches are refused,
+    // so that their sensor publishes them, until an acknowledgement arrives.
+    MockAggregator aggregator(allocator, eventLoop, 128000, 1000, 2);
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_TRUE(aggregator.add("sensor", AggregatorTest::cursor("a")));
+        aggregator.flush();
+    }
+    ASSERT_FALSE(aggregator.add("sensor", AggregatorTest::cursor("b")));
+    ASSERT_EQ(aggregator.getCounters().windowFull, 1);
+
+    aggregator.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    ASSERT_TRUE(aggregator.add("sensor", AggregatorTest::cursor("c")));
+    aggregator.stop();
+    ASSERT_EQ(aggregator.published.size(), 3);
+    ASSERT_EQ(decode(aggregator.published[2]).size(), 1);
+}
+
+TEST_F(AggregatorTest, StopCancelsDeadlineFromAnotherThread)
+{
+    // When the aggregator is stopped and destroyed from another thread than the event loop,
+    // then the deadline task is cancelled on the event loop, and never runs for the destroyed aggregator.
+    {
+        MockAggregator aggregator(allocator, eventLoop, 128000, 10);
+        ASSERT_TRUE(aggregator.add("sensor", AggregatorTest::cursor("a")));
+        aggregator.stop();
+        ASSERT_EQ(aggregator.published.size(), 1);
+        aggregator.start();
+        ASSERT_TRUE(aggregator.add("sensor", AggregatorTest::cursor("b")));
+    }
+    this_thread::sleep_for(chrono::milliseconds{50});
+}
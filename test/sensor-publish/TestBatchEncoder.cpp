@@ -0,0 +1,122 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/BatchEncoder.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    struct Message
+    {
+        string data;
+        uint64_t timeMs;
+    };
+
+    string encode(BatchEncoder &encoder, const vector<Message> &messages)
+    {
+        encoder.begin(messages.size());
+        for (const auto &message : messages)
+        {
+            EXPECT_TRUE(encoder.add(
+                reinterpret_cast<const uint8_t *>(message.data.data()), message.data.size(), message.timeMs));
+        }
+        aws_byte_cursor encoded;
+        EXPECT_TRUE(encoder.finish(encoded));
+        return string(reinterpret_cast<const char *>(encoded.ptr), encoded.len);
+    }
+} // namespace
+
+TEST(BatchEncoderTest, ParseFormat)
+{
+    BatchEncoder::Format format;
+    ASSERT_TRUE(BatchEncoder::ParseFormat("json_array", format));
+    ASSERT_EQ(BatchEncoder::Format::JsonArray, format);
+    ASSERT_TRUE(BatchEncoder::ParseFormat("cbor", format));
+    ASSERT_EQ(BatchEncoder::Format::Cbor, format);
+    ASSERT_TRUE(BatchEncoder::ParseFormat("length_prefixed", format));
+    ASSERT_EQ(BatchEncoder::Format::LengthPrefixed, format);
+    ASSERT_FALSE(BatchEncoder::ParseFormat("raw", format));
+}
+
+TEST(BatchEncoderTest, JsonArray)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::JsonArray, false, 64, 4);
+    ASSERT_EQ("[]", encode(encoder, {}));
+    ASSERT_EQ(R"(["a","bc"])", encode(encoder, {{"a", 0}, {"bc", 0}}));
+
+    // Quotes, backslashes and control characters are escaped.
+    ASSERT_EQ(R"(["{\"t\":\"x\\y\"}","\n\u0001"])", encode(encoder, {{R"({"t":"x\y"})", 0}, {"\n\x01", 0}}));
+}
+
+TEST(BatchEncoderTest, JsonArrayReplacesInvalidUtf8)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::JsonArray, false, 64, 4);
+
+    // Valid UTF-8 is copied as is.
+    string text = "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    ASSERT_EQ("[\"" + text + "\"]", encode(encoder, {{text, 0}}));
+
+    // Stray continuation bytes, truncated and overlong sequences and surrogates are replaced byte by byte.
+    ASSERT_EQ(
+        R"(["a\ufffdb\ufffd","\ufffd\ufffd","\ufffd\ufffd\ufffd"])",
+        encode(encoder, {{"a\x80" "b\xc3", 0}, {"\xc0\xaf", 0}, {"\xed\xa0\x80", 0}}));
+}
+
+TEST(BatchEncoderTest, JsonArrayWithTimestamps)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::JsonArray, true, 64, 4);
+    ASSERT_EQ(
+        R"([{"ts":1700000000123,"msg":"a"},{"ts":0,"msg":""}])", encode(encoder, {{"a", 1700000000123}, {"", 0}}));
+}
+
+TEST(BatchEncoderTest, JsonArrayGrowsWhenEscapingExceedsBatchSize)
+{
+    // Every byte of the message is escaped to six bytes.
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::JsonArray, false, 64, 1);
+    string message(64, '\x02');
+    string expected = "[\"";
+    for (size_t i = 0; i < message.size(); ++i)
+    {
+        expected += "\\u0002";
+    }
+    expected += "\"]";
+    ASSERT_EQ(expected, encode(encoder, {{message, 0}}));
+    ASSERT_EQ(R"(["a"])", encode(encoder, {{"a", 0}}));
+}
+
+TEST(BatchEncoderTest, Cbor)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::Cbor, false, 512, 4);
+
+    // Array of two byte strings.
+    ASSERT_EQ(string("\x82\x41" "a\x42" "bc"), encode(encoder, {{"a", 0}, {"bc", 0}}));
+
+    // Byte string lengths of 24 and above use an extended head.
+    string message(300, 'x');
+    ASSERT_EQ(string("\x81\x59\x01\x2c") + message, encode(encoder, {{message, 0}}));
+}
+
+TEST(BatchEncoderTest, CborWithTimestamps)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::Cbor, true, 64, 4);
+
+    // [{"ts": 1000, "msg": h'61'}]
+    ASSERT_EQ(string("\x81\xa2\x62ts\x19\x03\xe8\x63msg\x41" "a"), encode(encoder, {{"a", 1000}}));
+}
+
+TEST(BatchEncoderTest, LengthPrefixed)
+{
+    BatchEncoder encoder(aws_default_allocator(), BatchEncoder::Format::LengthPrefixed, false, 64, 4);
+    ASSERT_EQ(string("\0\0\0\x01" "a\0\0\0\x02" "bc", 11), encode(encoder, {{"a", 0}, {"bc", 0}}));
+
+    BatchEncoder timed(aws_default_allocator(), BatchEncoder::Format::LengthPrefixed, true, 64, 4);
+    ASSERT_EQ(string("\0\0\0\0\0\0\x03\xe8\0\0\0\x01" "a", 13), encode(timed, {{"a", 1000}}));
+}
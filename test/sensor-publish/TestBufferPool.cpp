@@ -0,0 +1,66 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/BufferPool.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class BufferPoolTest : public ::testing::Test
+{
+  public:
+    void SetUp() override { allocator = aws_default_allocator(); }
+
+    aws_allocator *allocator;
+};
+
+TEST_F(BufferPoolTest, ReusesReturnedBuffer)
+{
+    // When a buffer is returned, then the next buffer of the same size is the returned buffer.
+    BufferPool pool(allocator, 0);
+    void *first = pool.acquire(1024);
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(pool.inUseBytes(), 1024u);
+    pool.release(first, 1024);
+    ASSERT_EQ(pool.inUseBytes(), 0u);
+    ASSERT_EQ(pool.acquire(1024), first);
+    ASSERT_EQ(pool.allocatedBytes(), 1024u);
+    pool.release(first, 1024);
+}
+
+TEST_F(BufferPoolTest, BudgetExhausted)
+{
+    // When every buffer within the budget is in use, then acquire fails until a buffer is returned.
+    BufferPool pool(allocator, 2048);
+    void *first = pool.acquire(1024);
+    void *second = pool.acquire(1024);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    ASSERT_EQ(pool.acquire(1024), nullptr);
+    ASSERT_EQ(pool.allocatedBytes(), 2048u);
+
+    pool.release(second, 1024);
+    ASSERT_EQ(pool.acquire(1024), second);
+    pool.release(first, 1024);
+    pool.release(second, 1024);
+}
+
+TEST_F(BufferPoolTest, ReleasesFreeBuffersOfOtherSizes)
+{
+    // When the budget is reached with free buffers of another size, then they are released to make room.
+    BufferPool pool(allocator, 2048);
+    void *first = pool.acquire(1024);
+    void *second = pool.acquire(1024);
+    pool.release(first, 1024);
+    pool.release(second, 1024);
+    ASSERT_EQ(pool.allocatedBytes(), 2048u);
+
+    void *large = pool.acquire(2048);
+    ASSERT_NE(large, nullptr);
+    ASSERT_EQ(pool.allocatedBytes(), 2048u);
+    ASSERT_EQ(pool.acquire(1024), nullptr);
+    pool.release(large, 2048);
+}
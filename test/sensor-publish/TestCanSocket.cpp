@@ -0,0 +1,127 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/CanSocket.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/error.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#    include <linux/can.h>
+#    include <net/if.h>
+#endif
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    string format(uint32_t canId, const string &data)
+    {
+        char out[CanSocket::FRAME_TEXT_MAX];
+        size_t len = CanSocket::FormatFrame(canId, reinterpret_cast<const uint8_t *>(data.data()), data.size(), out);
+        return string(out, len);
+    }
+} // namespace
+
+TEST(CanSocketTest, ParseFilter)
+{
+    CanSocket::Filter filter;
+    ASSERT_TRUE(CanSocket::ParseFilter("123:7FF", filter));
+    ASSERT_EQ(0x123U, filter.id);
+    ASSERT_EQ(0x7FFU, filter.mask);
+
+    // An identifier of 8 digits matches extended frames, and ~ inverts the filter.
+    ASSERT_TRUE(CanSocket::ParseFilter("00000100~1ffffff0", filter));
+    ASSERT_EQ(0x100U | CanSocket::EFF_FLAG | CanSocket::INV_FILTER, filter.id);
+    ASSERT_EQ(0x1FFFFFF0U, filter.mask);
+
+    ASSERT_FALSE(CanSocket::ParseFilter("123", filter));
+    ASSERT_FALSE(CanSocket::ParseFilter("12G:7FF", filter));
+    ASSERT_FALSE(CanSocket::ParseFilter(":7FF", filter));
+    ASSERT_FALSE(CanSocket::ParseFilter("123:123456789", filter));
+}
+
+TEST(CanSocketTest, FormatFrame)
+{
+    ASSERT_EQ("123#DEADBEEF", format(0x123, "\xde\xad\xbe\xef"));
+    ASSERT_EQ("00A#", format(0xA, ""));
+    ASSERT_EQ("1F334455#1122", format(0x1F334455 | CanSocket::EFF_FLAG, "\x11\x22"));
+    ASSERT_EQ("123#R", format(0x123 | CanSocket::RTR_FLAG, ""));
+
+    // The largest message fits FRAME_TEXT_MAX.
+    ASSERT_EQ(
+        CanSocket::FRAME_TEXT_MAX, format(0x1FFFFFFF | CanSocket::EFF_FLAG, string(8, '\xff')).size());
+}
+
+TEST(CanSocketTest, ReadsFilteredFramesFromVcan)
+{
+#if defined(__linux__)
+    // Requires a virtual CAN interface: ip link add dev vcan0 type vcan && ip link set up vcan0
+    if (if_nametoindex("vcan0") == 0)
+    {
+        GTEST_SKIP() << "vcan0 is not available";
+    }
+
+    // When frames are sent on the interface, then only frames matching the filters are read, back to back.
+    CanSocket socket({"100:700"});
+    aws_socket_endpoint endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    snprintf(endpoint.address, sizeof(endpoint.address), "vcan0");
+    bool connected = false;
+    ASSERT_EQ(
+        AWS_OP_SUCCESS,
+        socket.connect(
+            &endpoint,
+            nullptr,
+            [](struct aws_socket *, int error_code, void *user_data) {
+                *static_cast<bool *>(user_data) = error_code == AWS_OP_SUCCESS;
+            },
+            &connected));
+    ASSERT_TRUE(connected);
+    ASSERT_FALSE(socket.waits_for_address());
+
+    int fd = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    ASSERT_GE(fd, 0);
+    sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = static_cast<int>(if_nametoindex("vcan0"));
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)));
+    for (uint32_t id : {0x123U, 0x234U, 0x1FFU})
+    {
+        can_frame frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.can_id = id;
+        frame.can_dlc = 2;
+        frame.data[0] = 0xAB;
+        frame.data[1] = 0xCD;
+        ASSERT_EQ(static_cast<ssize_t>(sizeof(frame)), write(fd, &frame, sizeof(frame)));
+    }
+    ::close(fd);
+
+    uint8_t storage[256];
+    aws_byte_buf buf = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    size_t lengths[8];
+    size_t count = 0, truncated = 0;
+    ASSERT_EQ(AWS_OP_SUCCESS, socket.read_messages(&buf, 64, lengths, 8, &count, &truncated));
+    ASSERT_EQ(2, count);
+    ASSERT_EQ(0, truncated);
+    ASSERT_EQ("123#ABCD1FF#ABCD", string(reinterpret_cast<char *>(buf.buffer), buf.len));
+    ASSERT_EQ(8, lengths[0]);
+    ASSERT_EQ(8, lengths[1]);
+
+    ASSERT_EQ(AWS_OP_ERR, socket.read_messages(&buf, 64, lengths, 8, &count, &truncated));
+    ASSERT_EQ(AWS_IO_READ_WOULD_BLOCK, aws_last_error());
+    socket.close();
+#else
+    GTEST_SKIP() << "CAN sockets are only supported on Linux";
+#endif
+}
@@ -0,0 +1,75 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/CommandQueue.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    size_t push(CommandQueue &queue, const string &command)
+    {
+        return queue.push(reinterpret_cast<const uint8_t *>(command.data()), command.size());
+    }
+} // namespace
+
+TEST(CommandQueueTest, ParseDropPolicy)
+{
+    CommandQueue::DropPolicy policy;
+    ASSERT_TRUE(CommandQueue::ParseDropPolicy("newest", policy));
+    ASSERT_EQ(CommandQueue::DropPolicy::Newest, policy);
+    ASSERT_TRUE(CommandQueue::ParseDropPolicy("oldest", policy));
+    ASSERT_EQ(CommandQueue::DropPolicy::Oldest, policy);
+    ASSERT_FALSE(CommandQueue::ParseDropPolicy("random", policy));
+}
+
+TEST(CommandQueueTest, PopInOrder)
+{
+    CommandQueue queue(16, CommandQueue::DropPolicy::Oldest);
+    ASSERT_EQ(0, push(queue, "on"));
+    ASSERT_EQ(0, push(queue, "off"));
+    ASSERT_EQ(2, queue.size());
+    ASSERT_EQ(5, queue.bytes());
+
+    string command;
+    ASSERT_TRUE(queue.pop(command));
+    ASSERT_EQ("on", command);
+    ASSERT_TRUE(queue.pop(command));
+    ASSERT_EQ("off", command);
+    ASSERT_FALSE(queue.pop(command));
+    ASSERT_EQ(0, queue.bytes());
+}
+
+TEST(CommandQueueTest, DropNewest)
+{
+    // When a command does not fit, then the command itself is dropped.
+    CommandQueue queue(8, CommandQueue::DropPolicy::Newest);
+    ASSERT_EQ(0, push(queue, "aaaa"));
+    ASSERT_EQ(0, push(queue, "bbb"));
+    ASSERT_EQ(1, push(queue, "cc"));
+    ASSERT_EQ(2, queue.size());
+
+    string command;
+    ASSERT_TRUE(queue.pop(command));
+    ASSERT_EQ("aaaa", command);
+}
+
+TEST(CommandQueueTest, DropOldest)
+{
+    // When a command does not fit, then the oldest commands are dropped until it fits.
+    CommandQueue queue(8, CommandQueue::DropPolicy::Oldest);
+    ASSERT_EQ(0, push(queue, "aaa"));
+    ASSERT_EQ(0, push(queue, "bbb"));
+    ASSERT_EQ(2, push(queue, "cccccc"));
+    ASSERT_EQ(1, queue.size());
+
+    // Commands larger than the buffer never fit.
+    ASSERT_EQ(1, push(queue, "ddddddddd"));
+    string command;
+    ASSERT_TRUE(queue.pop(command));
+    ASSERT_EQ("cccccc", command);
+}
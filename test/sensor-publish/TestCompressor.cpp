@@ -0,0 +1,130 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/Compressor.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+
+#include <zlib.h>
+
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+#    include <zstd.h>
+#endif
+
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t MAX_INPUT_BYTES = 64 * 1024;
+
+    string makeBatch(size_t messages)
+    {
+        string batch;
+        for (size_t i = 0; i < messages; ++i)
+        {
+            batch += "{\"sensor\":\"temperature\",\"seq\":" + to_string(i) + ",\"value\":21.5}\n";
+        }
+        return batch;
+    }
+
+    string gunzip(const aws_byte_cursor &compressed, size_t maxLen)
+    {
+        string out(maxLen, '\0');
+        z_stream stream{};
+        EXPECT_EQ(Z_OK, inflateInit2(&stream, 15 + 16));
+        stream.next_in = compressed.ptr;
+        stream.avail_in = uInt(compressed.len);
+        stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+        stream.avail_out = uInt(out.size());
+        EXPECT_EQ(Z_STREAM_END, inflate(&stream, Z_FINISH));
+        out.resize(stream.total_out);
+        inflateEnd(&stream);
+        return out;
+    }
+
+    aws_byte_cursor cursorOf(const string &data)
+    {
+        return aws_byte_cursor_from_array(data.data(), data.size());
+    }
+} // namespace
+
+TEST(CompressorTest, ParseAlgorithm)
+{
+    Compressor::Algorithm algorithm;
+    ASSERT_TRUE(Compressor::ParseAlgorithm("deflate", algorithm));
+    ASSERT_EQ(Compressor::Algorithm::Deflate, algorithm);
+    ASSERT_TRUE(Compressor::ParseAlgorithm("zstd", algorithm));
+    ASSERT_EQ(Compressor::Algorithm::Zstd, algorithm);
+    ASSERT_FALSE(Compressor::ParseAlgorithm("none", algorithm));
+    ASSERT_FALSE(Compressor::ParseAlgorithm("lz4", algorithm));
+}
+
+TEST(CompressorTest, DeflateRoundTrip)
+{
+    Compressor compressor(aws_default_allocator(), Compressor::Algorithm::Deflate, MAX_INPUT_BYTES);
+
+    // The context is reused, so every batch must decompress on its own.
+    for (size_t messages : {100, 10, 300})
+    {
+        string batch = makeBatch(messages);
+        aws_byte_cursor compressed;
+        ASSERT_TRUE(compressor.compress(cursorOf(batch), compressed));
+        ASSERT_EQ(0x1f, compressed.ptr[0]);
+        ASSERT_EQ(0x8b, compressed.ptr[1]);
+        ASSERT_EQ(batch, gunzip(compressed, batch.size()));
+    }
+
+    string batch = makeBatch(300);
+    aws_byte_cursor compressed;
+    ASSERT_TRUE(compressor.compress(cursorOf(batch), compressed));
+    ASSERT_GT(batch.size(), compressed.len * 5);
+}
+
+TEST(CompressorTest, IncompressibleBatchIsNotCompressed)
+{
+    Compressor compressor(aws_default_allocator(), Compressor::Algorithm::Deflate, MAX_INPUT_BYTES);
+
+    string batch(4096, '\0');
+    srand(1);
+    for (char &c : batch)
+    {
+        c = static_cast<char>(rand());
+    }
+    aws_byte_cursor compressed;
+    ASSERT_FALSE(compressor.compress(cursorOf(batch), compressed));
+}
+
+TEST(CompressorTest, BatchLargerThanMaximumIsNotCompressed)
+{
+    Compressor compressor(aws_default_allocator(), Compressor::Algorithm::Deflate, 1024);
+
+    string batch(2048, 'x');
+    aws_byte_cursor compressed;
+    ASSERT_FALSE(compressor.compress(cursorOf(batch), compressed));
+    ASSERT_FALSE(compressor.compress(cursorOf(""), compressed));
+}
+
+#if !defined(EXCLUDE_SENSOR_PUBLISH_ZSTD)
+TEST(CompressorTest, ZstdRoundTrip)
+{
+    Compressor compressor(aws_default_allocator(), Compressor::Algorithm::Zstd, MAX_INPUT_BYTES);
+
+    for (size_t messages : {100, 300})
+    {
+        string batch = makeBatch(messages);
+        aws_byte_cursor compressed;
+        ASSERT_TRUE(compressor.compress(cursorOf(batch), compressed));
+
+        string out(batch.size(), '\0');
+        size_t len = ZSTD_decompress(&out[0], out.size(), compressed.ptr, compressed.len);
+        ASSERT_FALSE(ZSTD_isError(len));
+        out.resize(len);
+        ASSERT_EQ(batch, out);
+    }
+}
+#endif
@@ -0,0 +1,167 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/DatagramSocket.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/error.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class DatagramSocketTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/aws-iot-device-client-dgram-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirTemplate));
+        dir = dirTemplate;
+        path = dir + "/sensor";
+
+        memset(&endpoint, 0, sizeof(endpoint));
+        snprintf(endpoint.address, sizeof(endpoint.address), "%s", path.c_str());
+    }
+
+    void TearDown() override
+    {
+        unlink(path.c_str());
+        rmdir(dir.c_str());
+    }
+
+    void connect(DatagramSocket &socket)
+    {
+        connected = false;
+        ASSERT_EQ(
+            AWS_OP_SUCCESS,
+            socket.connect(
+                &endpoint,
+                nullptr,
+                [](struct aws_socket *, int error_code, void *user_data) {
+                    *static_cast<bool *>(user_data) = error_code == AWS_OP_SUCCESS;
+                },
+                &connected));
+        ASSERT_TRUE(connected);
+    }
+
+    void send(const string &message)
+    {
+        int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+        ASSERT_EQ(
+            static_cast<ssize_t>(message.size()),
+            sendto(fd, message.data(), message.size(), 0, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)));
+        ::close(fd);
+    }
+
+    string dir;
+    string path;
+    aws_socket_endpoint endpoint;
+    bool connected{false};
+};
+
+TEST_F(DatagramSocketTest, ReadsWholeMessagesBackToBack)
+{
+    // When several datagrams are queued, then they are read at once and stored back to back,
+    // and datagrams larger than a slot are dropped.
+    DatagramSocket socket(DatagramSocket::Type::UnixDatagram);
+    connect(socket);
+    struct stat st;
+    ASSERT_EQ(0, stat(path.c_str(), &st));
+    ASSERT_EQ(0660u, st.st_mode & 0777);
+
+    send("first");
+    send("message larger than a slot");
+    send("second");
+
+    uint8_t storage[64];
+    aws_byte_buf buf = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    size_t lengths[8];
+    size_t count = 0, truncated = 0;
+    ASSERT_EQ(AWS_OP_SUCCESS, socket.read_messages(&buf, 16, lengths, 8, &count, &truncated));
+    ASSERT_EQ(2u, count);
+    ASSERT_EQ(5u, lengths[0]);
+    ASSERT_EQ(6u, lengths[1]);
+    ASSERT_EQ("firstsecond", string(reinterpret_cast<const char *>(buf.buffer), buf.len));
+    ASSERT_GE(truncated, 16u);
+
+    ASSERT_EQ(AWS_OP_ERR, socket.read_messages(&buf, 16, lengths, 8, &count, &truncated));
+    ASSERT_EQ(AWS_IO_READ_WOULD_BLOCK, aws_last_error());
+}
+
+TEST_F(DatagramSocketTest, ReplacesStaleSocketFileAndRemovesItOnClose)
+{
+    // When a socket file is left at the address, then it is replaced, and it is removed once closed.
+    {
+        DatagramSocket stale(DatagramSocket::Type::UnixDatagram);
+        connect(stale);
+        ASSERT_EQ(0, link(path.c_str(), (path + ".stale").c_str()));
+    }
+    ASSERT_EQ(0, rename((path + ".stale").c_str(), path.c_str()));
+
+    DatagramSocket socket(DatagramSocket::Type::UnixDatagram);
+    connect(socket);
+    ASSERT_TRUE(socket.is_open());
+    ASSERT_EQ(AWS_OP_SUCCESS, socket.close());
+    ASSERT_FALSE(socket.is_open());
+    ASSERT_NE(0, access(path.c_str(), F_OK));
+}
+
+TEST_F(DatagramSocketTest, WritesMessagesToConnectedPeer)
+{
+    // When connected to a seqpacket server, then each write is received as one message,
+    // and sockets bound to their address cannot write.
+    int server = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+    ASSERT_EQ(0, ::bind(server, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)));
+    ASSERT_EQ(0, listen(server, 1));
+
+    DatagramSocket socket(DatagramSocket::Type::UnixSeqPacket);
+    connect(socket);
+    int peer = accept(server, nullptr, nullptr);
+    ASSERT_GE(peer, 0);
+
+    size_t written = 0;
+    auto onWritten = [](struct aws_socket *, int error_code, size_t bytes_written, void *user_data) {
+        *static_cast<size_t *>(user_data) += error_code == AWS_OP_SUCCESS ? bytes_written : 0;
+    };
+    aws_byte_cursor first = aws_byte_cursor_from_c_str("on");
+    aws_byte_cursor second = aws_byte_cursor_from_c_str("off");
+    ASSERT_EQ(AWS_OP_SUCCESS, socket.write(&first, onWritten, &written));
+    ASSERT_EQ(AWS_OP_SUCCESS, socket.write(&second, onWritten, &written));
+    ASSERT_EQ(5u, written);
+
+    char message[16];
+    ASSERT_EQ(2, recv(peer, message, sizeof(message), 0));
+    ASSERT_EQ("on", string(message, 2));
+    ASSERT_EQ(3, recv(peer, message, sizeof(message), 0));
+    ASSERT_EQ("off", string(message, 3));
+
+    // Once the peer is gone, writes report the socket closed.
+    ::close(peer);
+    ASSERT_EQ(AWS_OP_ERR, socket.write(&first, onWritten, &written));
+    ASSERT_EQ(AWS_IO_SOCKET_CLOSED, aws_last_error());
+    socket.close();
+    ::close(server);
+
+    DatagramSocket bound(DatagramSocket::Type::UnixDatagram);
+    connect(bound);
+    ASSERT_EQ(AWS_OP_ERR, bound.write(&first, onWritten, &written));
+    ASSERT_EQ(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error());
+}
@@ -0,0 +1,187 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/EomScanner.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    vector<size_t> scanAll(const EomScanner &scanner, const string &data)
+    {
+        vector<size_t> bounds;
+        scanner.scan(data.data(), data.data() + data.size(), [&bounds](size_t eom) {
+            bounds.push_back(eom);
+            return true;
+        });
+        return bounds;
+    }
+
+    vector<size_t> regexAll(const string &pattern, const string &data)
+    {
+        vector<size_t> bounds;
+        regex re(pattern);
+        for (auto m = cregex_iterator(data.data(), data.data() + data.size(), re), mend = cregex_iterator(); m != mend;
+             ++m)
+        {
+            bounds.push_back((*m).position() + (*m).length());
+        }
+        return bounds;
+    }
+} // namespace
+
+TEST(EomScanner, SelectsModeForPattern)
+{
+    EXPECT_EQ(EomScanner::Mode::Byte, EomScanner("\n").getMode());
+    EXPECT_EQ(EomScanner::Mode::Byte, EomScanner("\\n").getMode());
+    EXPECT_EQ(EomScanner::Mode::Byte, EomScanner("\\.").getMode());
+    EXPECT_EQ(EomScanner::Mode::Literal, EomScanner("\r\n").getMode());
+    EXPECT_EQ(EomScanner::Mode::Literal, EomScanner("\\r\\n").getMode());
+    EXPECT_EQ(EomScanner::Mode::Literal, EomScanner("<EOM>").getMode());
+    EXPECT_EQ(EomScanner::Mode::Literal, EomScanner("\\x1e\\x1f").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSet, EomScanner("[,]").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSet, EomScanner("[a-c;]").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSetRun, EomScanner("[,]+").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSetRun, EomScanner("[\\r\\n]+").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSetRun, EomScanner("[^a-z]+").getMode());
+    EXPECT_EQ(EomScanner::Mode::ByteSetRun, EomScanner("\\n+").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("\\d+").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("a|b").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("ab+").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("[,]*").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("[[:space:]]+").getMode());
+    EXPECT_EQ(EomScanner::Mode::Regex, EomScanner("^x$").getMode());
+}
+
+TEST(EomScanner, Lookbehind)
+{
+    EXPECT_EQ(0u, EomScanner("\n").lookbehind());
+    EXPECT_EQ(1u, EomScanner("\r\n").lookbehind());
+    EXPECT_EQ(4u, EomScanner("<EOM>").lookbehind());
+    EXPECT_EQ(0u, EomScanner("[,]+").lookbehind());
+    EXPECT_EQ(EomScanner::UNBOUNDED_LOOKBEHIND, EomScanner("\\d+").lookbehind());
+}
+
+TEST(EomScanner, InvalidRegexThrows)
+{
+    EXPECT_THROW(EomScanner("a(b"), regex_error);
+}
+
+TEST(EomScanner, ScanByte)
+{
+    EomScanner scanner("\n");
+    ASSERT_EQ(vector<size_t>({5, 10, 11}), scanAll(scanner, "msg1\nmsg2\n\nmsg3"));
+}
+
+TEST(EomScanner, ScanLiteral)
+{
+    EomScanner scanner("\r\n");
+    ASSERT_EQ(vector<size_t>({6, 13}), scanAll(scanner, "msg1\r\n\rmsg2\r\n\r"));
+
+    EomScanner longScanner("<EOM>");
+    ASSERT_EQ(vector<size_t>({9, 18}), scanAll(longScanner, "msg1<EOM>msg2<EOM>msg3<EOM"));
+}
+
+TEST(EomScanner, ScanByteSetRun)
+{
+    EomScanner scanner("[\\r\\n]+");
+    ASSERT_EQ(vector<size_t>({6, 13, 15}), scanAll(scanner, "msg1\r\nmsg2\n\n\rm\r"));
+}
+
+TEST(EomScanner, ScanStopsWhenCallbackReturnsFalse)
+{
+    EomScanner scanner(",");
+    string data = "a,b,c,d,";
+    vector<size_t> bounds;
+    scanner.scan(data.data(), data.data() + data.size(), [&bounds](size_t eom) {
+        bounds.push_back(eom);
+        return bounds.size() < 2;
+    });
+    ASSERT_EQ(vector<size_t>({2, 4}), bounds);
+}
+
+TEST(EomScanner, DelimiterBegin)
+{
+    auto delimiterAt = [](const EomScanner &scanner, const string &message) {
+        return scanner.delimiterBegin(message.data(), message.data() + message.size()) - message.data();
+    };
+    EXPECT_EQ(4, delimiterAt(EomScanner("\n"), "msg1\n"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("\r\n"), "msg1\r\n"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("<EOM>"), "msg1<EOM>"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("[,;]"), "msg1;"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("[\\r\\n]+"), "msg1\r\n\n"));
+    EXPECT_EQ(0, delimiterAt(EomScanner("[\\r\\n]+"), "\n\n"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("\\d+;"), "msgx1234;"));
+    EXPECT_EQ(4, delimiterAt(EomScanner("\n"), "msg1")); // No delimiter.
+}
+
+TEST(EomScanner, MatchesRegexOnRandomData)
+{
+    const vector<string> patterns = {
+        ",", "\n", "\\x00", "\r\n", "abc", "<EOM>", "abab", "[,]", "[,]+", "[\\r\\n]+", "[a-c]+", "[^d-z]", "[^a]+",
+        "a+", "[abcdefg]+"};
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, 7);
+    const string alphabet = "abcd,\r\n";
+
+    for (const auto &pattern : patterns)
+    {
+        EomScanner scanner(pattern);
+        for (int trial = 0; trial < 50; ++trial)
+        {
+            string data;
+            for (int i = 0; i < 200; ++i)
+            {
+                int k = dist(gen);
+                data.push_back(k < static_cast<int>(alphabet.size()) ? alphabet[k] : '\0');
+            }
+            ASSERT_EQ(regexAll(pattern, data), scanAll(scanner, data)) << "pattern: " << pattern;
+        }
+    }
+}
+
+/**
+ * Throughput of each search strategy compared with std::regex.
+ * Run with --gtest_also_run_disabled_tests --gtest_filter='EomScanner.DISABLED_*'
+ */
+TEST(EomScanner, DISABLED_BenchmarkThroughput)
+{
+    // 4 MB of 100 byte messages.
+    string data;
+    while (data.size() < 4 * 1024 * 1024)
+    {
+        data.append(96, 'x');
+        data.append("\r\n,;");
+    }
+
+    const vector<string> patterns = {"\n", "\r\n", "\r\n,;", "[,]+", "[\\r\\n]+", "[,;\\r\\n]+", "[\\n]+[,]?"};
+    for (const auto &pattern : patterns)
+    {
+        EomScanner scanner(pattern);
+        size_t count = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < 10; ++i)
+        {
+            scanner.scan(data.data(), data.data() + data.size(), [&count](size_t) {
+                ++count;
+                return true;
+            });
+        }
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        printf(
+            "pattern: %-12s mode: %d matches: %zu MB/s: %.1f\n",
+            regex_replace(pattern, regex("\r|\n"), "~").c_str(),
+            static_cast<int>(scanner.getMode()),
+            count,
+            10 * data.size() / elapsed.count() / (1024 * 1024));
+    }
+}
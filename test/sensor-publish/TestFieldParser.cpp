@@ -0,0 +1,66 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/FieldParser.h"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    size_t parse(FieldParser &parser, const string &message)
+    {
+        return parser.parse(reinterpret_cast<const uint8_t *>(message.data()), message.size());
+    }
+} // namespace
+
+TEST(FieldParserTest, ParseFormat)
+{
+    FieldParser::Format format;
+    ASSERT_TRUE(FieldParser::ParseFormat("json", format));
+    ASSERT_EQ(FieldParser::Format::Json, format);
+    ASSERT_TRUE(FieldParser::ParseFormat("csv", format));
+    ASSERT_EQ(FieldParser::Format::Csv, format);
+    ASSERT_FALSE(FieldParser::ParseFormat("xml", format));
+
+    size_t column;
+    ASSERT_TRUE(FieldParser::ParseColumn("12", column));
+    ASSERT_EQ(12, column);
+    ASSERT_FALSE(FieldParser::ParseColumn("temp", column));
+    ASSERT_FALSE(FieldParser::ParseColumn("-1", column));
+    ASSERT_FALSE(FieldParser::ParseColumn("", column));
+    ASSERT_THROW(FieldParser(FieldParser::Format::Csv, vector<string>{"temp"}), std::runtime_error);
+}
+
+TEST(FieldParserTest, Json)
+{
+    FieldParser parser(FieldParser::Format::Json, {"temp", "rh"});
+    ASSERT_EQ(2, parse(parser, R"({"id": "x,\"temp\":1", "temp" : -1.5e1, "rh":40})"));
+    ASSERT_EQ(-15, parser.value(0));
+    ASSERT_EQ(40, parser.value(1));
+
+    // Nested keys, strings and values which are not finite numbers are not found, and nothing is kept
+    // from the previous message.
+    ASSERT_EQ(0, parse(parser, R"({"meta":{"temp":1},"rh":"40","temp":1e999})"));
+    ASSERT_FALSE(parser.found(0));
+    ASSERT_FALSE(parser.found(1));
+    ASSERT_EQ(0, parse(parser, "not json"));
+}
+
+TEST(FieldParserTest, Csv)
+{
+    FieldParser parser(FieldParser::Format::Csv, {"0", "2"});
+    ASSERT_EQ(2, parse(parser, " 7 ,x,\"2.5\""));
+    ASSERT_EQ(7, parser.value(0));
+    ASSERT_EQ(2.5, parser.value(1));
+
+    ASSERT_EQ(1, parse(parser, "3,,"));
+    ASSERT_TRUE(parser.found(0));
+    ASSERT_FALSE(parser.found(1));
+    ASSERT_EQ(0, parse(parser, ""));
+}
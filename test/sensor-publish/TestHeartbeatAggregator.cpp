@@ -0,0 +1,171 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/HeartbeatAggregator.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/clock.h>
+#include <aws/crt/Types.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Aws::Iot;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class HeartbeatAggregatorFakeSocket : public Socket
+{
+  public:
+    void init(aws_allocator *allocator) override {}
+
+    int connect(
+        const struct aws_socket_endpoint *remote_endpoint,
+        struct aws_event_loop *event_loop,
+        aws_socket_on_connection_result_fn *on_connection_result,
+        void *user_data) override
+    {
+        return AWS_OP_SUCCESS;
+    }
+
+    int subscribe_to_readable_events(aws_socket_on_readable_fn *on_readable, void *user_data) override
+    {
+        return AWS_OP_SUCCESS;
+    }
+
+    bool is_open() override { return true; }
+
+    int read(aws_byte_buf *buf, std::size_t *amount_read) override { return AWS_OP_SUCCESS; }
+
+    int close() override { return AWS_OP_SUCCESS; }
+
+    void clean_up() override {}
+};
+
+class HeartbeatSensor : public Sensor
+{
+  public:
+    HeartbeatSensor(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        aws_allocator *allocator,
+        aws_event_loop *eventLoop)
+        : Sensor(settings, allocator, nullptr, eventLoop, std::make_shared<HeartbeatAggregatorFakeSocket>())
+    {
+    }
+
+    void setState(SensorState state) { mState = state; }
+
+    SensorCounters &counters() { return mCounters; }
+};
+
+class FakeHeartbeatAggregator : public HeartbeatAggregator
+{
+  public:
+    using HeartbeatAggregator::HeartbeatAggregator;
+
+    uint16_t mqttPublish(const aws_byte_cursor *payload) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        published.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+        return static_cast<uint16_t>(published.size());
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> published;
+};
+
+class HeartbeatAggregatorTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        allocator = aws_default_allocator();
+        eventLoop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+        for (const char *name : {"sensor-1", "sensor-\"2\""})
+        {
+            settings.emplace_back(new PlainConfig::SensorPublish::SensorSettings());
+            settings.back()->name = std::string(name);
+            settings.back()->addr = "my-sensor-server";
+            settings.back()->mqttTopic = "my-sensor-data";
+            settings.back()->eomDelimiter = "[,]+";
+            settings.back()->bufferCapacity = 1024;
+            sensors.emplace_back(new HeartbeatSensor(*settings.back(), allocator, eventLoop));
+        }
+    }
+
+    void TearDown() override
+    {
+        sensors.clear();
+        aws_event_loop_destroy(eventLoop);
+    }
+
+    HeartbeatSensor &sensor(size_t i) { return static_cast<HeartbeatSensor &>(*sensors[i]); }
+
+    aws_allocator *allocator;
+    aws_event_loop *eventLoop;
+    std::vector<std::unique_ptr<PlainConfig::SensorPublish::SensorSettings>> settings;
+    std::vector<std::unique_ptr<Sensor>> sensors;
+    std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection;
+};
+
+TEST_F(HeartbeatAggregatorTest, FormatConnectedSensors)
+{
+    // When no sensor is connected, then there is no heartbeat.
+    FakeHeartbeatAggregator aggregator(connection, eventLoop, sensors, "heartbeat", 1);
+    ASSERT_EQ(aggregator.format(1000), "");
+
+    // When sensors are connected, then each is listed with its counters.
+    sensor(0).setState(SensorState::Connected);
+    sensor(0).counters().bytesRead = 4096;
+    sensor(0).counters().batches = 12;
+    sensor(0).counters().droppedDuplicate = 1;
+    sensor(0).counters().droppedRateLimited = 2;
+    sensor(0).counters().discardedBytes = 5;
+    sensor(0).counters().publishFailed = 1;
+    ASSERT_EQ(
+        aggregator.format(1000),
+        "{\"time_ms\":1000,\"sensors\":[{\"name\":\"sensor-1\",\"state\":\"connected\",\"bytes_read\":4096,"
+        "\"batches\":12,\"dropped_messages\":3,\"discarded_bytes\":5,\"publish_failed\":1}]}");
+
+    sensor(1).setState(SensorState::Connected);
+    ASSERT_EQ(
+        aggregator.format(2000),
+        "{\"time_ms\":2000,\"sensors\":[{\"name\":\"sensor-1\",\"state\":\"connected\",\"bytes_read\":4096,"
+        "\"batches\":12,\"dropped_messages\":3,\"discarded_bytes\":5,\"publish_failed\":1},"
+        "{\"name\":\"sensor-\\\"2\\\"\",\"state\":\"connected\",\"bytes_read\":0,\"batches\":0,"
+        "\"dropped_messages\":0,\"discarded_bytes\":0,\"publish_failed\":0}]}");
+
+    // When a sensor disconnects, then it is left out.
+    sensor(0).setState(SensorState::Connecting);
+    ASSERT_EQ(aggregator.format(3000).find("sensor-1"), std::string::npos);
+}
+
+TEST_F(HeartbeatAggregatorTest, PublishOneMessagePerInterval)
+{
+    // When started, then one message is published every interval for all sensors.
+    sensor(0).setState(SensorState::Connected);
+    sensor(1).setState(SensorState::Connected);
+    aws_event_loop_run(eventLoop);
+
+    FakeHeartbeatAggregator aggregator(connection, eventLoop, sensors, "heartbeat", 1);
+    aggregator.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    aggregator.stop();
+
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    std::lock_guard<std::mutex> lock(aggregator.mutex);
+    ASSERT_EQ(aggregator.published.size(), 1);
+    ASSERT_NE(aggregator.published[0].find("sensor-1"), std::string::npos);
+    ASSERT_NE(aggregator.published[0].find("sensor-\\\"2\\\""), std::string::npos);
+}
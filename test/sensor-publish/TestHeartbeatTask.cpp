@@ -11,6 +11,7 @@
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -50,7 +51,7 @@ class HeartbeatTaskTest : public ::testing::Test
 
     void TearDown() override { aws_event_loop_destroy(eventLoop); }
 
-    SensorState state;
+    std::atomic<SensorState> state;
     PlainConfig::SensorPublish::SensorSettings settings;
     std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection;
     aws_event_loop *eventLoop;
@@ -60,7 +61,7 @@ struct MockHeartbeatTask : public HeartbeatTask
 {
   public:
     MockHeartbeatTask(
-        const SensorState &state,
+        const std::atomic<SensorState> &state,
         const PlainConfig::SensorPublish::SensorSettings &settings,
         std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
         aws_event_loop *eventLoop)
@@ -0,0 +1,74 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/LatencyHistogram.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+TEST(LatencyHistogramTest, Buckets)
+{
+    // Small values are counted exactly, larger values in buckets of 1/16 of their power of two.
+    ASSERT_EQ(0, LatencyHistogram::BucketOf(0));
+    ASSERT_EQ(15, LatencyHistogram::BucketOf(15));
+    ASSERT_EQ(16, LatencyHistogram::BucketOf(16));
+    ASSERT_EQ(31, LatencyHistogram::BucketOf(31));
+    ASSERT_EQ(32, LatencyHistogram::BucketOf(32));
+    ASSERT_EQ(32, LatencyHistogram::BucketOf(33));
+    ASSERT_EQ(33, LatencyHistogram::BucketOf(34));
+    ASSERT_EQ(LatencyHistogram::BUCKETS - 1, LatencyHistogram::BucketOf(UINT64_MAX));
+
+    for (uint64_t value : {uint64_t(1), uint64_t(100), uint64_t(1000), uint64_t(123456), uint64_t(1) << 31})
+    {
+        size_t bucket = LatencyHistogram::BucketOf(value);
+        ASSERT_GE(LatencyHistogram::BucketMax(bucket), value);
+        ASSERT_LE(LatencyHistogram::BucketMax(bucket) - value, value / LatencyHistogram::SUB_BUCKETS);
+        ASSERT_EQ(bucket, LatencyHistogram::BucketOf(LatencyHistogram::BucketMax(bucket)));
+    }
+}
+
+TEST(LatencyHistogramTest, Percentiles)
+{
+    LatencyHistogram histogram;
+    ASSERT_EQ(0, histogram.percentile(0.5));
+
+    for (uint64_t value = 1; value <= 100; ++value)
+    {
+        histogram.record(value * 1000);
+    }
+    LatencyHistogram::Snapshot snapshot = histogram.snapshot();
+    ASSERT_EQ(100, snapshot.count);
+    ASSERT_EQ(100000, snapshot.max);
+    ASSERT_GE(snapshot.p50, 50000);
+    ASSERT_LE(snapshot.p50, 50000 + 50000 / LatencyHistogram::SUB_BUCKETS);
+    ASSERT_GE(snapshot.p99, 99000);
+    ASSERT_LE(snapshot.p99, snapshot.max);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecords)
+{
+    // Records from several threads are all counted.
+    LatencyHistogram histogram;
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&histogram, t]() {
+            for (uint64_t i = 0; i < 10000; ++i)
+            {
+                histogram.record(i + static_cast<uint64_t>(t));
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(40000, histogram.count());
+    ASSERT_EQ(10002, histogram.max());
+    ASSERT_EQ(10002, histogram.percentile(1.0));
+}
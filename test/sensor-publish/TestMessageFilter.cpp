@@ -0,0 +1,95 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/MessageFilter.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+using Verdict = MessageFilter::Verdict;
+
+namespace
+{
+    Verdict check(MessageFilter &filter, const string &message, MessageFilter::Clock::time_point now = {})
+    {
+        return filter.check(reinterpret_cast<const uint8_t *>(message.data()), message.size(), now);
+    }
+} // namespace
+
+TEST(MessageFilterTest, DropDuplicates)
+{
+    // Only a repeat of the last kept message is dropped.
+    MessageFilter filter(true, nullptr, 0, 0);
+    ASSERT_EQ(Verdict::Keep, check(filter, "21.5"));
+    ASSERT_EQ(Verdict::Duplicate, check(filter, "21.5"));
+    ASSERT_EQ(Verdict::Duplicate, check(filter, "21.5"));
+    ASSERT_EQ(Verdict::Keep, check(filter, "21.6"));
+    ASSERT_EQ(Verdict::Keep, check(filter, "21.5"));
+    ASSERT_EQ(Verdict::Keep, check(filter, "21.5 "));
+}
+
+TEST(MessageFilterTest, Deadband)
+{
+    // A message is dropped while every field it holds stays within the deadband of the last kept value.
+    unique_ptr<FieldParser> fields(new FieldParser(FieldParser::Format::Json, {"temp", "rh"}));
+    MessageFilter filter(false, move(fields), 0.5, 0);
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"temp":20.0})"));
+    ASSERT_EQ(Verdict::Deadband, check(filter, R"({"temp":20.5})"));
+    ASSERT_EQ(Verdict::Deadband, check(filter, R"({"temp":19.6})"));
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"temp":20.0,"rh":40})")); // First value of rh.
+    ASSERT_EQ(Verdict::Deadband, check(filter, R"({"temp":20.1,"rh":40.4})"));
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"temp":20.1,"rh":41})"));
+
+    // Drift is measured from the last kept value, not the last received value.
+    ASSERT_EQ(Verdict::Deadband, check(filter, R"({"temp":20.5})"));
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"temp":20.7})"));
+
+    // Messages without any of the fields are kept.
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"status":"ok"})"));
+    ASSERT_EQ(Verdict::Keep, check(filter, R"({"status":"ok"})"));
+}
+
+TEST(MessageFilterTest, TokenBucket)
+{
+    // Bursts of up to one second of messages are kept, then messages are kept at the configured rate.
+    MessageFilter filter(false, nullptr, 0, 10);
+    MessageFilter::Clock::time_point now{chrono::seconds{1}};
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(Verdict::Keep, check(filter, "m", now));
+    }
+    ASSERT_EQ(Verdict::RateLimited, check(filter, "m", now));
+
+    now += chrono::milliseconds{150};
+    ASSERT_EQ(Verdict::Keep, check(filter, "m", now));
+    ASSERT_EQ(Verdict::RateLimited, check(filter, "m", now));
+
+    // Idle time earns at most one second of messages.
+    now += chrono::seconds{10};
+    int kept = 0;
+    while (check(filter, "m", now) == Verdict::Keep)
+    {
+        ++kept;
+    }
+    ASSERT_EQ(10, kept);
+}
+
+TEST(MessageFilterTest, OnlyKeptMessagesUpdateFilters)
+{
+    // A message dropped by the rate filter is not the last kept message, so its repeat is kept once
+    // the rate allows it.
+    MessageFilter filter(true, nullptr, 0, 1);
+    MessageFilter::Clock::time_point now{chrono::seconds{1}};
+    ASSERT_EQ(Verdict::Keep, check(filter, "a", now));
+    ASSERT_EQ(Verdict::RateLimited, check(filter, "b", now));
+    ASSERT_EQ(Verdict::Duplicate, check(filter, "a", now));
+
+    now += chrono::seconds{1};
+    ASSERT_EQ(Verdict::Keep, check(filter, "b", now));
+}
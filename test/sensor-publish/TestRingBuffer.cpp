@@ -0,0 +1,268 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/RingBuffer.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    /**
+     * Write data into the ring buffer and store a boundary after each ','
+     */
+    size_t writeData(RingBuffer &ring, const string &data)
+    {
+        aws_byte_buf buf = ring.writableSpace();
+        size_t count = min(buf.capacity, data.size());
+        memcpy(buf.buffer, data.data(), count);
+        size_t start = ring.writeEnd();
+        ring.commitWrite(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (data[i] == ',')
+            {
+                ring.pushEom(start + i + 1);
+            }
+        }
+        ring.setScanned(ring.writeEnd());
+        return count;
+    }
+
+    string peekString(RingBuffer &ring, size_t &count)
+    {
+        aws_byte_cursor cursor = ring.peek(count);
+        return string(reinterpret_cast<const char *>(cursor.ptr), cursor.len);
+    }
+} // namespace
+
+class RingBufferTest : public ::testing::Test
+{
+  public:
+    void SetUp() override { allocator = aws_default_allocator(); }
+
+    aws_allocator *allocator;
+};
+
+TEST_F(RingBufferTest, PeekAndConsume)
+{
+    RingBuffer ring(allocator, 16, 4);
+    ASSERT_EQ(9u, writeData(ring, "aa,bb,cc,"));
+    ASSERT_EQ(3u, ring.eomCount());
+    ASSERT_EQ(9u, ring.size());
+
+    size_t count = 2;
+    ASSERT_EQ("aa,bb,", peekString(ring, count));
+    ASSERT_EQ(2u, count);
+    ring.consume(count);
+    ASSERT_EQ(3u, ring.size());
+
+    count = 5;
+    ASSERT_EQ("cc,", peekString(ring, count));
+    ASSERT_EQ(1u, count);
+}
+
+TEST_F(RingBufferTest, EmptyBufferRestartsAtBeginning)
+{
+    // When all data is published, then reading restarts at the start of the buffer without copying.
+    RingBuffer ring(allocator, 16, 4);
+    writeData(ring, "aa,bb,");
+    size_t count = 2;
+    ring.peek(count);
+    ring.consume(count);
+
+    ASSERT_EQ(0u, ring.size());
+    ASSERT_EQ(16u, ring.writableSpace().capacity);
+}
+
+TEST_F(RingBufferTest, WrapWithoutCompleteMessagesMovesPartial)
+{
+    // When the end of the buffer is reached and only a partial message remains,
+    // then the partial message is moved to the start of the buffer.
+    RingBuffer ring(allocator, 16, 4);
+    ASSERT_EQ(16u, writeData(ring, "0123456789,abcde"));
+    size_t count = 1;
+    ring.peek(count);
+    ring.consume(count);
+
+    aws_byte_buf buf = ring.writableSpace();
+    ASSERT_EQ(11u, buf.capacity);
+    ASSERT_EQ(5u, ring.size());
+    ASSERT_EQ(5u, ring.scanned());
+    ASSERT_EQ("abcde", string(reinterpret_cast<const char *>(ring.data()), 5));
+}
+
+TEST_F(RingBufferTest, WrapKeepsCompleteMessagesInPlace)
+{
+    // When the end of the buffer is reached with unpublished complete messages,
+    // then only the partial message is moved and the complete messages are published from where they are.
+    RingBuffer ring(allocator, 16, 8);
+    ASSERT_EQ(16u, writeData(ring, "aaaaa,bb,cc,dddd"));
+    size_t count = 1;
+    ASSERT_EQ("aaaaa,", peekString(ring, count));
+    ring.consume(count);
+    ASSERT_FALSE(ring.full());
+
+    // Partial message is moved, leaving two bytes until the oldest unpublished message.
+    ASSERT_EQ(2u, writeData(ring, "e,"));
+    ASSERT_TRUE(ring.hasEomInWriteSegment());
+    ASSERT_EQ(6u, ring.messageBegin());
+    ASSERT_EQ(12u, ring.size());
+    ASSERT_TRUE(ring.full());
+
+    // A batch never spans the wrap point.
+    count = 3;
+    ASSERT_EQ("bb,cc,", peekString(ring, count));
+    ASSERT_EQ(2u, count);
+    ring.consume(count);
+
+    count = 3;
+    ASSERT_EQ("dddde,", peekString(ring, count));
+    ASSERT_EQ(1u, count);
+    ring.consume(count);
+    ASSERT_EQ(0u, ring.size());
+}
+
+TEST_F(RingBufferTest, NoWrapWhenPartialDoesNotFit)
+{
+    // When the partial message does not fit before the oldest unpublished message,
+    // then the buffer is full until more messages are published.
+    RingBuffer ring(allocator, 16, 8);
+    writeData(ring, "aa,bb,cccccccccc");
+    size_t count = 1;
+    ring.peek(count);
+    ring.consume(count);
+
+    ASSERT_TRUE(ring.full());
+    ASSERT_EQ(0u, ring.writableSpace().capacity);
+
+    count = 1;
+    ring.peek(count);
+    ring.consume(count);
+    ASSERT_FALSE(ring.full());
+    ASSERT_EQ(6u, ring.writableSpace().capacity);
+}
+
+TEST_F(RingBufferTest, FullWithoutMessages)
+{
+    RingBuffer ring(allocator, 16, 8);
+    writeData(ring, "0123456789abcdef");
+    ASSERT_TRUE(ring.full());
+    ASSERT_EQ(0u, ring.eomCount());
+
+    ring.reset();
+    ASSERT_FALSE(ring.full());
+    ASSERT_EQ(0u, ring.size());
+}
+
+TEST_F(RingBufferTest, WrapWhenLessThanMinSpaceAtEnd)
+{
+    // When whole messages need minSpace contiguous bytes, then the write segment wraps as soon as less than
+    // minSpace bytes are free at the end, and the buffer is full while less than minSpace bytes are free.
+    RingBuffer ring(allocator, 16, 8);
+    writeData(ring, "aaaaa,bbbbb,");
+    ASSERT_FALSE(ring.full(4));
+    ASSERT_TRUE(ring.full(5));
+    ASSERT_EQ(4u, ring.writableSpace(5).capacity); // Nothing consumed yet, so no room at the start.
+
+    size_t count = 1;
+    ring.peek(count);
+    ring.consume(count);
+    ASSERT_FALSE(ring.full(5));
+    aws_byte_buf buf = ring.writableSpace(5);
+    ASSERT_EQ(6u, buf.capacity);
+    ASSERT_EQ(0u, ring.writeEnd());
+}
+
+TEST_F(RingBufferTest, EomRingFull)
+{
+    RingBuffer ring(allocator, 16, 2);
+    ASSERT_TRUE(ring.pushEom(1));
+    ASSERT_TRUE(ring.pushEom(2));
+    ASSERT_TRUE(ring.eomFull());
+    ASSERT_FALSE(ring.pushEom(3));
+    ASSERT_EQ(2u, ring.eomCount());
+    ASSERT_EQ(1u, ring.eomAt(0));
+    ASSERT_EQ(2u, ring.eomAt(1));
+}
+
+TEST_F(RingBufferTest, EomTimes)
+{
+    RingBuffer untimed(allocator, 16, 2);
+    ASSERT_TRUE(untimed.pushEom(1, 1000));
+    ASSERT_EQ(0u, untimed.eomTimeAt(0));
+
+    // Times follow their boundary around the ring.
+    RingBuffer ring(allocator, 16, 2, true);
+    ASSERT_TRUE(ring.pushEom(3, 1000));
+    ASSERT_TRUE(ring.pushEom(6, 2000));
+    ring.consume(1);
+    ASSERT_TRUE(ring.pushEom(9, 3000));
+    ASSERT_EQ(2000u, ring.eomTimeAt(0));
+    ASSERT_EQ(3000u, ring.eomTimeAt(1));
+}
+
+TEST_F(RingBufferTest, RemoveMessagesOfWriteSegment)
+{
+    // Removed messages are closed up with the following messages and the partial message, and the boundaries
+    // of kept messages move with them. Messages before the wrap are untouched.
+    RingBuffer ring(allocator, 32, 8);
+    writeData(ring, "aaaaaaaaaaaa,bbbbbbb,");
+    size_t count = 1;
+    ring.peek(count);
+    ring.consume(count);
+    writeData(ring, "cccccccccc,");
+    size_t first = ring.eomCount();
+    writeData(ring, "dd,e,ff,g");
+    ASSERT_EQ(5u, ring.eomCount());
+    ASSERT_EQ(9u, ring.writeEnd()); // Wrapped, with "bbbbbbb,cccccccccc," in the front segment.
+
+    size_t removed = ring.removeMessages(first, [](size_t begin, size_t end) { return end - begin != 3; });
+    ASSERT_EQ(1u, removed);
+    ASSERT_EQ(4u, ring.eomCount());
+    ASSERT_EQ(7u, ring.writeEnd());
+    ASSERT_EQ(ring.writeEnd(), ring.scanned());
+    ASSERT_EQ("dd,ff,g", string(reinterpret_cast<const char *>(ring.data()), ring.writeEnd()));
+    ASSERT_EQ(3u, ring.eomAt(2));
+    ASSERT_EQ(6u, ring.eomAt(3));
+
+    count = 4;
+    ASSERT_EQ("bbbbbbb,cccccccccc,", peekString(ring, count));
+    ASSERT_EQ(2u, count);
+}
+
+TEST_F(RingBufferTest, BorrowsBlockFromPoolWhileNotEmpty)
+{
+    // The block is borrowed on the first write and returned once every message is consumed.
+    auto pool = make_shared<BufferPool>(allocator, 0);
+    RingBuffer ring(allocator, 16, 4, false, pool);
+    ASSERT_FALSE(ring.allocated());
+    ASSERT_EQ(0u, pool->inUseBytes());
+
+    writeData(ring, "aa,bb,c");
+    ASSERT_TRUE(ring.allocated());
+    ASSERT_EQ(ring.blockSize(), pool->inUseBytes());
+
+    size_t count = 2;
+    ASSERT_EQ("aa,bb,", peekString(ring, count));
+    ring.consume(count);
+    ASSERT_TRUE(ring.allocated()); // Partial message is still buffered.
+
+    ring.reset();
+    ASSERT_FALSE(ring.allocated());
+    ASSERT_EQ(0u, pool->inUseBytes());
+
+    // When the pool has no room for the block, then there is no space to write into.
+    auto exhausted = make_shared<BufferPool>(allocator, 1);
+    RingBuffer starved(allocator, 16, 4, false, exhausted);
+    ASSERT_EQ(0u, starved.writableSpace().capacity);
+    ASSERT_FALSE(starved.allocated());
+}
@@ -12,9 +12,16 @@
 #include <aws/crt/mqtt/MqttClient.h>
 #include <aws/io/event_loop.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
 #include <memory>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 using namespace Aws::Iot;
@@ -23,6 +30,7 @@ using namespace Aws::Iot::DeviceClient::SensorPublish;
 
 using ::testing::_;
 using ::testing::ElementsAre;
+using ::testing::Invoke;
 using ::testing::NiceMock;
 
 class SensorTest : public ::testing::Test
@@ -61,11 +69,17 @@ class MockSensor : public Sensor
         aws_allocator *allocator,
         std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
         aws_event_loop *eventLoop,
-        std::shared_ptr<Socket> socket)
-        : Sensor(settings, allocator, connection, eventLoop, socket)
+        std::shared_ptr<Socket> socket,
+        std::shared_ptr<BufferPool> bufferPool = nullptr,
+        std::shared_ptr<Aggregator> aggregator = nullptr)
+        : Sensor(settings, allocator, connection, eventLoop, socket, bufferPool, aggregator)
     {
     }
 
+    void call_connect(bool delay) { Sensor::connect(delay); }
+
+    void call_scheduleReadRetry() { Sensor::scheduleReadRetry(); }
+
     void call_onConnectTaskCallback() { onConnectTaskCallback(); }
 
     void call_onConnectionResultCallback(int error_code) { onConnectionResultCallback(error_code); }
@@ -74,8 +88,6 @@ class MockSensor : public Sensor
 
     bool needPublish(size_t &bufferSize, size_t &numBatches) { return Sensor::needPublish(bufferSize, numBatches); }
 
-    SensorState getState() const { return mState; }
-
     void nextPublishTimeout(int64_t delay_ms)
     {
         mNextPublishTimeout = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds{delay_ms};
@@ -85,37 +97,119 @@ class MockSensor : public Sensor
     {
         for (size_t i = 1; i <= count; ++i)
         {
-            mEomBounds.push(i);
+            mReadBuf.pushEom(i);
+        }
+    }
+
+    void writeReadBuf(size_t count) { mReadBuf.commitWrite(count); }
+
+    void readMessages(const std::string &data)
+    {
+        aws_byte_buf space = mReadBuf.writableSpace();
+        size_t begin = mReadBuf.writeEnd();
+        aws_byte_buf_write(&space, reinterpret_cast<const uint8_t *>(data.data()), data.size());
+        mReadBuf.commitWrite(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (data[i] == ',')
+            {
+                mReadBuf.pushEom(begin + i + 1);
+            }
         }
+        mReadBuf.setScanned(mReadBuf.writeEnd());
     }
 
-    void writeReadBuf(size_t count) { mReadBuf.len += count; }
+    void consumeMessages(size_t count) { mReadBuf.consume(count); }
 
-    size_t getReadBufLen() const { return mReadBuf.len; }
+    size_t getReadBufLen() const { return mReadBuf.size(); }
 
-    size_t getEomBoundsSize() const { return mEomBounds.size(); }
+    bool holdsReadBuf() const { return mReadBuf.allocated(); }
+
+    size_t getReadBufBlockSize() const { return mReadBuf.blockSize(); }
+
+    size_t getEomBoundsSize() const { return mReadBuf.eomCount(); }
 
     std::vector<size_t> getEomBounds() const
     {
-        auto copyEomBounds(mEomBounds);
         std::vector<size_t> bounds;
-        while (!copyEomBounds.empty())
+        for (size_t i = 0; i < mReadBuf.eomCount(); ++i)
         {
-            bounds.push_back(copyEomBounds.front());
-            copyEomBounds.pop();
+            bounds.push_back(mReadBuf.eomAt(i));
         }
         return bounds;
     }
 
+    void call_publishOneMessage(
+        const std::string &payload,
+        LatencyClock::time_point readTime = LatencyClock::time_point())
+    {
+        aws_byte_cursor cursor = aws_byte_cursor_from_c_str(payload.c_str());
+        publishOneMessage(&cursor, readTime);
+    }
+
+    void call_drainSpool() { drainSpool(); }
+
+    void call_publish() { Sensor::publish(); }
+
+    void call_onResumeTaskCallback() { onResumeTaskCallback(); }
+
+    void setDeadLetterRetryDelay(int64_t delay_ms) { mDeadLetterRetryDelay = std::chrono::milliseconds{delay_ms}; }
+
+    void call_onPublishComplete(size_t index, int errorCode)
+    {
+        onPublishComplete(mqttPublished[index].context, static_cast<uint16_t>(index + 1), errorCode);
+    }
+
+    uint16_t mqttPublish(const aws_byte_cursor *topic, const aws_byte_cursor *payload, PublishContext *context)
+        override
+    {
+        mqttPublished.push_back(
+            {std::string(reinterpret_cast<const char *>(topic->ptr), topic->len),
+             std::string(reinterpret_cast<const char *>(payload->ptr), payload->len),
+             context});
+        if (mqttPublishFails)
+        {
+            aws_raise_error(AWS_IO_SOCKET_CLOSED);
+            return 0;
+        }
+        return static_cast<uint16_t>(mqttPublished.size());
+    }
+
+    struct MqttPublished
+    {
+        std::string topic;
+        std::string payload;
+        PublishContext *context;
+    };
+    std::vector<MqttPublished> mqttPublished;
+    bool mqttPublishFails{false};
+
+    uint16_t mqttSubscribe(const aws_byte_cursor *topic) override
+    {
+        mqttSubscribed = std::string(reinterpret_cast<const char *>(topic->ptr), topic->len);
+        return 1;
+    }
+
+    void mqttUnsubscribe(const aws_byte_cursor *) override { mqttSubscribed.clear(); }
+
+    void call_onCommandReceived(const std::string &command)
+    {
+        aws_byte_cursor cursor = aws_byte_cursor_from_array(command.data(), command.size());
+        onCommandReceived(&cursor);
+    }
+
+    std::string mqttSubscribed;
+
     MOCK_METHOD(void, connect, (bool delay), (override));
     MOCK_METHOD(void, publish, (), (override));
     MOCK_METHOD(void, close, (), (override));
+    MOCK_METHOD(void, scheduleReadRetry, (), (override));
 };
 
 class FakeSocket : public Socket
 {
   public:
-    void init(aws_allocator *allocator, aws_socket_options *options) override {}
+    void init(aws_allocator *allocator) override {}
 
     int connect(
         const struct aws_socket_endpoint *remote_endpoint,
@@ -199,6 +293,113 @@ TEST_F(SensorTest, SensorSocketConnectionResultSuccess)
     ASSERT_EQ(socket->count, 1);
 }
 
+class FakeSocketConnectsOnceAddrExists : public FakeSocket
+{
+  public:
+    int connect(
+        const struct aws_socket_endpoint *remote_endpoint,
+        struct aws_event_loop *event_loop,
+        aws_socket_on_connection_result_fn *on_connection_result,
+        void *user_data) override
+    {
+        ++attempts;
+        if (access(remote_endpoint->address, F_OK) != 0)
+        {
+            return aws_raise_error(AWS_IO_SOCKET_CONNECTION_REFUSED);
+        }
+        on_connection_result(nullptr, AWS_OP_SUCCESS, user_data);
+        connected = true;
+        return AWS_OP_SUCCESS;
+    }
+    std::atomic<int> attempts{0};
+    std::atomic<bool> connected{false};
+};
+
+TEST_F(SensorTest, ReconnectWhenAddrCreated)
+{
+    // When the sensor server creates its socket file while the sensor waits to poll the address again,
+    // then reconnect immediately instead of after addr_poll_sec.
+    char addrDir[] = "/tmp/aws-iot-device-client-sensor-addr-XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(addrDir));
+    std::string addr = std::string(addrDir) + "/sensor";
+    settings.addr = addr;
+    settings.addrPollSec = 3600;
+    auto socket = std::make_shared<FakeSocketConnectsOnceAddrExists>();
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+    ON_CALL(sensor, connect(_)).WillByDefault(Invoke([&sensor](bool delay) { sensor.call_connect(delay); }));
+
+    aws_task connectTask;
+    aws_task_init(
+        &connectTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) { static_cast<MockSensor *>(arg)->call_connect(false); },
+        &sensor,
+        __func__);
+    aws_event_loop_run(eventLoop);
+    aws_event_loop_schedule_task_now(eventLoop, &connectTask);
+
+    // The first attempt fails, and the next poll is an hour away.
+    for (int i = 0; i < 1000 && socket->attempts == 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    ASSERT_EQ(socket->attempts, 1);
+    ASSERT_FALSE(socket->connected);
+
+    FILE *file = fopen(addr.c_str(), "w");
+    ASSERT_NE(nullptr, file);
+    fclose(file);
+    for (int i = 0; i < 1000 && !socket->connected; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_TRUE(socket->connected);
+    ASSERT_EQ(socket->attempts, 2);
+    ASSERT_EQ(sensor.getState(), SensorState::Connected);
+    unlink(addr.c_str());
+    rmdir(addrDir);
+}
+
+TEST_F(SensorTest, StopCancelsTasksFromAnotherThread)
+{
+    // When the sensor is stopped and destroyed from another thread than the event loop while a task is scheduled,
+    // then the task is cancelled on the event loop before the sensor is gone, and never runs.
+    auto socket = std::make_shared<FakeSocket>();
+    aws_event_loop_run(eventLoop);
+    {
+        NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+        sensor.call_scheduleReadRetry();
+        sensor.stop();
+        sensor.call_scheduleReadRetry();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+}
+
+TEST_F(SensorTest, StopReturnsReadBufferAfterCancellingTasks)
+{
+    // When the sensor is stopped from another thread than the event loop while a task is scheduled,
+    // then the read buffer is returned to the buffer pool once the task is cancelled.
+    auto pool = std::make_shared<BufferPool>(allocator, 64 * 1024);
+    auto socket = std::make_shared<FakeSocket>();
+    aws_event_loop_run(eventLoop);
+    {
+        NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket, pool);
+        sensor.readMessages("msg1,msg");
+        ASSERT_TRUE(sensor.holdsReadBuf());
+        sensor.call_scheduleReadRetry();
+        sensor.stop();
+        ASSERT_FALSE(sensor.holdsReadBuf());
+        ASSERT_EQ(pool->inUseBytes(), 0);
+    }
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+}
+
 TEST_F(SensorTest, SensorSocketConnectionResultFails)
 {
     // When connect result callback returns success,
@@ -566,3 +767,788 @@ TEST_F(SensorTest, NeedPublishNoMessages)
     ASSERT_EQ(bufferSize, 0);
     ASSERT_EQ(numBatches, 0);
 }
+
+TEST_F(SensorTest, PublishFailedWithoutDeadLetterTopic)
+{
+    // When a publish fails and no dead-letter topic is configured,
+    // then the failure is counted and the message data is discarded.
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_publishOneMessage("msg1,");
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].topic, "my-sensor-data");
+
+    sensor.call_onPublishComplete(0, AWS_IO_SOCKET_CLOSED);
+    ASSERT_EQ(sensor.mqttPublished.size(), 1); // No republish.
+    ASSERT_EQ(sensor.getCounters().publishFailed, 1);
+    ASSERT_EQ(sensor.getCounters().deadLetterFailed, 0);
+}
+
+TEST_F(SensorTest, PublishSucceeds)
+{
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_publishOneMessage("msg1,");
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    ASSERT_EQ(sensor.getCounters().published, 1);
+    ASSERT_EQ(sensor.getCounters().publishFailed, 0);
+}
+
+TEST_F(SensorTest, PublishRecordsLatency)
+{
+    // When a batch read 5ms ago is published and acknowledged,
+    // then its queue, ack and total latency are recorded.
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    auto readTime = std::chrono::steady_clock::now() - std::chrono::milliseconds(5);
+    sensor.call_publishOneMessage("msg1,", readTime);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    const SensorLatency &latency = sensor.getLatency();
+    ASSERT_EQ(latency.queue.count(), 1);
+    ASSERT_GE(latency.queue.max(), 5000);
+    ASSERT_EQ(latency.ack.count(), 1);
+    ASSERT_EQ(latency.total.count(), 1);
+    ASSERT_GE(latency.total.max(), latency.queue.max());
+
+    // Failed publishes and batches without a read time only count towards what is known.
+    sensor.call_publishOneMessage("msg2,");
+    sensor.call_onPublishComplete(1, AWS_IO_SOCKET_CLOSED);
+    sensor.call_publishOneMessage("msg3,");
+    sensor.call_onPublishComplete(2, AWS_OP_SUCCESS);
+    ASSERT_EQ(latency.queue.count(), 1);
+    ASSERT_EQ(latency.ack.count(), 2);
+    ASSERT_EQ(latency.total.count(), 1);
+}
+
+TEST_F(SensorTest, PublishFailedRoutesToDeadLetterTopic)
+{
+    // When a publish fails and a dead-letter topic is configured,
+    // then the same payload is published to the dead-letter topic.
+    settings.mqttDeadLetterTopic = "my-sensor-dead-letter";
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_publishOneMessage("msg1,msg2,");
+    sensor.call_onPublishComplete(0, AWS_IO_SOCKET_CLOSED);
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+    ASSERT_EQ(sensor.mqttPublished[1].topic, "my-sensor-dead-letter");
+    ASSERT_EQ(sensor.mqttPublished[1].payload, "msg1,msg2,");
+
+    sensor.call_onPublishComplete(1, AWS_OP_SUCCESS);
+    ASSERT_EQ(sensor.getCounters().publishFailed, 1);
+    ASSERT_EQ(sensor.getCounters().deadLettered, 1);
+    ASSERT_EQ(sensor.getCounters().published, 0);
+}
+
+TEST_F(SensorTest, DeadLetterRetryBudget)
+{
+    // When publishing to the dead-letter topic keeps failing,
+    // then the batch is retried after a delay and dropped after the retry budget is exhausted.
+    settings.mqttDeadLetterTopic = "my-sensor-dead-letter";
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.setDeadLetterRetryDelay(10);
+
+    sensor.call_publishOneMessage("msg1,");
+    sensor.call_onPublishComplete(0, AWS_IO_SOCKET_CLOSED);
+    sensor.call_onPublishComplete(1, AWS_IO_SOCKET_CLOSED);
+    // Second attempt waits for the retry task.
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+
+    // Remaining attempts cannot be queued.
+    sensor.mqttPublishFails = true;
+    aws_event_loop_run(eventLoop);
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+    ASSERT_EQ(sensor.mqttPublished.size(), 4);
+    ASSERT_EQ(sensor.mqttPublished[3].topic, "my-sensor-dead-letter");
+    ASSERT_EQ(sensor.getCounters().deadLetterFailed, 1);
+    ASSERT_EQ(sensor.getCounters().deadLettered, 0);
+}
+
+TEST_F(SensorTest, StopCancelsDeadLetterRetry)
+{
+    // When the sensor is stopped while a dead-letter retry is waiting,
+    // then the retry is cancelled and the batch is dropped.
+    settings.mqttDeadLetterTopic = "my-sensor-dead-letter";
+    auto socket = std::make_shared<FakeSocket>();
+    aws_event_loop_run(eventLoop);
+    {
+        NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+        sensor.mqttPublishFails = true;
+        sensor.call_publishOneMessage("msg1,");
+        sensor.stop();
+        ASSERT_EQ(sensor.mqttPublished.size(), 2);
+        ASSERT_EQ(sensor.getCounters().deadLetterFailed, 1);
+    }
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+}
+
+TEST_F(SensorTest, DiscardedDataRoutesToDeadLetterTopic)
+{
+    // When the read buffer is full without an end of message delimiter,
+    // then the discarded data is published to the dead-letter topic.
+    settings.mqttDeadLetterTopic = "my-sensor-dead-letter";
+    settings.bufferCapacity = 1024;
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.writeReadBuf(settings.bufferCapacity.value());
+    size_t bufferSize, numBatches;
+    ASSERT_FALSE(sensor.needPublish(bufferSize, numBatches));
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+    ASSERT_EQ(sensor.getCounters().discardedBytes, settings.bufferCapacity.value());
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].topic, "my-sensor-dead-letter");
+    ASSERT_EQ(sensor.mqttPublished[0].payload.size(), settings.bufferCapacity.value());
+
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    ASSERT_EQ(sensor.getCounters().deadLettered, 1);
+}
+
+TEST_F(SensorTest, SpoolWhileDisconnected)
+{
+    // When the MQTT connection is down and a spool is configured,
+    // then batches are spooled and published at the drain rate once the connection resumes.
+    char spoolDir[] = "/tmp/aws-iot-device-client-sensor-spool-XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(spoolDir));
+    settings.spoolDir = spoolDir;
+    settings.spoolDrainRate = 20; // Two batches per run of the spool task.
+    {
+        auto socket = std::make_shared<FakeSocket>();
+        MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+        sensor.onConnectionStateChanged(false);
+        sensor.call_publishOneMessage("msg1,");
+        sensor.call_publishOneMessage("msg2,");
+        sensor.call_publishOneMessage("msg3,");
+        ASSERT_EQ(sensor.mqttPublished.size(), 0);
+        ASSERT_EQ(sensor.getCounters().spooled, 3);
+
+        // Nothing is drained while disconnected.
+        sensor.call_drainSpool();
+        ASSERT_EQ(sensor.mqttPublished.size(), 0);
+
+        sensor.onConnectionStateChanged(true);
+        sensor.call_publishOneMessage("msg4,"); // Live data is published directly.
+        sensor.call_drainSpool();
+        ASSERT_EQ(sensor.mqttPublished.size(), 3);
+        ASSERT_EQ(sensor.mqttPublished[0].payload, "msg4,");
+        ASSERT_EQ(sensor.mqttPublished[1].payload, "msg1,");
+        ASSERT_EQ(sensor.mqttPublished[2].payload, "msg2,");
+
+        sensor.call_drainSpool();
+        ASSERT_EQ(sensor.mqttPublished.size(), 4);
+        ASSERT_EQ(sensor.mqttPublished[3].payload, "msg3,");
+        ASSERT_EQ(sensor.getCounters().spoolDrained, 3);
+
+        for (size_t i = 0; i < sensor.mqttPublished.size(); ++i)
+        {
+            sensor.call_onPublishComplete(i, AWS_OP_SUCCESS);
+        }
+    }
+
+    DIR *dir = opendir(spoolDir);
+    for (dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+    {
+        if (entry->d_name[0] != '.')
+        {
+            unlink((std::string(spoolDir) + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(spoolDir);
+}
+
+TEST_F(SensorTest, CompressBatchAboveMinimumSize)
+{
+    // When compression is configured, then batches at or above the minimum size are published compressed,
+    // and smaller batches are published as is.
+    settings.compression = "deflate";
+    settings.compressionMinBytes = 64;
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    sensor.call_publishOneMessage("msg1,");
+    std::string batch;
+    for (int i = 0; i < 20; ++i)
+    {
+        batch += "{\"temperature\":21.5},";
+    }
+    sensor.call_publishOneMessage(batch);
+
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, "msg1,");
+    const std::string &compressed = sensor.mqttPublished[1].payload;
+    ASSERT_LT(compressed.size(), batch.size());
+    ASSERT_EQ(compressed.substr(0, 2), "\x1f\x8b"); // gzip magic bytes
+    ASSERT_EQ(sensor.getCounters().compressedBatches, 1);
+    ASSERT_EQ(sensor.getCounters().uncompressedBytes, batch.size());
+    ASSERT_EQ(sensor.getCounters().compressedBytes, compressed.size());
+
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    sensor.call_onPublishComplete(1, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, CompressEnvelopeLargerThanBufferCapacity)
+{
+    // When a batch format is configured, then an envelope larger than buffer_capacity is published compressed,
+    // and only an envelope which outgrew the compressor is published as is and counted.
+    settings.batchFormat = "json_array";
+    settings.compression = "deflate";
+    settings.compressionMinBytes = 64;
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    std::string envelope = "[\"" + std::string(1100, 'a') + "\"]";
+    sensor.call_publishOneMessage(envelope);
+    std::string escaped = "[\"" + std::string(1 << 16, '"') + "\"]";
+    sensor.call_publishOneMessage(escaped);
+
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+    ASSERT_EQ(sensor.mqttPublished[0].payload.substr(0, 2), "\x1f\x8b"); // gzip magic bytes
+    ASSERT_TRUE(sensor.mqttPublished[1].payload == escaped);
+    ASSERT_EQ(sensor.getCounters().compressedBatches, 1);
+    ASSERT_EQ(sensor.getCounters().compressionSkipped, 1);
+
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    sensor.call_onPublishComplete(1, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, PublishBatchInEnvelope)
+{
+    // When a batch format is configured, then messages are published in the envelope without their delimiter.
+    settings.batchFormat = "json_array";
+    auto socket = std::make_shared<FakeSocketReadData>();
+    socket->dataToWrite.emplace_back("msg1,\"msg2\",,msg3");
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+    EXPECT_CALL(sensor, publish()).Times(1);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    sensor.call_publish();
+
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, R"(["msg1","\"msg2\""])");
+    ASSERT_EQ(sensor.getReadBufLen(), 4); // Partial message is not published.
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, PublishBatchAcrossWrapPointAsOneMessage)
+{
+    // When the messages of a batch span the wrap point of the read buffer, then they are still published as a
+    // single message.
+    settings.bufferSize = 0;
+    settings.bufferCapacity = 1024;
+    auto socket = std::make_shared<FakeSocket>();
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+
+    std::string a = std::string(499, 'a') + ",";
+    std::string b = std::string(499, 'b') + ",";
+    std::string c = std::string(23, 'c') + ",";
+    sensor.readMessages(a + b + c);
+    sensor.consumeMessages(1);
+    sensor.readMessages("d,"); // Written at the start of the buffer.
+
+    sensor.call_publish();
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, b + c + "d,");
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+
+    // The next lap reuses the buffer joining the two parts.
+    sensor.readMessages(a + b + c);
+    sensor.consumeMessages(1);
+    sensor.readMessages("e,");
+    sensor.call_publish();
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+    ASSERT_EQ(sensor.mqttPublished[1].payload, b + c + "e,");
+    sensor.call_onPublishComplete(1, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, FilterMessagesBeforeBatching)
+{
+    // When drop_duplicates is configured, then repeated messages are removed from the buffer as they are read,
+    // and the batch holds the remaining messages and their delimiters.
+    settings.dropDuplicates = true;
+    auto socket = std::make_shared<FakeSocketReadData>();
+    socket->dataToWrite.emplace_back("a,a,b,,b,a,c");
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+    EXPECT_CALL(sensor, publish()).Times(1);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_EQ(sensor.getCounters().droppedDuplicate, 2);
+    ASSERT_EQ(sensor.getReadBufLen(), 8);
+    sensor.call_publish();
+
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, "a,b,,a,");
+    ASSERT_EQ(sensor.getReadBufLen(), 1); // Partial message is not filtered yet.
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, FlushIdleSensorWithinBufferTime)
+{
+    // When a sensor goes quiet after a partial batch, then the buffered messages are published once
+    // buffer_time_ms elapses, without waiting for another read.
+    constexpr int64_t bufferTimeMs = 50;
+    settings.bufferSize = 10;
+    settings.bufferTimeMs = bufferTimeMs;
+    auto socket = std::make_shared<FakeSocketReadData>();
+    socket->dataToWrite.emplace_back("msg1,msg2,");
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point readTime, publishTime;
+    ON_CALL(sensor, publish()).WillByDefault(Invoke([&sensor, &publishTime]() {
+        size_t published = sensor.mqttPublished.size();
+        sensor.call_publish();
+        if (sensor.mqttPublished.size() > published)
+        {
+            publishTime = Clock::now();
+        }
+    }));
+
+    // Connect and read once from the event loop, then leave the sensor idle.
+    struct ReadArgs
+    {
+        MockSensor *sensor;
+        Clock::time_point *readTime;
+    } args{&sensor, &readTime};
+    aws_task readTask;
+    aws_task_init(
+        &readTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) {
+            auto *readArgs = static_cast<ReadArgs *>(arg);
+            readArgs->sensor->call_onConnectionResultCallback(AWS_OP_SUCCESS);
+            *readArgs->readTime = Clock::now();
+            readArgs->sensor->call_onReadableCallback(AWS_OP_SUCCESS);
+        },
+        &args,
+        __func__);
+    aws_event_loop_run(eventLoop);
+    aws_event_loop_schedule_task_now(eventLoop, &readTask);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{bufferTimeMs * 4});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, "msg1,msg2,");
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(publishTime - readTime).count();
+    ASSERT_GE(latency, bufferTimeMs - 1);
+    ASSERT_LT(latency, bufferTimeMs * 3);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+}
+
+class FakeSocketFirehose : public FakeSocket
+{
+  public:
+    int read(aws_byte_buf *buf, std::size_t *amount_read) override
+    {
+        // The socket never runs out of data, until the test is done.
+        if (dry)
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        size_t len = std::min(buf->capacity - buf->len, sizeof(chunk) - 1);
+        aws_byte_buf_write(buf, reinterpret_cast<const uint8_t *>(chunk), len);
+        *amount_read = len;
+        ++count;
+        return AWS_OP_SUCCESS;
+    }
+    const char chunk[65] = "firehose,firehose,firehose,firehose,firehose,firehose,firehose,,";
+    std::atomic<size_t> count{0};
+    std::atomic<bool> dry{false};
+};
+
+TEST_F(SensorTest, ReadBudgetYieldsEventLoopToOtherSensors)
+{
+    // When a sensor keeps its socket readable, then it yields the shared event loop after the read budget,
+    // and a slow sensor on the same event loop is read and published without waiting for the fast sensor to drain.
+    auto firehoseSettings = settings;
+    firehoseSettings.name = "firehose";
+    firehoseSettings.maxInflight = 0;
+    firehoseSettings.readBudgetBytes = 4096;
+    auto firehoseSocket = std::make_shared<FakeSocketFirehose>();
+    NiceMock<MockSensor> firehose(firehoseSettings, allocator, connection, eventLoop, firehoseSocket);
+    ON_CALL(firehose, publish()).WillByDefault(Invoke([&firehose] { firehose.call_publish(); }));
+
+    auto slowSocket = std::make_shared<FakeSocketReadData>();
+    slowSocket->dataToWrite.emplace_back("slow,");
+    NiceMock<MockSensor> slow(settings, allocator, connection, eventLoop, slowSocket);
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point readableTime, publishTime;
+    ON_CALL(slow, publish()).WillByDefault(Invoke([&slow, &publishTime] {
+        slow.call_publish();
+        publishTime = Clock::now();
+    }));
+
+    aws_task firehoseTask;
+    aws_task_init(
+        &firehoseTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) {
+            auto *sensor = static_cast<MockSensor *>(arg);
+            sensor->call_onConnectionResultCallback(AWS_OP_SUCCESS);
+            sensor->call_onReadableCallback(AWS_OP_SUCCESS);
+        },
+        &firehose,
+        __func__);
+    aws_task slowTask;
+    aws_task_init(
+        &slowTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) {
+            static_cast<MockSensor *>(arg)->call_onReadableCallback(AWS_OP_SUCCESS);
+        },
+        &slow,
+        __func__);
+    aws_event_loop_run(eventLoop);
+    aws_event_loop_schedule_task_now(eventLoop, &firehoseTask);
+    while (firehoseSocket->count < 1000)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    // The slow sensor becomes readable while the firehose saturates the event loop.
+    readableTime = Clock::now();
+    aws_event_loop_schedule_task_now(eventLoop, &slowTask);
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    // Let the firehose run dry, so that no read retry is left scheduled once the event loop stops.
+    firehoseSocket->dry = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_GT(firehose.getCounters().readYielded, 1);
+    ASSERT_EQ(slow.mqttPublished.size(), 1);
+    ASSERT_EQ(slow.mqttPublished[0].payload, "slow,");
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(publishTime - readableTime).count();
+    ASSERT_LT(latency, 50);
+
+    slow.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    for (size_t i = 0; i < firehose.mqttPublished.size(); ++i)
+    {
+        firehose.call_onPublishComplete(i, AWS_OP_SUCCESS);
+    }
+}
+
+class FakeMessageSocket : public FakeSocket
+{
+  public:
+    bool is_message_based() override { return true; }
+
+    int read_messages(
+        aws_byte_buf *buf,
+        std::size_t slot_size,
+        std::size_t *lengths,
+        std::size_t max_messages,
+        std::size_t *count,
+        std::size_t *truncated_bytes) override
+    {
+        if (messages.empty())
+        {
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        *count = 0;
+        *truncated_bytes = 0;
+        for (const auto &message : messages)
+        {
+            if (message.size() > slot_size)
+            {
+                *truncated_bytes += message.size();
+                continue;
+            }
+            aws_byte_buf_write(buf, reinterpret_cast<const uint8_t *>(message.data()), message.size());
+            lengths[(*count)++] = message.size();
+        }
+        messages.clear();
+        return AWS_OP_SUCCESS;
+    }
+    std::vector<std::string> messages;
+};
+
+TEST_F(SensorTest, MessageSocketReadsWholeMessages)
+{
+    // When the socket preserves message boundaries, then every message read is complete without a delimiter,
+    // and messages larger than max_message_bytes are discarded.
+    settings.eomDelimiter = Aws::Crt::Optional<std::string>();
+    settings.batchFormat = "json_array";
+    settings.maxMessageBytes = 8;
+    auto socket = std::make_shared<FakeMessageSocket>();
+    socket->messages = {"a,b", "message too long", "cc", "ddd"};
+    MockSensor sensor(settings, allocator, connection, eventLoop, socket);
+    EXPECT_CALL(sensor, publish()).Times(1);
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_THAT(sensor.getEomBounds(), ElementsAre(3, 5, 8));
+    ASSERT_EQ(sensor.getCounters().discardedBytes, 16);
+
+    sensor.call_publish();
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    ASSERT_EQ(sensor.mqttPublished[0].payload, R"(["a,b","cc","ddd"])");
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, PauseReadingWhileInflightWindowFull)
+{
+    // When max_inflight publishes are not yet acknowledged, then reading and publishing pause,
+    // and resume once acknowledgements make room in the window.
+    settings.bufferSize = 1;
+    settings.maxInflight = 2;
+    auto socket = std::make_shared<FakeSocketReadData>();
+    socket->dataToWrite.emplace_back("a,b,c,d,");
+    socket->dataToWrite.emplace_back("e,");
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+    ON_CALL(sensor, publish()).WillByDefault(Invoke([&] { sensor.call_publish(); }));
+
+    sensor.call_onReadableCallback(AWS_OP_SUCCESS);
+    ASSERT_EQ(sensor.mqttPublished.size(), 2);
+    ASSERT_EQ(socket->count, 1); // Remaining data is left in the socket.
+    ASSERT_EQ(sensor.getCounters().windowFull, 1);
+
+    // A single acknowledgement makes room for a single publish.
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+    sensor.call_onResumeTaskCallback();
+    ASSERT_EQ(sensor.mqttPublished.size(), 3);
+    ASSERT_EQ(sensor.getCounters().windowFull, 2);
+
+    sensor.call_onPublishComplete(1, AWS_OP_SUCCESS);
+    sensor.call_onPublishComplete(2, AWS_OP_SUCCESS);
+    sensor.call_onResumeTaskCallback();
+    ASSERT_EQ(sensor.mqttPublished.size(), 4);
+    ASSERT_EQ(sensor.getEomBoundsSize(), 0);
+
+    sensor.call_onPublishComplete(3, AWS_OP_SUCCESS);
+}
+
+class FakeAggregator : public Aggregator
+{
+  public:
+    FakeAggregator(aws_allocator *allocator, aws_event_loop *eventLoop)
+        : Aggregator(allocator, nullptr, eventLoop, "aggregate-data", 1024, 1000, 1)
+    {
+    }
+
+    uint16_t mqttPublish(const aws_byte_cursor *payload) override
+    {
+        published.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+        return static_cast<uint16_t>(published.size());
+    }
+
+    void call_onPublishComplete(size_t index, int errorCode)
+    {
+        onPublishComplete(static_cast<uint16_t>(index + 1), errorCode);
+    }
+
+    std::vector<std::string> published;
+};
+
+TEST_F(SensorTest, AggregateBatchesOfSeveralSensors)
+{
+    // When sensors are configured with aggregate, then their batches are published together in a single message,
+    // except for a batch too large for the aggregate message, or added while the aggregate in-flight window is
+    // full, which is published to the sensor topic.
+    aws_event_loop_run(eventLoop);
+    auto aggregator = std::make_shared<FakeAggregator>(allocator, eventLoop);
+    auto otherSettings = settings;
+    otherSettings.name = "my-other-sensor";
+    auto socket = std::make_shared<FakeSocket>();
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket, nullptr, aggregator);
+    NiceMock<MockSensor> other(otherSettings, allocator, connection, eventLoop, socket, nullptr, aggregator);
+
+    sensor.call_publishOneMessage("a,b,");
+    other.call_publishOneMessage("c,");
+    ASSERT_TRUE(sensor.mqttPublished.empty());
+    ASSERT_TRUE(other.mqttPublished.empty());
+    ASSERT_EQ(sensor.getCounters().aggregated, 1);
+
+    aggregator->flush();
+    ASSERT_EQ(aggregator->published.size(), 1);
+    auto record = [](const std::string &name, const std::string &batch) {
+        return std::string{'\0', static_cast<char>(name.size())} + name +
+               std::string{'\0', '\0', '\0', static_cast<char>(batch.size())} + batch;
+    };
+    ASSERT_EQ(aggregator->published[0], record("my-sensor", "a,b,") + record("my-other-sensor", "c,"));
+
+    sensor.call_publishOneMessage(std::string(2048, 'x'));
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+
+    // The aggregate message is not acknowledged yet, and the window holds a single message.
+    other.call_publishOneMessage("d,");
+    ASSERT_EQ(other.mqttPublished.size(), 1);
+    ASSERT_EQ(other.mqttPublished[0].payload, "d,");
+    ASSERT_EQ(aggregator->getCounters().windowFull, 1);
+    other.call_onPublishComplete(0, AWS_OP_SUCCESS);
+
+    aggregator->call_onPublishComplete(0, AWS_OP_SUCCESS);
+    other.call_publishOneMessage("e,");
+    ASSERT_EQ(other.mqttPublished.size(), 1);
+    ASSERT_EQ(other.getCounters().aggregated, 2);
+}
+
+TEST_F(SensorTest, SummarizeMessagesPerWindow)
+{
+    // When summary fields are configured, then messages are released as soon as they are read,
+    // and only the summary of the window is published once the window ends.
+    constexpr int64_t windowMs = 50;
+    settings.eomDelimiter = "[\n]+";
+    settings.summaryFormat = "csv";
+    settings.summaryFields = {"1"};
+    settings.summaryWindowMs = windowMs;
+    auto socket = std::make_shared<FakeSocketReadData>();
+    socket->dataToWrite.emplace_back("a,1\nb,3\nc,x\n");
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+    ON_CALL(sensor, publish()).WillByDefault(Invoke([&sensor]() { sensor.call_publish(); }));
+
+    aws_task readTask;
+    aws_task_init(
+        &readTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) {
+            auto *readSensor = static_cast<MockSensor *>(arg);
+            readSensor->call_onConnectionResultCallback(AWS_OP_SUCCESS);
+            readSensor->call_onReadableCallback(AWS_OP_SUCCESS);
+        },
+        &sensor,
+        __func__);
+    aws_event_loop_run(eventLoop);
+    aws_event_loop_schedule_task_now(eventLoop, &readTask);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{windowMs * 4});
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_EQ(sensor.getReadBufLen(), 0);
+    ASSERT_EQ(sensor.mqttPublished.size(), 1);
+    const std::string &summary = sensor.mqttPublished[0].payload;
+    ASSERT_NE(summary.find(R"("window_ms":50,"messages":3,)"), std::string::npos);
+    ASSERT_NE(summary.find(R"("fields":{"1":{"count":2,"min":1,"max":3,"mean":2}}})"), std::string::npos);
+    sensor.call_onPublishComplete(0, AWS_OP_SUCCESS);
+}
+
+TEST_F(SensorTest, ManySensorsShareBoundedBufferPool)
+{
+    // When 500 sensors share a buffer pool, then the memory held by read buffers stays within the budget,
+    // idle sensors hold no read buffer, and sensors which found the pool exhausted read once buffers are returned.
+    constexpr size_t numSensors = 500;
+    constexpr size_t budget = 256 * 1024;
+    auto pool = std::make_shared<BufferPool>(allocator, budget);
+
+    std::vector<std::unique_ptr<NiceMock<MockSensor>>> sensors;
+    for (size_t i = 0; i < numSensors; ++i)
+    {
+        auto socket = std::make_shared<FakeSocketReadData>();
+        socket->dataToWrite.emplace_back("msg,");
+        sensors.emplace_back(new NiceMock<MockSensor>(settings, allocator, connection, eventLoop, socket, pool));
+        ASSERT_FALSE(sensors.back()->holdsReadBuf());
+    }
+    ASSERT_EQ(pool->allocatedBytes(), 0);
+
+    const size_t buffersInBudget = budget / sensors[0]->getReadBufBlockSize();
+    ASSERT_GT(buffersInBudget, 0);
+    ASSERT_LT(buffersInBudget, numSensors);
+
+    size_t published = 0;
+    while (published < numSensors)
+    {
+        const size_t remaining = numSensors - published;
+
+        // Every sensor is readable, but only as many as the budget allows hold a read buffer.
+        for (auto &sensor : sensors)
+        {
+            sensor->call_onReadableCallback(AWS_OP_SUCCESS);
+        }
+        ASSERT_LE(pool->allocatedBytes(), budget);
+        size_t holding = 0;
+        for (auto &sensor : sensors)
+        {
+            if (sensor->holdsReadBuf())
+            {
+                ++holding;
+                sensor->call_publish();
+                sensor->call_onPublishComplete(0, AWS_OP_SUCCESS);
+                ASSERT_FALSE(sensor->holdsReadBuf()); // Buffer is returned once published.
+                ++published;
+            }
+        }
+        ASSERT_EQ(holding, std::min(buffersInBudget, remaining));
+        ASSERT_EQ(pool->inUseBytes(), 0);
+    }
+
+    uint64_t deferred = 0;
+    for (auto &sensor : sensors)
+    {
+        ASSERT_EQ(sensor->mqttPublished.size(), 1);
+        ASSERT_EQ(sensor->mqttPublished[0].payload, "msg,");
+        deferred += sensor->getCounters().readDeferred;
+    }
+    ASSERT_GT(deferred, 0);
+    ASSERT_LE(pool->allocatedBytes(), budget);
+}
+
+class FakeSocketWrites : public FakeSocket
+{
+  public:
+    int write(const aws_byte_cursor *cursor, aws_socket_on_write_completed_fn *written_fn, void *user_data) override
+    {
+        if (wouldBlock > 0)
+        {
+            --wouldBlock;
+            return aws_raise_error(AWS_IO_READ_WOULD_BLOCK);
+        }
+        written.emplace_back(reinterpret_cast<const char *>(cursor->ptr), cursor->len);
+        written_fn(nullptr, AWS_OP_SUCCESS, cursor->len, user_data);
+        return AWS_OP_SUCCESS;
+    }
+    std::vector<std::string> written;
+    int wouldBlock{0};
+};
+
+TEST_F(SensorTest, WriteCommandsToSocket)
+{
+    // When commands are received on the command topic,
+    // then they wait in the command buffer while disconnected, dropping the oldest commands once it is full,
+    // and are written to the socket in order once connected, retrying while the socket would block.
+    settings.mqttCommandTopic = "my-sensor-commands";
+    settings.commandBufferBytes = 8;
+    auto socket = std::make_shared<FakeSocketWrites>();
+    socket->wouldBlock = 1;
+    NiceMock<MockSensor> sensor(settings, allocator, connection, eventLoop, socket);
+    sensor.start();
+    ASSERT_EQ(sensor.mqttSubscribed, "my-sensor-commands");
+
+    aws_event_loop_run(eventLoop);
+    sensor.call_onCommandReceived("cmd1");
+    sensor.call_onCommandReceived("cmd2");
+    sensor.call_onCommandReceived("cmd3");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    ASSERT_TRUE(socket->written.empty());
+    ASSERT_EQ(sensor.getCounters().droppedCommands, 1);
+
+    aws_task connectedTask;
+    aws_task_init(
+        &connectedTask,
+        [](struct aws_task *, void *arg, enum aws_task_status) {
+            static_cast<MockSensor *>(arg)->call_onConnectionResultCallback(AWS_OP_SUCCESS);
+        },
+        &sensor,
+        __func__);
+    aws_event_loop_schedule_task_now(eventLoop, &connectedTask);
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    sensor.call_onCommandReceived("cmd4");
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    sensor.stop();
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_THAT(socket->written, ElementsAre("cmd2", "cmd3", "cmd4"));
+    ASSERT_EQ(sensor.getCounters().commandsWritten, 3);
+    ASSERT_EQ(sensor.getCounters().droppedCommands, 1);
+    ASSERT_TRUE(sensor.mqttSubscribed.empty());
+}
@@ -69,7 +69,7 @@ class FakeNotifier : public ClientBaseNotifier
 class FakeSocket : public Socket
 {
   public:
-    void init(aws_allocator *allocator, aws_socket_options *options) override {}
+    void init(aws_allocator *allocator) override {}
 
     int connect(
         const struct aws_socket_endpoint *remote_endpoint,
@@ -167,7 +167,9 @@ class MockSensorPublishFeature : public SensorPublishFeature
         const PlainConfig::SensorPublish::SensorSettings &settings,
         aws_allocator *allocator,
         std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
-        aws_event_loop *eventLoop) const override
+        aws_event_loop *eventLoop,
+        std::shared_ptr<BufferPool> bufferPool,
+        std::shared_ptr<Aggregator> aggregator) const override
     {
         // Returns FakeSensor with no-op start and stop.
         return std::unique_ptr<FakeSensor>(new FakeSensor(settings, mResourceManager));
@@ -204,7 +206,9 @@ class MockSensorPublishFeatureCreateSensorThrows : public SensorPublishFeature
         const PlainConfig::SensorPublish::SensorSettings &settings,
         aws_allocator *allocator,
         std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection,
-        aws_event_loop *eventLoop) const override
+        aws_event_loop *eventLoop,
+        std::shared_ptr<BufferPool> bufferPool,
+        std::shared_ptr<Aggregator> aggregator) const override
     {
         throw std::runtime_error{"Sensor constructor throws"};
     }
@@ -250,3 +254,23 @@ TEST_F(SensorPublishFeatureTest, StopSensorSuccess)
     ASSERT_EQ(notifier->count_started, 0);
     ASSERT_EQ(notifier->count_stopped, 1);
 }
+
+TEST_F(SensorPublishFeatureTest, PlaceSensorsRoundRobin)
+{
+    // When no sensor is pinned, then sensors are placed round robin.
+    config.sensorPublish.settings.resize(5, config.sensorPublish.settings[0]);
+    config.sensorPublish.settings[3].enabled = false;
+
+    auto placement = SensorPublishFeature::PlaceSensors(config.sensorPublish.settings, 2);
+    ASSERT_EQ(placement, (std::vector<size_t>{0, 1, 0, 0, 1}));
+}
+
+TEST_F(SensorPublishFeatureTest, PlaceSensorsAroundPinnedSensor)
+{
+    // When a sensor is pinned, then the other sensors are placed on the least loaded loops.
+    config.sensorPublish.settings.resize(4, config.sensorPublish.settings[0]);
+    config.sensorPublish.settings[2].eventLoop = 0;
+
+    auto placement = SensorPublishFeature::PlaceSensors(config.sensorPublish.settings, 3);
+    ASSERT_EQ(placement, (std::vector<size_t>{1, 2, 0, 0}));
+}
@@ -0,0 +1,194 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/Spool.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    constexpr size_t MAX_BYTES = 1024 * 1024;
+
+    bool append(Spool &spool, const string &data)
+    {
+        return spool.append(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    }
+
+    string peekString(Spool &spool)
+    {
+        const uint8_t *data = nullptr;
+        size_t len = 0;
+        if (!spool.peek(&data, &len))
+        {
+            return "";
+        }
+        return string(reinterpret_cast<const char *>(data), len);
+    }
+
+    size_t countSegments(const string &dir)
+    {
+        size_t count = 0;
+        DIR *d = opendir(dir.c_str());
+        for (dirent *entry = readdir(d); entry != nullptr; entry = readdir(d))
+        {
+            if (strstr(entry->d_name, ".seg") != nullptr)
+            {
+                ++count;
+            }
+        }
+        closedir(d);
+        return count;
+    }
+} // namespace
+
+class SpoolTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/aws-iot-device-client-spool-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dirTemplate));
+        dir = dirTemplate;
+    }
+
+    void TearDown() override
+    {
+        DIR *d = opendir(dir.c_str());
+        for (dirent *entry = readdir(d); entry != nullptr; entry = readdir(d))
+        {
+            if (entry->d_name[0] != '.')
+            {
+                unlink((dir + "/" + entry->d_name).c_str());
+            }
+        }
+        closedir(d);
+        rmdir(dir.c_str());
+    }
+
+    string dir;
+};
+
+TEST_F(SpoolTest, AppendPeekPop)
+{
+    Spool spool(dir, MAX_BYTES);
+    ASSERT_TRUE(spool.open());
+    ASSERT_TRUE(spool.empty());
+    ASSERT_EQ("", peekString(spool));
+
+    ASSERT_TRUE(append(spool, "first"));
+    ASSERT_TRUE(append(spool, "second batch"));
+    ASSERT_EQ(2u, spool.records());
+    ASSERT_EQ(17u, spool.bytes());
+
+    ASSERT_EQ("first", peekString(spool));
+    spool.pop();
+    ASSERT_EQ("second batch", peekString(spool));
+    spool.pop();
+    ASSERT_TRUE(spool.empty());
+    ASSERT_EQ(0u, spool.bytes());
+}
+
+TEST_F(SpoolTest, RecoverAfterRestart)
+{
+    // When the spool is reopened, then records which were not consumed are read back in order.
+    {
+        Spool spool(dir, MAX_BYTES);
+        ASSERT_TRUE(spool.open());
+        append(spool, "aa");
+        append(spool, "bb");
+        append(spool, "cc");
+        spool.pop();
+    }
+
+    Spool spool(dir, MAX_BYTES);
+    ASSERT_TRUE(spool.open());
+    ASSERT_EQ(2u, spool.records());
+    ASSERT_EQ("bb", peekString(spool));
+    spool.pop();
+
+    // Appending continues after the recovered records.
+    ASSERT_TRUE(append(spool, "dd"));
+    ASSERT_EQ("cc", peekString(spool));
+    spool.pop();
+    ASSERT_EQ("dd", peekString(spool));
+}
+
+TEST_F(SpoolTest, ConsumedSegmentsAreDeleted)
+{
+    Spool spool(dir, MAX_BYTES);
+    ASSERT_TRUE(spool.open());
+    ASSERT_EQ(Spool::SEGMENT_BYTES_MIN, spool.segmentBytes());
+
+    // Two records per segment.
+    string record(spool.segmentBytes() / 2 - 64, 'x');
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_TRUE(append(spool, record));
+    }
+    ASSERT_EQ(3u, countSegments(dir));
+
+    while (!spool.empty())
+    {
+        spool.pop();
+    }
+    ASSERT_EQ("", peekString(spool));
+    ASSERT_EQ(1u, countSegments(dir));
+}
+
+TEST_F(SpoolTest, EvictOldestWhenFull)
+{
+    Spool spool(dir, MAX_BYTES);
+    ASSERT_TRUE(spool.open());
+
+    // Two records per segment, and the size cap holds four segments.
+    string record(spool.segmentBytes() / 2 - 64, 'x');
+    for (char c = 'a'; c < 'a' + 12; ++c)
+    {
+        record[0] = c;
+        ASSERT_TRUE(append(spool, record));
+    }
+
+    ASSERT_EQ(4u, countSegments(dir));
+    ASSERT_EQ(8u, spool.records());
+    ASSERT_EQ(4u, spool.evictedRecords());
+    ASSERT_EQ('e', peekString(spool)[0]);
+}
+
+TEST_F(SpoolTest, RejectRecordLargerThanSegment)
+{
+    Spool spool(dir, MAX_BYTES);
+    ASSERT_TRUE(spool.open());
+    ASSERT_FALSE(append(spool, string(spool.segmentBytes(), 'x')));
+    ASSERT_TRUE(spool.empty());
+}
+
+TEST_F(SpoolTest, DISABLED_BenchmarkSustainedIngest)
+{
+    // Run with SPOOL_BENCHMARK_DIR set to a directory on the target storage, for example eMMC.
+    const char *benchmarkDir = getenv("SPOOL_BENCHMARK_DIR");
+    Spool spool(benchmarkDir != nullptr ? benchmarkDir : dir, 64 * 1024 * 1024);
+    ASSERT_TRUE(spool.open());
+
+    constexpr size_t messages = 200000;
+    string message(200, 'x');
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < messages; ++i)
+    {
+        ASSERT_TRUE(append(spool, message));
+    }
+    spool.sync();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("Spooled %zu messages of %zu bytes: %.0f msgs/s\n", messages, message.size(), messages / seconds);
+    ASSERT_GE(messages / seconds, 10000.0);
+}
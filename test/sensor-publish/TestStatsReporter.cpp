@@ -0,0 +1,211 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/StatsReporter.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+#include <aws/common/clock.h>
+#include <aws/crt/Types.h>
+#include <aws/crt/mqtt/MqttClient.h>
+#include <aws/io/event_loop.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Aws::Iot;
+using namespace Aws::Iot::DeviceClient;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+class StatsReporterFakeSocket : public Socket
+{
+  public:
+    void init(aws_allocator *allocator) override {}
+
+    int connect(
+        const struct aws_socket_endpoint *remote_endpoint,
+        struct aws_event_loop *event_loop,
+        aws_socket_on_connection_result_fn *on_connection_result,
+        void *user_data) override
+    {
+        return AWS_OP_SUCCESS;
+    }
+
+    int subscribe_to_readable_events(aws_socket_on_readable_fn *on_readable, void *user_data) override
+    {
+        return AWS_OP_SUCCESS;
+    }
+
+    bool is_open() override { return true; }
+
+    int read(aws_byte_buf *buf, std::size_t *amount_read) override { return AWS_OP_SUCCESS; }
+
+    int close() override { return AWS_OP_SUCCESS; }
+
+    void clean_up() override {}
+};
+
+class StatsSensor : public Sensor
+{
+  public:
+    StatsSensor(
+        const PlainConfig::SensorPublish::SensorSettings &settings,
+        aws_allocator *allocator,
+        aws_event_loop *eventLoop)
+        : Sensor(settings, allocator, nullptr, eventLoop, std::make_shared<StatsReporterFakeSocket>())
+    {
+    }
+
+    SensorLatency &latency() { return mLatency; }
+};
+
+class FakeStatsReporter : public StatsReporter
+{
+  public:
+    using StatsReporter::StatsReporter;
+
+    uint16_t mqttPublish(const aws_byte_cursor *payload) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        published.emplace_back(reinterpret_cast<const char *>(payload->ptr), payload->len);
+        return static_cast<uint16_t>(published.size());
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> published;
+};
+
+class StatsReporterTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        allocator = aws_default_allocator();
+        eventLoop = aws_event_loop_new_default(allocator, aws_high_res_clock_get_ticks);
+
+        for (const char *name : {"sensor-1", "sensor-\"2\""})
+        {
+            settings.emplace_back(new PlainConfig::SensorPublish::SensorSettings());
+            settings.back()->name = std::string(name);
+            settings.back()->addr = "my-sensor-server";
+            settings.back()->mqttTopic = "my-sensor-data";
+            settings.back()->eomDelimiter = "[,]+";
+            settings.back()->bufferCapacity = 1024;
+            sensors.emplace_back(new StatsSensor(*settings.back(), allocator, eventLoop));
+        }
+
+        char dir[] = "/tmp/aws-iot-device-client-stats-XXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        statsDir = dir;
+        statsFile = statsDir + "/stats.json";
+    }
+
+    void TearDown() override
+    {
+        unlink(statsFile.c_str());
+        unlink((statsFile + ".tmp").c_str());
+        rmdir(statsDir.c_str());
+        sensors.clear();
+        aws_event_loop_destroy(eventLoop);
+    }
+
+    StatsSensor &sensor(size_t i) { return static_cast<StatsSensor &>(*sensors[i]); }
+
+    static std::string readFile(const std::string &path)
+    {
+        std::ifstream in(path);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    static bool fileExists(const std::string &path) { return access(path.c_str(), F_OK) == 0; }
+
+    aws_allocator *allocator;
+    aws_event_loop *eventLoop;
+    std::vector<std::unique_ptr<PlainConfig::SensorPublish::SensorSettings>> settings;
+    std::vector<std::unique_ptr<Sensor>> sensors;
+    std::shared_ptr<Aws::Crt::Mqtt::MqttConnection> connection;
+    std::string statsDir;
+    std::string statsFile;
+};
+
+TEST_F(StatsReporterTest, FormatLatencyOfEachSensor)
+{
+    // Each sensor is listed with the latency percentiles of its published batches, and its name is escaped.
+    sensor(0).latency().queue.record(5);
+    sensor(0).latency().queue.record(10);
+    sensor(0).latency().ack.record(7);
+    sensor(0).latency().total.record(12);
+
+    FakeStatsReporter reporter(connection, eventLoop, sensors, "", "", 1);
+    ASSERT_EQ(
+        reporter.format(1000),
+        "{\"time_ms\":1000,\"sensors\":[{\"name\":\"sensor-1\",\"latency_us\":{"
+        "\"queue\":{\"count\":2,\"p50\":5,\"p99\":10,\"max\":10},"
+        "\"ack\":{\"count\":1,\"p50\":7,\"p99\":7,\"max\":7},"
+        "\"total\":{\"count\":1,\"p50\":12,\"p99\":12,\"max\":12}}},"
+        "{\"name\":\"sensor-\\\"2\\\"\",\"latency_us\":{"
+        "\"queue\":{\"count\":0,\"p50\":0,\"p99\":0,\"max\":0},"
+        "\"ack\":{\"count\":0,\"p50\":0,\"p99\":0,\"max\":0},"
+        "\"total\":{\"count\":0,\"p50\":0,\"p99\":0,\"max\":0}}}]}");
+}
+
+TEST_F(StatsReporterTest, ReportReplacesStatsFile)
+{
+    // When reporting, then the stats file is replaced by a new file rather than rewritten in place, so a reader
+    // of the previous document still sees it whole, and the same document is published to the stats topic.
+    {
+        std::ofstream previous(statsFile);
+        previous << "previous document";
+    }
+    std::ifstream reader(statsFile);
+
+    FakeStatsReporter reporter(connection, eventLoop, sensors, statsFile, "stats", 1);
+    reporter.report();
+
+    std::stringstream previous;
+    previous << reader.rdbuf();
+    ASSERT_EQ(previous.str(), "previous document");
+
+    std::string document = readFile(statsFile);
+    ASSERT_EQ(document.find("{\"time_ms\":"), 0);
+    ASSERT_NE(document.find("\"name\":\"sensor-1\""), std::string::npos);
+    ASSERT_NE(document.find("\"name\":\"sensor-\\\"2\\\"\""), std::string::npos);
+    ASSERT_FALSE(fileExists(statsFile + ".tmp"));
+
+    std::lock_guard<std::mutex> lock(reporter.mutex);
+    ASSERT_EQ(reporter.published.size(), 1);
+    ASSERT_EQ(reporter.published[0], document);
+}
+
+TEST_F(StatsReporterTest, StopWritesFinalReportAndIsNotRescheduled)
+{
+    // When stopped before the first interval, then the stats file is written once, and the report task neither
+    // reports nor reschedules itself afterwards.
+    aws_event_loop_run(eventLoop);
+
+    FakeStatsReporter reporter(connection, eventLoop, sensors, statsFile, "stats", 1);
+    reporter.start();
+    reporter.stop();
+    ASSERT_TRUE(fileExists(statsFile));
+    ASSERT_FALSE(fileExists(statsFile + ".tmp"));
+
+    unlink(statsFile.c_str());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+
+    aws_event_loop_stop(eventLoop);
+    aws_event_loop_wait_for_stop_completion(eventLoop);
+
+    ASSERT_FALSE(fileExists(statsFile));
+    std::lock_guard<std::mutex> lock(reporter.mutex);
+    ASSERT_TRUE(reporter.published.empty());
+}
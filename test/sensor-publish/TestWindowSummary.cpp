@@ -0,0 +1,79 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../source/sensor-publish/WindowSummary.h"
+#include "gtest/gtest.h"
+
+#include <aws/common/allocator.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Aws::Iot::DeviceClient::SensorPublish;
+
+namespace
+{
+    void add(WindowSummary &summary, const string &message, uint64_t timeMs)
+    {
+        summary.add(reinterpret_cast<const uint8_t *>(message.data()), message.size(), timeMs);
+    }
+
+    string finish(WindowSummary &summary)
+    {
+        aws_byte_cursor encoded = summary.finish();
+        return string(reinterpret_cast<const char *>(encoded.ptr), encoded.len);
+    }
+} // namespace
+
+TEST(WindowSummaryTest, Json)
+{
+    WindowSummary summary(aws_default_allocator(), FieldParser::Format::Json, {"temp", "rh"}, 1000);
+    ASSERT_TRUE(summary.empty());
+
+    add(summary, R"({"temp": 20.5, "rh": 40, "id": "a"})", 12345);
+    add(summary, R"({"id":"b","temp":-1.5,"rh":"n/a"})", 12500);
+    add(summary, R"({"meta":{"temp":99},"temp":4})", 12999);
+    ASSERT_FALSE(summary.empty());
+    ASSERT_EQ(13000, summary.windowEnd());
+
+    // Nested keys and values which are not numbers are not counted.
+    ASSERT_EQ(
+        R"({"ts":12000,"window_ms":1000,"messages":3,)"
+        R"("fields":{"temp":{"count":3,"min":-1.5,"max":20.5,"mean":7.66666666666667},)"
+        R"("rh":{"count":1,"min":40,"max":40,"mean":40}}})",
+        finish(summary));
+    ASSERT_TRUE(summary.empty());
+}
+
+TEST(WindowSummaryTest, Csv)
+{
+    WindowSummary summary(aws_default_allocator(), FieldParser::Format::Csv, {"1", "3"}, 500);
+    add(summary, "a, 10 ,x,\"2\"", 100);
+    add(summary, "b,30", 200);
+    add(summary, "c,,y,7e1", 300);
+    ASSERT_EQ(
+        R"({"ts":0,"window_ms":500,"messages":3,)"
+        R"("fields":{"1":{"count":2,"min":10,"max":30,"mean":20},"3":{"count":2,"min":2,"max":70,"mean":36}}})",
+        finish(summary));
+}
+
+TEST(WindowSummaryTest, FinishStartsNewWindow)
+{
+    WindowSummary summary(aws_default_allocator(), FieldParser::Format::Json, {"v"}, 100);
+    add(summary, R"({"v":1})", 150);
+    finish(summary);
+
+    // The next window only holds the messages added after finish, and fields without values have no statistics.
+    add(summary, R"({"w":1})", 420);
+    ASSERT_EQ(500, summary.windowEnd());
+    ASSERT_EQ(R"({"ts":400,"window_ms":100,"messages":1,"fields":{"v":{"count":0}}})", finish(summary));
+}
+
+TEST(WindowSummaryTest, InvalidColumn)
+{
+    ASSERT_THROW(
+        WindowSummary(aws_default_allocator(), FieldParser::Format::Csv, vector<string>{"temp"}, 1000),
+        std::runtime_error);
+}